@@ -236,6 +236,7 @@ function handleWSMessage(data) {
             addMessageToLog(data);
             break;
         case 'actuatorStatus':
+        case 'actuatorsSet':
             updateActuatorStatus(data);
             break;
         case 'alert':
@@ -251,6 +252,9 @@ function handleWSMessage(data) {
         case 'wifiNetworks':
             displayWiFiNetworks(data.networks);
             break;
+        case 'wifiScanFailed':
+            showToast('WiFi scan failed', 'error');
+            break;
         case 'wifiConnecting':
             showToast(`Connecting to ${data.ssid}...`, 'info');
             break;
@@ -475,6 +479,25 @@ function loadWiFiStatus() {
         });
 }
 
+// Scans run in the background on the device: a 202 reply carries a
+// scanId to poll until the results are ready
+function fetchWiFiScan(refresh = false, scanId = null, attempts = 20) {
+    let url = '/api/wifi/scan';
+    if (scanId !== null) url += `?id=${scanId}`;
+    else if (refresh) url += '?refresh=1';
+
+    return fetch(url)
+        .then(response => response.json().then(data => ({status: response.status, data})))
+        .then(({status, data}) => {
+            if (status === 202 && attempts > 0) {
+                return new Promise(resolve => setTimeout(resolve, 1000))
+                    .then(() => fetchWiFiScan(false, data.scanId, attempts - 1));
+            }
+            if (status !== 200) throw new Error(data.error || 'Scan failed');
+            return data;
+        });
+}
+
 function scanWiFiNetworks() {
     showToast('Scanning for WiFi networks...', 'info');
     addActivityLog('Scanning WiFi networks');
@@ -485,8 +508,7 @@ function scanWiFiNetworks() {
         networkList.innerHTML = '<p style="text-align: center; padding: 20px;">🔍 Scanning...</p>';
     }
     
-    fetch('/api/wifi/scan')
-        .then(response => response.json())
+    fetchWiFiScan(true)
         .then(data => {
             wifiNetworks = data.networks || [];
             displayWiFiNetworks(wifiNetworks);
@@ -1095,6 +1117,23 @@ function toggleActuator(actuator, state) {
     });
 }
 
+// Apply several actuator commands in one request / one broadcast
+function setActuators(commands) {
+    return fetch('/api/actuators/batch', {
+        method: 'POST',
+        headers: {'Content-Type': 'application/json'},
+        body: JSON.stringify({commands: commands})
+    })
+    .then(response => response.json())
+    .then(data => {
+        if (!data.success) {
+            showToast(`Batch failed: ${data.error}`, 'error');
+        }
+        return data;
+    })
+    .catch(error => console.error('Error:', error));
+}
+
 function toggleRelay(relay, state) {
     toggleActuator(`relay${relay}`, state ? 1 : 0);
 }
@@ -7,6 +7,7 @@
 
 #include "ActuatorManager.h"
 #include "../utils/JSONHelper.h"
+#include "../utils/CommandHash.h"
 
 // Global instance
 ActuatorManager actuatorManager;
@@ -14,7 +15,7 @@ ActuatorManager actuatorManager;
 ActuatorManager::ActuatorManager()
     : ledController(nullptr), buzzerController(nullptr), motorController(nullptr),
       rgbController(nullptr), relayController(nullptr), servoController(nullptr),
-      initialized(false)
+      effectCount(0), scene(this), initialized(false)
 {
 }
 
@@ -38,6 +39,7 @@ bool ActuatorManager::begin()
 {
     DEBUG_PRINTLN("[ACTUATOR] Initializing Actuator Manager...");
 
+    ActuatorLock::begin();
     initializeActuators();
     loadDefaultConfiguration();
 
@@ -90,11 +92,31 @@ void ActuatorManager::initializeActuators()
     {
         DEBUG_PRINTLN("[ACTUATOR] Servo Controller initialized");
     }
+
+    registerEffect(rgbController->getEffect());
+    registerEffect(buzzerController->getEffect());
+    registerEffect(motorController->getEffect());
+    registerEffect(servoController->getEffect(1));
+    registerEffect(servoController->getEffect(2));
+    for (uint8_t relay = 1; relay <= 3; relay++)
+    {
+        registerEffect(relayController->getEffect(relay));
+    }
+    registerEffect(&scene);
+}
+
+void ActuatorManager::registerEffect(Effect *effect)
+{
+    if (effect && effectCount < MAX_EFFECTS)
+    {
+        effects[effectCount++] = effect;
+    }
 }
 
 // LED Control
 void ActuatorManager::setLED(bool state)
 {
+    ActuatorLock held;
     if (ledController)
     {
         ledController->setState(state);
@@ -103,6 +125,7 @@ void ActuatorManager::setLED(bool state)
 
 bool ActuatorManager::getLED()
 {
+    ActuatorLock held;
     if (ledController)
     {
         return ledController->getState();
@@ -113,6 +136,7 @@ bool ActuatorManager::getLED()
 // Buzzer Control
 void ActuatorManager::setBuzzer(bool state)
 {
+    ActuatorLock held;
     if (buzzerController)
     {
         buzzerController->setState(state);
@@ -121,6 +145,7 @@ void ActuatorManager::setBuzzer(bool state)
 
 void ActuatorManager::playTone(int frequency, int duration)
 {
+    ActuatorLock held;
     if (buzzerController)
     {
         buzzerController->playTone(frequency, duration);
@@ -129,6 +154,7 @@ void ActuatorManager::playTone(int frequency, int duration)
 
 void ActuatorManager::playMelody(const int *notes, const int *durations, int length)
 {
+    ActuatorLock held;
     if (buzzerController)
     {
         buzzerController->playMelody(notes, durations, length);
@@ -138,6 +164,7 @@ void ActuatorManager::playMelody(const int *notes, const int *durations, int len
 // Motor Control
 void ActuatorManager::setMotorSpeed(int speed)
 {
+    ActuatorLock held;
     if (motorController)
     {
         motorController->setSpeed(speed);
@@ -146,6 +173,7 @@ void ActuatorManager::setMotorSpeed(int speed)
 
 void ActuatorManager::setMotorDirection(bool forward)
 {
+    ActuatorLock held;
     if (motorController)
     {
         motorController->setDirection(forward);
@@ -154,6 +182,7 @@ void ActuatorManager::setMotorDirection(bool forward)
 
 void ActuatorManager::stopMotor()
 {
+    ActuatorLock held;
     if (motorController)
     {
         motorController->stop();
@@ -162,6 +191,7 @@ void ActuatorManager::stopMotor()
 
 int ActuatorManager::getSpeed()
 {
+    ActuatorLock held;
     if (motorController)
     {
         return motorController->getSpeed();
@@ -171,6 +201,7 @@ int ActuatorManager::getSpeed()
 
 bool ActuatorManager::getDirection()
 {
+    ActuatorLock held;
     if (motorController)
     {
         return motorController->getDirection();
@@ -181,6 +212,7 @@ bool ActuatorManager::getDirection()
 // RGB LED Control
 void ActuatorManager::setRGBColor(int red, int green, int blue)
 {
+    ActuatorLock held;
     if (rgbController)
     {
         rgbController->setColor(red, green, blue);
@@ -189,6 +221,7 @@ void ActuatorManager::setRGBColor(int red, int green, int blue)
 
 void ActuatorManager::setRGBColorHex(const String &hexColor)
 {
+    ActuatorLock held;
     if (rgbController)
     {
         rgbController->setColorHex(hexColor);
@@ -197,6 +230,7 @@ void ActuatorManager::setRGBColorHex(const String &hexColor)
 
 void ActuatorManager::setRGBBrightness(int brightness)
 {
+    ActuatorLock held;
     if (rgbController)
     {
         rgbController->setBrightness(brightness);
@@ -205,6 +239,7 @@ void ActuatorManager::setRGBBrightness(int brightness)
 
 void ActuatorManager::rainbowCycle(int wait)
 {
+    ActuatorLock held;
     if (rgbController)
     {
         rgbController->rainbowCycle(wait);
@@ -214,6 +249,7 @@ void ActuatorManager::rainbowCycle(int wait)
 // Relay Control
 void ActuatorManager::setRelay(int relay, bool state)
 {
+    ActuatorLock held;
     if (relayController)
     {
         relayController->setState(relay, state);
@@ -222,6 +258,7 @@ void ActuatorManager::setRelay(int relay, bool state)
 
 bool ActuatorManager::getRelay(int relay)
 {
+    ActuatorLock held;
     if (relayController)
     {
         return relayController->getState(relay);
@@ -231,6 +268,7 @@ bool ActuatorManager::getRelay(int relay)
 
 void ActuatorManager::toggleRelay(int relay)
 {
+    ActuatorLock held;
     if (relayController)
     {
         relayController->toggle(relay);
@@ -239,6 +277,7 @@ void ActuatorManager::toggleRelay(int relay)
 
 void ActuatorManager::pulseRelay(int relay, int duration)
 {
+    ActuatorLock held;
     if (relayController)
     {
         relayController->pulse(relay, duration);
@@ -248,6 +287,7 @@ void ActuatorManager::pulseRelay(int relay, int duration)
 // Servo Control
 void ActuatorManager::setServoAngle(int servo, int angle)
 {
+    ActuatorLock held;
     if (servoController)
     {
         servoController->setAngle(servo, angle);
@@ -256,6 +296,7 @@ void ActuatorManager::setServoAngle(int servo, int angle)
 
 void ActuatorManager::setServo(int servo, int angle)
 {
+    ActuatorLock held;
     if (servoController)
     {
         servoController->setAngle(servo, angle);
@@ -264,6 +305,7 @@ void ActuatorManager::setServo(int servo, int angle)
 
 int ActuatorManager::getServoAngle(int servo)
 {
+    ActuatorLock held;
     if (servoController)
     {
         return servoController->getAngle(servo);
@@ -273,6 +315,7 @@ int ActuatorManager::getServoAngle(int servo)
 
 void ActuatorManager::sweepServo(int servo, int startAngle, int endAngle, int speed)
 {
+    ActuatorLock held;
     if (servoController)
     {
         servoController->sweep(servo, startAngle, endAngle, speed);
@@ -282,13 +325,17 @@ void ActuatorManager::sweepServo(int servo, int startAngle, int endAngle, int sp
 // Scene Management
 void ActuatorManager::executeScene(const String &sceneName)
 {
+    ActuatorLock held;
     executeSceneInternal(sceneName);
 }
 
 void ActuatorManager::emergencyStop()
 {
+    ActuatorLock held;
     DEBUG_PRINTLN("[ACTUATOR] Emergency stop triggered");
 
+    cancelEffects();
+
     if (ledController)
         ledController->setState(false);
     if (buzzerController)
@@ -308,61 +355,118 @@ void ActuatorManager::emergencyStop()
 
 void ActuatorManager::triggerAlert()
 {
+    ActuatorLock held;
     DEBUG_PRINTLN("[ACTUATOR] Triggering alert");
 
-    // Flash red lights and sound buzzer
-    setRGBColor(255, 0, 0);
-    setBuzzer(true);
-    delay(1000);
-    setRGBColor(0, 0, 0);
-    setBuzzer(false);
+    // Flash red lights and sound buzzer for a second
+    scene.play(SCENE_TRIGGER_ALERT, millis());
 }
 
 void ActuatorManager::update()
 {
-    // Update any running animations or effects
+    ActuatorLock held;
+    uint32_t now = millis();
+
+    // Step effects whose next frame is due
+    for (uint8_t i = 0; i < effectCount; i++)
+    {
+        effects[i]->update(now);
+    }
+
+    // Polled startEffect() effects
     if (rgbController)
     {
         rgbController->updateEffect();
     }
 }
 
-void ActuatorManager::setActuator(const String &actuatorName, int value)
+uint32_t ActuatorManager::getSleepTime(uint32_t now, uint32_t maxSleep)
 {
-    if (actuatorName == "led" || actuatorName == "LED")
+    ActuatorLock held;
+    uint32_t sleep = maxSleep;
+    for (uint8_t i = 0; i < effectCount; i++)
     {
-        setLED(value > 0);
+        sleep = min(sleep, effects[i]->getSleepTime(now));
     }
-    else if (actuatorName == "buzzer")
+    return sleep;
+}
+
+void ActuatorManager::cancelEffects()
+{
+    ActuatorLock held;
+    for (uint8_t i = 0; i < effectCount; i++)
     {
-        setBuzzer(value > 0);
+        effects[i]->cancel();
     }
-    else if (actuatorName == "motor")
+}
+
+void ActuatorManager::setActuator(const String &actuatorName, int value)
+{
+    ActuatorLock held;
+    setActuator(lookupActuator(actuatorName.c_str()), value);
+}
+
+// Hash switch: one hash + one strcmp per lookup, collisions fail to compile
+#define ACTUATOR_NAME(name, id) \
+    case hashName(name):        \
+        return strcmp(text, name) == 0 ? id : ACTUATOR_UNKNOWN;
+
+ActuatorId ActuatorManager::lookupActuator(const char *text)
+{
+    if (!text)
+        return ACTUATOR_UNKNOWN;
+
+    switch (hashNameRuntime(text))
     {
-        setMotorSpeed(value);
+        ACTUATOR_NAME("led", ACTUATOR_LED)
+        ACTUATOR_NAME("LED", ACTUATOR_LED)
+        ACTUATOR_NAME("buzzer", ACTUATOR_BUZZER)
+        ACTUATOR_NAME("motor", ACTUATOR_MOTOR)
+        ACTUATOR_NAME("relay", ACTUATOR_RELAY1)
+        ACTUATOR_NAME("relay1", ACTUATOR_RELAY1)
+        ACTUATOR_NAME("relay2", ACTUATOR_RELAY2)
+        ACTUATOR_NAME("relay3", ACTUATOR_RELAY3)
+        ACTUATOR_NAME("servo", ACTUATOR_SERVO1)
+        ACTUATOR_NAME("servo1", ACTUATOR_SERVO1)
+        ACTUATOR_NAME("servo2", ACTUATOR_SERVO2)
+        ACTUATOR_NAME("rgb", ACTUATOR_RGB)
+    default:
+        return ACTUATOR_UNKNOWN;
     }
-    else if (actuatorName == "relay1" || actuatorName == "relay")
+}
+
+#undef ACTUATOR_NAME
+
+void ActuatorManager::setActuator(ActuatorId id, int value)
+{
+    ActuatorLock held;
+    switch (id)
     {
+    case ACTUATOR_LED:
+        setLED(value > 0);
+        break;
+    case ACTUATOR_BUZZER:
+        setBuzzer(value > 0);
+        break;
+    case ACTUATOR_MOTOR:
+        setMotorSpeed(value);
+        break;
+    case ACTUATOR_RELAY1:
         setRelay(1, value > 0);
-    }
-    else if (actuatorName == "relay2")
-    {
+        break;
+    case ACTUATOR_RELAY2:
         setRelay(2, value > 0);
-    }
-    else if (actuatorName == "relay3")
-    {
+        break;
+    case ACTUATOR_RELAY3:
         setRelay(3, value > 0);
-    }
-    else if (actuatorName == "servo1" || actuatorName == "servo")
-    {
+        break;
+    case ACTUATOR_SERVO1:
         setServoAngle(1, value);
-    }
-    else if (actuatorName == "servo2")
-    {
+        break;
+    case ACTUATOR_SERVO2:
         setServoAngle(2, value);
-    }
-    else if (actuatorName == "rgb")
-    {
+        break;
+    case ACTUATOR_RGB:
         // Simple RGB control - map value 0-255 to colors
         if (value == 0)
             setRGBColor(0, 0, 0); // Off
@@ -372,67 +476,213 @@ void ActuatorManager::setActuator(const String &actuatorName, int value)
             setRGBColor(0, 255, 0); // Green
         else
             setRGBColor(0, 0, 255); // Blue
+        break;
+    case ACTUATOR_UNKNOWN:
+    default:
+        DEBUG_PRINTLN("[ACTUATOR] Unknown actuator");
+        break;
     }
 }
 
+bool ActuatorManager::isKnownActuator(const char *name)
+{
+    return lookupActuator(name) != ACTUATOR_UNKNOWN;
+}
+
+/**
+ * @brief Check a command and that its payload fits the actuator
+ *
+ * "value" works for every actuator, "r"/"g"/"b" (all three) only for
+ * the RGB LED and "angle" only for the servos. One payload per command.
+ */
+bool ActuatorManager::validateCommand(JsonObjectConst command, const char *&error)
+{
+    if (command.isNull())
+    {
+        error = "Command must be an object";
+        return false;
+    }
+
+    const char *actuator = command["actuator"];
+    if (!actuator)
+    {
+        error = "Missing actuator";
+        return false;
+    }
+    ActuatorId id = lookupActuator(actuator);
+    if (id == ACTUATOR_UNKNOWN)
+    {
+        error = "Unknown actuator";
+        return false;
+    }
+
+    bool hasValue = command.containsKey("value");
+    bool hasAngle = command.containsKey("angle");
+    uint8_t rgbKeys = command.containsKey("r") + command.containsKey("g") + command.containsKey("b");
+
+    if (rgbKeys > 0 && id != ACTUATOR_RGB)
+    {
+        error = "r/g/b only apply to the rgb actuator";
+        return false;
+    }
+    if (rgbKeys > 0 && rgbKeys < 3)
+    {
+        error = "rgb needs all of r, g and b";
+        return false;
+    }
+    if (hasAngle && id != ACTUATOR_SERVO1 && id != ACTUATOR_SERVO2)
+    {
+        error = "angle only applies to servo1/servo2";
+        return false;
+    }
+    if (hasValue + hasAngle + (rgbKeys > 0) > 1)
+    {
+        error = "Give only one of value, angle or r/g/b";
+        return false;
+    }
+    if (!hasValue && !hasAngle && rgbKeys == 0)
+    {
+        error = "Missing value";
+        return false;
+    }
+
+    return true;
+}
+
+bool ActuatorManager::applyCommand(JsonObjectConst command)
+{
+    ActuatorLock held;
+    const char *error;
+    if (!validateCommand(command, error))
+    {
+        DEBUG_PRINTF("[ACTUATOR] Rejected command: %s\n", error);
+        return false;
+    }
+
+    ActuatorId id = lookupActuator(command["actuator"].as<const char *>());
+
+    if (command.containsKey("r"))
+    {
+        setRGBColor(command["r"].as<int>(), command["g"].as<int>(), command["b"].as<int>());
+    }
+    else if (command.containsKey("angle"))
+    {
+        setActuator(id, command["angle"].as<int>());
+    }
+    else
+    {
+        setActuator(id, command["value"].as<int>());
+    }
+    return true;
+}
+
+int ActuatorManager::applyBatch(JsonArrayConst commands, int &failedIndex, const char *&error)
+{
+    ActuatorLock held;
+    failedIndex = -1;
+
+    if (commands.isNull() || commands.size() == 0)
+    {
+        error = "No commands";
+        return -1;
+    }
+    if (commands.size() > ACTUATOR_BATCH_MAX)
+    {
+        error = "Too many commands";
+        return -1;
+    }
+
+    // Pass 1: validate everything so a bad entry leaves state untouched
+    int index = 0;
+    for (JsonVariantConst command : commands)
+    {
+        if (!validateCommand(command.as<JsonObjectConst>(), error))
+        {
+            failedIndex = index;
+            return -1;
+        }
+        index++;
+    }
+
+    // Pass 2: apply
+    for (JsonVariantConst command : commands)
+    {
+        applyCommand(command.as<JsonObjectConst>());
+    }
+
+    DEBUG_PRINTF("[ACTUATOR] Batch applied: %d commands\n", index);
+    return index;
+}
+
 // Status and Configuration
 String ActuatorManager::getStatus()
 {
-    String status = "{\"actuators\":{";
+    ActuatorLock held;
+    char buffer[384];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter json(out);
+
+    json.beginObject();
+    writeStatus(json);
+    json.endObject();
+
+    return String(buffer);
+}
+
+void ActuatorManager::writeStatus(ResponseWriter &json)
+{
+    ActuatorLock held;
+    json.beginObject("actuators");
 
     if (ledController)
     {
-        status += "\"led\":" + String(ledController->getState() ? "true" : "false") + ",";
+        json.field("led", ledController->getState());
     }
 
     if (buzzerController)
     {
-        status += "\"buzzer\":" + String(buzzerController->getState() ? "true" : "false") + ",";
+        json.field("buzzer", buzzerController->getState());
     }
 
     if (motorController)
     {
-        status += "\"motor\":{\"speed\":" + String(motorController->getSpeed()) +
-                  ",\"direction\":" + String(motorController->getDirection() ? "true" : "false") + "},";
+        json.beginObject("motor");
+        json.field("speed", motorController->getSpeed());
+        json.field("direction", motorController->getDirection());
+        json.endObject();
     }
 
     if (rgbController)
     {
-        status += "\"rgb\":{\"r\":" + String(rgbController->getRed()) +
-                  ",\"g\":" + String(rgbController->getGreen()) +
-                  ",\"b\":" + String(rgbController->getBlue()) +
-                  ",\"brightness\":" + String(rgbController->getBrightness()) + "},";
+        json.beginObject("rgb");
+        json.field("r", rgbController->getRed());
+        json.field("g", rgbController->getGreen());
+        json.field("b", rgbController->getBlue());
+        json.field("brightness", rgbController->getBrightness());
+        json.endObject();
     }
 
     if (relayController)
     {
-        status += "\"relays\":[";
+        json.beginArray("relays");
         for (int i = 1; i <= 3; i++)
         {
-            status += String(relayController->getState(i) ? "true" : "false");
-            if (i < 3)
-                status += ",";
+            json.value(relayController->getState(i));
         }
-        status += "],";
+        json.endArray();
     }
 
     if (servoController)
     {
-        status += "\"servo\":" + String(servoController->getAngle(1)) + ",";
-    }
-
-    // Remove trailing comma if present
-    if (status.endsWith(","))
-    {
-        status = status.substring(0, status.length() - 1);
+        json.field("servo", servoController->getAngle(1));
     }
 
-    status += "}}";
-    return status;
+    json.endObject();
 }
 
 bool ActuatorManager::saveConfiguration()
 {
+    ActuatorLock held;
     if (!initialized)
         return false;
 
@@ -443,6 +693,7 @@ bool ActuatorManager::saveConfiguration()
 
 bool ActuatorManager::loadConfiguration()
 {
+    ActuatorLock held;
     if (!initialized)
         return false;
 
@@ -452,6 +703,7 @@ bool ActuatorManager::loadConfiguration()
 
 void ActuatorManager::loadDefaultConfiguration()
 {
+    ActuatorLock held;
     // Set default states
     if (ledController)
         ledController->setState(false);
@@ -474,23 +726,11 @@ void ActuatorManager::executeSceneInternal(const String &sceneName)
 {
     if (sceneName == "welcome")
     {
-        // Welcome sequence
-        setLED(true);
-        setRGBColor(0, 255, 0); // Green
-        playTone(1000, 500);
-        delay(1000);
-        setLED(false);
-        setRGBColor(0, 0, 0);
+        scene.play(SCENE_WELCOME, millis());
     }
     else if (sceneName == "alert")
     {
-        // Alert sequence
-        setRGBColor(255, 0, 0); // Red
-        setBuzzer(true);
-        pulseRelay(1, 1000);
-        delay(2000);
-        setRGBColor(0, 0, 0);
-        setBuzzer(false);
+        scene.play(SCENE_ALERT, millis());
     }
     else if (sceneName == "rainbow")
     {
@@ -502,3 +742,74 @@ void ActuatorManager::executeSceneInternal(const String &sceneName)
         DEBUG_PRINTLN("[ACTUATOR] Unknown scene: " + sceneName);
     }
 }
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SCENE STATE MACHINE
+// ═══════════════════════════════════════════════════════════════════════════
+
+SceneEffect::SceneEffect(ActuatorManager *owner)
+    : manager(owner), scene(SCENE_NONE)
+{
+}
+
+void SceneEffect::play(uint8_t id, uint32_t now)
+{
+    // Let a running scene switch its own outputs off first
+    cancel();
+    scene = id;
+    start(now);
+}
+
+uint32_t SceneEffect::step(uint32_t now)
+{
+    if (phase > 0)
+    {
+        finish();
+        return EFFECT_DONE;
+    }
+
+    switch (scene)
+    {
+    case SCENE_WELCOME:
+        manager->setLED(true);
+        manager->setRGBColor(0, 255, 0); // Green
+        manager->playTone(1000, 500);
+        return 1000;
+
+    case SCENE_ALERT:
+        manager->setRGBColor(255, 0, 0); // Red
+        manager->setBuzzer(true);
+        manager->pulseRelay(1, 1000);
+        return 2000;
+
+    case SCENE_TRIGGER_ALERT:
+        manager->setRGBColor(255, 0, 0);
+        manager->setBuzzer(true);
+        return 1000;
+
+    default:
+        return EFFECT_DONE;
+    }
+}
+
+void SceneEffect::onCancel()
+{
+    finish();
+}
+
+void SceneEffect::finish()
+{
+    switch (scene)
+    {
+    case SCENE_WELCOME:
+        manager->setLED(false);
+        manager->setRGBColor(0, 0, 0);
+        break;
+
+    case SCENE_ALERT:
+    case SCENE_TRIGGER_ALERT:
+        manager->setRGBColor(0, 0, 0);
+        manager->setBuzzer(false);
+        break;
+    }
+}
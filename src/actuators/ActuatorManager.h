@@ -9,18 +9,73 @@
 #define ACTUATOR_MANAGER_H
 
 #include "../config.h"
+#include <ArduinoJson.h>
 #include "LEDController.h"
 #include "BuzzerController.h"
 #include "MotorController.h"
 #include "RGBLEDController.h"
 #include "RelayController.h"
 #include "ServoController.h"
+#include "Effect.h"
 #include "../utils/JSONHelper.h"
 #include "../utils/Logger.h"
+#include "../utils/ResponseWriter.h"
+
+// Actuator names resolved once to an id (see ActuatorManager::lookupActuator)
+enum ActuatorId
+{
+    ACTUATOR_UNKNOWN = 0,
+    ACTUATOR_LED,
+    ACTUATOR_BUZZER,
+    ACTUATOR_MOTOR,
+    ACTUATOR_RELAY1,
+    ACTUATOR_RELAY2,
+    ACTUATOR_RELAY3,
+    ACTUATOR_SERVO1,
+    ACTUATOR_SERVO2,
+    ACTUATOR_RGB
+};
+
+// Timed scenes run by SceneEffect
+enum SceneId
+{
+    SCENE_NONE = 0,
+    SCENE_WELCOME,
+    SCENE_ALERT,
+    SCENE_TRIGGER_ALERT // triggerAlert()
+};
+
+class ActuatorManager;
+
+/**
+ * @brief Switches a scene's outputs on, holds, then switches them off
+ *
+ * Cancelling (or starting another scene) switches the outputs off early.
+ */
+class SceneEffect : public Effect
+{
+private:
+    ActuatorManager *manager;
+    uint8_t scene;
+
+    void finish();
+
+protected:
+    uint32_t step(uint32_t now);
+    void onCancel();
+
+public:
+    SceneEffect(ActuatorManager *manager);
+    const char *getName() const { return "scene"; }
+
+    void play(uint8_t id, uint32_t now);
+};
 
 class ActuatorManager
 {
 private:
+    static const uint8_t MAX_EFFECTS = 10;
+
     LEDController *ledController;
     BuzzerController *buzzerController;
     MotorController *motorController;
@@ -28,6 +83,11 @@ private:
     RelayController *relayController;
     ServoController *servoController;
 
+    // Every controller's effect, stepped by update()
+    Effect *effects[MAX_EFFECTS];
+    uint8_t effectCount;
+    SceneEffect scene;
+
     bool initialized;
 
 public:
@@ -70,21 +130,38 @@ public:
     int getServoAngle(int servo);
     void sweepServo(int servo, int startAngle, int endAngle, int speed);
 
-    // Scene Management
+    // Scene Management (scenes and alerts run in the background)
     void executeScene(const String &sceneName);
     void emergencyStop();
     void triggerAlert();
     void setActuator(const String &actuatorName, int value);
+    void setActuator(ActuatorId id, int value);
+    static ActuatorId lookupActuator(const char *name);
+
+    // Command objects: {"actuator":"led","value":1} / {"actuator":"rgb","r":..,"g":..,"b":..}
+    //                  {"actuator":"servo1","angle":90}
+    bool isKnownActuator(const char *name);
+    bool validateCommand(JsonObjectConst command, const char *&error);
+    bool applyCommand(JsonObjectConst command);
+    // Validates every command first and applies none if any is invalid.
+    // Returns number of commands applied, or -1 (failedIndex/error set).
+    int applyBatch(JsonArrayConst commands, int &failedIndex, const char *&error);
 
     // Status and Configuration
     String getStatus();
+    void writeStatus(ResponseWriter &json); // Writes "actuators":{...} member
     bool saveConfiguration();
     bool loadConfiguration();
     void loadDefaultConfiguration();
+
+    // Advance running effects; call at least every getSleepTime() ms
     void update();
+    uint32_t getSleepTime(uint32_t now, uint32_t maxSleep);
+    void cancelEffects();
 
 private:
     void initializeActuators();
+    void registerEffect(Effect *effect);
     void executeSceneInternal(const String &sceneName);
 };
 
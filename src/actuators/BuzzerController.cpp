@@ -10,7 +10,7 @@
 
 BuzzerController::BuzzerController(uint8_t buzzerPin)
     : pin(buzzerPin), state(false), currentFrequency(0),
-      toneStartTime(0), toneDuration(0)
+      toneStartTime(0), toneDuration(0), toneTimer(0), sequence(this)
 {
     pinMode(pin, OUTPUT);
     digitalWrite(pin, LOW);
@@ -28,6 +28,7 @@ bool BuzzerController::begin()
 
 void BuzzerController::setState(bool newState)
 {
+    sequence.cancel();
     state = newState;
     if (state)
     {
@@ -46,6 +47,13 @@ bool BuzzerController::getState()
 }
 
 void BuzzerController::playTone(int frequency, int duration)
+{
+    // A direct tone replaces a running melody
+    sequence.cancel();
+    playNoteInternal(frequency, duration);
+}
+
+void BuzzerController::playNoteInternal(int frequency, int duration)
 {
     if (frequency <= 0)
         return;
@@ -55,10 +63,14 @@ void BuzzerController::playTone(int frequency, int duration)
     toneDuration = duration;
     state = true;
 
+    timingWheel.cancel(toneTimer);
+    toneTimer = 0;
+
     if (duration > 0)
     {
-        // Use tone() for timed tones
+        // Use tone() for timed tones; the wheel resets our state when it ends
         tone(pin, frequency, duration);
+        toneTimer = timingWheel.schedule(duration, onToneEnd, this);
     }
     else
     {
@@ -85,6 +97,17 @@ void BuzzerController::playNote(int frequency, int duration)
 
 void BuzzerController::stopTone()
 {
+    // Cancelling a sequence silences the buzzer itself
+    if (sequence.isRunning())
+        sequence.cancel();
+    else
+        endTone();
+}
+
+void BuzzerController::endTone()
+{
+    timingWheel.cancel(toneTimer);
+    toneTimer = 0;
     noTone(pin);
     analogWrite(pin, 0);
     state = false;
@@ -101,57 +124,66 @@ void BuzzerController::playMelody(const int *notes, const int *durations, int le
 
     DEBUG_PRINTLN("[BUZZER] Playing melody with " + String(length) + " notes");
 
+    // Copied, so the caller's arrays need not outlive this call
+    sequence.cancel();
+    sequence.clear();
     for (int i = 0; i < length; i++)
     {
+        bool added;
         if (notes[i] == 0)
         {
             // Rest
-            delay(durations[i]);
+            added = sequence.add(0, 0, durations[i]);
         }
         else
         {
-            playNote(notes[i], durations[i]);
-            delay(durations[i] + 50); // Small gap between notes
+            added = sequence.add(notes[i], durations[i], durations[i] + 50); // Small gap between notes
         }
+        if (!added)
+            break;
     }
+    startSequence();
 }
 
 void BuzzerController::playBeep(int frequency, int duration)
 {
     playTone(frequency, duration);
-    delay(duration + 100);
 }
 
 void BuzzerController::playErrorSound()
 {
     // Three short beeps
+    sequence.cancel();
+    sequence.clear();
     for (int i = 0; i < 3; i++)
     {
-        playBeep(500, 100);
-        delay(100);
+        sequence.add(500, 100, 300);
     }
+    startSequence();
 }
 
 void BuzzerController::playSuccessSound()
 {
     // Ascending tone
-    playBeep(800, 100);
-    delay(50);
-    playBeep(1000, 100);
-    delay(50);
-    playBeep(1200, 200);
+    sequence.cancel();
+    sequence.clear();
+    sequence.add(800, 100, 250);
+    sequence.add(1000, 100, 250);
+    sequence.add(1200, 200, 300);
+    startSequence();
 }
 
 void BuzzerController::playAlertSound()
 {
     // Siren-like sound
+    sequence.cancel();
+    sequence.clear();
     for (int i = 0; i < 5; i++)
     {
-        playTone(800, 200);
-        delay(50);
-        playTone(1200, 200);
-        delay(50);
+        sequence.add(800, 200, 50);
+        sequence.add(1200, 200, 50);
     }
+    startSequence();
 }
 
 void BuzzerController::setVolume(int dutyCycle)
@@ -189,68 +221,66 @@ void BuzzerController::playPattern(const char *pattern)
 
     // Simple pattern parser
     // B = beep, S = short pause, L = long pause
-    for (int i = 0; pattern[i] != '\0'; i++)
+    sequence.cancel();
+    sequence.clear();
+    bool added = true;
+    for (int i = 0; pattern[i] != '\0' && added; i++)
     {
         switch (pattern[i])
         {
         case 'B':
         case 'b':
-            playBeep();
+            added = sequence.add(1000, 500, 600); // playBeep() plus its gap
             break;
         case 'S':
         case 's':
-            delay(200);
+            added = sequence.add(0, 0, 200);
             break;
         case 'L':
         case 'l':
-            delay(500);
+            added = sequence.add(0, 0, 500);
             break;
         case ' ':
-            delay(100);
+            added = sequence.add(0, 0, 100);
             break;
         }
     }
+    startSequence();
 }
 
 void BuzzerController::beepSequence(int count, int interval)
 {
     DEBUG_PRINTLN("[BUZZER] Beeping sequence: " + String(count) + " times");
 
+    sequence.cancel();
+    sequence.clear();
     for (int i = 0; i < count; i++)
     {
-        playBeep();
-        if (i < count - 1)
-        {
-            delay(interval);
-        }
+        if (!sequence.add(1000, 500, 600 + (i < count - 1 ? interval : 0)))
+            break;
     }
+    startSequence();
 }
 
 void BuzzerController::sirenSound(int duration)
 {
-    unsigned long startTime = millis();
-    int direction = 1;
-    int frequency = 500;
+    if (duration <= 0)
+        return;
 
     DEBUG_PRINTLN("[BUZZER] Siren sound for " + String(duration) + "ms");
 
-    while (millis() - startTime < duration)
-    {
-        playTone(frequency, 50);
-        delay(50);
-
-        frequency += direction * 50;
-        if (frequency >= 1500)
-            direction = -1;
-        if (frequency <= 500)
-            direction = 1;
-    }
-
-    stopTone();
+    sequence.cancel();
+    sequence.clear();
+    sequence.sirenDuration = duration;
+    sequence.sirenFrequency = 500;
+    sequence.sirenDirection = 1;
+    startSequence();
 }
 
 bool BuzzerController::isPlaying()
 {
+    if (sequence.isRunning())
+        return true;
     if (toneDuration == 0)
         return state;
 
@@ -264,13 +294,17 @@ unsigned long BuzzerController::getPlayTime()
     return millis() - toneStartTime;
 }
 
-void BuzzerController::update()
+void BuzzerController::onToneEnd(void *context)
 {
-    // Check if timed tone has expired
-    if (toneDuration > 0 && (millis() - toneStartTime) >= toneDuration)
-    {
-        stopTone();
-    }
+    ActuatorLock held;
+    BuzzerController *buzzer = static_cast<BuzzerController *>(context);
+    buzzer->toneTimer = 0;
+    buzzer->endTone();
+}
+
+void BuzzerController::startSequence()
+{
+    sequence.start(millis());
 }
 
 void BuzzerController::setPWMFrequency(int frequency)
@@ -284,13 +318,73 @@ void BuzzerController::setPWMFrequency(int frequency)
     ledcAttachPin(pin, 0);
 }
 
-void BuzzerController::playNoteInternal(int frequency, int duration)
-{
-    playTone(frequency, duration);
-}
-
 void BuzzerController::parsePattern(const char *pattern)
 {
     // Pattern parsing is handled in playPattern()
     // This method is kept for future expansion
 }
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SEQUENCE STATE MACHINE
+// ═══════════════════════════════════════════════════════════════════════════
+
+BuzzerSequence::BuzzerSequence(BuzzerController *controller)
+    : buzzer(controller), length(0), sirenDuration(0), sirenFrequency(500), sirenDirection(1)
+{
+}
+
+void BuzzerSequence::clear()
+{
+    length = 0;
+    sirenDuration = 0;
+}
+
+bool BuzzerSequence::add(int frequency, int duration, int hold)
+{
+    if (length >= EFFECT_MAX_STEPS)
+    {
+        DEBUG_PRINTF("[BUZZER] Sequence truncated at %d steps\n", EFFECT_MAX_STEPS);
+        return false;
+    }
+
+    steps[length].frequency = constrain(frequency, 0, 65535);
+    steps[length].duration = constrain(duration, 0, 65535);
+    steps[length].hold = constrain(hold, 0, 65535);
+    length++;
+    return true;
+}
+
+uint32_t BuzzerSequence::step(uint32_t now)
+{
+    if (sirenDuration > 0)
+    {
+        if (now - startedAt >= sirenDuration)
+        {
+            buzzer->endTone();
+            return EFFECT_DONE;
+        }
+
+        buzzer->playNoteInternal(sirenFrequency, 50);
+        sirenFrequency += sirenDirection * 50;
+        if (sirenFrequency >= 1500)
+            sirenDirection = -1;
+        if (sirenFrequency <= 500)
+            sirenDirection = 1;
+        return 50;
+    }
+
+    if (phase >= length)
+        return EFFECT_DONE;
+
+    const Step &note = steps[phase];
+    if (note.frequency > 0)
+    {
+        buzzer->playNoteInternal(note.frequency, note.duration);
+    }
+    return note.hold;
+}
+
+void BuzzerSequence::onCancel()
+{
+    buzzer->endTone();
+}
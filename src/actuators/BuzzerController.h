@@ -10,15 +10,57 @@
 
 #include "../config.h"
 #include <Arduino.h>
+#include "../utils/TimingWheel.h"
+#include "Effect.h"
+
+class BuzzerController;
+
+/**
+ * @brief Plays a list of notes, or a siren sweep, one note per step
+ */
+class BuzzerSequence : public Effect
+{
+private:
+    friend class BuzzerController;
+
+    struct Step
+    {
+        uint16_t frequency; // 0 = rest
+        uint16_t duration;  // Tone length (ms)
+        uint16_t hold;      // Time until the next step (ms)
+    };
+
+    BuzzerController *buzzer;
+    Step steps[EFFECT_MAX_STEPS];
+    uint8_t length;
+    uint32_t sirenDuration; // Non-zero: sweep for this long instead of steps
+    int sirenFrequency;
+    int sirenDirection;
+
+    void clear();
+    bool add(int frequency, int duration, int hold);
+
+protected:
+    uint32_t step(uint32_t now);
+    void onCancel();
+
+public:
+    BuzzerSequence(BuzzerController *controller);
+    const char *getName() const { return "buzzer"; }
+};
 
 class BuzzerController
 {
+    friend class BuzzerSequence;
+
 private:
     uint8_t pin;
     bool state;
     int currentFrequency;
     unsigned long toneStartTime;
     unsigned long toneDuration;
+    TimerId toneTimer;       // Ends a timed tone
+    BuzzerSequence sequence; // Melodies, patterns and the siren
 
     // Melody definitions
     struct Note
@@ -39,7 +81,7 @@ public:
     void playNote(int frequency, int duration);
     void stopTone();
 
-    // Melody control
+    // Melody control (non-blocking; advanced through getEffect())
     void playMelody(const int *notes, const int *durations, int length);
     void playBeep(int frequency = 1000, int duration = 500);
     void playErrorSound();
@@ -54,13 +96,16 @@ public:
     void playPattern(const char *pattern);
     void beepSequence(int count, int interval = 200);
     void sirenSound(int duration = 2000);
+    Effect *getEffect() { return &sequence; }
 
     // Status and timing
     bool isPlaying();
     unsigned long getPlayTime();
-    void update();
 
 private:
+    static void onToneEnd(void *context);
+    void endTone();
+    void startSequence();
     void setPWMFrequency(int frequency);
     void playNoteInternal(int frequency, int duration);
     void parsePattern(const char *pattern);
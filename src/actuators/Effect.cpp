@@ -0,0 +1,91 @@
+/**
+ * @file Effect.cpp
+ * @brief Effect state machine driver and the actuator lock
+ */
+
+#include "Effect.h"
+
+Effect::Effect()
+    : running(false), nextStep(0), startedAt(0), phase(0)
+{
+}
+
+void Effect::start(uint32_t now)
+{
+    cancel();
+
+    startedAt = now;
+    phase = 0;
+    nextStep = now;
+    running = true;
+
+    update(now);
+}
+
+bool Effect::update(uint32_t now)
+{
+    if (!running || (int32_t)(now - nextStep) < 0)
+        return running;
+
+    uint32_t wait = step(now);
+    phase++;
+
+    // step() may have cancelled us (e.g. a motor effect calling stop())
+    if (!running)
+        return false;
+
+    if (wait == EFFECT_DONE)
+    {
+        running = false;
+        return false;
+    }
+
+    // Keep to the planned grid, but do not replay frames we slept through
+    nextStep += wait;
+    if ((int32_t)(now - nextStep) >= 0)
+        nextStep = now + wait;
+    return true;
+}
+
+void Effect::cancel()
+{
+    if (!running)
+        return;
+
+    running = false;
+    onCancel();
+}
+
+uint32_t Effect::getSleepTime(uint32_t now) const
+{
+    if (!running)
+        return EFFECT_DONE;
+
+    int32_t wait = (int32_t)(nextStep - now);
+    return wait > 0 ? (uint32_t)wait : 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ACTUATOR LOCK
+// ═══════════════════════════════════════════════════════════════════════════
+
+static SemaphoreHandle_t actuatorMutex = nullptr;
+
+void ActuatorLock::begin()
+{
+    if (actuatorMutex == nullptr)
+        actuatorMutex = xSemaphoreCreateRecursiveMutex();
+}
+
+ActuatorLock::ActuatorLock()
+    : held(actuatorMutex != nullptr)
+{
+    if (held)
+        xSemaphoreTakeRecursive(actuatorMutex, portMAX_DELAY);
+}
+
+ActuatorLock::~ActuatorLock()
+{
+    if (held)
+        xSemaphoreGiveRecursive(actuatorMutex);
+}
@@ -0,0 +1,79 @@
+/**
+ * @file Effect.h
+ * @brief Common interface for non-blocking actuator effects
+ *
+ * Melodies, colour animations, motor ramps, servo sweeps, relay pulses
+ * and scenes used to be loops around delay(), which stalled loop() (or
+ * the AsyncTCP task, when called from a web handler) for up to several
+ * seconds. Each of them is now an Effect: a small state machine whose
+ * step() does one frame of work and says how long until the next one.
+ *
+ *   start(now)   reset and run the first step right away
+ *   update(now)  run step() once its time has come (ActuatorManager::update)
+ *   cancel()     stop early; onCancel() puts the outputs in a safe state
+ *
+ * Starting an effect that is already running restarts it. Effects take
+ * the time as a parameter, so they can be driven by a virtual clock.
+ *
+ * Commands arrive on the AsyncTCP and WiFi tasks while effects and their
+ * timing-wheel frames run on the loop task, so every entry point into
+ * actuator state holds an ActuatorLock for its scope.
+ */
+
+#ifndef EFFECT_H
+#define EFFECT_H
+
+#include <Arduino.h>
+
+#define EFFECT_DONE 0xFFFFFFFFUL // step() return value: effect finished
+
+class Effect
+{
+private:
+    bool running;
+    uint32_t nextStep; // millis() of the next step
+
+protected:
+    uint32_t startedAt; // millis() when start() was called
+    uint32_t phase;     // Index of the current step (0 on the first)
+
+    // One frame of work; returns ms until the next step, or EFFECT_DONE
+    virtual uint32_t step(uint32_t now) = 0;
+    virtual void onCancel() {}
+
+public:
+    Effect();
+    virtual ~Effect() {}
+
+    virtual const char *getName() const = 0;
+
+    void start(uint32_t now);
+    // Returns true while the effect is still running
+    bool update(uint32_t now);
+    void cancel();
+
+    bool isRunning() const { return running; }
+    // Milliseconds until update() has work (0 if overdue)
+    uint32_t getSleepTime(uint32_t now) const;
+};
+
+/**
+ * @brief Holds the actuator mutex for its scope
+ *
+ * One recursive mutex for all actuator and effect state, so a command
+ * can call into other locked methods. No-op until begin() has created
+ * it (ActuatorManager::begin, before any other task is started).
+ */
+class ActuatorLock
+{
+private:
+    bool held;
+
+public:
+    ActuatorLock();
+    ~ActuatorLock();
+
+    static void begin();
+};
+
+#endif // EFFECT_H
@@ -11,7 +11,7 @@
 MotorController::MotorController(uint8_t in1, uint8_t in2, uint8_t enable)
     : in1Pin(in1), in2Pin(in2), enablePin(enable), initialized(false),
       isRunning(false), isForward(true), currentSpeed(0), maxSpeed(255),
-      minSpeed(50), acceleration(10), lastSpeedChange(0)
+      minSpeed(50), acceleration(10), lastSpeedChange(0), ramp(this)
 {
     pinMode(in1Pin, OUTPUT);
     pinMode(in2Pin, OUTPUT);
@@ -50,6 +50,8 @@ void MotorController::setSpeed(int speed)
     if (!initialized)
         return;
 
+    ramp.cancel();
+
     speed = constrainSpeed(speed);
     currentSpeed = speed;
 
@@ -103,6 +105,8 @@ void MotorController::stop()
     if (!initialized)
         return;
 
+    ramp.cancel();
+
     applySpeed(0);
     isRunning = false;
     currentSpeed = 0;
@@ -115,6 +119,8 @@ void MotorController::brake()
     if (!initialized)
         return;
 
+    ramp.cancel();
+
     // Hard brake by setting both inputs high
     digitalWrite(in1Pin, HIGH);
     digitalWrite(in2Pin, HIGH);
@@ -131,39 +137,8 @@ void MotorController::accelerateTo(int targetSpeed, int accelerationRate)
     if (!initialized)
         return;
 
-    targetSpeed = constrainSpeed(targetSpeed);
     acceleration = accelerationRate;
-
-    if (targetSpeed > currentSpeed)
-    {
-        // Accelerating
-        while (currentSpeed < targetSpeed && isRunning)
-        {
-            currentSpeed += acceleration;
-            if (currentSpeed > targetSpeed)
-                currentSpeed = targetSpeed;
-
-            applySpeed(currentSpeed);
-            delay(10); // Small delay for smooth acceleration
-            update();
-        }
-    }
-    else if (targetSpeed < currentSpeed)
-    {
-        // Decelerating
-        while (currentSpeed > targetSpeed && isRunning)
-        {
-            currentSpeed -= acceleration;
-            if (currentSpeed < targetSpeed)
-                currentSpeed = targetSpeed;
-
-            applySpeed(currentSpeed);
-            delay(10); // Small delay for smooth deceleration
-            update();
-        }
-    }
-
-    DEBUG_PRINTLN("[MOTOR] Accelerated to: " + String(currentSpeed));
+    startRamp(MOTOR_RAMP_RATE, targetSpeed, max(1, accelerationRate), 0, false);
 }
 
 void MotorController::decelerateTo(int targetSpeed, int decelerationRate)
@@ -202,28 +177,11 @@ void MotorController::rampUp(int targetSpeed, int rampTime)
 
     if (targetSpeed == -1)
         targetSpeed = maxSpeed;
-    targetSpeed = constrainSpeed(targetSpeed);
 
-    int startSpeed = currentSpeed;
-    unsigned long startTime = millis();
-    unsigned long duration = rampTime;
-
-    DEBUG_PRINTLN("[MOTOR] Ramping up from " + String(startSpeed) + " to " + String(targetSpeed) +
+    DEBUG_PRINTLN("[MOTOR] Ramping from " + String(currentSpeed) + " to " + String(constrainSpeed(targetSpeed)) +
                   " over " + String(rampTime) + "ms");
 
-    while (millis() - startTime < duration && isRunning)
-    {
-        unsigned long elapsed = millis() - startTime;
-        float progress = (float)elapsed / duration;
-
-        currentSpeed = startSpeed + (targetSpeed - startSpeed) * progress;
-        applySpeed(currentSpeed);
-
-        delay(10);
-    }
-
-    currentSpeed = targetSpeed;
-    applySpeed(currentSpeed);
+    startRamp(MOTOR_RAMP_TIMED, targetSpeed, 0, max(0, rampTime), false);
 }
 
 void MotorController::rampDown(int rampTime)
@@ -233,8 +191,10 @@ void MotorController::rampDown(int rampTime)
 
 void MotorController::smoothStop(int rampTime)
 {
-    rampDown(rampTime);
-    stop();
+    if (!initialized)
+        return;
+
+    startRamp(MOTOR_RAMP_TIMED, 0, 0, max(0, rampTime), true);
 }
 
 bool MotorController::isRunningState()
@@ -292,23 +252,12 @@ void MotorController::update()
 
 void MotorController::calibrate()
 {
+    if (!initialized)
+        return;
+
     // Motor calibration routine
     DEBUG_PRINTLN("[MOTOR] Starting motor calibration...");
-
-    // Test forward direction
-    setDirection(true);
-    setSpeed(minSpeed);
-    delay(1000);
-
-    // Test reverse direction
-    setDirection(false);
-    setSpeed(minSpeed);
-    delay(1000);
-
-    // Stop motor
-    stop();
-
-    DEBUG_PRINTLN("[MOTOR] Motor calibration complete");
+    startRamp(MOTOR_CALIBRATE, minSpeed, 0, 0, false);
 }
 
 String MotorController::getMotorStatus()
@@ -362,6 +311,17 @@ void MotorController::setMotorPins(bool in1State, bool in2State)
     digitalWrite(in2Pin, in2State ? HIGH : LOW);
 }
 
+void MotorController::startRamp(uint8_t mode, int targetSpeed, int rate, uint32_t duration, bool stopAtEnd)
+{
+    ramp.mode = mode;
+    ramp.startSpeed = currentSpeed;
+    ramp.targetSpeed = constrainSpeed(targetSpeed);
+    ramp.rate = rate;
+    ramp.duration = duration;
+    ramp.stopAtEnd = stopAtEnd;
+    ramp.start(millis());
+}
+
 // Compatibility methods for ActuatorManager
 int MotorController::getSpeed()
 {
@@ -372,3 +332,69 @@ bool MotorController::getDirection()
 {
     return isMovingForward();
 }
+
+// ═══════════════════════════════════════════════════════════════════════════
+// RAMP STATE MACHINE
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define MOTOR_RATE_STEP_MS 10 // accelerateTo() rate is per this many ms
+
+MotorRamp::MotorRamp(MotorController *controller)
+    : motor(controller), mode(MOTOR_RAMP_RATE), startSpeed(0), targetSpeed(0),
+      rate(1), duration(0), stopAtEnd(false)
+{
+}
+
+uint32_t MotorRamp::step(uint32_t now)
+{
+    int &speed = motor->currentSpeed;
+
+    switch (mode)
+    {
+    case MOTOR_RAMP_RATE:
+        if (speed == targetSpeed)
+        {
+            DEBUG_PRINTLN("[MOTOR] Accelerated to: " + String(speed));
+            return EFFECT_DONE;
+        }
+        if (speed < targetSpeed)
+            speed = min(speed + rate, targetSpeed);
+        else
+            speed = max(speed - rate, targetSpeed);
+        motor->applySpeed(speed);
+        return MOTOR_RATE_STEP_MS;
+
+    case MOTOR_RAMP_TIMED:
+    {
+        uint32_t elapsed = now - startedAt;
+        if (elapsed >= duration)
+        {
+            speed = targetSpeed;
+            motor->applySpeed(speed);
+            if (stopAtEnd)
+                motor->stop();
+            return EFFECT_DONE;
+        }
+
+        float progress = (float)elapsed / duration;
+        speed = startSpeed + (targetSpeed - startSpeed) * progress;
+        motor->applySpeed(speed);
+        return EFFECT_FRAME_MS;
+    }
+
+    case MOTOR_CALIBRATE:
+        // 1 s forward, 1 s reverse at minimum speed, then stop
+        if (phase < 2)
+        {
+            motor->isForward = (phase == 0);
+            speed = targetSpeed;
+            motor->applySpeed(speed);
+            return 1000;
+        }
+        motor->stop();
+        DEBUG_PRINTLN("[MOTOR] Motor calibration complete");
+        return EFFECT_DONE;
+    }
+
+    return EFFECT_DONE;
+}
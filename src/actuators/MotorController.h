@@ -10,9 +10,45 @@
 
 #include "../config.h"
 #include <Arduino.h>
+#include "Effect.h"
+
+class MotorController;
+
+enum MotorRampMode
+{
+    MOTOR_RAMP_RATE,  // accelerateTo(): fixed change per step
+    MOTOR_RAMP_TIMED, // rampUp()/rampDown(): reach target after a duration
+    MOTOR_CALIBRATE   // calibrate(): forward, reverse, stop
+};
+
+/**
+ * @brief Speed ramps and the calibration run, one speed update per step
+ */
+class MotorRamp : public Effect
+{
+private:
+    friend class MotorController;
+
+    MotorController *motor;
+    uint8_t mode;
+    int startSpeed;
+    int targetSpeed;
+    int rate;          // Rate mode: speed change per step
+    uint32_t duration; // Timed mode: ms from startSpeed to targetSpeed
+    bool stopAtEnd;    // Timed mode: stop() once there (smoothStop)
+
+protected:
+    uint32_t step(uint32_t now);
+
+public:
+    MotorRamp(MotorController *controller);
+    const char *getName() const { return "motor"; }
+};
 
 class MotorController
 {
+    friend class MotorRamp;
+
 private:
     uint8_t in1Pin;
     uint8_t in2Pin;
@@ -29,6 +65,8 @@ private:
     int acceleration;
     unsigned long lastSpeedChange;
 
+    MotorRamp ramp; // Running ramp or calibration; setSpeed()/stop() cancel it
+
 public:
     MotorController(uint8_t in1, uint8_t in2, uint8_t enable);
 
@@ -47,7 +85,7 @@ public:
     void setMaxSpeed(int maxSpeed);
     void setMinSpeed(int minSpeed);
 
-    // Speed control with ramping
+    // Speed control with ramping (non-blocking; advanced through getEffect())
     void rampUp(int targetSpeed = -1, int rampTime = 1000);
     void rampDown(int rampTime = 1000);
     void smoothStop(int rampTime = 1000);
@@ -72,12 +110,14 @@ public:
     void update();
     void calibrate();
     String getMotorStatus();
+    Effect *getEffect() { return &ramp; }
 
 private:
     void applySpeed(int speed);
     void updateSpeedWithRamping();
     int constrainSpeed(int speed);
     void setMotorPins(bool in1State, bool in2State);
+    void startRamp(uint8_t mode, int targetSpeed, int rate, uint32_t duration, bool stopAtEnd);
 };
 
 #endif // MOTOR_CONTROLLER_H
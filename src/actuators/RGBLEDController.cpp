@@ -13,8 +13,8 @@ RGBLEDController::RGBLEDController(uint8_t rPin, uint8_t gPin, uint8_t bPin)
     : redPin(rPin), greenPin(gPin), bluePin(bPin), initialized(false), state(false),
       redValue(0), greenValue(0), blueValue(0), brightness(255), transitioning(false),
       transitionStart(0), transitionDuration(0), targetRed(0), targetGreen(0), targetBlue(0),
-      effectType(EFFECT_NONE), effectTimer(0), effectSpeed(100), effectIntensity(255),
-      hue(0), saturation(100), value(100)
+      transitionTimer(0), effectType(EFFECT_NONE), effectTimer(0), effectSpeed(100), effectIntensity(255),
+      hue(0), saturation(100), value(100), animation(this)
 {
     pinMode(redPin, OUTPUT);
     pinMode(greenPin, OUTPUT);
@@ -49,6 +49,13 @@ bool RGBLEDController::begin()
 }
 
 void RGBLEDController::setColor(int red, int green, int blue)
+{
+    // An explicit colour replaces whatever animation is running
+    animation.cancel();
+    showColor(red, green, blue);
+}
+
+void RGBLEDController::showColor(int red, int green, int blue)
 {
     if (!initialized)
         return;
@@ -92,6 +99,12 @@ void RGBLEDController::setColorHex(const String &hexColor)
 }
 
 void RGBLEDController::setColorHSV(int h, int s, int v)
+{
+    animation.cancel();
+    showColorHSV(h, s, v);
+}
+
+void RGBLEDController::showColorHSV(int h, int s, int v)
 {
     if (!initialized)
         return;
@@ -137,6 +150,12 @@ void RGBLEDController::setState(bool newState)
     }
     else
     {
+        // Switching off also abandons a running transition or animation
+        animation.cancel();
+        transitioning = false;
+        timingWheel.cancel(transitionTimer);
+        transitionTimer = 0;
+
         setPinValue(redPin, 0);
         setPinValue(greenPin, 0);
         setPinValue(bluePin, 0);
@@ -164,6 +183,10 @@ void RGBLEDController::transitionToColor(int red, int green, int blue, unsigned
     transitionStart = millis();
     transitionDuration = duration;
 
+    // Frames are driven by the timing wheel; restart if one is running
+    timingWheel.cancel(transitionTimer);
+    transitionTimer = timingWheel.schedule(RGB_TRANSITION_STEP_MS, onTransitionStep, this);
+
     DEBUG_PRINTLN("[RGB] Starting transition to RGB(" + String(targetRed) + ", " + String(targetGreen) + ", " + String(targetBlue) + ") over " + String(duration) + "ms");
 }
 
@@ -218,6 +241,7 @@ void RGBLEDController::updateTransition()
 
 void RGBLEDController::startEffect(int effectType, int speed, int intensity)
 {
+    animation.cancel();
     this->effectType = effectType;
     this->effectSpeed = speed;
     this->effectIntensity = intensity;
@@ -228,6 +252,7 @@ void RGBLEDController::startEffect(int effectType, int speed, int intensity)
 
 void RGBLEDController::stopEffect()
 {
+    animation.cancel();
     effectType = EFFECT_NONE;
     setColor(0, 0, 0);
 
@@ -283,79 +308,52 @@ void RGBLEDController::updateEffect()
 
 void RGBLEDController::rainbowCycle(int wait)
 {
-    for (int j = 0; j < 256; j++)
-    {
-        setColorHSV(j, 255, effectIntensity);
-        delay(wait);
-    }
+    startAnimation(RGB_ANIM_RAINBOW, 0, 0, 0, wait, 0, 256);
 }
 
 void RGBLEDController::colorWipe(int red, int green, int blue, int wait)
 {
-    setColor(red, green, blue);
-    delay(wait);
-    setColor(0, 0, 0);
-    delay(wait);
+    startAnimation(RGB_ANIM_BLINK, red, green, blue, wait, 0, 1);
 }
 
 void RGBLEDController::theaterChase(int red, int green, int blue, int wait)
 {
-    for (int j = 0; j < 10; j++)
-    {
-        for (int q = 0; q < 3; q++)
-        {
-            setColor(red, green, blue);
-            delay(wait);
-            setColor(0, 0, 0);
-            delay(wait);
-        }
-    }
+    startAnimation(RGB_ANIM_BLINK, red, green, blue, wait, 0, 30);
 }
 
 void RGBLEDController::theaterChaseRainbow(int wait)
 {
-    for (int j = 0; j < 256; j += 10)
-    {
-        theaterChase(((j >> 3) & 31) * 8, ((j >> 8) & 31) * 8, ((j >> 16) & 31) * 8, wait);
-    }
+    // 26 colours (j = 0, 10 .. 250), 30 blinks each
+    startAnimation(RGB_ANIM_THEATER_RAINBOW, 0, 0, 0, wait, 0, 26 * 30);
 }
 
 void RGBLEDController::twinkle(int red, int green, int blue, int count, int speed)
 {
-    for (int i = 0; i < count; i++)
-    {
-        setColor(red, green, blue);
-        delay(random(50, speed));
-        setColor(0, 0, 0);
-        delay(random(50, speed));
-    }
+    startAnimation(RGB_ANIM_TWINKLE, red, green, blue, 0, speed, count);
 }
 
 void RGBLEDController::twinkleRandom(int count, int speed)
 {
-    for (int i = 0; i < count; i++)
-    {
-        int r = random(255);
-        int g = random(255);
-        int b = random(255);
-        twinkle(r, g, b, 1, speed);
-    }
+    startAnimation(RGB_ANIM_TWINKLE_RANDOM, 0, 0, 0, 0, speed, count);
 }
 
 void RGBLEDController::sparkles(int red, int green, int blue, int count)
 {
-    for (int i = 0; i < count; i++)
-    {
-        setColor(red, green, blue);
-        delay(random(10, 100));
-        setColor(0, 0, 0);
-        delay(random(10, 100));
-    }
+    startAnimation(RGB_ANIM_SPARKLES, red, green, blue, 0, 0, count);
 }
 
 void RGBLEDController::fire(int cooling, int sparking, int speedDelay)
 {
-    // Fire effect implementation
+    animation.cooling = cooling;
+    animation.sparking = sparking;
+    startAnimation(RGB_ANIM_FIRE, 0, 0, 0, speedDelay, 0, 0);
+}
+
+/**
+ * @brief One frame of the fire simulation (3 heat cells, top one shown)
+ */
+void RGBLEDController::fireFrame(int cooling, int sparking)
+{
     static byte heat[3];
 
     // Step 1.  Cool down every cell a little
@@ -381,37 +379,22 @@ void RGBLEDController::fire(int cooling, int sparking, int speedDelay)
     byte colorindex = heat[2];
     if (colorindex < 64)
     {
-        setColor(colorindex * 4, 0, 0); // Red
+        showColor(colorindex * 4, 0, 0); // Red
     }
     else if (colorindex < 128)
     {
-        setColor(255, (colorindex - 64) * 4, 0); // Orange/Yellow
+        showColor(255, (colorindex - 64) * 4, 0); // Orange/Yellow
     }
     else
     {
-        setColor(255, 255, (colorindex - 128) * 4); // White/Yellow
+        showColor(255, 255, (colorindex - 128) * 4); // White/Yellow
     }
-
-    delay(speedDelay);
 }
 
 void RGBLEDController::lightning(int red, int green, int blue, int strikes, int strikeDelay, int flashDelay)
 {
-    for (int i = 0; i < strikes; i++)
-    {
-        // Random delay between strikes
-        delay(random(strikeDelay / 2, strikeDelay));
-
-        // Flash sequence
-        int flashes = random(2, 5);
-        for (int j = 0; j < flashes; j++)
-        {
-            setColor(red, green, blue);
-            delay(random(flashDelay / 2, flashDelay));
-            setColor(0, 0, 0);
-            delay(random(flashDelay / 2, flashDelay));
-        }
-    }
+    animation.flashes = 0;
+    startAnimation(RGB_ANIM_LIGHTNING, red, green, blue, flashDelay, strikeDelay, strikes);
 }
 
 void RGBLEDController::fadeToBlack(int fadeRate)
@@ -425,47 +408,40 @@ void RGBLEDController::fadeToBlack(int fadeRate)
 
 void RGBLEDController::pulse(int red, int green, int blue, int duration)
 {
-    unsigned long startTime = millis();
-    int startRed = redValue;
-    int startGreen = greenValue;
-    int startBlue = blueValue;
-
-    while (millis() - startTime < duration)
-    {
-        unsigned long elapsed = millis() - startTime;
-        float progress = (float)elapsed / duration;
-
-        // Sinusoidal pulse
-        float pulse = (sin(progress * PI * 2) + 1) / 2;
-
-        int currentRed = startRed + (red - startRed) * pulse;
-        int currentGreen = startGreen + (green - startGreen) * pulse;
-        int currentBlue = startBlue + (blue - startBlue) * pulse;
-
-        setColor(currentRed, currentGreen, currentBlue);
-        delay(20);
-    }
+    animation.fromRed = redValue;
+    animation.fromGreen = greenValue;
+    animation.fromBlue = blueValue;
+    startAnimation(RGB_ANIM_PULSE, red, green, blue, EFFECT_FRAME_MS, duration, 0);
 }
 
 void RGBLEDController::breathe(int red, int green, int blue, int cycleTime)
 {
-    unsigned long startTime = millis();
+    startAnimation(RGB_ANIM_BREATHE, red, green, blue, EFFECT_FRAME_MS, cycleTime, 0);
+}
 
-    while (millis() - startTime < cycleTime)
-    {
-        unsigned long elapsed = millis() - startTime;
-        float progress = (float)elapsed / cycleTime;
+void RGBLEDController::stopAnimation()
+{
+    animation.cancel();
+}
 
-        // Smooth breathing effect
-        float breath = (sin(progress * PI * 2 - PI / 2) + 1) / 2;
+void RGBLEDController::startAnimation(uint8_t mode, int red, int green, int blue, int wait, int span, int count)
+{
+    if (!initialized)
+        return;
 
-        int currentRed = red * breath;
-        int currentGreen = green * breath;
-        int currentBlue = blue * breath;
+    // Animations and the polled startEffect() effects share the LED
+    effectType = EFFECT_NONE;
 
-        setColor(currentRed, currentGreen, currentBlue);
-        delay(20);
-    }
+    animation.mode = mode;
+    animation.red = red;
+    animation.green = green;
+    animation.blue = blue;
+    animation.wait = wait;
+    animation.span = span;
+    animation.count = count;
+    animation.start(millis());
+
+    DEBUG_PRINTLN("[RGB] Starting animation " + String(mode));
 }
 
 String RGBLEDController::getColorStatus()
@@ -646,7 +622,20 @@ void RGBLEDController::hsvToRgb(int h, int s, int v, int &r, int &g, int &b)
     b = constrain(b, 0, 255);
 }
 
-int RGBLEDController::easeInOutQuad(float t)
+void RGBLEDController::onTransitionStep(void *context)
+{
+    ActuatorLock held;
+    RGBLEDController *rgb = static_cast<RGBLEDController *>(context);
+    rgb->transitionTimer = 0;
+    rgb->updateTransition();
+
+    if (rgb->transitioning)
+    {
+        rgb->transitionTimer = timingWheel.schedule(RGB_TRANSITION_STEP_MS, onTransitionStep, rgb);
+    }
+}
+
+float RGBLEDController::easeInOutQuad(float t)
 {
     return t < 0.5 ? 2 * t * t : -1 + (4 - 2 * t) * t;
 }
@@ -658,7 +647,7 @@ void RGBLEDController::updateFireEffect()
 
     if (millis() - fireTimer > 50)
     {
-        fire(55, 120, 15);
+        fireFrame(55, 120);
         fireTimer = millis();
     }
 }
@@ -668,3 +657,125 @@ void RGBLEDController::updateLightningEffect()
     // Lightning effect is handled in the main lightning() function
     // This is a placeholder for continuous lightning effects
 }
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ANIMATION STATE MACHINE
+// ═══════════════════════════════════════════════════════════════════════════
+
+RGBAnimation::RGBAnimation(RGBLEDController *controller)
+    : rgb(controller), mode(RGB_ANIM_RAINBOW), red(0), green(0), blue(0),
+      fromRed(0), fromGreen(0), fromBlue(0), wait(0), span(0), count(0),
+      cooling(55), sparking(120), flashes(0)
+{
+}
+
+uint32_t RGBAnimation::step(uint32_t now)
+{
+    uint32_t elapsed = now - startedAt;
+
+    switch (mode)
+    {
+    case RGB_ANIM_RAINBOW:
+        if (phase >= (uint32_t)count)
+            return EFFECT_DONE;
+        rgb->showColorHSV(phase, 255, rgb->effectIntensity);
+        return wait;
+
+    case RGB_ANIM_LIGHTNING:
+        return stepLightning();
+
+    case RGB_ANIM_PULSE:
+    {
+        if (elapsed >= (uint32_t)span)
+            return EFFECT_DONE;
+
+        // Sinusoidal pulse
+        float progress = (float)elapsed / span;
+        float pulse = (sin(progress * PI * 2) + 1) / 2;
+        rgb->showColor(fromRed + (red - fromRed) * pulse,
+                       fromGreen + (green - fromGreen) * pulse,
+                       fromBlue + (blue - fromBlue) * pulse);
+        return wait;
+    }
+
+    case RGB_ANIM_BREATHE:
+    {
+        if (elapsed >= (uint32_t)span)
+            return EFFECT_DONE;
+
+        // Smooth breathing effect
+        float progress = (float)elapsed / span;
+        float breath = (sin(progress * PI * 2 - PI / 2) + 1) / 2;
+        rgb->showColor(red * breath, green * breath, blue * breath);
+        return wait;
+    }
+
+    case RGB_ANIM_FIRE:
+        rgb->fireFrame(cooling, sparking);
+        return wait;
+
+    default:
+        return stepBlink();
+    }
+}
+
+/**
+ * @brief Even steps switch the colour on, odd steps switch it off
+ */
+uint32_t RGBAnimation::stepBlink()
+{
+    if (phase >= 2 * (uint32_t)count)
+        return EFFECT_DONE;
+
+    bool on = (phase % 2) == 0;
+    if (!on)
+    {
+        rgb->showColor(0, 0, 0);
+    }
+    else if (mode == RGB_ANIM_THEATER_RAINBOW)
+    {
+        int j = (phase / 2 / 30) * 10;
+        rgb->showColor(((j >> 3) & 31) * 8, ((j >> 8) & 31) * 8, ((j >> 16) & 31) * 8);
+    }
+    else if (mode == RGB_ANIM_TWINKLE_RANDOM)
+    {
+        rgb->showColor(random(255), random(255), random(255));
+    }
+    else
+    {
+        rgb->showColor(red, green, blue);
+    }
+
+    switch (mode)
+    {
+    case RGB_ANIM_TWINKLE:
+    case RGB_ANIM_TWINKLE_RANDOM:
+        return random(50, span);
+    case RGB_ANIM_SPARKLES:
+        return random(10, 100);
+    default:
+        return wait;
+    }
+}
+
+/**
+ * @brief Pause before each strike, then 2-4 random-length flashes
+ */
+uint32_t RGBAnimation::stepLightning()
+{
+    if (flashes == 0)
+    {
+        if (count <= 0)
+            return EFFECT_DONE;
+        count--;
+        flashes = 2 * random(2, 5);
+        return random(span / 2, span);
+    }
+
+    if (flashes % 2 == 0)
+        rgb->showColor(red, green, blue);
+    else
+        rgb->showColor(0, 0, 0);
+    flashes--;
+    return random(wait / 2, wait);
+}
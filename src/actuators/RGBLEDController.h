@@ -10,9 +10,60 @@
 
 #include "../config.h"
 #include <Arduino.h>
+#include "../utils/TimingWheel.h"
+#include "Effect.h"
+
+class RGBLEDController;
+
+// Preset animations run by RGBAnimation
+enum RGBAnimationMode
+{
+    RGB_ANIM_RAINBOW,
+    RGB_ANIM_BLINK,           // colorWipe, theaterChase
+    RGB_ANIM_THEATER_RAINBOW, // theaterChase through a colour ramp
+    RGB_ANIM_TWINKLE,
+    RGB_ANIM_TWINKLE_RANDOM,
+    RGB_ANIM_SPARKLES,
+    RGB_ANIM_LIGHTNING,
+    RGB_ANIM_PULSE,
+    RGB_ANIM_BREATHE,
+    RGB_ANIM_FIRE // Runs until cancelled
+};
+
+/**
+ * @brief One preset animation at a time, one colour per step
+ */
+class RGBAnimation : public Effect
+{
+private:
+    friend class RGBLEDController;
+
+    RGBLEDController *rgb;
+    uint8_t mode;
+    int red, green, blue;             // Animation colour
+    int fromRed, fromGreen, fromBlue; // Pulse: colour at start
+    int wait;                         // Frame / flash / blink time (ms)
+    int span;                         // Pulse/breathe duration, twinkle speed, strike delay
+    int count;                        // Rainbow steps, blink cycles or strikes left
+    int cooling;                      // Fire parameters
+    int sparking;
+    int flashes;                      // Lightning: on/off steps left in this strike
+
+    uint32_t stepBlink();
+    uint32_t stepLightning();
+
+protected:
+    uint32_t step(uint32_t now);
+
+public:
+    RGBAnimation(RGBLEDController *controller);
+    const char *getName() const { return "rgb"; }
+};
 
 class RGBLEDController
 {
+    friend class RGBAnimation;
+
 private:
     uint8_t redPin;
     uint8_t greenPin;
@@ -34,6 +85,7 @@ private:
     int targetRed;
     int targetGreen;
     int targetBlue;
+    TimerId transitionTimer; // Next transition frame
 
     // Animation effects
     int effectType;
@@ -46,6 +98,8 @@ private:
     int saturation;
     int value;
 
+    RGBAnimation animation; // Preset effects (rainbowCycle() .. breathe())
+
 public:
     RGBLEDController(uint8_t rPin, uint8_t gPin, uint8_t bPin);
 
@@ -74,7 +128,7 @@ public:
     void stopEffect();
     void updateEffect();
 
-    // Preset effects
+    // Preset effects (non-blocking; advanced through getEffect())
     void rainbowCycle(int wait = 20);
     void colorWipe(int red, int green, int blue, int wait = 50);
     void theaterChase(int red, int green, int blue, int wait = 50);
@@ -89,6 +143,8 @@ public:
     void fadeToBlack(int fadeRate = 10);
     void pulse(int red, int green, int blue, int duration = 1000);
     void breathe(int red, int green, int blue, int cycleTime = 2000);
+    void stopAnimation();
+    Effect *getEffect() { return &animation; }
 
     // Status and information
     String getColorStatus();
@@ -104,11 +160,16 @@ public:
     void setEffectIntensity(int intensity);
 
 private:
+    void showColor(int red, int green, int blue);
+    void showColorHSV(int hue, int saturation, int value);
+    void startAnimation(uint8_t mode, int red, int green, int blue, int wait, int span, int count);
+    void fireFrame(int cooling, int sparking);
     void applyColor();
     void setPinValue(uint8_t pin, int value);
     void rgbToHsv(int r, int g, int b, int &h, int &s, int &v);
     void hsvToRgb(int h, int s, int v, int &r, int &g, int &b);
-    int easeInOutQuad(float t);
+    float easeInOutQuad(float t);
+    static void onTransitionStep(void *context);
     void updateFireEffect();
     void updateLightningEffect();
 };
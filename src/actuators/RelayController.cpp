@@ -6,6 +6,7 @@
 #include "RelayController.h"
 
 RelayController::RelayController(bool activeL)
+    : pulses{RelayPulse(this, 1), RelayPulse(this, 2), RelayPulse(this, 3)}
 {
     activeLow = activeL;
     relay1State = false;
@@ -30,6 +31,14 @@ bool RelayController::begin()
 }
 
 void RelayController::setState(uint8_t relay, bool state)
+{
+    Effect *effect = getEffect(relay);
+    if (effect)
+        effect->cancel();
+    writeState(relay, state);
+}
+
+void RelayController::writeState(uint8_t relay, bool state)
 {
     uint8_t pin;
     bool *statePtr;
@@ -99,7 +108,41 @@ void RelayController::allOff()
 
 void RelayController::pulse(uint8_t relay, uint32_t durationMs)
 {
-    setState(relay, true);
-    delay(durationMs);
-    setState(relay, false);
-}
\ No newline at end of file
+    if (relay < 1 || relay > 3)
+        return;
+
+    RelayPulse &effect = pulses[relay - 1];
+    effect.cancel();
+    effect.duration = durationMs;
+    effect.start(millis());
+}
+
+Effect *RelayController::getEffect(uint8_t relay)
+{
+    if (relay < 1 || relay > 3)
+        return nullptr;
+    return &pulses[relay - 1];
+}
+
+RelayPulse::RelayPulse(RelayController *owner, uint8_t number)
+    : controller(owner), relay(number), duration(0)
+{
+}
+
+const char *RelayPulse::getName() const
+{
+    static const char *const names[] = {"relay1", "relay2", "relay3"};
+    return names[relay - 1];
+}
+
+uint32_t RelayPulse::step(uint32_t now)
+{
+    if (phase == 0)
+    {
+        controller->writeState(relay, true);
+        return duration;
+    }
+
+    controller->writeState(relay, false);
+    return EFFECT_DONE;
+}
@@ -6,25 +6,57 @@
 #ifndef RELAY_CONTROLLER_H
 #define RELAY_CONTROLLER_H
 #include "../config.h"
+#include "Effect.h"
+
+class RelayController;
+
+/**
+ * @brief Switches one relay on, then off after the pulse length
+ *
+ * Cancelling leaves the relay as it is.
+ */
+class RelayPulse : public Effect
+{
+private:
+    friend class RelayController;
+
+    RelayController *controller;
+    uint8_t relay;
+    uint32_t duration;
+
+protected:
+    uint32_t step(uint32_t now);
+
+public:
+    RelayPulse(RelayController *controller, uint8_t relay);
+    const char *getName() const;
+};
 
 class RelayController
 {
+    friend class RelayPulse;
+
 private:
     bool relay1State;
     bool relay2State;
     bool relay3State;
     bool activeLow; // Most relay modules are active low
+    RelayPulse pulses[3];
+
+    void writeState(uint8_t relay, bool state);
 
 public:
     RelayController(bool activeLow = true);
 
     bool begin();
-    void setState(uint8_t relay, bool state);
+    void setState(uint8_t relay, bool state); // Also ends a pulse
     bool getState(uint8_t relay);
     void toggle(uint8_t relay);
     void allOn();
     void allOff();
+    // Non-blocking; advanced through getEffect()
     void pulse(uint8_t relay, uint32_t durationMs);
+    Effect *getEffect(uint8_t relay);
 };
 
 #endif
@@ -6,6 +6,7 @@
 #include "ServoController.h"
 
 ServoController::ServoController()
+    : sweep1(this, 1), sweep2(this, 2)
 {
     servo1Attached = false;
     servo2Attached = false;
@@ -40,6 +41,14 @@ bool ServoController::begin()
 }
 
 void ServoController::setAngle(uint8_t servoNum, int angle)
+{
+    ServoSweep *sweep = getSweep(servoNum);
+    if (sweep)
+        sweep->cancel();
+    writeAngle(servoNum, angle);
+}
+
+void ServoController::writeAngle(uint8_t servoNum, int angle)
 {
     // Constrain angle to valid range
     angle = constrain(angle, 0, 180);
@@ -66,19 +75,24 @@ void ServoController::setAngle(uint8_t servoNum, int angle)
 
 void ServoController::sweep(uint8_t servoNum, int minAngle, int maxAngle, int delayMs)
 {
-    // Sweep from min to max
-    for (int angle = minAngle; angle <= maxAngle; angle++)
-    {
-        setAngle(servoNum, angle);
-        delay(delayMs);
-    }
+    ServoSweep *sweep = getSweep(servoNum);
+    if (!sweep)
+        return;
+
+    sweep->cancel();
+    sweep->minAngle = minAngle;
+    sweep->maxAngle = maxAngle;
+    sweep->delayMs = max(0, delayMs);
+    sweep->start(millis());
+}
 
-    // Sweep back from max to min
-    for (int angle = maxAngle; angle >= minAngle; angle--)
-    {
-        setAngle(servoNum, angle);
-        delay(delayMs);
-    }
+ServoSweep *ServoController::getSweep(uint8_t servoNum)
+{
+    if (servoNum == 1)
+        return &sweep1;
+    if (servoNum == 2)
+        return &sweep2;
+    return nullptr;
 }
 
 int ServoController::getAngle(uint8_t servoNum)
@@ -98,4 +112,21 @@ void ServoController::detach(uint8_t servoNum)
         servo2.detach();
         servo2Attached = false;
     }
-}
\ No newline at end of file
+}
+
+ServoSweep::ServoSweep(ServoController *owner, uint8_t num)
+    : controller(owner), servoNum(num), minAngle(0), maxAngle(180), delayMs(15)
+{
+}
+
+uint32_t ServoSweep::step(uint32_t now)
+{
+    // Steps 0..span-1 go up, span..2*span-1 come back down
+    int span = maxAngle - minAngle + 1;
+    if (span <= 0 || phase >= 2 * (uint32_t)span)
+        return EFFECT_DONE;
+
+    int angle = (int)phase < span ? minAngle + (int)phase : maxAngle - ((int)phase - span);
+    controller->writeAngle(servoNum, angle);
+    return delayMs;
+}
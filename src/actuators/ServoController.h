@@ -8,9 +8,36 @@
 
 #include "../config.h"
 #include <ESP32Servo.h>
+#include "Effect.h"
+
+class ServoController;
+
+/**
+ * @brief Sweeps one servo min -> max -> min, one degree per step
+ */
+class ServoSweep : public Effect
+{
+private:
+    friend class ServoController;
+
+    ServoController *controller;
+    uint8_t servoNum;
+    int minAngle;
+    int maxAngle;
+    int delayMs;
+
+protected:
+    uint32_t step(uint32_t now);
+
+public:
+    ServoSweep(ServoController *controller, uint8_t servoNum);
+    const char *getName() const { return servoNum == 1 ? "servo1" : "servo2"; }
+};
 
 class ServoController
 {
+    friend class ServoSweep;
+
 private:
     Servo servo1;
     Servo servo2;
@@ -18,13 +45,20 @@ private:
     bool servo2Attached;
     int currentAngle1;
     int currentAngle2;
+    ServoSweep sweep1;
+    ServoSweep sweep2;
+
+    ServoSweep *getSweep(uint8_t servoNum);
+    void writeAngle(uint8_t servoNum, int angle);
 
 public:
     ServoController();
 
     bool begin();
-    void setAngle(uint8_t servoNum, int angle);
+    void setAngle(uint8_t servoNum, int angle); // Also stops a sweep
+    // Non-blocking; advanced through getEffect()
     void sweep(uint8_t servoNum, int minAngle, int maxAngle, int delayMs);
+    Effect *getEffect(uint8_t servoNum) { return getSweep(servoNum); }
     int getAngle(uint8_t servoNum);
     void detach(uint8_t servoNum);
 };
@@ -483,26 +483,54 @@ bool ImageProcessor::batchConvertFormat(const char *inputDir, const char *output
 
 String ImageProcessor::getMotionStatus()
 {
-    String status = "{\"motion\":{";
-    status += "\"detected\":" + String(lastMotion.motionDetected ? "true" : "false") + ",";
-    status += "\"pixels\":" + String(lastMotion.motionPixels) + ",";
-    status += "\"total\":" + String(lastMotion.totalPixels) + ",";
-    status += "\"percentage\":" + String(lastMotion.motionPercentage, 2) + ",";
-    status += "\"timestamp\":" + String(lastMotion.timestamp);
-    status += "}}";
-    return status;
+    char buffer[160];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter json(out);
+
+    json.beginObject();
+    writeMotionStatus(json);
+    json.endObject();
+    return String(buffer);
 }
 
 String ImageProcessor::getFaceStatus()
 {
-    String status = "{\"faces\":{";
-    status += "\"detected\":" + String(lastFace.faceDetected ? "true" : "false") + ",";
-    status += "\"count\":" + String(lastFace.faceCount) + ",";
-    status += "\"center\":{\"x\":" + String(lastFace.centerX) + ",\"y\":" + String(lastFace.centerY) + "},";
-    status += "\"size\":{\"width\":" + String(lastFace.width) + ",\"height\":" + String(lastFace.height) + "},";
-    status += "\"timestamp\":" + String(lastFace.timestamp);
-    status += "}}";
-    return status;
+    char buffer[192];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter json(out);
+
+    json.beginObject();
+    writeFaceStatus(json);
+    json.endObject();
+    return String(buffer);
+}
+
+void ImageProcessor::writeMotionStatus(ResponseWriter &json)
+{
+    json.beginObject("motion");
+    json.field("detected", lastMotion.motionDetected);
+    json.field("pixels", lastMotion.motionPixels);
+    json.field("total", lastMotion.totalPixels);
+    json.field("percentage", lastMotion.motionPercentage, 2);
+    json.field("timestamp", lastMotion.timestamp);
+    json.endObject();
+}
+
+void ImageProcessor::writeFaceStatus(ResponseWriter &json)
+{
+    json.beginObject("faces");
+    json.field("detected", lastFace.faceDetected);
+    json.field("count", lastFace.faceCount);
+    json.beginObject("center");
+    json.field("x", lastFace.centerX);
+    json.field("y", lastFace.centerY);
+    json.endObject();
+    json.beginObject("size");
+    json.field("width", lastFace.width);
+    json.field("height", lastFace.height);
+    json.endObject();
+    json.field("timestamp", lastFace.timestamp);
+    json.endObject();
 }
 
 bool ImageProcessor::hasMotion()
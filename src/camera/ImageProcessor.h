@@ -16,6 +16,7 @@
 #include <esp_camera.h>
 #include <FS.h>
 #include <SPIFFS.h>
+#include "../utils/ResponseWriter.h"
 
 class ImageProcessor
 {
@@ -90,6 +91,8 @@ public:
     // Status and results
     String getMotionStatus();
     String getFaceStatus();
+    void writeMotionStatus(ResponseWriter &json); // Writes "motion":{...} member
+    void writeFaceStatus(ResponseWriter &json);   // Writes "faces":{...} member
     bool hasMotion();
     bool hasFaces();
     void clearResults();
@@ -122,6 +122,17 @@
 #define WIFI_TIMEOUT 20000
 #define WIFI_RETRY_DELAY 500
 
+/**
+ * WiFi network scan (non-blocking, see WiFiManager::requestScan)
+ *
+ * WIFI_SCAN_TTL: Scan results are reused for this long (milliseconds)
+ * WIFI_SCAN_TIMEOUT: Give up on a scan that never completes (milliseconds)
+ * WIFI_SCAN_MAX_RESULTS: Networks kept per scan (strongest first)
+ */
+#define WIFI_SCAN_TTL 30000
+#define WIFI_SCAN_TIMEOUT 15000
+#define WIFI_SCAN_MAX_RESULTS 16
+
 // ═══════════════════════════════════════════════════════════════════════════
 // WEB SERVER CONFIGURATION
 // ═══════════════════════════════════════════════════════════════════════════
@@ -140,6 +151,64 @@
 #define WEBSOCKET_PORT 81
 #define MAX_CLIENTS 4
 
+/**
+ * Static asset cache (see core/StaticFileCache.h)
+ *
+ * STATIC_CACHE_BUDGET: Total bytes of file bodies kept in RAM
+ * STATIC_CACHE_MAX_ENTRIES: Number of files kept at once (LRU eviction)
+ * STATIC_CACHE_MAX_FILE: Larger files are streamed from SPIFFS instead
+ * STATIC_CACHE_MIN_FREE_HEAP: Never cache into heap below this free level
+ *
+ * NOTE: With PSRAM the bodies live in PSRAM and the budget can be large.
+ *       Without it they share the regular heap, so keep the budget small.
+ */
+#ifdef BOARD_HAS_PSRAM
+#define STATIC_CACHE_BUDGET (512 * 1024)
+#else
+#define STATIC_CACHE_BUDGET (48 * 1024)
+#endif
+#define STATIC_CACHE_MAX_ENTRIES 12
+#define STATIC_CACHE_MAX_FILE (STATIC_CACHE_BUDGET / 2)
+#define STATIC_CACHE_MIN_FREE_HEAP (40 * 1024)
+#define STATIC_CACHE_PATH_LEN 48
+
+/**
+ * Server-Sent Events stream at /api/stream (see core/EventStream.h)
+ *
+ * EVENT_STREAM_RING_SIZE: Recent events kept for Last-Event-ID resume
+ * EVENT_STREAM_SLOT_SIZE: Largest event kept in the ring; sized for the
+ *                         sensor message. Bigger ones (wifiNetworks) are
+ *                         still sent live, just not replayable
+ * EVENT_STREAM_RETRY: Reconnect delay suggested to clients (milliseconds)
+ *
+ * RAM used by the ring: RING_SIZE x SLOT_SIZE (8 KB by default)
+ */
+#define EVENT_STREAM_RING_SIZE 8
+#define EVENT_STREAM_SLOT_SIZE SENSOR_SNAPSHOT_SIZE
+#define EVENT_STREAM_RETRY 3000
+
+/**
+ * Metrics registry and /metrics endpoint (see utils/Metrics.h)
+ *
+ * METRICS_PREFIX: Prepended to every metric name
+ * METRICS_MAX: Metrics that can be registered
+ * METRICS_MAX_BUCKETS: Bucket bounds per histogram (+Inf is implicit)
+ * METRICS_LINE_SIZE: Longest rendered exposition line
+ */
+#define METRICS_PREFIX "esp32_"
+#define METRICS_MAX 40
+#define METRICS_MAX_BUCKETS 12
+#define METRICS_LINE_SIZE 160
+
+/**
+ * Web handler profiling (see core/RouteProfiler.h, served at /api/perf)
+ *
+ * PERF_MAX_ROUTES: Routes that get a latency histogram (~230 bytes each)
+ * PERF_SLOW_HANDLER_US: Handlers slower than this are logged (microseconds)
+ */
+#define PERF_MAX_ROUTES 40
+#define PERF_SLOW_HANDLER_US 20000
+
 // ═══════════════════════════════════════════════════════════════════════════
 // OTA (OVER-THE-AIR UPDATE) CONFIGURATION
 // ═══════════════════════════════════════════════════════════════════════════
@@ -173,6 +242,7 @@
  * MAX_ESPNOW_PEERS: Maximum number of peer devices (ESP32 limit: 20)
  * ESPNOW_RETRY_COUNT: Number of retries for failed transmissions
  * ESPNOW_ACK_TIMEOUT: Timeout for acknowledgment (milliseconds)
+ * ESPNOW_PEER_TIMEOUT: Silence after which a peer is marked inactive
  *
  * CHANNEL SELECTION:
  * - Must be same for all communicating devices
@@ -188,6 +258,7 @@
 #define MAX_ESPNOW_PEERS 5
 #define ESPNOW_RETRY_COUNT 3
 #define ESPNOW_ACK_TIMEOUT 200
+#define ESPNOW_PEER_TIMEOUT 60000
 
 /**
  * Default peer device MAC address
@@ -296,6 +367,7 @@ extern uint8_t peerMAC[]; // Broadcast
  */
 #define I2C_SDA 21
 #define I2C_SCL 22
+// #define MPU_INT_PIN 39 // Optional MPU6050 INT (data ready), input-only pin
 
 // ───────────────────────────────────────────────────────────────────────
 // ACTUATOR PINS - ESP32 DEVKIT
@@ -535,10 +607,9 @@ extern uint8_t peerMAC[]; // Broadcast
  * ULTRASONIC_MAX_DISTANCE: Maximum distance for HC-SR04 (cm)
  *   - 400cm is sensor maximum
  *   - Set lower to filter spurious readings
- *
- * LDR_SAMPLES: Number of samples to average for LDR
- *   - More samples = smoother readings
- *   - More samples = slower response
+ * ULTRASONIC_MIN_DISTANCE: Shorter echoes are rejected (cm)
+ * ULTRASONIC_MEDIAN: Pings in the median filter (odd, up to 9)
+ * ULTRASONIC_TIMEOUT_US: Ping timeout; covers MAX_DISTANCE and back
  *
  * TEMP/HUMIDITY_OFFSET: Calibration offsets
  *   - Compare with reference thermometer
@@ -547,10 +618,130 @@ extern uint8_t peerMAC[]; // Broadcast
  */
 #define SENSOR_READ_INTERVAL 2000   // 2 seconds
 #define ULTRASONIC_MAX_DISTANCE 400 // 400 cm
-#define LDR_SAMPLES 10              // Average 10 readings
+#define ULTRASONIC_MIN_DISTANCE 2   // 2 cm
+#define ULTRASONIC_MEDIAN 5         // 5 pings
+#define ULTRASONIC_TIMEOUT_US 30000 // 30 ms
 #define TEMP_OFFSET 0.0             // Temperature calibration
 #define HUMIDITY_OFFSET 0.0         // Humidity calibration
 
+/**
+ * Per-sensor polling (see sensors/SensorManager.h)
+ *
+ * Each sensor is read at its own rate by the "sampling" task; the
+ * SENSOR_READ_INTERVAL cycle only publishes the latest values.
+ *
+ * *_POLL_INTERVAL: Time between reads of that sensor (ms)
+ *   - DHT22 gives a new reading at most every 2 s
+ *   - PIR is read on its interrupt; the interval only catches motion end
+ * PIR_HOLD_TIME: Output low this long (ms) before motion counts as ended
+ * PIR_EDGE_QUEUE: PIR edges buffered between the ISR and the sampler
+ * SENSOR_MAX_SENSORS: Sensors the registry can hold
+ * SENSOR_MAX_FAILURES: Failed reads in a row before a sensor is reported
+ *   unhealthy, left out of sensor data and retried every SENSOR_RETRY_INTERVAL
+ */
+#define DHT_POLL_INTERVAL 2000
+#define BMP_POLL_INTERVAL 1000
+#define MPU_POLL_INTERVAL 10
+#define ANALOG_POLL_INTERVAL 1000 // LDR, soil moisture, MQ135
+#define ULTRASONIC_POLL_INTERVAL 50 // 20 pings/s; the echo is interrupt-driven
+#define PIR_POLL_INTERVAL 500
+#define PIR_HOLD_TIME 2000
+#define PIR_EDGE_QUEUE 16
+#define SENSOR_MAX_SENSORS 10
+#define SENSOR_MAX_FAILURES 3
+#define SENSOR_RETRY_INTERVAL 10000
+
+/**
+ * Adaptive sampling (see sensors/AdaptivePolicy.h)
+ *
+ * Stable sensors are polled less often, and the SENSOR_READ_INTERVAL
+ * cycle only logs/broadcasts/sends when a watched field has changed.
+ * All of these can be changed at run time through POST /api/config
+ * ("adaptive" object), which also saves them for the next boot.
+ *
+ * ADAPTIVE_SAMPLING: false = fixed periods, publish every cycle
+ * ADAPTIVE_DEADBANDS: {field, threshold} pairs; a field is watched when
+ *   listed here, and a move of at least `threshold` (field units) since
+ *   the last significant reading is a change
+ * ADAPTIVE_STABLE_POLLS: Unchanged readings before the period doubles
+ * ADAPTIVE_MAX_SLOWDOWN: Longest period as a multiple of *_POLL_INTERVAL
+ *   (power of two); sensors that must keep their rate (MPU6050, PIR)
+ *   are never slowed
+ * ADAPTIVE_HEARTBEAT: Publish at least this often even without changes
+ *   (ms), so consumers can tell a quiet sensor from a dead device
+ */
+#define ADAPTIVE_SAMPLING true
+#define ADAPTIVE_DEADBANDS                                  \
+    {"temperature", 0.2f}, {"humidity", 1.0f},              \
+    {"pressure", 0.5f}, {"airQuality", 5.0f},               \
+    {"lightLevel", 40.0f}, {"soilMoisture", 40.0f},         \
+    {"distance", 3.0f}, {"motion", 0.5f},                   \
+    {"pitch", 2.0f}, {"roll", 2.0f}, {"vibrationRms", 0.02f}
+#define ADAPTIVE_STABLE_POLLS 3
+#define ADAPTIVE_MAX_SLOWDOWN 8
+#define ADAPTIVE_HEARTBEAT 60000
+
+/**
+ * Analog sampling (see sensors/AdcSampler.h)
+ *
+ * LDR, soil moisture and MQ135 read a filtered value kept up to date by
+ * the "adc" task. Each reading is the mean of the last 16 decimated
+ * outputs (AdcDemux ADC_HISTORY).
+ *
+ * ADC_USE_DMA: Sample ADC1 in continuous mode; false = analogRead() polling
+ * ADC_DMA_SAMPLE_RATE: Conversions per second over all channels (ESP32
+ *   minimum 20000)
+ * ADC_DMA_DECIMATION: Conversions per channel averaged into one output
+ *   (3 channels: 20000 / 3 / 256 = 26 outputs/s, 0.6 s of history)
+ * ADC_DMA_FRAME_BYTES: Results per task wake-up (2 bytes each)
+ * ADC_DMA_TIMEOUT_MS: Longest wait for a frame
+ * ADC_POLL_INTERVAL: Polled mode, time between reads of all pins (ms)
+ * ADC_POLL_DECIMATION: Polled mode, reads averaged into one output
+ * ADC_TASK_*: Sampling task; DMA mode wakes it ~40 times a second
+ */
+#define ADC_USE_DMA true
+#define ADC_DMA_SAMPLE_RATE 20000
+#define ADC_DMA_DECIMATION 256
+#define ADC_DMA_FRAME_BYTES 1024
+#define ADC_DMA_TIMEOUT_MS 100
+#define ADC_POLL_INTERVAL 10
+#define ADC_POLL_DECIMATION 8
+#define ADC_TASK_CORE 1
+#define ADC_TASK_PRIORITY 2
+#define ADC_TASK_STACK 3072
+
+/**
+ * MPU6050 acquisition (see sensors/MPU6050Sensor.h)
+ *
+ * MPU_USE_FIFO: Let the chip sample into its FIFO at MPU_SAMPLE_RATE and
+ *   drain it in bursts; false = one read per MPU_POLL_INTERVAL
+ * MPU_SAMPLE_RATE: FIFO sample rate, 4-1000 Hz
+ * MPU_FIFO_BATCH: Samples per drain (the FIFO holds 85)
+ * MPU_FUSION_BETA: Madgwick filter gain; higher trusts the accelerometer
+ *   more (faster tilt correction, more vibration noise)
+ * MPU_INT_PIN (board section, optional): MPU6050 INT. When defined the
+ *   drain is triggered every MPU_FIFO_BATCH samples by the data-ready
+ *   interrupt instead of by a timer
+ */
+#define MPU_USE_FIFO true
+#define MPU_SAMPLE_RATE 200
+#define MPU_FIFO_BATCH 10
+#define MPU_FUSION_BETA 0.1f
+
+/**
+ * Vibration analysis (ENABLE_VIBRATION, see sensors/VibrationAnalyzer.h)
+ *
+ * A 256-point FFT over the MPU6050 FIFO stream, reduced to RMS, peak,
+ * crest factor, peak frequency and band energies.
+ *
+ * VIBRATION_INTERVAL: Time between feature frames (ms); frames overlap
+ *   when it is shorter than the 1.28 s frame at 200 Hz
+ * VIBRATION_BAND_EDGES: Band edges in Hz, ascending, at most 7 (6 bands);
+ *   keep the last edge at or below MPU_SAMPLE_RATE / 2
+ */
+#define VIBRATION_INTERVAL 1000
+#define VIBRATION_BAND_EDGES 2, 10, 25, 50, 100
+
 // ═══════════════════════════════════════════════════════════════════════════
 // DATA LOGGING CONFIGURATION
 // ═══════════════════════════════════════════════════════════════════════════
@@ -592,7 +783,71 @@ extern uint8_t peerMAC[]; // Broadcast
 #define WATCHDOG_TIMEOUT 30000      // Watchdog reset timeout
 #define HEARTBEAT_INTERVAL 1000     // LED blink rate
 #define STATUS_UPDATE_INTERVAL 5000 // Status broadcast interval
+#define STATUS_SNAPSHOT_INTERVAL 1000 // /api/status snapshot rebuild rate
+#define STATUS_SLOW_REFRESH 30000     // SPIFFS usage refresh in snapshot
 #define SERIAL_BAUD 115200          // Serial Monitor baud rate
+#define NETWORK_POLL_INTERVAL 20    // OTA / WiFi manager / web server polling
+#define ACTUATOR_UPDATE_INTERVAL 20 // Actuator transitions (fades, tones)
+#define HEALTH_CHECK_INTERVAL 10000 // checkSystemHealth() period
+#define LOGGING_INTERVAL 60000      // Periodic log checkpoint
+#define SERIAL_POLL_INTERVAL 250    // Serial Monitor commands (typed, not latency-bound)
+
+/**
+ * Cooperative scheduler (see utils/Scheduler.h)
+ *
+ * SCHEDULER_MAX_TASKS: Tasks that can be registered
+ * SCHEDULER_MAX_SLEEP: Longest the loop sleeps with nothing due (ms);
+ *                      events and notify() wake it earlier
+ */
+#define SCHEDULER_MAX_TASKS 16
+#define SCHEDULER_MAX_SLEEP 100
+
+/**
+ * Timing wheel (see utils/TimingWheel.h)
+ *
+ * TIMING_WHEEL_TICK_MS: Timer resolution; a timer fires up to one tick late
+ * TIMING_WHEEL_MAX_TIMERS: Pending one-shot timers (fixed node pool, 20
+ *                          bytes each: 5 KB). Today's users hold about ten;
+ *                          the rest is room for per-peer retransmits and
+ *                          per-client timeouts. Lower it on tight builds.
+ * RGB_TRANSITION_STEP_MS: Frame interval of RGB colour transitions
+ */
+#define TIMING_WHEEL_TICK_MS 10
+#define TIMING_WHEEL_MAX_TIMERS 256
+#define RGB_TRANSITION_STEP_MS 20
+
+/**
+ * Actuator effects (see actuators/Effect.h)
+ *
+ * EFFECT_MAX_STEPS: Notes in a buzzer melody / pattern (longer ones are cut)
+ * EFFECT_FRAME_MS: Frame interval of time-based effects (pulse, breathe, ramps)
+ */
+#define EFFECT_MAX_STEPS 64
+#define EFFECT_FRAME_MS 20
+
+/**
+ * FreeRTOS task split (ENABLE_TASK_SPLIT, see core/TaskRunner.h)
+ *
+ * Core 0 runs the WiFi stack; core 1 runs loop() and AsyncTCP.
+ * loop() runs at priority 1; higher numbers preempt lower ones.
+ *
+ * TASK_SENSOR_*:  Sampling, kept above loop() so it stays on time
+ * TASK_PUBLISH_*: WebSocket / SSE / ESP-NOW sends
+ * TASK_STORAGE_*: SPIFFS writes, lowest so flash stalls only delay logging
+ * TASK_QUEUE_DEPTH: Snapshots buffered per consumer (power of two)
+ * SENSOR_SNAPSHOT_SIZE: Serialized sensor JSON per snapshot
+ */
+#define TASK_SENSOR_CORE 1
+#define TASK_SENSOR_PRIORITY 3
+#define TASK_SENSOR_STACK 6144
+#define TASK_PUBLISH_CORE 0
+#define TASK_PUBLISH_PRIORITY 2
+#define TASK_PUBLISH_STACK 4096
+#define TASK_STORAGE_CORE 0
+#define TASK_STORAGE_PRIORITY 1
+#define TASK_STORAGE_STACK 4096
+#define TASK_QUEUE_DEPTH 4
+#define SENSOR_SNAPSHOT_SIZE 1024
 
 // ═══════════════════════════════════════════════════════════════════════════
 // BUFFER SIZES
@@ -607,10 +862,18 @@ extern uint8_t peerMAC[]; // Broadcast
  * JSON_BUFFER_SIZE: For sensor data JSON (typical: 1-2KB)
  * HTTP_BUFFER_SIZE: For HTTP responses (typical: 512B-2KB)
  * ESPNOW_BUFFER_SIZE: ESP-NOW max payload (250 bytes fixed)
+ * STATUS_SNAPSHOT_SIZE: Pre-serialized /api/status document
+ * HTTP_MAX_BODY_SIZE: Largest accepted POST body (larger gets 413)
+ * HTTP_MAX_CONFIG_SIZE: Largest accepted POST /api/config body
+ * ACTUATOR_BATCH_MAX: Commands per /api/actuators/batch or WS setActuators
  */
 #define JSON_BUFFER_SIZE 2048
 #define HTTP_BUFFER_SIZE 1024
 #define ESPNOW_BUFFER_SIZE 250
+#define STATUS_SNAPSHOT_SIZE 2048
+#define HTTP_MAX_BODY_SIZE 1024
+#define HTTP_MAX_CONFIG_SIZE 4096
+#define ACTUATOR_BATCH_MAX 16
 
 // ═══════════════════════════════════════════════════════════════════════════
 // FEATURE ENABLES
@@ -629,6 +892,10 @@ extern uint8_t peerMAC[]; // Broadcast
  * ENABLE_SENSORS: Sensor reading
  * ENABLE_ACTUATORS: Actuator control
  * ENABLE_CAMERA: Camera (ESP32-CAM only)
+ * ENABLE_TASK_SPLIT: Sample/store/publish sensors on separate FreeRTOS
+ *                    tasks instead of the main loop
+ * ENABLE_VIBRATION: FFT vibration features from the MPU6050 (needs
+ *                   MPU_USE_FIFO)
  */
 #define ENABLE_OTA true
 #define ENABLE_WEBSERVER true
@@ -637,6 +904,8 @@ extern uint8_t peerMAC[]; // Broadcast
 #define ENABLE_SENSORS true
 #define ENABLE_ACTUATORS true
 #define ENABLE_CAMERA (DEVICE_TYPE == 1) // Auto-detect
+#define ENABLE_TASK_SPLIT true
+#define ENABLE_VIBRATION true
 
 // ═══════════════════════════════════════════════════════════════════════════
 // DEBUG SETTINGS
@@ -658,6 +927,23 @@ extern uint8_t peerMAC[]; // Broadcast
 #define DEBUG_SENSORS true
 #define DEBUG_ACTUATORS true
 
+/**
+ * Main loop profiler (see utils/LoopProfiler.h)
+ *
+ * ENABLE_LOOP_PROFILER: Time loop() stages; compiles to nothing when false
+ * LOOP_PROFILER_MAX_STAGES: Distinct PROFILE_STAGE() names
+ * LOOP_PROFILER_MAX_TIMERS: Distinct PROFILE_TIMER() names
+ * LOOP_PROFILER_RING: Recent samples kept per stage for p99
+ * LOOP_TIMER_SLACK_MS: A Timer firing later than this counts as an overrun
+ *
+ * Results: GET /api/perf/loop, or type "perf" in the Serial Monitor
+ */
+#define ENABLE_LOOP_PROFILER DEBUG_MODE
+#define LOOP_PROFILER_MAX_STAGES 12
+#define LOOP_PROFILER_MAX_TIMERS 8
+#define LOOP_PROFILER_RING 64
+#define LOOP_TIMER_SLACK_MS 20
+
 /**
  * Debug print macros
  *
@@ -0,0 +1,569 @@
+/**
+ * @file CommandDispatcher.cpp
+ * @brief Command handlers and hashed name lookup
+ */
+
+#include "CommandDispatcher.h"
+#include "WebServer.h"
+#include "WiFiManager.h"
+#include "ESPNowComm.h"
+#include "StatusSnapshot.h"
+#include "sensors/SensorManager.h"
+#include "actuators/ActuatorManager.h"
+#include "../utils/CommandHash.h"
+#include "../utils/ResponseWriter.h"
+#include "../utils/Scheduler.h"
+#include <SPIFFS.h>
+
+extern SensorManager sensorManager;
+extern ActuatorManager actuatorManager;
+extern WiFiManager wifiManager;
+extern ESPNowComm espnowComm;
+extern DataLogger dataLogger;
+
+// Global instance
+CommandDispatcher commandDispatcher;
+
+#define CMD_SOURCE_LOCAL (CMD_SOURCE_WEBSOCKET | CMD_SOURCE_HTTP)
+#define CMD_SOURCE_ANY (CMD_SOURCE_WEBSOCKET | CMD_SOURCE_HTTP | CMD_SOURCE_ESPNOW)
+
+// ═══════════════════════════════════════════════════════════════════════════
+// COMMAND CONTEXT
+// ═══════════════════════════════════════════════════════════════════════════
+
+CommandContext::CommandContext(CommandSource src)
+{
+    source = src;
+    client = nullptr;
+    request = nullptr;
+    peerMac = nullptr;
+    error = nullptr;
+    errorCode = 400;
+    replied = false;
+}
+
+void CommandContext::reply(const char *json)
+{
+    switch (source)
+    {
+    case CMD_SOURCE_WEBSOCKET:
+        if (client)
+            client->text(json);
+        break;
+    case CMD_SOURCE_HTTP:
+        // An HTTP request can only be answered once
+        if (request && !replied)
+            request->send(200, "application/json", json);
+        break;
+    case CMD_SOURCE_ESPNOW:
+        if (peerMac)
+            espnowComm.sendMessage(peerMac, MSG_ACK, json);
+        break;
+    }
+    replied = true;
+}
+
+bool CommandContext::fail(const char *message, int code)
+{
+    error = message;
+    errorCode = code;
+    return false;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// COMMAND HANDLERS
+// ═══════════════════════════════════════════════════════════════════════════
+
+static bool cmdGetStatus(JsonObjectConst args, CommandContext &ctx)
+{
+    // Pre-serialized by the main loop - just copy it out
+    if (ctx.source == CMD_SOURCE_HTTP)
+    {
+        statusSnapshot.respond(ctx.request);
+        ctx.replied = true;
+        return true;
+    }
+
+    AsyncWebSocketMessageBuffer *message = statusSnapshot.makeWebSocketBuffer(ctx.client->server());
+    if (message == nullptr)
+        return ctx.fail("Status not ready", 503);
+
+    ctx.client->text(message);
+    ctx.replied = true;
+    return true;
+}
+
+static bool cmdGetSensorData(JsonObjectConst args, CommandContext &ctx)
+{
+    StaticJsonDocument<1024> response;
+    sensorManager.getAllSensorData(response.to<JsonObject>());
+    response["type"] = "sensor";
+
+    char buffer[1024];
+    serializeJson(response, buffer);
+    ctx.reply(buffer);
+    return true;
+}
+
+/**
+ * @brief Write the payload a validated actuator command applied
+ */
+static void writeAppliedPayload(ResponseWriter &json, JsonObjectConst args)
+{
+    json.field("actuator", args["actuator"].as<const char *>());
+    if (args.containsKey("r"))
+    {
+        json.field("r", args["r"].as<int>());
+        json.field("g", args["g"].as<int>());
+        json.field("b", args["b"].as<int>());
+    }
+    else if (args.containsKey("angle"))
+    {
+        json.field("angle", args["angle"].as<int>());
+    }
+    else
+    {
+        json.field("value", args["value"].as<int>());
+    }
+}
+
+static bool cmdSetActuator(JsonObjectConst args, CommandContext &ctx)
+{
+    const char *error;
+    if (!actuatorManager.validateCommand(args, error))
+        return ctx.fail(error);
+
+    actuatorManager.applyCommand(args);
+
+    // Broadcast state change to all WebSocket clients
+    char buffer[256];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter json(out);
+    json.beginObject();
+    json.field("type", "actuatorSet");
+    writeAppliedPayload(json, args);
+    json.field("success", true);
+    json.endObject();
+    webServer.broadcastText(buffer, "actuatorSet");
+
+    if (ctx.source == CMD_SOURCE_ESPNOW)
+    {
+        // Acknowledge back to the sending peer with what was applied
+        out.reset();
+        ResponseWriter ack(out);
+        ack.beginObject();
+        ack.field("status", "ok");
+        writeAppliedPayload(ack, args);
+        ack.endObject();
+        ctx.reply(buffer);
+    }
+    else if (ctx.source == CMD_SOURCE_WEBSOCKET)
+    {
+        ctx.replied = true; // Covered by the broadcast
+    }
+    return true;
+}
+
+static bool cmdSetActuators(JsonObjectConst args, CommandContext &ctx)
+{
+    int failedIndex;
+    const char *error;
+    int applied = actuatorManager.applyBatch(args["commands"].as<JsonArrayConst>(), failedIndex, error);
+
+    char buffer[512];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter json(out);
+
+    if (applied < 0)
+    {
+        json.beginObject();
+        json.field("type", "error");
+        json.field("success", false);
+        json.field("message", error);
+        json.field("error", error);
+        json.field("index", failedIndex);
+        json.endObject();
+
+        if (ctx.request)
+        {
+            ctx.request->send(400, "application/json", buffer);
+            ctx.replied = true;
+        }
+        else
+        {
+            ctx.reply(buffer);
+        }
+        return false;
+    }
+
+    webServer.broadcastActuatorState(applied);
+
+    if (ctx.source == CMD_SOURCE_WEBSOCKET)
+    {
+        ctx.replied = true; // Covered by the broadcast
+        return true;
+    }
+
+    json.beginObject();
+    json.field("success", true);
+    json.field("applied", applied);
+    if (ctx.source == CMD_SOURCE_HTTP)
+    {
+        actuatorManager.writeStatus(json);
+    }
+    json.endObject();
+    ctx.reply(buffer);
+    return true;
+}
+
+static bool cmdGetActuatorStatus(JsonObjectConst args, CommandContext &ctx)
+{
+    char buffer[512];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter json(out);
+    json.beginObject();
+    json.field("type", "actuatorStatus");
+    actuatorManager.writeStatus(json);
+    json.endObject();
+    ctx.reply(buffer);
+    return true;
+}
+
+static bool cmdGetPeers(JsonObjectConst args, CommandContext &ctx)
+{
+    StaticJsonDocument<1024> response;
+    response["type"] = "peers";
+    JsonArray peers = response.createNestedArray("peers");
+
+    uint8_t peerCount = espnowComm.getPeerCount();
+    for (uint8_t i = 0; i < peerCount; i++)
+    {
+        PeerInfo *peer = espnowComm.getPeerInfo(i);
+        if (peer && peer->active)
+        {
+            JsonObject peerObj = peers.createNestedObject();
+            peerObj["mac"] = espnowComm.getMacString(peer->mac);
+            peerObj["name"] = peer->name;
+            peerObj["lastSeen"] = peer->lastSeen;
+            peerObj["messagesSent"] = peer->messagesSent;
+            peerObj["messagesReceived"] = peer->messagesReceived;
+            peerObj["connected"] = (millis() - peer->lastSeen) < 60000;
+        }
+    }
+
+    char buffer[1024];
+    serializeJson(response, buffer);
+    ctx.reply(buffer);
+    return true;
+}
+
+static bool cmdSendToPeer(JsonObjectConst args, CommandContext &ctx)
+{
+    const char *peerMac = args["peer"];
+    JsonVariantConst messageVar = args["message"];
+
+    if (!peerMac || messageVar.isNull())
+        return ctx.fail("Missing peer or message");
+
+    uint8_t mac[6];
+    if (sscanf(peerMac, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
+               &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]) != 6)
+        return ctx.fail("Invalid MAC address");
+
+    String messageStr;
+    serializeJson(messageVar, messageStr);
+
+    bool success = espnowComm.sendMessage(mac, MSG_CUSTOM, messageStr.c_str());
+
+    dataLogger.logEvent(("Sent to " + String(peerMac) + ": " + messageStr).c_str());
+
+    StaticJsonDocument<256> response;
+    response["type"] = "espnowMessage";
+    response["direction"] = "sent";
+    response["peer"] = peerMac;
+    response["message"] = messageVar;
+    response["success"] = success;
+
+    char buffer[256];
+    serializeJson(response, buffer);
+    webServer.broadcastText(buffer, "espnowMessage");
+
+    if (ctx.source == CMD_SOURCE_WEBSOCKET)
+    {
+        ctx.replied = true; // Covered by the broadcast
+    }
+    else
+    {
+        ctx.reply(success ? "{\"success\":true}" : "{\"success\":false,\"error\":\"Send failed\"}");
+    }
+    return true;
+}
+
+static bool cmdTriggerAlert(JsonObjectConst args, CommandContext &ctx)
+{
+    const char *message = args["message"] | "Alert triggered";
+
+    actuatorManager.triggerAlert();
+
+    StaticJsonDocument<256> response;
+    response["type"] = "alert";
+    response["message"] = message;
+
+    char buffer[256];
+    serializeJson(response, buffer);
+    webServer.broadcastText(buffer, "alert");
+
+    espnowComm.sendToAllPeers(MSG_ALERT, message);
+
+    if (ctx.source == CMD_SOURCE_WEBSOCKET)
+    {
+        ctx.replied = true; // Covered by the broadcast
+    }
+    return true;
+}
+
+static bool cmdWiFiScan(JsonObjectConst args, CommandContext &ctx)
+{
+    // Never scan here: this runs on the AsyncTCP task
+    bool refresh = args["refresh"] | false;
+
+    char buffer[1536];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter json(out);
+    json.beginObject();
+
+    if (!refresh && wifiManager.hasFreshScan())
+    {
+        json.field("type", "wifiNetworks");
+        wifiManager.writeScanResults(json);
+    }
+    else
+    {
+        // Results are pushed to all clients as "wifiNetworks" when done
+        json.field("type", "wifiScanStarted");
+        json.field("scanId", wifiManager.requestScan(refresh));
+    }
+
+    json.endObject();
+    ctx.reply(buffer);
+    return true;
+}
+
+static bool cmdWiFiConnect(JsonObjectConst args, CommandContext &ctx)
+{
+    const char *ssid = args["ssid"];
+    const char *password = args["password"];
+
+    if (!ssid)
+        return ctx.fail("Missing SSID");
+
+    WiFi.begin(ssid, password);
+
+    StaticJsonDocument<128> response;
+    response["type"] = "wifiConnecting";
+    response["ssid"] = ssid;
+
+    char buffer[128];
+    serializeJson(response, buffer);
+    ctx.reply(buffer);
+    return true;
+}
+
+static bool cmdListFiles(JsonObjectConst args, CommandContext &ctx)
+{
+    StaticJsonDocument<1024> response;
+    response["type"] = "fileList";
+    JsonArray files = response.createNestedArray("files");
+
+    if (webServer.isSPIFFSAvailable())
+    {
+        File root = SPIFFS.open("/");
+        File file = root.openNextFile();
+
+        while (file)
+        {
+            JsonObject fileObj = files.createNestedObject();
+            fileObj["name"] = file.name();
+            fileObj["size"] = file.size();
+            file = root.openNextFile();
+        }
+    }
+
+    char buffer[1024];
+    serializeJson(response, buffer);
+    ctx.reply(buffer);
+    return true;
+}
+
+static bool cmdGetConfig(JsonObjectConst args, CommandContext &ctx)
+{
+    DynamicJsonDocument response(2048);
+    response["type"] = "config";
+    response["deviceName"] = DEVICE_NAME;
+    response["sensorInterval"] = SENSOR_READ_INTERVAL;
+    sensorManager.getAdaptiveConfig(response.createNestedObject("adaptive"));
+
+    char buffer[1024];
+    serializeJson(response, buffer);
+    ctx.reply(buffer);
+    return true;
+}
+
+static bool cmdSaveConfig(JsonObjectConst args, CommandContext &ctx)
+{
+    if (!sensorManager.configureAdaptive(args["adaptive"].as<JsonObjectConst>()))
+        return ctx.fail("Too many deadbands");
+
+    File configFile = SPIFFS.open("/config.json", FILE_WRITE);
+    if (!configFile)
+        return ctx.fail("Cannot open config file", 500);
+
+    serializeJson(args, configFile);
+    configFile.close();
+
+    ctx.reply("{\"type\":\"configSaved\",\"success\":true}");
+    return true;
+}
+
+static bool cmdRestart(JsonObjectConst args, CommandContext &ctx)
+{
+    ctx.reply("{\"type\":\"restarting\"}");
+
+    delay(1000);
+    ESP.restart();
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DISPATCHER
+// ═══════════════════════════════════════════════════════════════════════════
+
+CommandDispatcher::CommandDispatcher()
+{
+    totalDispatched = 0;
+    totalUnknown = 0;
+    totalRejected = 0;
+}
+
+/**
+ * @brief Look up a command handler by name
+ *
+ * Each case confirms the hash match with strcmp(), so an unknown name
+ * that happens to collide with a command is still rejected.
+ */
+CommandHandler CommandDispatcher::find(const char *name, uint8_t &allowedSources)
+{
+#define COMMAND_CASE(text, handler, sources)                 \
+    case hashName(text):                                     \
+        if (strcmp(name, text) != 0)                         \
+            return nullptr;                                  \
+        allowedSources = (sources);                          \
+        return handler;
+
+    allowedSources = 0;
+    if (name == nullptr)
+        return nullptr;
+
+    switch (hashNameRuntime(name))
+    {
+        COMMAND_CASE("getStatus", cmdGetStatus, CMD_SOURCE_LOCAL)
+        COMMAND_CASE("getSensorData", cmdGetSensorData, CMD_SOURCE_LOCAL)
+        COMMAND_CASE("setActuator", cmdSetActuator, CMD_SOURCE_ANY)
+        COMMAND_CASE("setActuators", cmdSetActuators, CMD_SOURCE_ANY)
+        COMMAND_CASE("getActuatorStatus", cmdGetActuatorStatus, CMD_SOURCE_LOCAL)
+        COMMAND_CASE("getPeers", cmdGetPeers, CMD_SOURCE_LOCAL)
+        COMMAND_CASE("sendToPeer", cmdSendToPeer, CMD_SOURCE_LOCAL)
+        COMMAND_CASE("triggerAlert", cmdTriggerAlert, CMD_SOURCE_LOCAL)
+        COMMAND_CASE("wifiScan", cmdWiFiScan, CMD_SOURCE_LOCAL)
+        COMMAND_CASE("wifiConnect", cmdWiFiConnect, CMD_SOURCE_LOCAL)
+        COMMAND_CASE("listFiles", cmdListFiles, CMD_SOURCE_LOCAL)
+        COMMAND_CASE("getConfig", cmdGetConfig, CMD_SOURCE_LOCAL)
+        // HTTP has its own POST /api/config and /api/restart routes
+        COMMAND_CASE("saveConfig", cmdSaveConfig, CMD_SOURCE_WEBSOCKET)
+        COMMAND_CASE("restart", cmdRestart, CMD_SOURCE_WEBSOCKET)
+    default:
+        return nullptr;
+    }
+
+#undef COMMAND_CASE
+}
+
+/**
+ * @brief Run a command and send any reply the handler did not
+ * @return true if the command ran successfully
+ *
+ * Default replies: HTTP gets {"success":true} or an error status,
+ * WebSocket clients only hear about errors, ESP-NOW peers get an ack.
+ */
+bool CommandDispatcher::dispatch(const char *name, JsonObjectConst args, CommandContext &ctx)
+{
+    uint8_t allowedSources;
+    CommandHandler handler = find(name, allowedSources);
+    bool success = false;
+
+    if (handler == nullptr)
+    {
+        totalUnknown++;
+        ctx.fail("Unknown command", 404);
+    }
+    else if ((allowedSources & ctx.source) == 0)
+    {
+        totalRejected++;
+        ctx.fail("Command not allowed from this source", 403);
+    }
+    else
+    {
+        totalDispatched++;
+        success = handler(args, ctx);
+
+        // Wake the main loop so actuator transitions start right away
+        if (success)
+            scheduler.post(SCHED_EVENT_COMMAND);
+    }
+
+    if (ctx.replied)
+        return success;
+
+    if (!success)
+    {
+        DEBUG_PRINTF("[CMD] %s failed: %s\n", name ? name : "(none)", ctx.error ? ctx.error : "?");
+
+        char buffer[160];
+        FixedBufferPrint out(buffer, sizeof(buffer));
+        ResponseWriter json(out);
+        json.beginObject();
+        if (ctx.source == CMD_SOURCE_WEBSOCKET)
+        {
+            json.field("type", "error");
+            json.field("command", name ? name : "");
+            json.field("message", ctx.error ? ctx.error : "Command failed");
+        }
+        else
+        {
+            json.field("success", false);
+            json.field("error", ctx.error ? ctx.error : "Command failed");
+        }
+        json.endObject();
+
+        if (ctx.source == CMD_SOURCE_HTTP && ctx.request)
+        {
+            ctx.request->send(ctx.errorCode, "application/json", buffer);
+            ctx.replied = true;
+        }
+        else
+        {
+            ctx.reply(buffer);
+        }
+        return false;
+    }
+
+    if (ctx.source == CMD_SOURCE_HTTP)
+    {
+        ctx.reply("{\"success\":true}");
+    }
+    else if (ctx.source == CMD_SOURCE_ESPNOW)
+    {
+        ctx.reply("{\"status\":\"ok\"}");
+    }
+    return true;
+}
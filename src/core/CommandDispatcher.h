@@ -0,0 +1,77 @@
+/**
+ * @file CommandDispatcher.h
+ * @brief One command handler set shared by WebSocket, REST and ESP-NOW
+ *
+ * Commands are JSON objects named by their "type" (WebSocket, POST
+ * /api/command) or implied by the route / message type (/api/actuator,
+ * ESP-NOW MSG_ACTUATOR_CMD). Names resolve through a compile-time hash
+ * switch to a handler function in O(1); see utils/CommandHash.h.
+ *
+ * Each command declares which transports may invoke it, so e.g. a peer
+ * can set actuators over ESP-NOW but cannot restart the device.
+ */
+
+#ifndef COMMAND_DISPATCHER_H
+#define COMMAND_DISPATCHER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+#include "../config.h"
+
+enum CommandSource
+{
+    CMD_SOURCE_WEBSOCKET = 0x01,
+    CMD_SOURCE_HTTP = 0x02,
+    CMD_SOURCE_ESPNOW = 0x04
+};
+
+/**
+ * @brief Where a command came from and how to answer it
+ */
+class CommandContext
+{
+public:
+    CommandSource source;
+    AsyncWebSocketClient *client;    // WebSocket only
+    AsyncWebServerRequest *request;  // HTTP only
+    const uint8_t *peerMac;          // ESP-NOW only
+    const char *error;               // Set by a handler that fails
+    int errorCode;                   // HTTP status for the error
+    bool replied;
+
+    explicit CommandContext(CommandSource src);
+
+    // Send a JSON reply over the originating transport (first reply only for HTTP)
+    void reply(const char *json);
+    bool fail(const char *message, int code = 400);
+};
+
+// Returns false (after ctx.fail()) when the command could not be executed
+typedef bool (*CommandHandler)(JsonObjectConst args, CommandContext &ctx);
+
+class CommandDispatcher
+{
+private:
+    // Statistics
+    uint32_t totalDispatched;
+    uint32_t totalUnknown;
+    uint32_t totalRejected;
+
+public:
+    CommandDispatcher();
+
+    // Resolve a command name; allowedSources receives the CommandSource mask
+    CommandHandler find(const char *name, uint8_t &allowedSources);
+
+    // Run command and send default replies (errors, HTTP success)
+    bool dispatch(const char *name, JsonObjectConst args, CommandContext &ctx);
+
+    uint32_t getDispatchedCount() { return totalDispatched; }
+    uint32_t getUnknownCount() { return totalUnknown; }
+    uint32_t getRejectedCount() { return totalRejected; }
+};
+
+extern CommandDispatcher commandDispatcher;
+
+#endif // COMMAND_DISPATCHER_H
@@ -29,6 +29,7 @@ ESPNowComm::ESPNowComm()
     for (int i = 0; i < MAX_ESPNOW_PEERS; i++)
     {
         peers[i].active = false;
+        peerTimers[i] = 0;
     }
 }
 
@@ -116,6 +117,7 @@ bool ESPNowComm::addPeer(const uint8_t *mac, const char *name)
     peers[peerCount].lastSeen = millis();
     peers[peerCount].messagesSent = 0;
     peers[peerCount].messagesReceived = 0;
+    armPeerTimeout(peerCount);
 
     peerCount++;
 
@@ -154,6 +156,14 @@ bool ESPNowComm::removePeer(const uint8_t *mac)
     }
     peerCount--;
 
+    // Timers belong to slots: re-arm the shifted ones, drop the last
+    timingWheel.cancel(peerTimers[peerCount]);
+    peerTimers[peerCount] = 0;
+    for (int i = index; i < peerCount; i++)
+    {
+        armPeerTimeout(i);
+    }
+
     DEBUG_PRINTLN("Peer removed");
     return true;
 }
@@ -185,6 +195,9 @@ PeerInfo *ESPNowComm::getPeerInfo(uint8_t index)
 
 /**
  * @brief Update peer activity timestamp
+ *
+ * Runs on the WiFi task, so it only stamps the peer; the timeout timer
+ * is left to the loop task, which sees the new lastSeen when it fires.
  */
 void ESPNowComm::updatePeerActivity(const uint8_t *mac)
 {
@@ -194,6 +207,7 @@ void ESPNowComm::updatePeerActivity(const uint8_t *mac)
         {
             peers[i].lastSeen = millis();
             peers[i].messagesReceived++;
+            peers[i].active = true;
             break;
         }
     }
@@ -203,7 +217,7 @@ void ESPNowComm::updatePeerActivity(const uint8_t *mac)
  * @brief Send message to specific peer
  * @param mac Destination MAC address
  * @param type Message type
- * @param data Data to send (JSON string)
+ * @param data Data to send (JSON string, at most ESPNOW_MAX_PAYLOAD bytes)
  * @return true if successful
  */
 bool ESPNowComm::sendMessage(const uint8_t *mac, uint8_t type, const char *data)
@@ -215,12 +229,14 @@ bool ESPNowComm::sendMessage(const uint8_t *mac, uint8_t type, const char *data)
     WiFi.macAddress(msg.sender);
     msg.timestamp = millis();
 
-    // Copy data
+    // Copy data; cut-off JSON would only fail to parse on the peer
     size_t dataLen = strlen(data);
-    if (dataLen > sizeof(msg.data) - 1)
+    if (dataLen > ESPNOW_MAX_PAYLOAD)
     {
-        dataLen = sizeof(msg.data) - 1;
-        DEBUG_PRINTLN("WARNING: Data truncated");
+        totalFailed++;
+        DEBUG_PRINTF("ERROR: %u-byte message does not fit in a frame (max %u)\n",
+                     (unsigned)dataLen, (unsigned)ESPNOW_MAX_PAYLOAD);
+        return false;
     }
     memcpy(msg.data, data, dataLen);
     msg.data[dataLen] = '\0';
@@ -457,6 +473,52 @@ void ESPNowComm::resetStatistics()
     }
 }
 
+/**
+ * @brief (Re)start the inactivity timeout of a peer slot
+ *
+ * Runs ESPNOW_PEER_TIMEOUT after the peer was last seen. Replaces
+ * polling every peer from the main loop. Loop task only (addPeer,
+ * removePeer, the timer itself): the cancel/schedule pair on
+ * peerTimers[] is not safe against a second caller.
+ */
+void ESPNowComm::armPeerTimeout(uint8_t index)
+{
+    timingWheel.cancel(peerTimers[index]);
+    peerTimers[index] = 0;
+
+    uint32_t silent = millis() - peers[index].lastSeen;
+    uint32_t remaining = silent < ESPNOW_PEER_TIMEOUT ? ESPNOW_PEER_TIMEOUT - silent : 0;
+    peerTimers[index] = timingWheel.schedule(remaining, onPeerTimeout, (void *)(uintptr_t)index);
+}
+
+void ESPNowComm::onPeerTimeout(void *context)
+{
+    uint8_t index = (uint8_t)(uintptr_t)context;
+    ESPNowComm *self = s_instance;
+    if (self == nullptr || index >= self->peerCount)
+        return;
+
+    self->peerTimers[index] = 0;
+    PeerInfo &peer = self->peers[index];
+
+    // A message may have arrived after this timer was armed
+    if (millis() - peer.lastSeen < ESPNOW_PEER_TIMEOUT)
+    {
+        self->armPeerTimeout(index);
+        return;
+    }
+
+    if (peer.active)
+    {
+        peer.active = false;
+        DEBUG_PRINTF("Peer %s marked inactive\n", peer.name);
+    }
+
+    // Keep checking at the timeout rate, so a peer that comes back is
+    // timed again without the WiFi task touching the timer
+    self->peerTimers[index] = timingWheel.schedule(ESPNOW_PEER_TIMEOUT, onPeerTimeout, context);
+}
+
 /**
  * @brief Check peer activity and mark inactive peers
  * @param timeout Timeout in milliseconds
@@ -9,6 +9,7 @@
 #ifndef ESPNOW_COMM_H
 #define ESPNOW_COMM_H
 #include "../config.h"
+#include "../utils/TimingWheel.h"
 #include <esp_now.h>
 
 // Message types
@@ -35,6 +36,9 @@ struct ESPNowMessage
     uint8_t checksum;   // Simple checksum for validation
 };
 
+// Longest string sendMessage() accepts (data[] keeps its terminator)
+#define ESPNOW_MAX_PAYLOAD (sizeof(ESPNowMessage::data) - 1)
+
 // Peer information
 struct PeerInfo
 {
@@ -55,6 +59,7 @@ class ESPNowComm
 private:
     PeerInfo peers[MAX_ESPNOW_PEERS];
     uint8_t peerCount;
+    TimerId peerTimers[MAX_ESPNOW_PEERS]; // Inactivity timeout per slot
     OnDataRecvCallback recvCallback;
     OnDataSentCallback sentCallback;
 
@@ -66,6 +71,8 @@ private:
     // Internal methods
     static uint8_t calculateChecksum(const ESPNowMessage *msg);
     static bool validateChecksum(const ESPNowMessage *msg);
+    void armPeerTimeout(uint8_t index);
+    static void onPeerTimeout(void *context);
 
     // Static callbacks for ESP-NOW
     static void onDataSent(const uint8_t *mac_addr, esp_now_send_status_t status);
@@ -105,8 +112,8 @@ public:
     void getStatistics(uint32_t &sent, uint32_t &received, uint32_t &failed);
     void resetStatistics();
 
-    // Keep alive
-    void checkPeerActivity(uint32_t timeout = 60000); // 60 seconds timeout
+    // Keep alive (peers also time out on their own after ESPNOW_PEER_TIMEOUT)
+    void checkPeerActivity(uint32_t timeout = ESPNOW_PEER_TIMEOUT);
 };
 
 extern ESPNowComm espnowComm; // Global instance
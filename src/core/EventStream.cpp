@@ -0,0 +1,151 @@
+/**
+ * @file EventStream.cpp
+ * @brief Implementation of Server-Sent Events feed
+ */
+
+#include "EventStream.h"
+
+// Global instance
+EventStream eventStream;
+
+/**
+ * @brief Constructor
+ */
+EventStream::EventStream()
+{
+    source = nullptr;
+    lock = nullptr;
+    head = 0;
+    count = 0;
+    nextId = 1;
+    totalPublished = 0;
+    totalReplayed = 0;
+    totalTooLarge = 0;
+}
+
+/**
+ * @brief Create the event source and attach it to the server
+ * @return true if ready
+ */
+bool EventStream::begin(AsyncWebServer *server)
+{
+    if (source != nullptr)
+        return true;
+
+    lock = xSemaphoreCreateMutex();
+    if (lock == nullptr)
+        return false;
+
+    // Start each boot at a random id so a client's Last-Event-ID from
+    // before a reboot is not mistaken for one of ours
+    nextId = 1 + (esp_random() >> 4);
+
+    source = new AsyncEventSource("/api/stream");
+    source->onConnect([this](AsyncEventSourceClient *client)
+                      { onConnect(client); });
+    server->addHandler(source);
+
+    DEBUG_PRINTLN("[SSE] Event stream at /api/stream");
+    return true;
+}
+
+/**
+ * @brief Replay missed events to a (re)connecting client
+ *
+ * Runs on the AsyncTCP task while publish() runs on other tasks, hence
+ * the lock around the ring.
+ */
+void EventStream::onConnect(AsyncEventSourceClient *client)
+{
+    uint32_t lastId = client->lastId();
+
+    if (lastId == 0)
+    {
+        client->send("{\"type\":\"hello\"}", "hello", 0, EVENT_STREAM_RETRY);
+        return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+
+    // Known ids run from just before the oldest stored event to the last
+    // one sent. Anything else (ring overrun, an id from before a reboot)
+    // is unknown: resync, then replay whatever the ring holds.
+    uint8_t oldest = (head + EVENT_STREAM_RING_SIZE - count) % EVENT_STREAM_RING_SIZE;
+    uint32_t firstKnown = count > 0 ? ring[oldest].id : nextId;
+    if (lastId >= nextId || lastId + 1 < firstKnown)
+    {
+        client->send("{\"type\":\"resync\"}", "resync", 0, EVENT_STREAM_RETRY);
+        lastId = 0;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const Slot &slot = ring[(oldest + i) % EVENT_STREAM_RING_SIZE];
+        if (slot.id > lastId)
+        {
+            client->send(slot.data, slot.topic, slot.id);
+            totalReplayed++;
+        }
+    }
+
+    xSemaphoreGive(lock);
+}
+
+/**
+ * @brief Copy an event into the ring, overwriting the oldest
+ */
+void EventStream::store(uint32_t id, const char *topic, const char *json, size_t length)
+{
+    Slot &slot = ring[head];
+    slot.id = id;
+    strlcpy(slot.topic, topic, sizeof(slot.topic));
+    memcpy(slot.data, json, length + 1);
+
+    head = (head + 1) % EVENT_STREAM_RING_SIZE;
+    if (count < EVENT_STREAM_RING_SIZE)
+        count++;
+}
+
+/**
+ * @brief Publish one event
+ * @param topic SSE event name (normally the message "type")
+ * @param json Event payload
+ *
+ * Callers run on the loop, the publish task, AsyncTCP and the WiFi task.
+ * The send stays under the lock so ids go out in the order they are
+ * stored, and onConnect() cannot replay an event that is also about to
+ * be sent live.
+ */
+void EventStream::publish(const char *topic, const char *json)
+{
+    if (source == nullptr || json == nullptr)
+        return;
+
+    size_t length = strlen(json);
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    uint32_t id = nextId++;
+    if (length < EVENT_STREAM_SLOT_SIZE)
+    {
+        store(id, topic, json, length);
+    }
+    else
+    {
+        totalTooLarge++;
+    }
+    totalPublished++;
+
+    if (source->count() > 0)
+    {
+        source->send(json, topic, id);
+    }
+    xSemaphoreGive(lock);
+}
+
+/**
+ * @brief Number of connected stream clients
+ */
+size_t EventStream::getClientCount()
+{
+    return source ? source->count() : 0;
+}
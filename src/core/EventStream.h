@@ -0,0 +1,76 @@
+/**
+ * @file EventStream.h
+ * @brief Server-Sent Events feed at /api/stream
+ *
+ * Publishes the same messages as the WebSocket broadcasts, using the
+ * message "type" as the SSE event name (sensor, status, alert,
+ * actuatorSet, ...). Clients that can't speak WebSocket - curl, scripts,
+ * small displays - keep one connection open instead of polling:
+ *
+ * @code
+ * curl -N http://esp32.local/api/stream
+ * @endcode
+ *
+ * Every event carries an increasing id. The last EVENT_STREAM_RING_SIZE
+ * events are kept in RAM, so a client reconnecting with Last-Event-ID
+ * is sent what it missed. If it missed more than the ring holds, or its
+ * id is not from this boot (ids start at a random value), it gets a
+ * "resync" event and should re-fetch /api/status and /api/sensors.
+ *
+ * Events longer than a slot (wifiNetworks scan results) are sent live
+ * but never replayed; a client that missed one re-requests the scan.
+ */
+
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "../config.h"
+
+#define EVENT_STREAM_TOPIC_LEN 20
+
+class EventStream
+{
+private:
+    struct Slot
+    {
+        uint32_t id;
+        char topic[EVENT_STREAM_TOPIC_LEN];
+        char data[EVENT_STREAM_SLOT_SIZE];
+    };
+
+    AsyncEventSource *source;
+    SemaphoreHandle_t lock;
+
+    Slot ring[EVENT_STREAM_RING_SIZE];
+    uint8_t head;  // Next slot to write
+    uint8_t count; // Slots in use
+    uint32_t nextId;
+
+    // Statistics
+    uint32_t totalPublished;
+    uint32_t totalReplayed;
+    uint32_t totalTooLarge;
+
+    void onConnect(AsyncEventSourceClient *client);
+    void store(uint32_t id, const char *topic, const char *json, size_t length);
+
+public:
+    EventStream();
+
+    // Register /api/stream on the server (before catch-all handlers)
+    bool begin(AsyncWebServer *server);
+
+    // Send to all stream clients and remember for resume
+    void publish(const char *topic, const char *json);
+
+    size_t getClientCount();
+    uint32_t getLastId() { return nextId - 1; }
+    uint32_t getPublishedCount() { return totalPublished; }
+    uint32_t getReplayedCount() { return totalReplayed; }
+};
+
+extern EventStream eventStream;
+
+#endif // EVENT_STREAM_H
@@ -10,6 +10,7 @@
  */
 
 #include "OTAManager.h"
+#include "StaticFileCache.h"
 
 // Global instance
 OTAManager otaManager;
@@ -216,6 +217,8 @@ void OTAManager::setupCallbacks()
             type = "sketch";
         } else { // U_SPIFFS
             type = "filesystem";
+            // Cached web assets are about to become stale
+            staticFileCache.setEnabled(false);
         }
         
         DEBUG_PRINTLN("\n╔═══════════════════════════════════════════════════╗");
@@ -353,6 +356,9 @@ void OTAManager::setupCallbacks()
         
         // Update statistics
         failedUpdates++;
+
+        // Filesystem left as it was - resume caching
+        staticFileCache.setEnabled(true);
         
         // LED indication (error - fast blinking)
         if (useLED && ledPin >= 0) {
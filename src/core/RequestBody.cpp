@@ -0,0 +1,121 @@
+/**
+ * @file RequestBody.cpp
+ * @brief Implementation of multi-chunk POST body accumulator
+ */
+
+#include "RequestBody.h"
+
+/**
+ * @brief Per-request state stored in request->_tempObject
+ *
+ * The body bytes follow the header in the same allocation, so the
+ * request's destructor releases everything with a single free().
+ */
+struct BodyBuffer
+{
+    size_t total;
+    size_t received;
+    RequestBody::Status status;
+    char data[1]; // total + 1 bytes when status != TOO_LARGE/NO_MEMORY
+};
+
+static BodyBuffer *allocateHeader(RequestBody::Status status)
+{
+    BodyBuffer *buffer = (BodyBuffer *)malloc(sizeof(BodyBuffer));
+    if (buffer)
+    {
+        buffer->total = 0;
+        buffer->received = 0;
+        buffer->status = status;
+        buffer->data[0] = '\0';
+    }
+    return buffer;
+}
+
+void RequestBody::collect(AsyncWebServerRequest *request, uint8_t *data,
+                          size_t len, size_t index, size_t total)
+{
+    collectUpTo(request, data, len, index, total, HTTP_MAX_BODY_SIZE);
+}
+
+void RequestBody::collectUpTo(AsyncWebServerRequest *request, uint8_t *data,
+                              size_t len, size_t index, size_t total, size_t limit)
+{
+    BodyBuffer *buffer = (BodyBuffer *)request->_tempObject;
+
+    if (index == 0 && buffer == nullptr)
+    {
+        if (total > limit)
+        {
+            request->_tempObject = allocateHeader(BODY_TOO_LARGE);
+            return;
+        }
+
+        buffer = (BodyBuffer *)malloc(sizeof(BodyBuffer) + total);
+        if (buffer == nullptr)
+        {
+            request->_tempObject = allocateHeader(BODY_NO_MEMORY);
+            return;
+        }
+
+        buffer->total = total;
+        buffer->received = 0;
+        buffer->status = BODY_PARTIAL;
+        request->_tempObject = buffer;
+    }
+
+    // Rejected, or a chunk for a body we never saw the start of
+    if (buffer == nullptr || buffer->status != BODY_PARTIAL)
+        return;
+
+    // Chunks arrive in order; anything else is a malformed request
+    if (index != buffer->received || index + len > buffer->total)
+    {
+        buffer->status = BODY_BAD_CHUNK;
+        return;
+    }
+
+    memcpy(buffer->data + index, data, len);
+    buffer->received += len;
+
+    if (buffer->received == buffer->total)
+    {
+        buffer->data[buffer->total] = '\0';
+        buffer->status = BODY_COMPLETE;
+    }
+}
+
+RequestBody::Status RequestBody::getStatus(AsyncWebServerRequest *request)
+{
+    BodyBuffer *buffer = (BodyBuffer *)request->_tempObject;
+    return buffer ? buffer->status : BODY_MISSING;
+}
+
+const char *RequestBody::require(AsyncWebServerRequest *request, size_t &length)
+{
+    length = 0;
+
+    switch (getStatus(request))
+    {
+    case BODY_COMPLETE:
+    {
+        BodyBuffer *buffer = (BodyBuffer *)request->_tempObject;
+        length = buffer->total;
+        return buffer->data;
+    }
+    case BODY_TOO_LARGE:
+        request->send(413, "application/json", "{\"success\":false,\"error\":\"Request body too large\"}");
+        return nullptr;
+    case BODY_NO_MEMORY:
+        request->send(503, "application/json", "{\"success\":false,\"error\":\"Out of memory\"}");
+        return nullptr;
+    case BODY_BAD_CHUNK:
+        request->send(400, "application/json", "{\"success\":false,\"error\":\"Malformed request body\"}");
+        return nullptr;
+    case BODY_PARTIAL:
+    case BODY_MISSING:
+    default:
+        request->send(400, "application/json", "{\"success\":false,\"error\":\"Missing request body\"}");
+        return nullptr;
+    }
+}
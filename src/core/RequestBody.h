@@ -0,0 +1,61 @@
+/**
+ * @file RequestBody.h
+ * @brief Reassembles POST bodies that arrive in several TCP chunks
+ *
+ * AsyncWebServer calls a route's body handler once per received chunk
+ * (index = offset, len = chunk size, total = Content-Length). Parsing
+ * each chunk on its own breaks as soon as a body spans two segments,
+ * and the data is not NUL-terminated either.
+ *
+ * Usage - collect in the body handler, consume in the request handler
+ * (which AsyncWebServer only calls once the whole body has arrived):
+ *
+ * @code
+ * server->on("/api/x", HTTP_POST, [](AsyncWebServerRequest *request) {
+ *     size_t length;
+ *     const char *body = RequestBody::require(request, length);
+ *     if (!body) return; // 400/413/503 already sent
+ *     deserializeJson(doc, body, length);
+ * }, NULL, RequestBody::collect);
+ * @endcode
+ *
+ * The buffer lives in request->_tempObject, which AsyncWebServer frees
+ * together with the request.
+ */
+
+#ifndef REQUEST_BODY_H
+#define REQUEST_BODY_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "../config.h"
+
+class RequestBody
+{
+public:
+    enum Status : uint8_t
+    {
+        BODY_MISSING = 0,
+        BODY_PARTIAL,
+        BODY_COMPLETE,
+        BODY_TOO_LARGE,
+        BODY_NO_MEMORY,
+        BODY_BAD_CHUNK // Out of order, or past Content-Length
+    };
+
+    // Body handler for routes with the default HTTP_MAX_BODY_SIZE limit
+    static void collect(AsyncWebServerRequest *request, uint8_t *data,
+                        size_t len, size_t index, size_t total);
+
+    // Body handler with an explicit size limit
+    static void collectUpTo(AsyncWebServerRequest *request, uint8_t *data,
+                            size_t len, size_t index, size_t total, size_t limit);
+
+    static Status getStatus(AsyncWebServerRequest *request);
+
+    // Complete, NUL-terminated body; sends an error response and returns
+    // nullptr if the body is missing, incomplete or was rejected
+    static const char *require(AsyncWebServerRequest *request, size_t &length);
+};
+
+#endif // REQUEST_BODY_H
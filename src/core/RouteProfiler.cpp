@@ -0,0 +1,199 @@
+/**
+ * @file RouteProfiler.cpp
+ * @brief Implementation of per-route latency histograms
+ */
+
+#include "RouteProfiler.h"
+#include "../utils/ResponseWriter.h"
+
+// Global instance
+RouteProfiler routeProfiler;
+
+/**
+ * @brief Constructor
+ */
+RouteProfiler::RouteProfiler()
+{
+    routeCount = 0;
+}
+
+/**
+ * @brief Register a route at setup time
+ */
+int8_t RouteProfiler::addRoute(const char *path, WebRequestMethodComposite method)
+{
+    if (routeCount >= PERF_MAX_ROUTES)
+    {
+        DEBUG_PRINTF("[PERF] No slot for %s - increase PERF_MAX_ROUTES\n", path);
+        return -1;
+    }
+
+    RouteStats &stats = routes[routeCount];
+    memset(&stats, 0, sizeof(stats));
+    stats.path = path;
+    stats.method = method;
+    return routeCount++;
+}
+
+/**
+ * @brief Log-linear bucket index for a latency
+ */
+uint8_t RouteProfiler::bucketFor(uint32_t micros)
+{
+    const uint32_t subBuckets = 1 << PERF_SUB_BUCKET_BITS;
+    if (micros < subBuckets)
+        return micros;
+
+    uint8_t msb = 31 - __builtin_clz(micros);
+    uint8_t shift = msb - PERF_SUB_BUCKET_BITS;
+    uint32_t index = (shift << PERF_SUB_BUCKET_BITS) + (micros >> shift);
+
+    return index < PERF_BUCKETS ? index : PERF_BUCKETS - 1;
+}
+
+/**
+ * @brief Largest latency that falls into a bucket
+ *
+ * The last bucket also takes everything beyond the range, so it has no
+ * upper bound (percentile() then reports the max).
+ */
+uint32_t RouteProfiler::bucketUpperBound(uint8_t bucket)
+{
+    const uint32_t subBuckets = 1 << PERF_SUB_BUCKET_BITS;
+    if (bucket < subBuckets)
+        return bucket;
+    if (bucket >= PERF_BUCKETS - 1)
+        return UINT32_MAX;
+
+    uint8_t shift = (bucket >> PERF_SUB_BUCKET_BITS) - 1;
+    uint32_t mantissa = (bucket & (subBuckets - 1)) + subBuckets;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+const char *RouteProfiler::methodName(WebRequestMethodComposite method)
+{
+    switch (method)
+    {
+    case HTTP_GET:
+        return "GET";
+    case HTTP_POST:
+        return "POST";
+    case HTTP_DELETE:
+        return "DELETE";
+    case HTTP_PUT:
+        return "PUT";
+    case HTTP_PATCH:
+        return "PATCH";
+    default:
+        return "ANY";
+    }
+}
+
+/**
+ * @brief Record one handler run
+ * @param heapDelta Free heap after minus before (negative = retained)
+ */
+void RouteProfiler::record(int8_t route, uint32_t micros, int32_t heapDelta)
+{
+    if (route < 0 || route >= routeCount)
+        return;
+
+    RouteStats &stats = routes[route];
+    uint8_t bucket = bucketFor(micros);
+    if (stats.buckets[bucket] == UINT16_MAX)
+    {
+        // Halve the whole route rather than stop counting one bucket, so
+        // the percentiles keep their proportions; rounding up keeps rare
+        // buckets from disappearing
+        for (uint8_t i = 0; i < PERF_BUCKETS; i++)
+            stats.buckets[i] = (stats.buckets[i] + 1) / 2;
+    }
+    stats.buckets[bucket]++;
+
+    stats.count++;
+    stats.totalMicros += micros;
+    if (micros > stats.maxMicros)
+        stats.maxMicros = micros;
+    if (heapDelta < stats.heapDeltaMin)
+        stats.heapDeltaMin = heapDelta;
+    stats.heapDeltaTotal += heapDelta;
+
+    if (micros >= PERF_SLOW_HANDLER_US)
+    {
+        stats.slowCount++;
+        DEBUG_PRINTF("[PERF] Slow handler %s %s: %lu us (heap %+ld)\n",
+                     methodName(stats.method), stats.path,
+                     (unsigned long)micros, (long)heapDelta);
+    }
+}
+
+/**
+ * @brief Latency at the given percentile (bucket upper bound)
+ */
+uint32_t RouteProfiler::percentile(const RouteStats &stats, uint8_t percent)
+{
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < PERF_BUCKETS; i++)
+    {
+        total += stats.buckets[i];
+    }
+    if (total == 0)
+        return 0;
+
+    // Rank of the sample at this percentile (1-based, rounded up)
+    uint32_t rank = (total * percent + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < PERF_BUCKETS; i++)
+    {
+        seen += stats.buckets[i];
+        if (seen >= rank)
+        {
+            uint32_t bound = bucketUpperBound(i);
+            return bound < stats.maxMicros ? bound : stats.maxMicros;
+        }
+    }
+    return stats.maxMicros;
+}
+
+/**
+ * @brief Clear all statistics, keep registered routes
+ */
+void RouteProfiler::reset()
+{
+    for (uint8_t i = 0; i < routeCount; i++)
+    {
+        const char *path = routes[i].path;
+        WebRequestMethodComposite method = routes[i].method;
+        memset(&routes[i], 0, sizeof(routes[i]));
+        routes[i].path = path;
+        routes[i].method = method;
+    }
+}
+
+/**
+ * @brief Write per-route statistics (routes never hit are skipped)
+ */
+void RouteProfiler::writeStats(ResponseWriter &json)
+{
+    json.beginArray("routes");
+    for (uint8_t i = 0; i < routeCount; i++)
+    {
+        const RouteStats &stats = routes[i];
+        if (stats.count == 0)
+            continue;
+
+        json.beginObject();
+        json.field("method", methodName(stats.method));
+        json.field("path", stats.path);
+        json.field("count", stats.count);
+        json.field("p50", percentile(stats, 50));
+        json.field("p99", percentile(stats, 99));
+        json.field("max", stats.maxMicros);
+        json.field("mean", (unsigned long)(stats.totalMicros / stats.count));
+        json.field("slow", stats.slowCount);
+        json.field("heapDeltaMin", (long)stats.heapDeltaMin);
+        json.field("heapDeltaMean", (long)(stats.heapDeltaTotal / (int64_t)stats.count));
+        json.endObject();
+    }
+    json.endArray();
+}
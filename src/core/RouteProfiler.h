@@ -0,0 +1,77 @@
+/**
+ * @file RouteProfiler.h
+ * @brief Per-route handler latency histograms for the web server
+ *
+ * setupRoutes() wraps every handler with WebServerManager::timed(), which
+ * measures the handler with esp_timer_get_time() and records:
+ * - a log-linear (HDR-style) latency histogram, for p50/p99
+ * - max and mean latency
+ * - free-heap change across the handler (response objects still queued
+ *   for sending count as retained)
+ *
+ * Handlers slower than PERF_SLOW_HANDLER_US are logged with their route.
+ * Results are served at /api/perf (DELETE /api/perf resets them).
+ *
+ * Buckets: exact below 4 us, then 4 sub-buckets per power of two, so a
+ * reported percentile is at most ~25% above the true value.
+ * Bucket counts are 16-bit; when one fills, every bucket of that route
+ * is halved, so long-running routes keep their shape (older samples
+ * simply weigh less).
+ *
+ * All handlers run on the AsyncTCP task, so recording needs no lock.
+ */
+
+#ifndef ROUTE_PROFILER_H
+#define ROUTE_PROFILER_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "../config.h"
+
+#define PERF_SUB_BUCKET_BITS 2
+#define PERF_BUCKETS 96 // Resolves up to ~30 s; the last bucket is open-ended
+
+class ResponseWriter;
+
+class RouteProfiler
+{
+private:
+    struct RouteStats
+    {
+        const char *path;
+        WebRequestMethodComposite method;
+        uint32_t count;
+        uint32_t slowCount;
+        uint32_t maxMicros;
+        uint64_t totalMicros;
+        int32_t heapDeltaMin; // Most negative = most heap retained
+        int64_t heapDeltaTotal;
+        uint16_t buckets[PERF_BUCKETS];
+    };
+
+    RouteStats routes[PERF_MAX_ROUTES];
+    uint8_t routeCount;
+
+    static uint8_t bucketFor(uint32_t micros);
+    static uint32_t bucketUpperBound(uint8_t bucket);
+    static const char *methodName(WebRequestMethodComposite method);
+    uint32_t percentile(const RouteStats &stats, uint8_t percent);
+
+public:
+    RouteProfiler();
+
+    // Returns route slot, or -1 if PERF_MAX_ROUTES is exhausted
+    int8_t addRoute(const char *path, WebRequestMethodComposite method);
+
+    void record(int8_t route, uint32_t micros, int32_t heapDelta);
+    void reset();
+
+    // Write "routes":[...] member
+    void writeStats(ResponseWriter &json);
+
+    uint8_t getRouteCount() { return routeCount; }
+};
+
+extern RouteProfiler routeProfiler;
+
+#endif // ROUTE_PROFILER_H
@@ -0,0 +1,405 @@
+/**
+ * @file StaticFileCache.cpp
+ * @brief Implementation of in-RAM static asset cache
+ */
+
+#include "StaticFileCache.h"
+#include <FS.h>
+#include <SPIFFS.h>
+
+// Global instance
+StaticFileCache staticFileCache;
+
+/**
+ * @brief Constructor
+ */
+StaticFileCache::StaticFileCache()
+{
+    lock = nullptr;
+    budget = 0;
+    usedBytes = 0;
+    useCounter = 0;
+    enabled = false;
+    usePSRAM = false;
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+    bypasses = 0;
+    notFound = 0;
+
+    for (int i = 0; i < STATIC_CACHE_MAX_ENTRIES; i++)
+    {
+        entries[i].path[0] = '\0';
+        entries[i].acceptGzip = false;
+        entries[i].lastUsed = 0;
+    }
+}
+
+/**
+ * @brief Initialize cache
+ * @param budgetBytes Maximum bytes of cached file bodies
+ * @return true if ready
+ */
+bool StaticFileCache::begin(size_t budgetBytes)
+{
+    if (lock == nullptr)
+    {
+        lock = xSemaphoreCreateMutex();
+        if (lock == nullptr)
+        {
+            DEBUG_PRINTLN("[CACHE] Failed to create mutex");
+            return false;
+        }
+    }
+
+#ifdef BOARD_HAS_PSRAM
+    usePSRAM = psramFound();
+#endif
+
+    budget = budgetBytes;
+    enabled = true;
+
+    DEBUG_PRINTF("[CACHE] Static file cache: %u bytes in %s, %d entries\n",
+                 budget, usePSRAM ? "PSRAM" : "heap", STATIC_CACHE_MAX_ENTRIES);
+    return true;
+}
+
+/**
+ * @brief Get cached asset, loading it from SPIFFS on a miss
+ * @param path Absolute SPIFFS path (e.g. "/index.html")
+ * @param acceptGzip Client accepts a gzip-encoded body
+ * @return Cached asset or nullptr if it cannot be served from cache
+ *
+ * Missing files are counted as notFound, not as misses, so scans for
+ * absent paths do not drag the hit rate down.
+ */
+CachedAssetPtr StaticFileCache::get(const char *path, bool acceptGzip)
+{
+    if (!enabled || lock == nullptr || strlen(path) >= STATIC_CACHE_PATH_LEN)
+    {
+        return nullptr;
+    }
+
+    // Fast path: hit
+    xSemaphoreTake(lock, portMAX_DELAY);
+    int index = findEntry(path, acceptGzip);
+    if (index >= 0)
+    {
+        entries[index].lastUsed = ++useCounter;
+        hits++;
+        CachedAssetPtr asset = entries[index].asset;
+        xSemaphoreGive(lock);
+        return asset;
+    }
+    xSemaphoreGive(lock);
+
+    // Slow path: read from flash without holding the lock
+    bool found = false;
+    CachedAssetPtr asset = loadFromFlash(path, acceptGzip, found);
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (!found)
+    {
+        notFound++;
+        xSemaphoreGive(lock);
+        return nullptr;
+    }
+    misses++;
+    if (!asset)
+    {
+        xSemaphoreGive(lock);
+        return nullptr;
+    }
+
+    // Another request may have loaded the same file meanwhile
+    index = findEntry(path, acceptGzip);
+    if (index >= 0)
+    {
+        entries[index].lastUsed = ++useCounter;
+        CachedAssetPtr existing = entries[index].asset;
+        xSemaphoreGive(lock);
+        return existing;
+    }
+
+    // Filesystem may have been invalidated while we were reading
+    if (enabled)
+    {
+        index = claimSlot(asset->length);
+        if (index >= 0)
+        {
+            strncpy(entries[index].path, path, STATIC_CACHE_PATH_LEN - 1);
+            entries[index].path[STATIC_CACHE_PATH_LEN - 1] = '\0';
+            entries[index].acceptGzip = acceptGzip;
+            entries[index].asset = asset;
+            entries[index].lastUsed = ++useCounter;
+            usedBytes += asset->length;
+        }
+    }
+    xSemaphoreGive(lock);
+
+    return asset;
+}
+
+/**
+ * @brief Drop every cached body
+ *
+ * Bodies still referenced by in-flight responses are freed when
+ * those responses complete.
+ */
+void StaticFileCache::invalidateAll()
+{
+    if (lock == nullptr)
+        return;
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (int i = 0; i < STATIC_CACHE_MAX_ENTRIES; i++)
+    {
+        entries[i].asset.reset();
+        entries[i].path[0] = '\0';
+        entries[i].lastUsed = 0;
+    }
+    usedBytes = 0;
+    xSemaphoreGive(lock);
+
+    DEBUG_PRINTLN("[CACHE] Static file cache invalidated");
+}
+
+/**
+ * @brief Enable or disable caching
+ *
+ * Disabling also invalidates, so no stale body survives a filesystem
+ * rewrite. Requests fall back to SPIFFS while disabled.
+ */
+void StaticFileCache::setEnabled(bool enable)
+{
+    if (!enable)
+    {
+        enabled = false;
+        invalidateAll();
+    }
+    else if (lock != nullptr)
+    {
+        enabled = true;
+    }
+}
+
+/**
+ * @brief Check whether a path is a web asset worth caching
+ */
+bool StaticFileCache::isCacheable(const char *path)
+{
+    const char *ext = strrchr(path, '.');
+    if (ext == nullptr)
+        return false;
+
+    return strcmp(ext, ".html") == 0 || strcmp(ext, ".htm") == 0 ||
+           strcmp(ext, ".css") == 0 || strcmp(ext, ".js") == 0 ||
+           strcmp(ext, ".svg") == 0 || strcmp(ext, ".ico") == 0 ||
+           strcmp(ext, ".png") == 0 || strcmp(ext, ".jpg") == 0 ||
+           strcmp(ext, ".gif") == 0;
+}
+
+/**
+ * @brief Get content type based on file extension
+ */
+const char *StaticFileCache::getContentType(const char *path)
+{
+    const char *ext = strrchr(path, '.');
+    if (ext == nullptr)
+        return "text/plain";
+
+    if (strcmp(ext, ".html") == 0 || strcmp(ext, ".htm") == 0)
+        return "text/html";
+    else if (strcmp(ext, ".css") == 0)
+        return "text/css";
+    else if (strcmp(ext, ".js") == 0)
+        return "application/javascript";
+    else if (strcmp(ext, ".svg") == 0)
+        return "image/svg+xml";
+    else if (strcmp(ext, ".ico") == 0)
+        return "image/x-icon";
+    else if (strcmp(ext, ".png") == 0)
+        return "image/png";
+    else if (strcmp(ext, ".jpg") == 0)
+        return "image/jpeg";
+    else if (strcmp(ext, ".gif") == 0)
+        return "image/gif";
+    return "text/plain";
+}
+
+/**
+ * @brief Number of occupied cache slots
+ */
+uint8_t StaticFileCache::getEntryCount()
+{
+    uint8_t count = 0;
+    for (int i = 0; i < STATIC_CACHE_MAX_ENTRIES; i++)
+    {
+        if (entries[i].asset)
+            count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Hit rate in percent
+ */
+float StaticFileCache::getHitRate()
+{
+    uint32_t lookups = hits + misses;
+    if (lookups == 0)
+        return 0.0f;
+    return (hits * 100.0f) / lookups;
+}
+
+/**
+ * @brief Print cache status
+ */
+void StaticFileCache::printStatus()
+{
+    Serial.println("┌─────────────────────────────────────────────────┐");
+    Serial.println("│          STATIC FILE CACHE                      │");
+    Serial.println("├─────────────────────────────────────────────────┤");
+    Serial.printf("│ Enabled:        %-28s │\n", enabled ? "Yes" : "No");
+    Serial.printf("│ Memory:         %-28s │\n", usePSRAM ? "PSRAM" : "Heap");
+    Serial.printf("│ Entries:        %-3u / %-22d │\n", getEntryCount(), STATIC_CACHE_MAX_ENTRIES);
+    Serial.printf("│ Bytes:          %-8u / %-17u │\n", usedBytes, budget);
+    Serial.printf("│ Hits:           %-28u │\n", hits);
+    Serial.printf("│ Misses:         %-28u │\n", misses);
+    Serial.printf("│ Evictions:      %-28u │\n", evictions);
+    Serial.printf("│ Not Found:      %-28u │\n", notFound);
+    Serial.printf("│ Hit Rate:       %-26.1f %% │\n", getHitRate());
+    Serial.println("└─────────────────────────────────────────────────┘");
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PRIVATE HELPERS (call with lock held unless noted)
+// ═══════════════════════════════════════════════════════════════════════════
+
+int StaticFileCache::findEntry(const char *path, bool acceptGzip)
+{
+    for (int i = 0; i < STATIC_CACHE_MAX_ENTRIES; i++)
+    {
+        if (entries[i].asset && entries[i].acceptGzip == acceptGzip &&
+            strcmp(entries[i].path, path) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Find a free slot, evicting least recently used entries
+ * @param bytesNeeded Size of the body to insert
+ * @return Slot index or -1 if the body does not fit the budget
+ */
+int StaticFileCache::claimSlot(size_t bytesNeeded)
+{
+    if (bytesNeeded > budget)
+        return -1;
+
+    while (true)
+    {
+        int freeSlot = -1;
+        int oldest = -1;
+        for (int i = 0; i < STATIC_CACHE_MAX_ENTRIES; i++)
+        {
+            if (!entries[i].asset)
+            {
+                if (freeSlot < 0)
+                    freeSlot = i;
+            }
+            else if (oldest < 0 || entries[i].lastUsed < entries[oldest].lastUsed)
+            {
+                oldest = i;
+            }
+        }
+
+        if (freeSlot >= 0 && usedBytes + bytesNeeded <= budget)
+            return freeSlot;
+        if (oldest < 0)
+            return -1;
+
+        evict(oldest);
+    }
+}
+
+void StaticFileCache::evict(int index)
+{
+    usedBytes -= entries[index].asset->length;
+    entries[index].asset.reset();
+    entries[index].path[0] = '\0';
+    entries[index].lastUsed = 0;
+    evictions++;
+}
+
+uint8_t *StaticFileCache::allocate(size_t size)
+{
+#ifdef BOARD_HAS_PSRAM
+    if (usePSRAM)
+    {
+        return (uint8_t *)ps_malloc(size);
+    }
+#endif
+    // Do not starve the rest of the system for a cache entry
+    if (ESP.getFreeHeap() < size + STATIC_CACHE_MIN_FREE_HEAP)
+    {
+        return nullptr;
+    }
+    return (uint8_t *)malloc(size);
+}
+
+/**
+ * @brief Read a file body from SPIFFS (no lock held)
+ * @param found Set when the file (or its .gz variant) exists
+ *
+ * Prefers a pre-compressed "<path>.gz" variant when the client accepts
+ * gzip.
+ */
+CachedAssetPtr StaticFileCache::loadFromFlash(const char *path, bool acceptGzip, bool &found)
+{
+    char gzPath[STATIC_CACHE_PATH_LEN + 3];
+    snprintf(gzPath, sizeof(gzPath), "%s.gz", path);
+
+    bool gzipped = acceptGzip && SPIFFS.exists(gzPath);
+    if (!gzipped && !SPIFFS.exists(path))
+    {
+        found = false;
+        return nullptr;
+    }
+    found = true;
+
+    File file = SPIFFS.open(gzipped ? gzPath : path, "r");
+    if (!file || file.isDirectory())
+    {
+        return nullptr;
+    }
+
+    size_t size = file.size();
+    if (size == 0 || size > STATIC_CACHE_MAX_FILE)
+    {
+        file.close();
+        bypasses++;
+        return nullptr;
+    }
+
+    uint8_t *buffer = allocate(size);
+    if (buffer == nullptr)
+    {
+        file.close();
+        bypasses++;
+        return nullptr;
+    }
+
+    size_t read = file.read(buffer, size);
+    file.close();
+    if (read != size)
+    {
+        free(buffer);
+        DEBUG_PRINTF("[CACHE] Short read on %s\n", path);
+        return nullptr;
+    }
+
+    return CachedAssetPtr(new CachedAsset(buffer, size, gzipped, getContentType(path)));
+}
@@ -0,0 +1,113 @@
+/**
+ * @file StaticFileCache.h
+ * @brief In-RAM LRU cache for static web assets
+ *
+ * Keeps the bodies of the most requested SPIFFS assets (index.html,
+ * style.css, script.js, ...) in RAM so repeated page loads are served
+ * without touching flash. Bodies live in PSRAM when the board has it,
+ * otherwise in regular heap under a fixed byte budget.
+ *
+ * If a pre-compressed "<file>.gz" exists next to an asset, the
+ * compressed body is cached and served with "Content-Encoding: gzip" to
+ * clients that accept it. Clients that do not get the plain file, cached
+ * as a separate entry.
+ *
+ * Cached bodies are reference counted, so an entry evicted while a
+ * response is still streaming stays valid until that response is done.
+ */
+
+#ifndef STATIC_FILE_CACHE_H
+#define STATIC_FILE_CACHE_H
+
+#include <Arduino.h>
+#include <memory>
+#include "../config.h"
+
+/**
+ * @brief Immutable cached file body
+ */
+struct CachedAsset
+{
+    uint8_t *data;
+    size_t length;
+    bool gzipped;
+    const char *contentType;
+
+    CachedAsset(uint8_t *buffer, size_t len, bool gz, const char *type)
+        : data(buffer), length(len), gzipped(gz), contentType(type) {}
+    ~CachedAsset() { free(data); }
+
+    CachedAsset(const CachedAsset &) = delete;
+    CachedAsset &operator=(const CachedAsset &) = delete;
+};
+
+typedef std::shared_ptr<CachedAsset> CachedAssetPtr;
+
+class StaticFileCache
+{
+private:
+    struct Entry
+    {
+        char path[STATIC_CACHE_PATH_LEN];
+        bool acceptGzip; // Entry answers clients that accept gzip
+        CachedAssetPtr asset;
+        uint32_t lastUsed;
+    };
+
+    Entry entries[STATIC_CACHE_MAX_ENTRIES];
+    SemaphoreHandle_t lock;
+
+    size_t budget;
+    size_t usedBytes;
+    uint32_t useCounter;
+    bool enabled;
+    bool usePSRAM;
+
+    // Statistics
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t bypasses;
+    uint32_t notFound;
+
+    int findEntry(const char *path, bool acceptGzip);
+    int claimSlot(size_t bytesNeeded);
+    void evict(int index);
+    CachedAssetPtr loadFromFlash(const char *path, bool acceptGzip, bool &found);
+    uint8_t *allocate(size_t size);
+
+public:
+    StaticFileCache();
+
+    bool begin(size_t budgetBytes = STATIC_CACHE_BUDGET);
+
+    // Returns the cached body, loading it from SPIFFS on a miss.
+    // Returns nullptr if the file is missing or cannot be cached.
+    // acceptGzip: the client sent "Accept-Encoding: gzip"
+    CachedAssetPtr get(const char *path, bool acceptGzip);
+
+    // Drop every cached body (filesystem changed)
+    void invalidateAll();
+    // Enable/disable caching (disabled while the filesystem is rewritten)
+    void setEnabled(bool enable);
+    bool isEnabled() { return enabled; }
+
+    static bool isCacheable(const char *path);
+    static const char *getContentType(const char *path);
+
+    // Statistics
+    uint32_t getHits() { return hits; }
+    uint32_t getMisses() { return misses; }
+    uint32_t getEvictions() { return evictions; }
+    uint32_t getBypasses() { return bypasses; }
+    uint32_t getNotFound() { return notFound; }
+    uint8_t getEntryCount();
+    size_t getUsedBytes() { return usedBytes; }
+    size_t getBudget() { return budget; }
+    float getHitRate();
+    void printStatus();
+};
+
+extern StaticFileCache staticFileCache;
+
+#endif // STATIC_FILE_CACHE_H
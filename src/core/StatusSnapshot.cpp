@@ -0,0 +1,316 @@
+/**
+ * @file StatusSnapshot.cpp
+ * @brief Implementation of pre-serialized system status document
+ */
+
+#include "StatusSnapshot.h"
+#include "WebServer.h"
+#include "WiFiManager.h"
+#include "OTAManager.h"
+#include "ESPNowComm.h"
+#include "StaticFileCache.h"
+#include "EventStream.h"
+#include "sensors/SensorManager.h"
+#include "../utils/ResponseWriter.h"
+#include <WiFi.h>
+#include <SPIFFS.h>
+
+extern SensorManager sensorManager;
+extern OTAManager otaManager;
+extern ESPNowComm espnowComm;
+
+// Global instance
+StatusSnapshot statusSnapshot;
+
+/**
+ * @brief Print tee that hashes what it forwards (FNV-1a)
+ */
+class DigestPrint : public Print
+{
+private:
+    Print &out;
+    uint32_t hash;
+
+public:
+    explicit DigestPrint(Print &output) : out(output), hash(2166136261u) {}
+
+    size_t write(uint8_t c) override
+    {
+        hash = (hash ^ c) * 16777619u;
+        return out.write(c);
+    }
+
+    size_t write(const uint8_t *data, size_t size) override
+    {
+        for (size_t i = 0; i < size; i++)
+            hash = (hash ^ data[i]) * 16777619u;
+        return out.write(data, size);
+    }
+
+    uint32_t digest() const { return hash; }
+};
+
+/**
+ * @brief Constructor
+ */
+StatusSnapshot::StatusSnapshot()
+{
+    buffer[0] = '\0';
+    scratch[0] = '\0';
+    length = 0;
+    generation = 0;
+    bootNonce = 0;
+    contentDigest = 0;
+    lock = nullptr;
+    lastRefresh = 0;
+    lastSlowRefresh = 0;
+    storageTotal = 0;
+    storageUsed = 0;
+}
+
+/**
+ * @brief Create lock and build the first snapshot
+ * @return true if ready
+ */
+bool StatusSnapshot::begin()
+{
+    if (lock == nullptr)
+    {
+        lock = xSemaphoreCreateMutex();
+        if (lock == nullptr)
+            return false;
+    }
+
+    // generation restarts at 1 on every boot; the nonce keeps an ETag
+    // saved before a reboot from matching a different document
+    bootNonce = esp_random();
+
+    refreshSlowFields();
+    refresh();
+    return true;
+}
+
+/**
+ * @brief Rebuild when STATUS_SNAPSHOT_INTERVAL has elapsed
+ */
+void StatusSnapshot::update()
+{
+    if (lock == nullptr)
+        return;
+
+    unsigned long now = millis();
+    if (now - lastSlowRefresh >= STATUS_SLOW_REFRESH)
+    {
+        refreshSlowFields();
+    }
+    if (now - lastRefresh >= STATUS_SNAPSHOT_INTERVAL)
+    {
+        refresh();
+    }
+}
+
+/**
+ * @brief Rebuild the document now and publish it
+ */
+void StatusSnapshot::refresh()
+{
+    if (lock == nullptr)
+        return;
+
+    lastRefresh = millis();
+    uint32_t nextGeneration;
+    size_t len = build(nextGeneration);
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    memcpy(buffer, scratch, len + 1);
+    length = len;
+    generation = nextGeneration;
+    xSemaphoreGive(lock);
+}
+
+/**
+ * @brief Query SPIFFS usage (slow - walks the filesystem)
+ */
+void StatusSnapshot::refreshSlowFields()
+{
+    lastSlowRefresh = millis();
+    storageTotal = SPIFFS.totalBytes();
+    storageUsed = SPIFFS.usedBytes();
+}
+
+/**
+ * @brief Serialize current status into scratch
+ * @param nextGeneration Generation of the new document: unchanged unless
+ *        some field differs from the published one
+ * @return Document length
+ */
+size_t StatusSnapshot::build(uint32_t &nextGeneration)
+{
+    FixedBufferPrint out(scratch, sizeof(scratch));
+    DigestPrint digest(out);
+    ResponseWriter json(digest);
+
+    uint32_t freeHeap = ESP.getFreeHeap();
+    uint32_t heapSize = ESP.getHeapSize();
+    bool connected = WiFi.status() == WL_CONNECTED;
+    wifi_mode_t mode = WiFi.getMode();
+    bool apMode = mode == WIFI_AP || mode == WIFI_AP_STA;
+
+    json.beginObject();
+    json.field("type", "status");
+    json.field("device", DEVICE_NAME);
+    json.field("version", FIRMWARE_VERSION);
+    json.field("uptime", millis());
+    json.field("freeHeap", freeHeap);
+    json.field("heapSize", heapSize);
+    json.field("heapUsage", 100 - (freeHeap * 100 / heapSize));
+    json.field("cpuUsage", 0); // Placeholder
+    json.field("wifiConnected", connected);
+    json.field("wifiRSSI", WiFi.RSSI());
+    json.field("ip", WiFi.localIP().toString());
+    json.field("mac", WiFi.macAddress());
+    json.field("ssid", WiFi.SSID());
+    json.field("clients", webServer.getClientCount());
+    json.field("streamClients", eventStream.getClientCount());
+    json.field("spiffs", storageTotal > 0);
+    json.field("sensorCount", sensorManager.getSensorCount());
+
+    // Storage info (slow fields)
+    json.field("storageTotal", storageTotal);
+    json.field("storageUsed", storageUsed);
+    json.field("storageUsage", storageTotal > 0 ? storageUsed * 100 / storageTotal : 0);
+
+    // WiFi Manager info
+    json.beginObject("wifi");
+    json.field("connected", connected);
+    json.field("ssid", WiFi.SSID());
+    json.field("rssi", WiFi.RSSI());
+    json.field("ip", WiFi.localIP().toString());
+    json.field("gateway", WiFi.gatewayIP().toString());
+    json.field("subnet", WiFi.subnetMask().toString());
+    json.field("dns", WiFi.dnsIP().toString());
+    json.field("apMode", apMode);
+    if (apMode)
+    {
+        json.field("apSSID", WiFi.softAPSSID());
+        json.field("apIP", WiFi.softAPIP().toString());
+        json.field("apClients", WiFi.softAPgetStationNum());
+    }
+    json.endObject();
+
+    // OTA Manager info
+    json.beginObject("ota");
+    json.field("initialized", otaManager.isInitialized());
+    json.field("hostname", otaManager.getHostname());
+    json.field("port", otaManager.getPort());
+    json.field("updating", otaManager.isUpdating());
+    json.field("progress", otaManager.getProgress());
+    json.field("totalUpdates", otaManager.getTotalUpdates());
+    json.field("failedUpdates", otaManager.getFailedUpdates());
+    json.endObject();
+
+    // ESP-NOW statistics
+    uint32_t sent, received, failed;
+    espnowComm.getStatistics(sent, received, failed);
+    json.beginObject("espnow");
+    json.field("sent", sent);
+    json.field("received", received);
+    json.field("failed", failed);
+    json.field("peers", espnowComm.getPeerCount());
+    json.endObject();
+
+    // Static file cache statistics
+    json.beginObject("staticCache");
+    json.field("enabled", staticFileCache.isEnabled());
+    json.field("entries", staticFileCache.getEntryCount());
+    json.field("bytes", staticFileCache.getUsedBytes());
+    json.field("budget", staticFileCache.getBudget());
+    json.field("hits", staticFileCache.getHits());
+    json.field("misses", staticFileCache.getMisses());
+    json.field("evictions", staticFileCache.getEvictions());
+    json.field("bypasses", staticFileCache.getBypasses());
+    json.field("notFound", staticFileCache.getNotFound());
+    json.field("hitRate", staticFileCache.getHitRate(), 1);
+    json.endObject();
+
+#if ENABLE_CAMERA
+    json.field("hasCamera", true);
+#else
+    json.field("hasCamera", false);
+#endif
+
+    // Last, once we know whether anything moved
+    nextGeneration = generation;
+    if (generation == 0 || digest.digest() != contentDigest)
+    {
+        contentDigest = digest.digest();
+        nextGeneration++;
+    }
+    json.field("generation", nextGeneration);
+    json.endObject();
+
+    if (out.overflowed())
+    {
+        DEBUG_PRINTLN("[STATUS] Snapshot truncated - increase STATUS_SNAPSHOT_SIZE");
+    }
+    return out.length();
+}
+
+/**
+ * @brief Send snapshot as HTTP response
+ *
+ * Replies 304 Not Modified when the client's If-None-Match matches the
+ * current boot and generation. The route must keep that header (see
+ * WebServerManager::setupRoutes); the server drops it otherwise.
+ */
+void StatusSnapshot::respond(AsyncWebServerRequest *request)
+{
+    if (lock == nullptr)
+    {
+        request->send(503, "application/json", "{\"error\":\"Status not ready\"}");
+        return;
+    }
+
+    char etag[24];
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    snprintf(etag, sizeof(etag), "\"%08x-%08x\"", bootNonce, generation);
+
+    if (request->hasHeader("If-None-Match") &&
+        request->header("If-None-Match") == etag)
+    {
+        xSemaphoreGive(lock);
+        AsyncWebServerResponse *response = request->beginResponse(304);
+        response->addHeader("ETag", etag);
+        request->send(response);
+        return;
+    }
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json", length + 1);
+    response->write((const uint8_t *)buffer, length);
+    xSemaphoreGive(lock);
+
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+}
+
+/**
+ * @brief Copy snapshot into a WebSocket message buffer
+ * @return Buffer ready for client->text(), or nullptr
+ */
+AsyncWebSocketMessageBuffer *StatusSnapshot::makeWebSocketBuffer(AsyncWebSocket *ws)
+{
+    if (lock == nullptr || ws == nullptr)
+        return nullptr;
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    AsyncWebSocketMessageBuffer *message = ws->makeBuffer(length);
+    if (message)
+    {
+        memcpy(message->get(), buffer, length);
+    }
+    xSemaphoreGive(lock);
+
+    return message;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file StatusSnapshot.h
+ * @brief Pre-serialized system status document
+ *
+ * /api/status and the WebSocket "getStatus" used to rebuild a ~1.5 KB
+ * JSON document on every request, querying SPIFFS, WiFi, OTA and
+ * ESP-NOW each time. The snapshot is instead rebuilt from the main loop
+ * (via webServer.handle()) once per STATUS_SNAPSHOT_INTERVAL, with slow
+ * fields such as SPIFFS usage refreshed every STATUS_SLOW_REFRESH.
+ *
+ * Requests only copy the finished buffer. A rebuild bumps the generation
+ * counter only when some field of the document changed; uptime moves on
+ * every rebuild, so each one normally is a new generation. The ETag is a
+ * per-boot nonce plus the generation, so a 304 always means the client
+ * holds the exact body: pollers sending If-None-Match faster than the
+ * rebuild interval get bodiless replies, and a tag saved before a reboot
+ * never matches.
+ */
+
+#ifndef STATUS_SNAPSHOT_H
+#define STATUS_SNAPSHOT_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "../config.h"
+
+class StatusSnapshot
+{
+private:
+    char buffer[STATUS_SNAPSHOT_SIZE];  // Published document
+    char scratch[STATUS_SNAPSHOT_SIZE]; // Next document, built unlocked
+    size_t length;
+    uint32_t generation;
+    uint32_t bootNonce;     // Random per boot, part of the ETag
+    uint32_t contentDigest; // Hash of the published document
+    SemaphoreHandle_t lock;
+
+    unsigned long lastRefresh;
+    unsigned long lastSlowRefresh;
+
+    // Slow fields (refreshed every STATUS_SLOW_REFRESH)
+    size_t storageTotal;
+    size_t storageUsed;
+
+    void refreshSlowFields();
+    size_t build(uint32_t &nextGeneration);
+
+public:
+    StatusSnapshot();
+
+    bool begin();
+
+    // Call from the main loop; rebuilds when the interval has elapsed
+    void update();
+    // Rebuild now (e.g. after a state change worth publishing)
+    void refresh();
+
+    // Serve as HTTP response (304 when If-None-Match matches)
+    void respond(AsyncWebServerRequest *request);
+    // Copy into a WebSocket message buffer (caller sends it)
+    AsyncWebSocketMessageBuffer *makeWebSocketBuffer(AsyncWebSocket *ws);
+
+    uint32_t getGeneration() { return generation; }
+    size_t getLength() { return length; }
+};
+
+extern StatusSnapshot statusSnapshot;
+
+#endif // STATUS_SNAPSHOT_H
@@ -0,0 +1,227 @@
+/**
+ * @file TaskRunner.cpp
+ * @brief Implementation of the sensor / storage / publish task split
+ */
+
+#include "TaskRunner.h"
+#include "../utils/ResponseWriter.h"
+
+// Global instance
+TaskRunner taskRunner;
+
+TaskRunner::TaskRunner()
+{
+    source = nullptr;
+    storeSink = nullptr;
+    publishSink = nullptr;
+    memset(&sensorStats, 0, sizeof(sensorStats));
+    memset(&storageStats, 0, sizeof(storageStats));
+    memset(&publishStats, 0, sizeof(publishStats));
+    sensorStats.name = "sensor";
+    storageStats.name = "storage";
+    publishStats.name = "publish";
+    sensorInterval = SENSOR_READ_INTERVAL;
+    sequence = 0;
+    storageDropped = 0;
+    publishDropped = 0;
+    maxLatency = 0;
+    totalLatency = 0;
+}
+
+bool TaskRunner::begin(SnapshotSource sourceFn, SnapshotSink store, SnapshotSink publish)
+{
+    if (isRunning() || sourceFn == nullptr)
+        return false;
+
+    source = sourceFn;
+    storeSink = store;
+    publishSink = publish;
+
+    // Consumers first, so the sensor task never notifies a null handle
+    if (xTaskCreatePinnedToCore(storageMain, "storage", TASK_STORAGE_STACK, this,
+                                TASK_STORAGE_PRIORITY, &storageStats.handle, TASK_STORAGE_CORE) != pdPASS ||
+        xTaskCreatePinnedToCore(publishMain, "publish", TASK_PUBLISH_STACK, this,
+                                TASK_PUBLISH_PRIORITY, &publishStats.handle, TASK_PUBLISH_CORE) != pdPASS ||
+        xTaskCreatePinnedToCore(sensorMain, "sensor", TASK_SENSOR_STACK, this,
+                                TASK_SENSOR_PRIORITY, &sensorStats.handle, TASK_SENSOR_CORE) != pdPASS)
+    {
+        // Don't leave half the pipeline running next to the loop fallback
+        end();
+        DEBUG_PRINTLN("[TASKS] ✗ Failed to create tasks");
+        return false;
+    }
+
+    DEBUG_PRINTF("[TASKS] sensor@core%d storage@core%d publish@core%d\n",
+                 TASK_SENSOR_CORE, TASK_STORAGE_CORE, TASK_PUBLISH_CORE);
+    return true;
+}
+
+/**
+ * @brief Delete whichever tasks exist, producer first
+ *
+ * Queued snapshots are discarded; begin() may be called again.
+ */
+void TaskRunner::end()
+{
+    TaskStats *order[] = {&sensorStats, &publishStats, &storageStats};
+    for (TaskStats *stats : order)
+    {
+        if (stats->handle != nullptr)
+        {
+            vTaskDelete(stats->handle);
+            stats->handle = nullptr;
+        }
+    }
+
+    while (storageQueue.front())
+        storageQueue.pop();
+    while (publishQueue.front())
+        publishQueue.pop();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TASK BODIES
+// ═══════════════════════════════════════════════════════════════════════════
+
+void TaskRunner::sensorMain(void *param)
+{
+    TaskRunner *self = static_cast<TaskRunner *>(param);
+    TickType_t lastWake = xTaskGetTickCount();
+
+    for (;;)
+    {
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(self->sensorInterval));
+        self->sample();
+    }
+}
+
+void TaskRunner::storageMain(void *param)
+{
+    TaskRunner *self = static_cast<TaskRunner *>(param);
+
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        self->drain(self->storageQueue, self->storeSink, self->storageStats, false);
+    }
+}
+
+void TaskRunner::publishMain(void *param)
+{
+    TaskRunner *self = static_cast<TaskRunner *>(param);
+
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        self->drain(self->publishQueue, self->publishSink, self->publishStats, true);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PRODUCER / CONSUMERS
+// ═══════════════════════════════════════════════════════════════════════════
+
+void TaskRunner::sample()
+{
+    uint32_t start = micros();
+    size_t length = source(scratch.json, sizeof(scratch.json));
+    if (length == 0 || length >= sizeof(scratch.json))
+        return;
+
+    scratch.sequence = ++sequence;
+    scratch.length = length;
+    scratch.sampledAt = start;
+    record(sensorStats, micros() - start);
+
+    if (storeSink)
+    {
+        if (storageQueue.push(scratch))
+            xTaskNotifyGive(storageStats.handle);
+        else
+            storageDropped++;
+    }
+
+    if (publishSink)
+    {
+        if (publishQueue.push(scratch))
+            xTaskNotifyGive(publishStats.handle);
+        else
+            publishDropped++;
+    }
+}
+
+void TaskRunner::drain(SpscQueue<SensorSnapshot, TASK_QUEUE_DEPTH> &queue, SnapshotSink sink,
+                       TaskStats &stats, bool measureLatency)
+{
+    const SensorSnapshot *snapshot;
+    while ((snapshot = queue.front()) != nullptr)
+    {
+        uint32_t start = micros();
+        sink(*snapshot);
+        uint32_t end = micros();
+        record(stats, end - start);
+
+        if (measureLatency)
+        {
+            uint32_t latency = end - snapshot->sampledAt;
+            totalLatency += latency;
+            if (latency > maxLatency)
+                maxLatency = latency;
+        }
+        queue.pop();
+    }
+}
+
+void TaskRunner::record(TaskStats &stats, uint32_t micros)
+{
+    stats.runs++;
+    stats.totalMicros += micros;
+    if (micros > stats.maxMicros)
+        stats.maxMicros = micros;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// STATISTICS
+// ═══════════════════════════════════════════════════════════════════════════
+
+void TaskRunner::writeTask(ResponseWriter &json, const TaskStats &stats, uint32_t stackSize)
+{
+    json.beginObject();
+    json.field("name", stats.name);
+    json.field("runs", (unsigned long)stats.runs);
+    json.field("avg", (unsigned long)(stats.runs ? stats.totalMicros / stats.runs : 0));
+    json.field("max", (unsigned long)stats.maxMicros);
+    json.field("stack", (unsigned long)stackSize);
+    // Bytes never touched; a small number means the stack is too tight
+    json.field("stackFree", (unsigned long)(stats.handle ? uxTaskGetStackHighWaterMark(stats.handle) : 0));
+    json.endObject();
+}
+
+void TaskRunner::writeStats(ResponseWriter &json)
+{
+    json.beginObject("tasks");
+    json.field("running", isRunning());
+    json.field("interval", (unsigned long)sensorInterval);
+    json.field("snapshots", (unsigned long)sequence);
+    json.field("latencyAvg", (unsigned long)(publishStats.runs ? totalLatency / publishStats.runs : 0));
+    json.field("latencyMax", (unsigned long)maxLatency);
+
+    json.beginObject("storageQueue");
+    json.field("depth", (unsigned long)storageQueue.size());
+    json.field("highWater", (unsigned long)storageQueue.getHighWater());
+    json.field("dropped", (unsigned long)storageDropped);
+    json.endObject();
+
+    json.beginObject("publishQueue");
+    json.field("depth", (unsigned long)publishQueue.size());
+    json.field("highWater", (unsigned long)publishQueue.getHighWater());
+    json.field("dropped", (unsigned long)publishDropped);
+    json.endObject();
+
+    json.beginArray("list");
+    writeTask(json, sensorStats, TASK_SENSOR_STACK);
+    writeTask(json, storageStats, TASK_STORAGE_STACK);
+    writeTask(json, publishStats, TASK_PUBLISH_STACK);
+    json.endArray();
+    json.endObject();
+}
@@ -0,0 +1,109 @@
+/**
+ * @file TaskRunner.h
+ * @brief Sensor sampling, storage and publishing on dedicated FreeRTOS tasks
+ *
+ * With everything in loop(), a slow SPIFFS write or log rotation delays
+ * the next sensor sample and the ESP-NOW traffic behind it. With
+ * ENABLE_TASK_SPLIT the sensor cycle is split into three pinned tasks:
+ *
+ *   sensor task ──► storageQueue ──► storage task  (DataLogger / SPIFFS)
+ *        │
+ *        └────────► publishQueue ──► publish task  (WebSocket, SSE, ESP-NOW)
+ *
+ * - sensor:  samples every interval with vTaskDelayUntil, so a slow
+ *            consumer cannot shift the sampling grid
+ * - storage: lowest priority, may block on flash for as long as it needs
+ * - publish: network sends, next to the WiFi stack on core 0
+ *
+ * Tasks exchange fixed-size snapshots through lock-free SPSC queues and
+ * wake consumers with task notifications. A full queue drops the snapshot
+ * (counted), so a stalled consumer never blocks sampling.
+ *
+ * What a snapshot contains and what "store"/"publish" mean is supplied
+ * by main.cpp as callbacks, the same ones the single-loop path uses.
+ */
+
+#ifndef TASK_RUNNER_H
+#define TASK_RUNNER_H
+
+#include <Arduino.h>
+#include "../config.h"
+#include "../utils/SpscQueue.h"
+
+class ResponseWriter;
+
+/**
+ * @brief One round of sensor data, serialized once by the sensor task
+ */
+struct SensorSnapshot
+{
+    uint32_t sequence;
+    uint32_t sampledAt; // micros() when sampling started
+    uint16_t length;
+    char json[SENSOR_SNAPSHOT_SIZE];
+};
+
+// Fill buffer with JSON; return length (0 = nothing to send)
+typedef size_t (*SnapshotSource)(char *buffer, size_t size);
+typedef void (*SnapshotSink)(const SensorSnapshot &snapshot);
+
+class TaskRunner
+{
+private:
+    struct TaskStats
+    {
+        const char *name;
+        TaskHandle_t handle;
+        uint32_t runs;
+        uint32_t maxMicros;
+        uint64_t totalMicros;
+    };
+
+    SnapshotSource source;
+    SnapshotSink storeSink;
+    SnapshotSink publishSink;
+
+    SpscQueue<SensorSnapshot, TASK_QUEUE_DEPTH> storageQueue;
+    SpscQueue<SensorSnapshot, TASK_QUEUE_DEPTH> publishQueue;
+    SensorSnapshot scratch; // Sensor task's working snapshot
+
+    TaskStats sensorStats;
+    TaskStats storageStats;
+    TaskStats publishStats;
+
+    volatile uint32_t sensorInterval;
+    uint32_t sequence;
+    uint32_t storageDropped;
+    uint32_t publishDropped;
+    uint32_t maxLatency; // Sampling start to published (us)
+    uint64_t totalLatency;
+
+    static void sensorMain(void *param);
+    static void storageMain(void *param);
+    static void publishMain(void *param);
+
+    void sample();
+    void drain(SpscQueue<SensorSnapshot, TASK_QUEUE_DEPTH> &queue, SnapshotSink sink,
+               TaskStats &stats, bool measureLatency);
+    static void record(TaskStats &stats, uint32_t micros);
+    void writeTask(ResponseWriter &json, const TaskStats &stats, uint32_t stackSize);
+
+public:
+    TaskRunner();
+
+    // Create and start the three tasks; call once from setup()
+    bool begin(SnapshotSource source, SnapshotSink store, SnapshotSink publish);
+    void end();
+    bool isRunning() { return sensorStats.handle != nullptr; }
+
+    // Takes effect after the current wait
+    void setSensorInterval(uint32_t interval) { sensorInterval = interval; }
+    uint32_t getSensorInterval() { return sensorInterval; }
+
+    // Write "tasks":{...} member
+    void writeStats(ResponseWriter &json);
+};
+
+extern TaskRunner taskRunner;
+
+#endif // TASK_RUNNER_H
@@ -9,9 +9,22 @@
 #include "ESPNowComm.h"
 #include "WiFiManager.h"
 #include "OTAManager.h"
+#include "StaticFileCache.h"
+#include "StatusSnapshot.h"
+#include "RequestBody.h"
+#include "CommandDispatcher.h"
+#include "EventStream.h"
+#include "RouteProfiler.h"
+#include "TaskRunner.h"
+#include "../utils/ResponseWriter.h"
+#include "../utils/Metrics.h"
+#include "../utils/LoopProfiler.h"
+#include "../utils/Scheduler.h"
+#include "../utils/TimingWheel.h"
 #include <FS.h>
 #include <SPIFFS.h>
 #include <Update.h>
+#include <esp_timer.h>
 
 // External references (define these in your main.cpp)
 extern SensorManager sensorManager;
@@ -24,6 +37,222 @@ extern DataLogger dataLogger;
 // Global instance
 WebServerManager webServer;
 
+/**
+ * @brief Parse a POST body and run it through the command dispatcher
+ * @param command Command name, or nullptr to take it from the body's "type"
+ */
+static void dispatchRequestCommand(AsyncWebServerRequest *request, const char *command)
+{
+    size_t length;
+    const char *body = RequestBody::require(request, length);
+    if (!body)
+        return;
+
+    StaticJsonDocument<1024> doc;
+    DeserializationError error = deserializeJson(doc, body, length);
+    if (error)
+    {
+        request->send(400, "application/json", "{\"success\":false,\"error\":\"JSON parse error\"}");
+        return;
+    }
+
+    if (command == nullptr)
+    {
+        command = doc["type"];
+    }
+
+    CommandContext ctx(CMD_SOURCE_HTTP);
+    ctx.request = request;
+    commandDispatcher.dispatch(command, doc.as<JsonObjectConst>(), ctx);
+}
+
+/**
+ * @brief Headers-only response for HEAD requests
+ *
+ * Reports the Content-Length of the body a GET would return but never
+ * sends it. ESPAsyncWebServer 1.2 has no HEAD handling of its own.
+ */
+class HeadResponse : public AsyncBasicResponse
+{
+public:
+    HeadResponse(const char *contentType, size_t length)
+        : AsyncBasicResponse(200, contentType)
+    {
+        _contentLength = length;
+    }
+
+    void _respond(AsyncWebServerRequest *request) override
+    {
+        _state = RESPONSE_HEADERS;
+        String head = _assembleHead(request->version());
+        _writtenLength += request->client()->write(head.c_str(), head.length());
+        _state = RESPONSE_WAIT_ACK;
+    }
+};
+
+/**
+ * @brief GET route that keeps one request header for its handler
+ *
+ * ESPAsyncWebServer only keeps the headers a handler asks for in
+ * canHandle(); this route asks for its header explicitly instead of
+ * relying on what server->on() registers.
+ */
+class HeaderAwareHandler : public AsyncWebHandler
+{
+private:
+    const char *uri;
+    const char *header;
+    ArRequestHandlerFunction onRequest;
+
+public:
+    HeaderAwareHandler(const char *path, const char *name, ArRequestHandlerFunction handler)
+        : uri(path), header(name), onRequest(handler) {}
+
+    bool canHandle(AsyncWebServerRequest *request) override
+    {
+        if (request->method() != HTTP_GET || request->url() != uri)
+            return false;
+        request->addInterestingHeader(header);
+        return true;
+    }
+
+    void handleRequest(AsyncWebServerRequest *request) override
+    {
+        onRequest(request);
+    }
+
+    bool isRequestHandlerTrivial() override { return true; }
+};
+
+/**
+ * @brief Static file handler backed by the in-RAM asset cache
+ *
+ * Serves cacheable web assets from StaticFileCache and falls back to
+ * streaming from SPIFFS when a file is too large or memory is short.
+ * Everything else is left to the regular serveStatic handler.
+ *
+ * The gzip variant of an asset only goes to clients that accept it, and
+ * HEAD requests get the headers of the matching GET without the body.
+ */
+class CachedStaticHandler : public AsyncWebHandler
+{
+private:
+    static String resolvePath(AsyncWebServerRequest *request)
+    {
+        String path = request->url();
+        if (path.endsWith("/"))
+        {
+            path += "index.html";
+        }
+        return path;
+    }
+
+    static bool acceptsGzip(AsyncWebServerRequest *request)
+    {
+        AsyncWebHeader *header = request->getHeader("Accept-Encoding");
+        return header != nullptr && header->value().indexOf("gzip") >= 0;
+    }
+
+    static void sendHead(AsyncWebServerRequest *request, const char *contentType,
+                         size_t length, bool gzipped)
+    {
+        AsyncWebServerResponse *response = new HeadResponse(contentType, length);
+        if (gzipped)
+        {
+            response->addHeader("Content-Encoding", "gzip");
+        }
+        request->send(response);
+    }
+
+public:
+    bool canHandle(AsyncWebServerRequest *request) override
+    {
+        if (request->method() != HTTP_GET && request->method() != HTTP_HEAD)
+            return false;
+
+        const String &url = request->url();
+        if (url.startsWith("/api/") || url.startsWith("/debug/") || url == "/ws")
+            return false;
+
+        if (!StaticFileCache::isCacheable(resolvePath(request).c_str()))
+            return false;
+
+        // Headers are parsed after canHandle(); keep the one we need
+        request->addInterestingHeader("Accept-Encoding");
+        return true;
+    }
+
+    void handleRequest(AsyncWebServerRequest *request) override
+    {
+        String path = resolvePath(request);
+        const char *contentType = StaticFileCache::getContentType(path.c_str());
+        bool gzipOk = acceptsGzip(request);
+        bool head = request->method() == HTTP_HEAD;
+
+        CachedAssetPtr asset = staticFileCache.get(path.c_str(), gzipOk);
+        if (asset)
+        {
+            if (head)
+            {
+                sendHead(request, asset->contentType, asset->length, asset->gzipped);
+                return;
+            }
+
+            AsyncWebServerResponse *response = request->beginResponse(
+                asset->contentType, asset->length,
+                [asset](uint8_t *buffer, size_t maxLen, size_t index) -> size_t
+                {
+                    size_t remaining = asset->length - index;
+                    size_t chunk = remaining < maxLen ? remaining : maxLen;
+                    memcpy(buffer, asset->data + index, chunk);
+                    return chunk;
+                });
+            if (asset->gzipped)
+            {
+                response->addHeader("Content-Encoding", "gzip");
+            }
+            request->send(response);
+            return;
+        }
+
+        // Not cacheable right now - stream from flash
+        String gzPath = path + ".gz";
+        bool gzipped = gzipOk && SPIFFS.exists(gzPath);
+        if (gzipped || SPIFFS.exists(path))
+        {
+            if (head)
+            {
+                File file = SPIFFS.open(gzipped ? gzPath : path, "r");
+                sendHead(request, contentType, file ? file.size() : 0, gzipped);
+                file.close();
+            }
+            else if (gzipped)
+            {
+                AsyncWebServerResponse *response = request->beginResponse(SPIFFS, gzPath, contentType);
+                response->addHeader("Content-Encoding", "gzip");
+                request->send(response);
+            }
+            else
+            {
+                request->send(SPIFFS, path, contentType);
+            }
+            return;
+        }
+
+        // Only a compressed copy exists and the client cannot take it
+        if (SPIFFS.exists(gzPath))
+        {
+            request->send(406, "text/plain", "406 - Not Acceptable (gzip only)");
+            return;
+        }
+
+        String message = "404 - Not Found\n\nURI: " + request->url();
+        request->send(404, "text/plain", message);
+    }
+
+    bool isRequestHandlerTrivial() override { return true; }
+};
+
 /**
  * @brief Constructor
  */
@@ -81,6 +310,7 @@ bool WebServerManager::begin(uint16_t port, uint16_t wsPort)
 
     Serial.printf("HTTP Port:      %d\n", port);
     Serial.printf("WebSocket Path: /ws\n");
+    Serial.printf("Event Stream:   /api/stream\n");
     Serial.printf("SPIFFS:         %s\n", spiffsAvailable ? "Available" : "Not Available");
 
     // Setup WebSocket
@@ -89,9 +319,22 @@ bool WebServerManager::begin(uint16_t port, uint16_t wsPort)
     // Add WebSocket handler to server
     server->addHandler(ws);
 
+    // SSE feed at /api/stream (ahead of the catch-all handlers)
+    eventStream.begin(server);
+
     // Setup HTTP routes
     setupRoutes();
 
+    // Expose module statistics at /metrics
+    setupMetrics();
+
+    // Build the first status document before requests arrive
+    statusSnapshot.begin();
+
+    // Push WiFi scan results to WebSocket clients when a scan finishes
+    wifiManager.setOnScanComplete([](uint32_t scanId, bool success)
+                                  { webServer.broadcastWiFiScan(scanId, success); });
+
     // Start server
     server->begin();
     serverStartTime = millis();
@@ -244,13 +487,16 @@ void WebServerManager::onWebSocketEvent(AsyncWebSocket *server,
 
 /**
  * @brief Process incoming WebSocket message
+ *
+ * Every message is {"type": <command>, ...args}; the command table lives
+ * in CommandDispatcher so REST and ESP-NOW share the same handlers.
  */
 void WebServerManager::processWebSocketMessage(AsyncWebSocketClient *client,
                                                uint8_t *data,
                                                size_t len)
 {
-    StaticJsonDocument<512> doc;
-    DeserializationError error = deserializeJson(doc, (char *)data);
+    StaticJsonDocument<1024> doc;
+    DeserializationError error = deserializeJson(doc, (const char *)data, len);
 
     if (error)
     {
@@ -264,286 +510,9 @@ void WebServerManager::processWebSocketMessage(AsyncWebSocketClient *client,
 
     Serial.printf("WebSocket message type: %s\n", type);
 
-    // GET STATUS
-    if (strcmp(type, "getStatus") == 0)
-    {
-        StaticJsonDocument<1536> response;
-        response["type"] = "status";
-        response["device"] = DEVICE_NAME;
-        response["version"] = FIRMWARE_VERSION;
-        response["uptime"] = millis();
-        response["freeHeap"] = ESP.getFreeHeap();
-        response["heapSize"] = ESP.getHeapSize();
-        response["heapUsage"] = (100 - (ESP.getFreeHeap() * 100 / ESP.getHeapSize()));
-        response["wifiConnected"] = WiFi.status() == WL_CONNECTED;
-        response["wifiRSSI"] = WiFi.RSSI();
-        response["ip"] = WiFi.localIP().toString();
-        response["mac"] = WiFi.macAddress();
-        response["ssid"] = WiFi.SSID();
-        response["sensorCount"] = sensorManager.getSensorCount();
-        response["clients"] = clientCount;
-
-        // WiFi info
-        JsonObject wifi = response.createNestedObject("wifi");
-        wifi["connected"] = WiFi.status() == WL_CONNECTED;
-        wifi["apMode"] = WiFi.getMode() == WIFI_AP || WiFi.getMode() == WIFI_AP_STA;
-
-        // OTA info
-        JsonObject ota = response.createNestedObject("ota");
-        ota["updating"] = otaManager.isUpdating();
-        ota["progress"] = otaManager.getProgress();
-
-        // ESP-NOW stats
-        JsonObject espnow = response.createNestedObject("espnow");
-        uint32_t sent, received, failed;
-        espnowComm.getStatistics(sent, received, failed);
-        espnow["sent"] = sent;
-        espnow["received"] = received;
-        espnow["failed"] = failed;
-        espnow["peers"] = espnowComm.getPeerCount();
-
-        char buffer[1536];
-        serializeJson(response, buffer);
-        client->text(buffer);
-    }
-    // GET SENSOR DATA
-    else if (strcmp(type, "getSensorData") == 0)
-    {
-        StaticJsonDocument<1024> response;
-        sensorManager.getAllSensorData(response.to<JsonObject>());
-        response["type"] = "sensor";
-
-        char buffer[1024];
-        serializeJson(response, buffer);
-        client->text(buffer);
-    }
-    // SET ACTUATOR
-    else if (strcmp(type, "setActuator") == 0)
-    {
-        const char *actuator = doc["actuator"];
-        int value = doc["value"];
-
-        if (actuator)
-        {
-            actuatorManager.setActuator(actuator, value);
-
-            StaticJsonDocument<256> response;
-            response["type"] = "actuatorSet";
-            response["actuator"] = actuator;
-            response["value"] = value;
-            response["success"] = true;
-
-            char buffer[256];
-            serializeJson(response, buffer);
-            ws->textAll(buffer);
-        }
-    }
-    // GET ACTUATOR STATUS
-    else if (strcmp(type, "getActuatorStatus") == 0)
-    {
-        String status = actuatorManager.getStatus();
-
-        StaticJsonDocument<1024> response;
-        deserializeJson(response, status);
-        response["type"] = "actuatorStatus";
-
-        char buffer[1024];
-        serializeJson(response, buffer);
-        client->text(buffer);
-    }
-    // GET PEERS
-    else if (strcmp(type, "getPeers") == 0)
-    {
-        StaticJsonDocument<1024> response;
-        response["type"] = "peers";
-        JsonArray peers = response.createNestedArray("peers");
-
-        uint8_t peerCount = espnowComm.getPeerCount();
-        for (uint8_t i = 0; i < peerCount; i++)
-        {
-            PeerInfo *peer = espnowComm.getPeerInfo(i);
-            if (peer && peer->active)
-            {
-                JsonObject peerObj = peers.createNestedObject();
-                peerObj["mac"] = espnowComm.getMacString(peer->mac);
-                peerObj["name"] = peer->name;
-                peerObj["lastSeen"] = peer->lastSeen;
-                peerObj["messagesSent"] = peer->messagesSent;
-                peerObj["messagesReceived"] = peer->messagesReceived;
-                peerObj["connected"] = (millis() - peer->lastSeen) < 60000;
-            }
-        }
-
-        char buffer[1024];
-        serializeJson(response, buffer);
-        client->text(buffer);
-    }
-    // SEND TO PEER
-    else if (strcmp(type, "sendToPeer") == 0)
-    {
-        const char *peerMac = doc["peer"];
-        JsonVariant messageVar = doc["message"];
-
-        if (peerMac && !messageVar.isNull())
-        {
-            uint8_t mac[6];
-            if (sscanf(peerMac, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
-                       &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]) == 6)
-            {
-
-                String messageStr;
-                serializeJson(messageVar, messageStr);
-
-                bool success = espnowComm.sendMessage(mac, MSG_CUSTOM, messageStr.c_str());
-
-                dataLogger.logEvent(("Sent to " + String(peerMac) + ": " + messageStr).c_str());
-
-                StaticJsonDocument<256> response;
-                response["type"] = "espnowMessage";
-                response["direction"] = "sent";
-                response["peer"] = peerMac;
-                response["message"] = messageVar;
-                response["success"] = success;
-
-                char buffer[256];
-                serializeJson(response, buffer);
-                ws->textAll(buffer);
-            }
-        }
-    }
-    // TRIGGER ALERT
-    else if (strcmp(type, "triggerAlert") == 0)
-    {
-        const char *message = doc["message"] | "Alert triggered";
-
-        actuatorManager.triggerAlert();
-
-        StaticJsonDocument<256> response;
-        response["type"] = "alert";
-        response["message"] = message;
-
-        char buffer[256];
-        serializeJson(response, buffer);
-        ws->textAll(buffer);
-
-        espnowComm.sendToAllPeers(MSG_ALERT, message);
-    }
-    // WiFi SCAN
-    else if (strcmp(type, "wifiScan") == 0)
-    {
-        int n = WiFi.scanNetworks();
-
-        StaticJsonDocument<2048> response;
-        response["type"] = "wifiNetworks";
-        JsonArray networks = response.createNestedArray("networks");
-
-        for (int i = 0; i < n; i++)
-        {
-            JsonObject net = networks.createNestedObject();
-            net["ssid"] = WiFi.SSID(i);
-            net["rssi"] = WiFi.RSSI(i);
-            net["encryption"] = (WiFi.encryptionType(i) == WIFI_AUTH_OPEN) ? "Open" : "Secured";
-        }
-
-        char buffer[2048];
-        serializeJson(response, buffer);
-        client->text(buffer);
-    }
-    // WiFi CONNECT
-    else if (strcmp(type, "wifiConnect") == 0)
-    {
-        const char *ssid = doc["ssid"];
-        const char *password = doc["password"];
-
-        if (ssid)
-        {
-            WiFi.begin(ssid, password);
-
-            StaticJsonDocument<128> response;
-            response["type"] = "wifiConnecting";
-            response["ssid"] = ssid;
-
-            char buffer[128];
-            serializeJson(response, buffer);
-            client->text(buffer);
-        }
-    }
-    // LIST FILES
-    else if (strcmp(type, "listFiles") == 0)
-    {
-        listSPIFFSFiles(client);
-    }
-    // GET CONFIG
-    else if (strcmp(type, "getConfig") == 0)
-    {
-        StaticJsonDocument<512> response;
-        response["type"] = "config";
-        response["deviceName"] = DEVICE_NAME;
-        response["sensorInterval"] = SENSOR_READ_INTERVAL;
-
-        char buffer[512];
-        serializeJson(response, buffer);
-        client->text(buffer);
-    }
-    // SAVE CONFIG
-    else if (strcmp(type, "saveConfig") == 0)
-    {
-        File configFile = SPIFFS.open("/config.json", FILE_WRITE);
-        if (configFile)
-        {
-            serializeJson(doc, configFile);
-            configFile.close();
-
-            StaticJsonDocument<128> response;
-            response["type"] = "configSaved";
-            response["success"] = true;
-
-            char buffer[128];
-            serializeJson(response, buffer);
-            client->text(buffer);
-        }
-    }
-    // RESTART
-    else if (strcmp(type, "restart") == 0)
-    {
-        StaticJsonDocument<128> response;
-        response["type"] = "restarting";
-
-        char buffer[128];
-        serializeJson(response, buffer);
-        client->text(buffer);
-
-        delay(1000);
-        ESP.restart();
-    }
-}
-
-/**
- * @brief List SPIFFS files to WebSocket client
- */
-void WebServerManager::listSPIFFSFiles(AsyncWebSocketClient *client)
-{
-    StaticJsonDocument<1024> response;
-    response["type"] = "fileList";
-    JsonArray files = response.createNestedArray("files");
-
-    if (spiffsAvailable)
-    {
-        File root = SPIFFS.open("/");
-        File file = root.openNextFile();
-
-        while (file)
-        {
-            JsonObject fileObj = files.createNestedObject();
-            fileObj["name"] = file.name();
-            fileObj["size"] = file.size();
-            file = root.openNextFile();
-        }
-    }
-
-    char buffer[1024];
-    serializeJson(response, buffer);
-    client->text(buffer);
+    CommandContext ctx(CMD_SOURCE_WEBSOCKET);
+    ctx.client = client;
+    commandDispatcher.dispatch(type, doc.as<JsonObjectConst>(), ctx);
 }
 
 /**
@@ -588,642 +557,23 @@ void WebServerManager::removeClient(AsyncWebSocketClient *client)
     }
 }
 
-/**
- * @brief Setup all HTTP routes
- */
-void WebServerManager::setupRoutes()
-{
-    // ───────────────────────────────────────────────────────────────────────
-    // STATIC FILE SERVING (SPIFFS)
-    // ───────────────────────────────────────────────────────────────────────
-    if (spiffsAvailable)
-    {
-        Serial.println("Setting up SPIFFS file server...");
-        server->serveStatic("/", SPIFFS, "/").setDefaultFile("index.html");
-        Serial.println("✓ SPIFFS static file server configured");
-    }
-
-    // ───────────────────────────────────────────────────────────────────────
-    // DEBUG ENDPOINT
-    // ───────────────────────────────────────────────────────────────────────
-    server->on("/debug/files", HTTP_GET, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        
-        String response = "<!DOCTYPE html><html><head><title>SPIFFS Files</title>";
-        response += "<style>body {font-family: Arial, sans-serif; margin: 20px; background: #f5f5f5;}";
-        response += "h1 {color: #333;} ul {list-style-type: none; padding: 0;}";
-        response += "li {padding: 8px; margin: 5px 0; background: white; border-radius: 4px;}</style></head><body>";
-        response += "<h1>🗂️ SPIFFS Files Debug</h1>";
-        
-        if (webServer.spiffsAvailable) {
-            response += "<p><strong>SPIFFS Status:</strong> ✓ Available</p>";
-            response += "<h2>All Files:</h2><ul>";
-            File root = SPIFFS.open("/");
-            File file = root.openNextFile();
-            
-            int fileCount = 0;
-            while(file){
-                String filePath = String(file.path());
-                response += "<li>📄 <strong>" + filePath + "</strong> (" + String(file.size()) + " bytes)";
-                response += " <a href='" + filePath + "' target='_blank'>Open</a></li>";
-                file = root.openNextFile();
-                fileCount++;
-            }
-            response += "</ul><p>Total files: " + String(fileCount) + "</p>";
-        } else {
-            response += "<p><strong>SPIFFS Status:</strong> ✗ Not Available</p>";
-        }
-        
-        response += "<hr><p><a href='/'>← Back to Dashboard</a></p></body></html>";
-        request->send(200, "text/html", response); });
-
-    // ───────────────────────────────────────────────────────────────────────
-    // SYSTEM STATUS API (Enhanced with WiFi & OTA info)
-    // ───────────────────────────────────────────────────────────────────────
-    server->on("/api/status", HTTP_GET, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        
-        StaticJsonDocument<1536> doc;
-        doc["device"] = DEVICE_NAME;
-        doc["version"] = FIRMWARE_VERSION;
-        doc["uptime"] = millis();
-        doc["freeHeap"] = ESP.getFreeHeap();
-        doc["heapSize"] = ESP.getHeapSize();
-        doc["heapUsage"] = (100 - (ESP.getFreeHeap() * 100 / ESP.getHeapSize()));
-        doc["cpuUsage"] = 0; // Placeholder
-        doc["wifiConnected"] = WiFi.status() == WL_CONNECTED;
-        doc["wifiRSSI"] = WiFi.RSSI();
-        doc["ip"] = WiFi.localIP().toString();
-        doc["mac"] = WiFi.macAddress();
-        doc["ssid"] = WiFi.SSID();
-        doc["clients"] = webServer.clientCount;
-        doc["spiffs"] = webServer.spiffsAvailable;
-        doc["sensorCount"] = sensorManager.getSensorCount();
-        
-        // Storage info
-        size_t totalBytes = SPIFFS.totalBytes();
-        size_t usedBytes = SPIFFS.usedBytes();
-        doc["storageTotal"] = totalBytes;
-        doc["storageUsed"] = usedBytes;
-        doc["storageUsage"] = (usedBytes * 100 / totalBytes);
-        
-        // WiFi Manager info
-        JsonObject wifi = doc.createNestedObject("wifi");
-        wifi["connected"] = WiFi.status() == WL_CONNECTED;
-        wifi["ssid"] = WiFi.SSID();
-        wifi["rssi"] = WiFi.RSSI();
-        wifi["ip"] = WiFi.localIP().toString();
-        wifi["gateway"] = WiFi.gatewayIP().toString();
-        wifi["subnet"] = WiFi.subnetMask().toString();
-        wifi["dns"] = WiFi.dnsIP().toString();
-        wifi["apMode"] = WiFi.getMode() == WIFI_AP || WiFi.getMode() == WIFI_AP_STA;
-        if (wifi["apMode"]) {
-            wifi["apSSID"] = WiFi.softAPSSID();
-            wifi["apIP"] = WiFi.softAPIP().toString();
-            wifi["apClients"] = WiFi.softAPgetStationNum();
-        }
-        
-        // OTA Manager info
-        JsonObject ota = doc.createNestedObject("ota");
-        ota["initialized"] = otaManager.isInitialized();
-        ota["hostname"] = otaManager.getHostname();
-        ota["port"] = otaManager.getPort();
-        ota["updating"] = otaManager.isUpdating();
-        ota["progress"] = otaManager.getProgress();
-        ota["totalUpdates"] = otaManager.getTotalUpdates();
-        ota["failedUpdates"] = otaManager.getFailedUpdates();
-        
-        // ESP-NOW statistics
-        JsonObject espnow = doc.createNestedObject("espnow");
-        uint32_t sent, received, failed;
-        espnowComm.getStatistics(sent, received, failed);
-        espnow["sent"] = sent;
-        espnow["received"] = received;
-        espnow["failed"] = failed;
-        espnow["peers"] = espnowComm.getPeerCount();
-
-#if ENABLE_CAMERA
-        doc["hasCamera"] = true;
-#else
-        doc["hasCamera"] = false;
-#endif
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response); });
-
-    // ───────────────────────────────────────────────────────────────────────
-    // WIFI MANAGER ENDPOINTS
-    // ───────────────────────────────────────────────────────────────────────
-
-    // Scan WiFi Networks
-    server->on("/api/wifi/scan", HTTP_GET, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        
-        int n = WiFi.scanNetworks();
-        
-        StaticJsonDocument<2048> doc;
-        JsonArray networks = doc.createNestedArray("networks");
-        
-        for (int i = 0; i < n; i++) {
-            JsonObject net = networks.createNestedObject();
-            net["ssid"] = WiFi.SSID(i);
-            net["rssi"] = WiFi.RSSI(i);
-            net["encryption"] = (WiFi.encryptionType(i) == WIFI_AUTH_OPEN) ? "Open" : "Secured";
-            net["channel"] = WiFi.channel(i);
-        }
-        
-        doc["count"] = n;
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response); });
-
-    // Connect to WiFi Network
-    server->on("/api/wifi/connect", HTTP_POST, [](AsyncWebServerRequest *request) {}, NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
-               {
-        webServer.totalRequests++;
-        
-        StaticJsonDocument<256> doc;
-        deserializeJson(doc, (char*)data);
-        
-        const char* ssid = doc["ssid"];
-        const char* password = doc["password"];
-        
-        if (ssid) {
-            // Attempt to connect
-            WiFi.begin(ssid, password);
-            
-            // Wait up to 10 seconds
-            int timeout = 0;
-            while (WiFi.status() != WL_CONNECTED && timeout < 20) {
-                delay(500);
-                timeout++;
-            }
-            
-            if (WiFi.status() == WL_CONNECTED) {
-                request->send(200, "application/json", "{\"success\":true,\"ip\":\"" + WiFi.localIP().toString() + "\"}");
-            } else {
-                request->send(200, "application/json", "{\"success\":false,\"error\":\"Connection failed\"}");
-            }
-        } else {
-            request->send(400, "application/json", "{\"success\":false,\"error\":\"Missing SSID\"}");
-        } });
-
-    // Disconnect WiFi
-    server->on("/api/wifi/disconnect", HTTP_POST, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        WiFi.disconnect();
-        request->send(200, "application/json", "{\"success\":true}"); });
-
-    // Get WiFi Status
-    server->on("/api/wifi/status", HTTP_GET, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        
-        StaticJsonDocument<512> doc;
-        doc["connected"] = WiFi.status() == WL_CONNECTED;
-        doc["ssid"] = WiFi.SSID();
-        doc["rssi"] = WiFi.RSSI();
-        doc["ip"] = WiFi.localIP().toString();
-        doc["mac"] = WiFi.macAddress();
-        doc["gateway"] = WiFi.gatewayIP().toString();
-        doc["subnet"] = WiFi.subnetMask().toString();
-        doc["dns"] = WiFi.dnsIP().toString();
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response); });
-
-    // Start Access Point
-    server->on("/api/wifi/ap/start", HTTP_POST, [](AsyncWebServerRequest *request) {}, NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
-               {
-        webServer.totalRequests++;
-        
-        StaticJsonDocument<256> doc;
-        deserializeJson(doc, (char*)data);
-        
-        const char* ssid = doc["ssid"] | AP_SSID;
-        const char* password = doc["password"] | AP_PASSWORD;
-        
-        WiFi.softAP(ssid, password);
-        
-        StaticJsonDocument<256> response;
-        response["success"] = true;
-        response["ssid"] = ssid;
-        response["ip"] = WiFi.softAPIP().toString();
-        
-        char buffer[256];
-        serializeJson(response, buffer);
-        request->send(200, "application/json", buffer); });
-
-    // Stop Access Point
-    server->on("/api/wifi/ap/stop", HTTP_POST, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        WiFi.softAPdisconnect(true);
-        request->send(200, "application/json", "{\"success\":true}"); });
-
-    // ───────────────────────────────────────────────────────────────────────
-    // OTA UPDATE ENDPOINTS
-    // ───────────────────────────────────────────────────────────────────────
-
-    // OTA Status
-    server->on("/api/ota/status", HTTP_GET, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        
-        StaticJsonDocument<512> doc;
-        doc["initialized"] = otaManager.isInitialized();
-        doc["hostname"] = otaManager.getHostname();
-        doc["port"] = otaManager.getPort();
-        doc["updating"] = otaManager.isUpdating();
-        doc["progress"] = otaManager.getProgress();
-        doc["state"] = otaManager.getStatusString();
-        doc["totalUpdates"] = otaManager.getTotalUpdates();
-        doc["failedUpdates"] = otaManager.getFailedUpdates();
-        doc["lastUpdate"] = otaManager.getLastUpdateTime();
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response); });
-
-    // Trigger OTA Update (for web-based OTA)
-    server->on("/api/ota/update", HTTP_POST, [](AsyncWebServerRequest *request)
-               { request->send(200, "application/json", "{\"success\":true,\"message\":\"Upload firmware file\"}"); }, [](AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final)
-               {
-            if (!index) {
-                Serial.printf("OTA Update Start: %s\n", filename.c_str());
-                
-                // Start update
-                if (!Update.begin(UPDATE_SIZE_UNKNOWN)) {
-                    Update.printError(Serial);
-                }
-            }
-            
-            // Write data
-            if (Update.write(data, len) != len) {
-                Update.printError(Serial);
-            }
-            
-            if (final) {
-                if (Update.end(true)) {
-                    Serial.printf("OTA Update Success: %u bytes\n", index + len);
-                } else {
-                    Update.printError(Serial);
-                }
-            } });
-
-    // ───────────────────────────────────────────────────────────────────────
-    // SENSOR DATA API
-    // ───────────────────────────────────────────────────────────────────────
-    server->on("/api/sensors", HTTP_GET, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        
-        StaticJsonDocument<1024> doc;
-        sensorManager.getAllSensorData(doc.to<JsonObject>());
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response); });
-
-    // ───────────────────────────────────────────────────────────────────────
-    // ACTUATOR CONTROL API (Enhanced)
-    // ───────────────────────────────────────────────────────────────────────
-    server->on("/api/actuator", HTTP_POST, [](AsyncWebServerRequest *request) {}, NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
-               {
-        webServer.totalRequests++;
-        
-        StaticJsonDocument<256> doc;
-        DeserializationError error = deserializeJson(doc, (char*)data);
-        
-        if (error) {
-            request->send(400, "application/json", "{\"success\":false,\"error\":\"JSON parse error\"}");
-            return;
-        }
-        
-        const char* actuator = doc["actuator"];
-        
-        if (!actuator) {
-            request->send(400, "application/json", "{\"success\":false,\"error\":\"Missing actuator\"}");
-            return;
-        }
-        
-        // Handle different actuator types
-        if (doc.containsKey("value")) {
-            int value = doc["value"];
-            actuatorManager.setActuator(actuator, value);
-        }
-        else if (doc.containsKey("r") && doc.containsKey("g") && doc.containsKey("b")) {
-            int r = doc["r"];
-            int g = doc["g"];
-            int b = doc["b"];
-            actuatorManager.setRGBColor(r, g, b);
-        }
-        else if (doc.containsKey("angle")) {
-            int angle = doc["angle"];
-            actuatorManager.setActuator(actuator, angle);
-        }
-        
-        // Broadcast state change to all WebSocket clients
-        StaticJsonDocument<256> response;
-        response["type"] = "actuatorSet";
-        response["actuator"] = actuator;
-        if (doc.containsKey("value")) response["value"] = doc["value"];
-        if (doc.containsKey("r")) {
-            response["r"] = doc["r"];
-            response["g"] = doc["g"];
-            response["b"] = doc["b"];
-        }
-        response["success"] = true;
-        
-        char buffer[256];
-        serializeJson(response, buffer);
-        webServer.ws->textAll(buffer);
-        
-        request->send(200, "application/json", "{\"success\":true}"); });
-
-    // Get Actuator Status
-    server->on("/api/actuators/status", HTTP_GET, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        String status = actuatorManager.getStatus();
-        request->send(200, "application/json", status); });
-
-    // Reset All Actuators
-    server->on("/api/actuators/reset", HTTP_POST, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        actuatorManager.loadDefaultConfiguration();
-        
-        request->send(200, "application/json", "{\"success\":true}");
-        
-        StaticJsonDocument<128> doc;
-        doc["type"] = "actuatorsReset";
-        char buffer[128];
-        serializeJson(doc, buffer);
-        webServer.ws->textAll(buffer); });
-
-    // Emergency Stop
-    server->on("/api/actuators/emergency-stop", HTTP_POST, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        actuatorManager.emergencyStop();
-        
-        request->send(200, "application/json", "{\"success\":true}");
-        
-        StaticJsonDocument<128> doc;
-        doc["type"] = "alert";
-        doc["message"] = "Emergency stop activated";
-        char buffer[128];
-        serializeJson(doc, buffer);
-        webServer.ws->textAll(buffer); });
-
-    // ───────────────────────────────────────────────────────────────────────
-    // ESP-NOW PEERS API
-    // ───────────────────────────────────────────────────────────────────────
-    server->on("/api/peers", HTTP_GET, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        
-        StaticJsonDocument<1024> doc;
-        JsonArray peers = doc.createNestedArray("peers");
-        
-        uint8_t peerCount = espnowComm.getPeerCount();
-        for (uint8_t i = 0; i < peerCount; i++) {
-            PeerInfo* peer = espnowComm.getPeerInfo(i);
-            if (peer && peer->active) {
-                JsonObject peerObj = peers.createNestedObject();
-                peerObj["mac"] = espnowComm.getMacString(peer->mac);
-                peerObj["name"] = peer->name;
-                peerObj["active"] = peer->active;
-                peerObj["lastSeen"] = peer->lastSeen;
-                peerObj["messagesSent"] = peer->messagesSent;
-                peerObj["messagesReceived"] = peer->messagesReceived;
-                peerObj["connected"] = (millis() - peer->lastSeen) < 60000;
-            }
-        }
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response); });
-
-    // Send ESP-NOW Message
-    server->on("/api/peers/send", HTTP_POST, [](AsyncWebServerRequest *request) {}, NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
-               {
-        webServer.totalRequests++;
-        
-        StaticJsonDocument<512> doc;
-        DeserializationError error = deserializeJson(doc, (char*)data);
-        
-        if (error) {
-            request->send(400, "application/json", "{\"success\":false,\"error\":\"JSON parse error\"}");
-            return;
-        }
-        
-        const char* peerMac = doc["peer"];
-        const char* message = doc["message"];
-        
-        if (!peerMac || !message) {
-            request->send(400, "application/json", "{\"success\":false,\"error\":\"Missing parameters\"}");
-            return;
-        }
-        
-        uint8_t mac[6];
-        if (sscanf(peerMac, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
-                   &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]) != 6) {
-            request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid MAC address\"}");
-            return;
-        }
-        
-        bool success = espnowComm.sendMessage(mac, MSG_CUSTOM, message);
-        
-        if (success) {
-            request->send(200, "application/json", "{\"success\":true}");
-        } else {
-            request->send(500, "application/json", "{\"success\":false,\"error\":\"Send failed\"}");
-        } });
-
-    // ───────────────────────────────────────────────────────────────────────
-    // LOGS API
-    // ───────────────────────────────────────────────────────────────────────
-    server->on("/api/logs", HTTP_GET, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        
-        String category = "events";
-        if (request->hasParam("category")) {
-            category = request->getParam("category")->value();
-        }
-        
-        String logs = dataLogger.readLog(category.c_str(), 100);
-        request->send(200, "text/plain", logs); });
-
-    server->on("/api/logs", HTTP_DELETE, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        dataLogger.deleteAllLogs();
-        request->send(200, "application/json", "{\"success\":true}"); });
-
-    // ───────────────────────────────────────────────────────────────────────
-    // CONFIGURATION API
-    // ───────────────────────────────────────────────────────────────────────
-    server->on("/api/config", HTTP_GET, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        
-        StaticJsonDocument<512> doc;
-        doc["deviceName"] = DEVICE_NAME;
-        doc["sensorInterval"] = SENSOR_READ_INTERVAL;
-        doc["enableLogging"] = ENABLE_DATA_LOGGING;
-        doc["enableESPNow"] = ENABLE_ESPNOW;
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response); });
-
-    server->on("/api/config", HTTP_POST, [](AsyncWebServerRequest *request) {}, NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
-               {
-        webServer.totalRequests++;
-        
-        StaticJsonDocument<512> doc;
-        DeserializationError error = deserializeJson(doc, (char*)data);
-        
-        if (error) {
-            request->send(400, "application/json", "{\"success\":false}");
-            return;
-        }
-        
-        File configFile = SPIFFS.open("/config.json", FILE_WRITE);
-        if (configFile) {
-            serializeJson(doc, configFile);
-            configFile.close();
-            request->send(200, "application/json", "{\"success\":true}");
-        } else {
-            request->send(500, "application/json", "{\"success\":false}");
-        } });
-
-    // ───────────────────────────────────────────────────────────────────────
-    // DATA EXPORT API
-    // ───────────────────────────────────────────────────────────────────────
-    server->on("/api/export", HTTP_GET, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        
-        StaticJsonDocument<2048> doc;
-        
-        JsonObject system = doc.createNestedObject("system");
-        system["device"] = DEVICE_NAME;
-        system["version"] = FIRMWARE_VERSION;
-        system["uptime"] = millis();
-        system["freeHeap"] = ESP.getFreeHeap();
-        
-        JsonObject sensors = doc.createNestedObject("sensors");
-        sensorManager.getAllSensorData(sensors);
-        
-        JsonObject espnow = doc.createNestedObject("espnow");
-        uint32_t sent, received, failed;
-        espnowComm.getStatistics(sent, received, failed);
-        espnow["sent"] = sent;
-        espnow["received"] = received;
-        espnow["failed"] = failed;
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response); });
-
-    // ───────────────────────────────────────────────────────────────────────
-    // SYSTEM CONTROL ENDPOINTS
-    // ───────────────────────────────────────────────────────────────────────
-    server->on("/api/restart", HTTP_POST, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        request->send(200, "text/plain", "Restarting...");
-        delay(1000);
-        ESP.restart(); });
-
-    server->on("/api/reset", HTTP_POST, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        SPIFFS.remove("/config.json");
-        dataLogger.deleteAllLogs();
-        request->send(200, "application/json", "{\"success\":true}");
-        delay(1000);
-        ESP.restart(); });
-
-    server->on("/api/alert", HTTP_POST, [](AsyncWebServerRequest *request) {}, NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
-               {
-        webServer.totalRequests++;
-        
-        StaticJsonDocument<256> doc;
-        deserializeJson(doc, (char*)data);
-        
-        const char* message = doc["message"] | "Alert triggered";
-        
-        actuatorManager.triggerAlert();
-        
-        StaticJsonDocument<256> alert;
-        alert["type"] = "alert";
-        alert["message"] = message;
-        char buffer[256];
-        serializeJson(alert, buffer);
-        webServer.ws->textAll(buffer);
-        
-        espnowComm.sendToAllPeers(MSG_ALERT, message);
-        
-        request->send(200, "application/json", "{\"success\":true}"); });
-
-    server->on("/api/files", HTTP_GET, [](AsyncWebServerRequest *request)
-               {
-        webServer.totalRequests++;
-        
-        StaticJsonDocument<2048> doc;
-        doc["spiffs"] = webServer.spiffsAvailable;
-        JsonArray files = doc.createNestedArray("files");
-        
-        if (webServer.spiffsAvailable) {
-            File root = SPIFFS.open("/");
-            File file = root.openNextFile();
-            
-            while(file){
-                JsonObject fileObj = files.createNestedObject();
-                fileObj["name"] = file.path();
-                fileObj["size"] = file.size();
-                file = root.openNextFile();
-            }
-        }
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response); });
-
-    // ───────────────────────────────────────────────────────────────────────
-    // FALLBACK HOMEPAGE (if SPIFFS not available)
-    // ───────────────────────────────────────────────────────────────────────
-    if (!spiffsAvailable)
-    {
-        server->on("/", HTTP_GET, [](AsyncWebServerRequest *request)
-                   {
-            webServer.totalRequests++;
-            
-            String html = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-    <title>ESP32 IoT Dashboard</title>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <style>
-        * {
-            margin: 0;
-            padding: 0;
-            box-sizing: border-box;
-            font-family: 'Segoe UI', Tahoma, Geneva, Verdana, sans-serif;
+// ───────────────────────────────────────────────────────────────────────────
+// FALLBACK HOMEPAGE (served when SPIFFS has no index.html)
+// %VERSION% and %IP% are expanded by ResponseWriter::writeTemplate()
+// ───────────────────────────────────────────────────────────────────────────
+static const char FALLBACK_INDEX_HTML[] PROGMEM = R"rawliteral(
+<!DOCTYPE html>
+<html>
+<head>
+    <title>ESP32 IoT Dashboard</title>
+    <meta charset="UTF-8">
+    <meta name="viewport" content="width=device-width, initial-scale=1.0">
+    <style>
+        * {
+            margin: 0;
+            padding: 0;
+            box-sizing: border-box;
+            font-family: 'Segoe UI', Tahoma, Geneva, Verdana, sans-serif;
         }
 
         body {
@@ -1548,187 +898,865 @@ void WebServerManager::setupRoutes()
         </div>
     </div>
 
-    <script>
-        const ip = "%IP%";
-        let ws = null;
-        let logCount = 0;
-        const maxLogs = 20;
+    <script>
+        const ip = "%IP%";
+        let ws = null;
+        let logCount = 0;
+        const maxLogs = 20;
+
+        function addLog(message) {
+            const now = new Date();
+            const time = `[${now.getHours().toString().padStart(2, '0')}:${now.getMinutes().toString().padStart(2, '0')}:${now.getSeconds().toString().padStart(2, '0')}]`;
+            const logDiv = document.getElementById('systemLog');
+
+            const logEntry = document.createElement('div');
+            logEntry.className = 'log-entry';
+            logEntry.innerHTML = `<span class="log-time">${time}</span> <span class="log-message">${message}</span>`;
+
+            logDiv.prepend(logEntry);
+
+            // Limit number of logs
+            if (logDiv.children.length > maxLogs) {
+                logDiv.removeChild(logDiv.lastChild);
+            }
+
+            logCount++;
+        }
+
+        function connectWS() {
+            if (ws && ws.readyState === WebSocket.OPEN) {
+                addLog('WebSocket already connected');
+                return;
+            }
+
+            addLog('Connecting to WebSocket...');
+            ws = new WebSocket(`ws://${ip}/ws`);
+
+            ws.onopen = () => {
+                addLog('✓ WebSocket connected');
+                document.getElementById('wsStatus').textContent = 'Connected';
+                document.getElementById('wsStatus').className = 'ws-status ws-connected';
+                updateStatus();
+
+                // Request initial data
+                setTimeout(() => {
+                    getStatus();
+                    getSensorData();
+                }, 500);
+            };
+
+            ws.onmessage = (event) => {
+                try {
+                    const data = JSON.parse(event.data);
+
+                    if (data.type === 'status') {
+                        updateStatusDisplay(data);
+                    } else if (data.type === 'sensor') {
+                        updateSensorDisplay(data);
+                    } else if (data.type === 'connected') {
+                        addLog(`Connected with ID: ${data.clientId}`);
+                    } else if (data.type === 'actuatorSet') {
+                        addLog(`Actuator ${data.actuator} set to ${data.value}`);
+                    } else if (data.type === 'alert') {
+                        addLog(`⚠ Alert: ${JSON.stringify(data)}`);
+                    }
+                } catch (e) {
+                    console.error('Error parsing WebSocket message:', e);
+                }
+            };
+
+            ws.onclose = () => {
+                addLog('✗ WebSocket disconnected');
+                document.getElementById('wsStatus').textContent = 'Disconnected';
+                document.getElementById('wsStatus').className = 'ws-status ws-disconnected';
+            };
+
+            ws.onerror = (error) => {
+                addLog('❌ WebSocket error occurred');
+                console.error('WebSocket error:', error);
+            };
+        }
+
+        function updateStatusDisplay(data) {
+            document.getElementById('uptime').textContent = Math.floor(data.uptime / 1000) + 's';
+            document.getElementById('heap').textContent = Math.floor(data.freeHeap / 1024) + ' KB';
+            document.getElementById('rssiValue').textContent = data.wifiRSSI + ' dBm';
+            document.getElementById('clientCount').textContent = data.clients || 0;
+            document.getElementById('fsStatus').textContent = data.spiffs ? 'Available' : 'Not Available';
+            document.getElementById('deviceName').textContent = data.device || 'ESP32';
+        }
+
+        function updateSensorDisplay(data) {
+            if (data.temperature !== undefined) {
+                document.getElementById('tempValue').textContent = data.temperature.toFixed(1);
+            }
+            if (data.humidity !== undefined) {
+                document.getElementById('humidityValue').textContent = data.humidity.toFixed(1) + '%';
+            }
+            if (data.pressure !== undefined) {
+                document.getElementById('pressureValue').textContent = data.pressure.toFixed(1) + ' hPa';
+            }
+            addLog('Sensor data updated');
+        }
+
+        function updateStatus() {
+            if (ws && ws.readyState === WebSocket.OPEN) {
+                ws.send(JSON.stringify({type: 'getStatus'}));
+                // Auto-refresh every 10 seconds
+                setTimeout(updateStatus, 10000);
+            }
+        }
+
+        function getStatus() {
+            if (ws && ws.readyState === WebSocket.OPEN) {
+                ws.send(JSON.stringify({type: 'getStatus'}));
+            } else {
+                alert('Please connect WebSocket first');
+            }
+        }
+
+        function getSensorData() {
+            if (ws && ws.readyState === WebSocket.OPEN) {
+                ws.send(JSON.stringify({type: 'getSensorData'}));
+                addLog('Requesting sensor data...');
+            } else {
+                alert('Please connect WebSocket first');
+            }
+        }
+
+        function controlActuator(actuator, value) {
+            if (ws && ws.readyState === WebSocket.OPEN) {
+                ws.send(JSON.stringify({
+                    type: 'setActuator',
+                    actuator: actuator,
+                    value: value
+                }));
+                addLog(`Sending control: ${actuator} = ${value}`);
+            } else {
+                alert('Please connect WebSocket first');
+            }
+        }
+
+        function restartDevice() {
+            if (confirm('Are you sure you want to restart the device?')) {
+                fetch('/api/restart', { method: 'POST' })
+                    .then(() => {
+                        addLog('Device restart initiated...');
+                    })
+                    .catch(err => {
+                        addLog('Error restarting device');
+                        console.error(err);
+                    });
+            }
+        }
+
+        // Auto-connect on page load
+        window.addEventListener('load', () => {
+            connectWS();
+
+            // Add initial logs
+            addLog('Dashboard initialized');
+            addLog('Device IP: ' + ip);
+            addLog('Firmware: %VERSION%');
+
+            // Update IP display
+            document.getElementById('ipAddress').textContent = ip;
+        });
+
+        // Handle page visibility change
+        document.addEventListener('visibilitychange', () => {
+            if (!document.hidden && (!ws || ws.readyState !== WebSocket.OPEN)) {
+                connectWS();
+            }
+        });
+    </script>
+</body>
+</html>
+)rawliteral";
+
+/**
+ * @brief Wrap a route handler with request counting and latency profiling
+ *
+ * Times the handler itself (not the transfer of its response) with
+ * esp_timer_get_time() and records it in routeProfiler.
+ */
+ArRequestHandlerFunction WebServerManager::timed(const char *path, WebRequestMethodComposite method,
+                                                 ArRequestHandlerFunction handler)
+{
+    int8_t route = routeProfiler.addRoute(path, method);
+
+    return [route, handler](AsyncWebServerRequest *request)
+    {
+        webServer.totalRequests++;
+
+        uint32_t heapBefore = ESP.getFreeHeap();
+        int64_t start = esp_timer_get_time();
+
+        handler(request);
+
+        uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+        routeProfiler.record(route, elapsed, (int32_t)(ESP.getFreeHeap() - heapBefore));
+    };
+}
+
+/**
+ * @brief Setup all HTTP routes
+ */
+void WebServerManager::setupRoutes()
+{
+    // ───────────────────────────────────────────────────────────────────────
+    // STATIC FILE SERVING (SPIFFS)
+    // ───────────────────────────────────────────────────────────────────────
+    if (spiffsAvailable)
+    {
+        Serial.println("Setting up SPIFFS file server...");
+        staticFileCache.begin();
+        server->addHandler(new CachedStaticHandler());
+        server->serveStatic("/", SPIFFS, "/").setDefaultFile("index.html");
+        Serial.println("✓ SPIFFS static file server configured (RAM cached)");
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // DEBUG ENDPOINT
+    // ───────────────────────────────────────────────────────────────────────
+    server->on("/debug/files", HTTP_GET, timed("/debug/files", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        AsyncResponseStream *response = request->beginResponseStream("text/html");
+        ResponseWriter html(*response);
+        html.raw("<!DOCTYPE html><html><head><title>SPIFFS Files</title>");
+        html.raw("<style>body {font-family: Arial, sans-serif; margin: 20px; background: #f5f5f5;}");
+        html.raw("h1 {color: #333;} ul {list-style-type: none; padding: 0;}");
+        html.raw("li {padding: 8px; margin: 5px 0; background: white; border-radius: 4px;}</style></head><body>");
+        html.raw("<h1>🗂️ SPIFFS Files Debug</h1>");
+        
+        if (webServer.spiffsAvailable) {
+            html.raw("<p><strong>SPIFFS Status:</strong> ✓ Available</p>");
+            html.raw("<h2>All Files:</h2><ul>");
+            File root = SPIFFS.open("/");
+            File file = root.openNextFile();
+            
+            int fileCount = 0;
+            while(file){
+                const char *filePath = file.path();
+                html.raw("<li>📄 <strong>").html(filePath).raw("</strong> (");
+                response->print(file.size());
+                html.raw(" bytes) <a href='").html(filePath).raw("' target='_blank'>Open</a></li>");
+                file = root.openNextFile();
+                fileCount++;
+            }
+            response->printf("</ul><p>Total files: %d</p>", fileCount);
+        } else {
+            html.raw("<p><strong>SPIFFS Status:</strong> ✗ Not Available</p>");
+        }
+        
+        html.raw("<hr><p><a href='/'>← Back to Dashboard</a></p></body></html>");
+        request->send(response); }));
+
+    // ───────────────────────────────────────────────────────────────────────
+    // METRICS (Prometheus text format, streamed line by line)
+    // ───────────────────────────────────────────────────────────────────────
+    server->on("/metrics", HTTP_GET, timed("/metrics", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        struct MetricsStream
+        {
+            MetricsCursor cursor;
+            char line[METRICS_LINE_SIZE];
+            size_t length;
+            size_t sent;
+            bool done;
+
+            MetricsStream() : cursor(metrics), length(0), sent(0), done(false) {}
+        };
+        std::shared_ptr<MetricsStream> stream = std::make_shared<MetricsStream>();
+
+        AsyncWebServerResponse *response = request->beginChunkedResponse(
+            "text/plain; version=0.0.4",
+            [stream](uint8_t *buffer, size_t maxLen, size_t index) -> size_t
+            {
+                size_t written = 0;
+                while (written < maxLen)
+                {
+                    if (stream->sent == stream->length)
+                    {
+                        if (stream->done)
+                            break;
+
+                        FixedBufferPrint out(stream->line, sizeof(stream->line));
+                        stream->done = !stream->cursor.next(out);
+                        stream->length = out.length();
+                        stream->sent = 0;
+                        if (out.overflowed())
+                            stream->line[stream->length - 1] = '\n';
+                        continue;
+                    }
+
+                    size_t chunk = stream->length - stream->sent;
+                    if (chunk > maxLen - written)
+                        chunk = maxLen - written;
+                    memcpy(buffer + written, stream->line + stream->sent, chunk);
+                    stream->sent += chunk;
+                    written += chunk;
+                }
+                return written;
+            });
+        request->send(response); }));
+
+    // ───────────────────────────────────────────────────────────────────────
+    // HANDLER LATENCY (see RouteProfiler.h)
+    // ───────────────────────────────────────────────────────────────────────
+    // Main loop stages (registered before /api/perf, which would match it)
+    server->on("/api/perf/loop", HTTP_GET, timed("/api/perf/loop", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        AsyncResponseStream *response = request->beginResponseStream("application/json", 2048);
+        ResponseWriter json(*response);
+        json.beginObject();
+#if ENABLE_LOOP_PROFILER
+        json.field("enabled", true);
+        loopProfiler.writeJson(json);
+#else
+        json.field("enabled", false);
+#endif
+        scheduler.writeStats(json);
+        taskRunner.writeStats(json);
+        json.endObject();
+        request->send(response); }));
+
+    server->on("/api/perf/loop", HTTP_DELETE, timed("/api/perf/loop", HTTP_DELETE, [](AsyncWebServerRequest *request)
+               {
+#if ENABLE_LOOP_PROFILER
+        loopProfiler.reset();
+#endif
+        request->send(200, "application/json", "{\"success\":true}"); }));
 
-        function addLog(message) {
-            const now = new Date();
-            const time = `[${now.getHours().toString().padStart(2, '0')}:${now.getMinutes().toString().padStart(2, '0')}:${now.getSeconds().toString().padStart(2, '0')}]`;
-            const logDiv = document.getElementById('systemLog');
+    server->on("/api/perf", HTTP_GET, timed("/api/perf", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        AsyncResponseStream *response = request->beginResponseStream("application/json", 2048);
+        ResponseWriter json(*response);
+        json.beginObject();
+        json.field("unit", "us");
+        json.field("slowThreshold", (unsigned long)PERF_SLOW_HANDLER_US);
+        routeProfiler.writeStats(json);
+        json.endObject();
+        request->send(response); }));
+
+    server->on("/api/perf", HTTP_DELETE, timed("/api/perf", HTTP_DELETE, [](AsyncWebServerRequest *request)
+               {
+        routeProfiler.reset();
+        request->send(200, "application/json", "{\"success\":true}"); }));
 
-            const logEntry = document.createElement('div');
-            logEntry.className = 'log-entry';
-            logEntry.innerHTML = `<span class="log-time">${time}</span> <span class="log-message">${message}</span>`;
+    // ───────────────────────────────────────────────────────────────────────
+    // SYSTEM STATUS API (Enhanced with WiFi & OTA info)
+    // ───────────────────────────────────────────────────────────────────────
+    server->addHandler(new HeaderAwareHandler("/api/status", "If-None-Match", timed("/api/status", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        // Snapshot is rebuilt by the main loop; supports If-None-Match
+        statusSnapshot.respond(request); })));
 
-            logDiv.prepend(logEntry);
+    // ───────────────────────────────────────────────────────────────────────
+    // WIFI MANAGER ENDPOINTS
+    // ───────────────────────────────────────────────────────────────────────
 
-            // Limit number of logs
-            if (logDiv.children.length > maxLogs) {
-                logDiv.removeChild(logDiv.lastChild);
+    // Scan WiFi Networks (non-blocking)
+    //   GET /api/wifi/scan            -> 200 cached results, or 202 {"scanId"}
+    //   GET /api/wifi/scan?refresh=1  -> always starts a new scan (202)
+    //   GET /api/wifi/scan?id=N       -> 200 once scan N is done, else 202
+    server->on("/api/wifi/scan", HTTP_GET, timed("/api/wifi/scan", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        uint32_t scanId;
+        if (request->hasParam("id")) {
+            scanId = request->getParam("id")->value().toInt();
+            if (wifiManager.isScanFailed(scanId)) {
+                request->send(500, "application/json", "{\"success\":false,\"error\":\"Scan failed\"}");
+                return;
+            }
+        } else {
+            bool refresh = request->hasParam("refresh");
+            if (!refresh && wifiManager.hasFreshScan()) {
+                scanId = wifiManager.getCompletedScanId();
+            } else {
+                scanId = wifiManager.requestScan(refresh);
             }
+        }
 
-            logCount++;
+        AsyncResponseStream *response = request->beginResponseStream("application/json", 1536);
+        ResponseWriter json(*response);
+        json.beginObject();
+        if (wifiManager.isScanComplete(scanId)) {
+            wifiManager.writeScanResults(json);
+        } else {
+            response->setCode(202);
+            json.field("scanId", scanId);
+            json.field("status", "scanning");
         }
+        json.endObject();
+        request->send(response); }));
 
-        function connectWS() {
-            if (ws && ws.readyState === WebSocket.OPEN) {
-                addLog('WebSocket already connected');
-                return;
+    // Connect to WiFi Network
+    server->on("/api/wifi/connect", HTTP_POST, timed("/api/wifi/connect", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+        size_t length;
+        const char *body = RequestBody::require(request, length);
+        if (!body) return;
+        
+        StaticJsonDocument<256> doc;
+        deserializeJson(doc, body, length);
+        
+        const char* ssid = doc["ssid"];
+        const char* password = doc["password"];
+        
+        if (ssid) {
+            // Attempt to connect
+            WiFi.begin(ssid, password);
+            
+            // Wait up to 10 seconds
+            int timeout = 0;
+            while (WiFi.status() != WL_CONNECTED && timeout < 20) {
+                delay(500);
+                timeout++;
+            }
+            
+            if (WiFi.status() == WL_CONNECTED) {
+                request->send(200, "application/json", "{\"success\":true,\"ip\":\"" + WiFi.localIP().toString() + "\"}");
+            } else {
+                request->send(200, "application/json", "{\"success\":false,\"error\":\"Connection failed\"}");
             }
+        } else {
+            request->send(400, "application/json", "{\"success\":false,\"error\":\"Missing SSID\"}");
+        } }), NULL, RequestBody::collect);
 
-            addLog('Connecting to WebSocket...');
-            ws = new WebSocket(`ws://${ip}/ws`);
+    // Disconnect WiFi
+    server->on("/api/wifi/disconnect", HTTP_POST, timed("/api/wifi/disconnect", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+        WiFi.disconnect();
+        request->send(200, "application/json", "{\"success\":true}"); }));
 
-            ws.onopen = () => {
-                addLog('✓ WebSocket connected');
-                document.getElementById('wsStatus').textContent = 'Connected';
-                document.getElementById('wsStatus').className = 'ws-status ws-connected';
-                updateStatus();
+    // Get WiFi Status
+    server->on("/api/wifi/status", HTTP_GET, timed("/api/wifi/status", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        StaticJsonDocument<512> doc;
+        doc["connected"] = WiFi.status() == WL_CONNECTED;
+        doc["ssid"] = WiFi.SSID();
+        doc["rssi"] = WiFi.RSSI();
+        doc["ip"] = WiFi.localIP().toString();
+        doc["mac"] = WiFi.macAddress();
+        doc["gateway"] = WiFi.gatewayIP().toString();
+        doc["subnet"] = WiFi.subnetMask().toString();
+        doc["dns"] = WiFi.dnsIP().toString();
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response); }));
 
-                // Request initial data
-                setTimeout(() => {
-                    getStatus();
-                    getSensorData();
-                }, 500);
-            };
+    // Start Access Point
+    server->on("/api/wifi/ap/start", HTTP_POST, timed("/api/wifi/ap/start", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+        size_t length;
+        const char *body = RequestBody::require(request, length);
+        if (!body) return;
+        
+        StaticJsonDocument<256> doc;
+        deserializeJson(doc, body, length);
+        
+        const char* ssid = doc["ssid"] | AP_SSID;
+        const char* password = doc["password"] | AP_PASSWORD;
+        
+        WiFi.softAP(ssid, password);
+        
+        StaticJsonDocument<256> response;
+        response["success"] = true;
+        response["ssid"] = ssid;
+        response["ip"] = WiFi.softAPIP().toString();
+        
+        char buffer[256];
+        serializeJson(response, buffer);
+        request->send(200, "application/json", buffer); }), NULL, RequestBody::collect);
 
-            ws.onmessage = (event) => {
-                try {
-                    const data = JSON.parse(event.data);
+    // Stop Access Point
+    server->on("/api/wifi/ap/stop", HTTP_POST, timed("/api/wifi/ap/stop", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+        WiFi.softAPdisconnect(true);
+        request->send(200, "application/json", "{\"success\":true}"); }));
 
-                    if (data.type === 'status') {
-                        updateStatusDisplay(data);
-                    } else if (data.type === 'sensor') {
-                        updateSensorDisplay(data);
-                    } else if (data.type === 'connected') {
-                        addLog(`Connected with ID: ${data.clientId}`);
-                    } else if (data.type === 'actuatorSet') {
-                        addLog(`Actuator ${data.actuator} set to ${data.value}`);
-                    } else if (data.type === 'alert') {
-                        addLog(`⚠ Alert: ${JSON.stringify(data)}`);
-                    }
-                } catch (e) {
-                    console.error('Error parsing WebSocket message:', e);
+    // ───────────────────────────────────────────────────────────────────────
+    // OTA UPDATE ENDPOINTS
+    // ───────────────────────────────────────────────────────────────────────
+
+    // OTA Status
+    server->on("/api/ota/status", HTTP_GET, timed("/api/ota/status", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        StaticJsonDocument<512> doc;
+        doc["initialized"] = otaManager.isInitialized();
+        doc["hostname"] = otaManager.getHostname();
+        doc["port"] = otaManager.getPort();
+        doc["updating"] = otaManager.isUpdating();
+        doc["progress"] = otaManager.getProgress();
+        doc["state"] = otaManager.getStatusString();
+        doc["totalUpdates"] = otaManager.getTotalUpdates();
+        doc["failedUpdates"] = otaManager.getFailedUpdates();
+        doc["lastUpdate"] = otaManager.getLastUpdateTime();
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response); }));
+
+    // Trigger OTA Update (for web-based OTA)
+    server->on("/api/ota/update", HTTP_POST, timed("/api/ota/update", HTTP_POST, [](AsyncWebServerRequest *request)
+               { request->send(200, "application/json", "{\"success\":true,\"message\":\"Upload firmware file\"}"); }), [](AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final)
+               {
+            if (!index) {
+                Serial.printf("OTA Update Start: %s\n", filename.c_str());
+                
+                // Start update
+                if (!Update.begin(UPDATE_SIZE_UNKNOWN)) {
+                    Update.printError(Serial);
                 }
-            };
+            }
+            
+            // Write data
+            if (Update.write(data, len) != len) {
+                Update.printError(Serial);
+            }
+            
+            if (final) {
+                if (Update.end(true)) {
+                    Serial.printf("OTA Update Success: %u bytes\n", index + len);
+                } else {
+                    Update.printError(Serial);
+                }
+            } });
 
-            ws.onclose = () => {
-                addLog('✗ WebSocket disconnected');
-                document.getElementById('wsStatus').textContent = 'Disconnected';
-                document.getElementById('wsStatus').className = 'ws-status ws-disconnected';
-            };
+    // ───────────────────────────────────────────────────────────────────────
+    // SENSOR DATA API
+    // ───────────────────────────────────────────────────────────────────────
+    // Per-sensor poll counts, failures and read times (before /api/sensors)
+    server->on("/api/sensors/health", HTTP_GET, timed("/api/sensors/health", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        AsyncResponseStream *response = request->beginResponseStream("application/json", 1024);
+        ResponseWriter json(*response);
+        json.beginObject();
+        json.field("count", (int)sensorManager.getSensorCount());
+        sensorManager.writeHealth(json);
+        json.endObject();
+        request->send(response); }));
+
+    server->on("/api/sensors", HTTP_GET, timed("/api/sensors", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        StaticJsonDocument<1024> doc;
+        sensorManager.getAllSensorData(doc.to<JsonObject>());
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response); }));
 
-            ws.onerror = (error) => {
-                addLog('❌ WebSocket error occurred');
-                console.error('WebSocket error:', error);
-            };
+    // ───────────────────────────────────────────────────────────────────────
+    // ACTUATOR CONTROL API (Enhanced)
+    // ───────────────────────────────────────────────────────────────────────
+    server->on("/api/actuator", HTTP_POST, timed("/api/actuator", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+        dispatchRequestCommand(request, "setActuator"); }), NULL, RequestBody::collect);
+
+    // Apply several actuator commands in one pass, one broadcast
+    server->on("/api/actuators/batch", HTTP_POST, timed("/api/actuators/batch", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+        size_t length;
+        const char *body = RequestBody::require(request, length);
+        if (!body) return;
+
+        StaticJsonDocument<1024> doc;
+        DeserializationError error = deserializeJson(doc, body, length);
+        if (error) {
+            request->send(400, "application/json", "{\"success\":false,\"error\":\"JSON parse error\"}");
+            return;
+        }
+
+        // Accept either {"commands":[...]} or a bare array
+        JsonArrayConst commands = doc.is<JsonArray>() ? doc.as<JsonArrayConst>()
+                                                      : doc["commands"].as<JsonArrayConst>();
+        int failedIndex;
+        const char *reason;
+        int applied = actuatorManager.applyBatch(commands, failedIndex, reason);
+
+        AsyncResponseStream *response = request->beginResponseStream("application/json", 384);
+        ResponseWriter json(*response);
+        json.beginObject();
+        if (applied < 0) {
+            response->setCode(400);
+            json.field("success", false);
+            json.field("error", reason);
+            json.field("index", failedIndex);
+        } else {
+            json.field("success", true);
+            json.field("applied", applied);
+            actuatorManager.writeStatus(json);
+        }
+        json.endObject();
+        request->send(response);
+
+        if (applied >= 0) {
+            webServer.broadcastActuatorState(applied);
+        } }), NULL, RequestBody::collect);
+
+    // Get Actuator Status
+    server->on("/api/actuators/status", HTTP_GET, timed("/api/actuators/status", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        AsyncResponseStream *response = request->beginResponseStream("application/json", 384);
+        ResponseWriter json(*response);
+        json.beginObject();
+        actuatorManager.writeStatus(json);
+        json.endObject();
+        request->send(response); }));
+
+    // Reset All Actuators
+    server->on("/api/actuators/reset", HTTP_POST, timed("/api/actuators/reset", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+        actuatorManager.loadDefaultConfiguration();
+        
+        request->send(200, "application/json", "{\"success\":true}");
+        
+        StaticJsonDocument<128> doc;
+        doc["type"] = "actuatorsReset";
+        char buffer[128];
+        serializeJson(doc, buffer);
+        webServer.broadcastText(buffer, "actuatorsReset"); }));
+
+    // Emergency Stop
+    server->on("/api/actuators/emergency-stop", HTTP_POST, timed("/api/actuators/emergency-stop", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+        actuatorManager.emergencyStop();
+        
+        request->send(200, "application/json", "{\"success\":true}");
+        
+        StaticJsonDocument<128> doc;
+        doc["type"] = "alert";
+        doc["message"] = "Emergency stop activated";
+        char buffer[128];
+        serializeJson(doc, buffer);
+        webServer.broadcastText(buffer, "alert"); }));
+
+    // ───────────────────────────────────────────────────────────────────────
+    // ESP-NOW PEERS API
+    // ───────────────────────────────────────────────────────────────────────
+    server->on("/api/peers", HTTP_GET, timed("/api/peers", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        StaticJsonDocument<1024> doc;
+        JsonArray peers = doc.createNestedArray("peers");
+        
+        uint8_t peerCount = espnowComm.getPeerCount();
+        for (uint8_t i = 0; i < peerCount; i++) {
+            PeerInfo* peer = espnowComm.getPeerInfo(i);
+            if (peer && peer->active) {
+                JsonObject peerObj = peers.createNestedObject();
+                peerObj["mac"] = espnowComm.getMacString(peer->mac);
+                peerObj["name"] = peer->name;
+                peerObj["active"] = peer->active;
+                peerObj["lastSeen"] = peer->lastSeen;
+                peerObj["messagesSent"] = peer->messagesSent;
+                peerObj["messagesReceived"] = peer->messagesReceived;
+                peerObj["connected"] = (millis() - peer->lastSeen) < 60000;
+            }
         }
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response); }));
 
-        function updateStatusDisplay(data) {
-            document.getElementById('uptime').textContent = Math.floor(data.uptime / 1000) + 's';
-            document.getElementById('heap').textContent = Math.floor(data.freeHeap / 1024) + ' KB';
-            document.getElementById('rssiValue').textContent = data.wifiRSSI + ' dBm';
-            document.getElementById('clientCount').textContent = data.clients || 0;
-            document.getElementById('fsStatus').textContent = data.spiffs ? 'Available' : 'Not Available';
-            document.getElementById('deviceName').textContent = data.device || 'ESP32';
+    // Send ESP-NOW Message
+    server->on("/api/peers/send", HTTP_POST, timed("/api/peers/send", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+        size_t length;
+        const char *body = RequestBody::require(request, length);
+        if (!body) return;
+        
+        StaticJsonDocument<512> doc;
+        DeserializationError error = deserializeJson(doc, body, length);
+        
+        if (error) {
+            request->send(400, "application/json", "{\"success\":false,\"error\":\"JSON parse error\"}");
+            return;
         }
-
-        function updateSensorDisplay(data) {
-            if (data.temperature !== undefined) {
-                document.getElementById('tempValue').textContent = data.temperature.toFixed(1);
-            }
-            if (data.humidity !== undefined) {
-                document.getElementById('humidityValue').textContent = data.humidity.toFixed(1) + '%';
-            }
-            if (data.pressure !== undefined) {
-                document.getElementById('pressureValue').textContent = data.pressure.toFixed(1) + ' hPa';
-            }
-            addLog('Sensor data updated');
+        
+        const char* peerMac = doc["peer"];
+        const char* message = doc["message"];
+        
+        if (!peerMac || !message) {
+            request->send(400, "application/json", "{\"success\":false,\"error\":\"Missing parameters\"}");
+            return;
         }
-
-        function updateStatus() {
-            if (ws && ws.readyState === WebSocket.OPEN) {
-                ws.send(JSON.stringify({type: 'getStatus'}));
-                // Auto-refresh every 10 seconds
-                setTimeout(updateStatus, 10000);
-            }
+        
+        uint8_t mac[6];
+        if (sscanf(peerMac, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
+                   &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]) != 6) {
+            request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid MAC address\"}");
+            return;
         }
+        
+        bool success = espnowComm.sendMessage(mac, MSG_CUSTOM, message);
+        
+        if (success) {
+            request->send(200, "application/json", "{\"success\":true}");
+        } else {
+            request->send(500, "application/json", "{\"success\":false,\"error\":\"Send failed\"}");
+        } }), NULL, RequestBody::collect);
 
-        function getStatus() {
-            if (ws && ws.readyState === WebSocket.OPEN) {
-                ws.send(JSON.stringify({type: 'getStatus'}));
-            } else {
-                alert('Please connect WebSocket first');
-            }
+    // ───────────────────────────────────────────────────────────────────────
+    // LOGS API
+    // ───────────────────────────────────────────────────────────────────────
+    server->on("/api/logs", HTTP_GET, timed("/api/logs", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        String category = "events";
+        if (request->hasParam("category")) {
+            category = request->getParam("category")->value();
         }
+        
+        String logs = dataLogger.readLog(category.c_str(), 100);
+        request->send(200, "text/plain", logs); }));
 
-        function getSensorData() {
-            if (ws && ws.readyState === WebSocket.OPEN) {
-                ws.send(JSON.stringify({type: 'getSensorData'}));
-                addLog('Requesting sensor data...');
-            } else {
-                alert('Please connect WebSocket first');
-            }
-        }
+    server->on("/api/logs", HTTP_DELETE, timed("/api/logs", HTTP_DELETE, [](AsyncWebServerRequest *request)
+               {
+        dataLogger.deleteAllLogs();
+        request->send(200, "application/json", "{\"success\":true}"); }));
 
-        function controlActuator(actuator, value) {
-            if (ws && ws.readyState === WebSocket.OPEN) {
-                ws.send(JSON.stringify({
-                    type: 'setActuator',
-                    actuator: actuator,
-                    value: value
-                }));
-                addLog(`Sending control: ${actuator} = ${value}`);
-            } else {
-                alert('Please connect WebSocket first');
-            }
-        }
+    // ───────────────────────────────────────────────────────────────────────
+    // CONFIGURATION API
+    // ───────────────────────────────────────────────────────────────────────
+    server->on("/api/config", HTTP_GET, timed("/api/config", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        DynamicJsonDocument doc(2048);
+        doc["deviceName"] = DEVICE_NAME;
+        doc["sensorInterval"] = SENSOR_READ_INTERVAL;
+        doc["enableLogging"] = ENABLE_DATA_LOGGING;
+        doc["enableESPNow"] = ENABLE_ESPNOW;
+        sensorManager.getAdaptiveConfig(doc.createNestedObject("adaptive"));
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response); }));
 
-        function restartDevice() {
-            if (confirm('Are you sure you want to restart the device?')) {
-                fetch('/api/restart', { method: 'POST' })
-                    .then(() => {
-                        addLog('Device restart initiated...');
-                    })
-                    .catch(err => {
-                        addLog('Error restarting device');
-                        console.error(err);
-                    });
-            }
+    server->on("/api/config", HTTP_POST, timed("/api/config", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+        size_t length;
+        const char *body = RequestBody::require(request, length);
+        if (!body) return;
+        
+        // Validate before persisting; config may be larger than other bodies
+        DynamicJsonDocument doc(HTTP_MAX_CONFIG_SIZE * 2);
+        DeserializationError error = deserializeJson(doc, body, length);
+        
+        if (error) {
+            request->send(400, "application/json", "{\"success\":false}");
+            return;
+        }
+        
+        // Adaptive sampling settings take effect right away
+        if (!sensorManager.configureAdaptive(doc["adaptive"].as<JsonObjectConst>())) {
+            request->send(400, "application/json", "{\"success\":false,\"error\":\"Too many deadbands\"}");
+            return;
         }
+        
+        File configFile = SPIFFS.open("/config.json", FILE_WRITE);
+        if (configFile) {
+            serializeJson(doc, configFile);
+            configFile.close();
+            request->send(200, "application/json", "{\"success\":true}");
+        } else {
+            request->send(500, "application/json", "{\"success\":false}");
+        } }), NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
+               { RequestBody::collectUpTo(request, data, len, index, total, HTTP_MAX_CONFIG_SIZE); });
 
-        // Auto-connect on page load
-        window.addEventListener('load', () => {
-            connectWS();
+    // ───────────────────────────────────────────────────────────────────────
+    // DATA EXPORT API
+    // ───────────────────────────────────────────────────────────────────────
+    server->on("/api/export", HTTP_GET, timed("/api/export", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        StaticJsonDocument<2048> doc;
+        
+        JsonObject system = doc.createNestedObject("system");
+        system["device"] = DEVICE_NAME;
+        system["version"] = FIRMWARE_VERSION;
+        system["uptime"] = millis();
+        system["freeHeap"] = ESP.getFreeHeap();
+        
+        JsonObject sensors = doc.createNestedObject("sensors");
+        sensorManager.getAllSensorData(sensors);
+        
+        JsonObject espnow = doc.createNestedObject("espnow");
+        uint32_t sent, received, failed;
+        espnowComm.getStatistics(sent, received, failed);
+        espnow["sent"] = sent;
+        espnow["received"] = received;
+        espnow["failed"] = failed;
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response); }));
 
-            // Add initial logs
-            addLog('Dashboard initialized');
-            addLog('Device IP: ' + ip);
-            addLog('Firmware: %VERSION%');
+    // ───────────────────────────────────────────────────────────────────────
+    // SYSTEM CONTROL ENDPOINTS
+    // ───────────────────────────────────────────────────────────────────────
+    server->on("/api/restart", HTTP_POST, timed("/api/restart", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+        request->send(200, "text/plain", "Restarting...");
+        delay(1000);
+        ESP.restart(); }));
 
-            // Update IP display
-            document.getElementById('ipAddress').textContent = ip;
-        });
+    server->on("/api/reset", HTTP_POST, timed("/api/reset", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+        SPIFFS.remove("/config.json");
+        dataLogger.deleteAllLogs();
+        request->send(200, "application/json", "{\"success\":true}");
+        delay(1000);
+        ESP.restart(); }));
 
-        // Handle page visibility change
-        document.addEventListener('visibilitychange', () => {
-            if (!document.hidden && (!ws || ws.readyState !== WebSocket.OPEN)) {
-                connectWS();
+    server->on("/api/alert", HTTP_POST, timed("/api/alert", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+        dispatchRequestCommand(request, "triggerAlert"); }), NULL, RequestBody::collect);
+
+    // Generic command endpoint: same {"type":...} messages as the WebSocket
+    server->on("/api/command", HTTP_POST, timed("/api/command", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+        dispatchRequestCommand(request, nullptr); }), NULL, RequestBody::collect);
+
+    server->on("/api/files", HTTP_GET, timed("/api/files", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+        StaticJsonDocument<2048> doc;
+        doc["spiffs"] = webServer.spiffsAvailable;
+        JsonArray files = doc.createNestedArray("files");
+        
+        if (webServer.spiffsAvailable) {
+            File root = SPIFFS.open("/");
+            File file = root.openNextFile();
+            
+            while(file){
+                JsonObject fileObj = files.createNestedObject();
+                fileObj["name"] = file.path();
+                fileObj["size"] = file.size();
+                file = root.openNextFile();
             }
-        });
-    </script>
-</body>
-</html>
-)rawliteral";
+        }
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response); }));
 
-            // Replace placeholders
-            html.replace("%VERSION%", FIRMWARE_VERSION);
-            html.replace("%IP%", WiFi.localIP().toString());
+    // ───────────────────────────────────────────────────────────────────────
+    // FALLBACK HOMEPAGE (if SPIFFS not available)
+    // ───────────────────────────────────────────────────────────────────────
+    if (!spiffsAvailable)
+    {
+        server->on("/", HTTP_GET, timed("/", HTTP_GET, [](AsyncWebServerRequest *request)
+                   {
+            String ip = WiFi.localIP().toString();
+            const TemplateVar vars[] = {
+                {"VERSION", FIRMWARE_VERSION},
+                {"IP", ip.c_str()},
+            };
 
-            request->send(200, "text/html", html); });
+            // Pre-size the stream so the page is written without regrowing
+            AsyncResponseStream *response =
+                request->beginResponseStream("text/html", sizeof(FALLBACK_INDEX_HTML) + 64);
+            ResponseWriter writer(*response);
+            writer.writeTemplate(FALLBACK_INDEX_HTML, vars, sizeof(vars) / sizeof(vars[0]));
+            request->send(response); }));
     }
 
     // ───────────────────────────────────────────────────────────────────────
@@ -1741,6 +1769,101 @@ void WebServerManager::setupRoutes()
         request->send(404, "text/plain", message); });
 }
 
+/**
+ * @brief Register module statistics with the metrics registry
+ *
+ * Existing counters stay where they are; the registry reads them
+ * through callbacks when /metrics is scraped.
+ */
+void WebServerManager::setupMetrics()
+{
+    static bool registered = false;
+    if (registered)
+        return; // Server restarted - registry still holds these
+    registered = true;
+
+    // System
+    metrics.addGauge("uptime_seconds", "Time since boot",
+                     []() -> double { return millis() / 1000.0; });
+    metrics.addGauge("heap_free_bytes", "Free heap",
+                     []() -> double { return ESP.getFreeHeap(); });
+    metrics.addGauge("heap_min_free_bytes", "Lowest free heap since boot",
+                     []() -> double { return ESP.getMinFreeHeap(); });
+    metrics.addGauge("wifi_rssi_dbm", "WiFi signal strength",
+                     []() -> double { return WiFi.status() == WL_CONNECTED ? WiFi.RSSI() : NAN; });
+
+    // Web server
+    metrics.addCounter("http_requests_total", "HTTP API requests handled",
+                       []() -> double { return webServer.getRequestCount(); });
+    metrics.addCounter("ws_messages_total", "WebSocket messages received",
+                       []() -> double { return webServer.getWSMessageCount(); });
+    metrics.addGauge("ws_clients", "Connected WebSocket clients",
+                     []() -> double { return webServer.getClientCount(); });
+    metrics.addGauge("stream_clients", "Connected /api/stream clients",
+                     []() -> double { return eventStream.getClientCount(); });
+    metrics.addCounter("commands_total", "Commands dispatched",
+                       []() -> double { return commandDispatcher.getDispatchedCount(); });
+    metrics.addCounter("commands_unknown_total", "Unknown commands received",
+                       []() -> double { return commandDispatcher.getUnknownCount(); });
+    metrics.addCounter("commands_rejected_total", "Commands refused for their source",
+                       []() -> double { return commandDispatcher.getRejectedCount(); });
+
+    // Static file cache
+    metrics.addCounter("static_cache_hits_total", "Static file cache hits",
+                       []() -> double { return staticFileCache.getHits(); });
+    metrics.addCounter("static_cache_misses_total", "Static file cache misses",
+                       []() -> double { return staticFileCache.getMisses(); });
+    metrics.addCounter("static_cache_evictions_total", "Static file cache evictions",
+                       []() -> double { return staticFileCache.getEvictions(); });
+    metrics.addCounter("static_cache_not_found_total", "Static file requests for missing files",
+                       []() -> double { return staticFileCache.getNotFound(); });
+    metrics.addGauge("static_cache_bytes", "Bytes held by the static file cache",
+                     []() -> double { return staticFileCache.getUsedBytes(); });
+
+    // ESP-NOW
+    metrics.addCounter("espnow_sent_total", "ESP-NOW messages sent",
+                       []() -> double
+                       { uint32_t sent, received, failed;
+                         espnowComm.getStatistics(sent, received, failed);
+                         return sent; });
+    metrics.addCounter("espnow_received_total", "ESP-NOW messages received",
+                       []() -> double
+                       { uint32_t sent, received, failed;
+                         espnowComm.getStatistics(sent, received, failed);
+                         return received; });
+    metrics.addCounter("espnow_failed_total", "ESP-NOW sends that failed",
+                       []() -> double
+                       { uint32_t sent, received, failed;
+                         espnowComm.getStatistics(sent, received, failed);
+                         return failed; });
+    metrics.addGauge("espnow_peers", "Registered ESP-NOW peers",
+                     []() -> double { return espnowComm.getPeerCount(); });
+
+    // Timing wheel
+    metrics.addGauge("timers_pending", "Pending timing wheel timers",
+                     []() -> double { return timingWheel.getPending(); });
+    metrics.addCounter("timers_fired_total", "Timing wheel callbacks run",
+                       []() -> double { return timingWheel.getFired(); });
+    metrics.addCounter("timers_exhausted_total", "Timers refused because the pool was full",
+                       []() -> double { return timingWheel.getPoolExhausted(); });
+
+    // Data logger
+    metrics.addCounter("log_writes_total", "Log entries written",
+                       []() -> double { return dataLogger.getTotalWrites(); });
+    metrics.addCounter("log_write_failures_total", "Log writes that failed",
+                       []() -> double { return dataLogger.getFailedWrites(); });
+    metrics.addCounter("log_rotations_total", "Log file rotations",
+                       []() -> double { return dataLogger.getTotalRotations(); });
+    metrics.addCounter("log_bytes_written_total", "Bytes written to log files",
+                       []() -> double { return dataLogger.getTotalBytesWritten(); });
+
+    // OTA
+    metrics.addCounter("ota_updates_total", "Successful OTA updates",
+                       []() -> double { return otaManager.getTotalUpdates(); });
+    metrics.addCounter("ota_failed_updates_total", "Failed OTA updates",
+                       []() -> double { return otaManager.getFailedUpdates(); });
+}
+
 /**
  * @brief Get content type based on file extension
  */
@@ -1784,6 +1907,64 @@ void WebServerManager::broadcast(const String &message)
     }
 }
 
+/**
+ * @brief Broadcast a pre-serialized message to WebSocket and SSE clients
+ * @param topic SSE event name (the message "type")
+ */
+void WebServerManager::broadcastText(const char *message, const char *topic)
+{
+    if (ws && initialized)
+    {
+        ws->textAll(message);
+        eventStream.publish(topic, message);
+    }
+}
+
+/**
+ * @brief Broadcast full actuator state after a batch update
+ */
+void WebServerManager::broadcastActuatorState(int applied)
+{
+    if (ws && initialized)
+    {
+        char buffer[512];
+        FixedBufferPrint out(buffer, sizeof(buffer));
+        ResponseWriter json(out);
+        json.beginObject();
+        json.field("type", "actuatorsSet");
+        json.field("count", applied);
+        actuatorManager.writeStatus(json);
+        json.endObject();
+        broadcastText(buffer, "actuatorsSet");
+    }
+}
+
+/**
+ * @brief Broadcast WiFi scan completion (called from the main loop)
+ */
+void WebServerManager::broadcastWiFiScan(uint32_t scanId, bool success)
+{
+    if (ws && initialized && ws->count() + eventStream.getClientCount() > 0)
+    {
+        char buffer[1536];
+        FixedBufferPrint out(buffer, sizeof(buffer));
+        ResponseWriter json(out);
+        json.beginObject();
+        if (success)
+        {
+            json.field("type", "wifiNetworks");
+            wifiManager.writeScanResults(json);
+        }
+        else
+        {
+            json.field("type", "wifiScanFailed");
+            json.field("scanId", scanId);
+        }
+        json.endObject();
+        broadcastText(buffer, success ? "wifiNetworks" : "wifiScanFailed");
+    }
+}
+
 /**
  * @brief Broadcast sensor data
  */
@@ -1798,7 +1979,7 @@ void WebServerManager::broadcastSensorData(const char *jsonData)
             doc["type"] = "sensor";
             char buffer[1024];
             serializeJson(doc, buffer);
-            ws->textAll(buffer);
+            broadcastText(buffer, "sensor");
         }
     }
 }
@@ -1817,7 +1998,7 @@ void WebServerManager::broadcastStatus(const char *jsonData)
             doc["type"] = "status";
             char buffer[512];
             serializeJson(doc, buffer);
-            ws->textAll(buffer);
+            broadcastText(buffer, "status");
         }
     }
 }
@@ -1836,7 +2017,7 @@ void WebServerManager::broadcastAlert(const char *jsonData)
             doc["type"] = "alert";
             char buffer[256];
             serializeJson(doc, buffer);
-            ws->textAll(buffer);
+            broadcastText(buffer, "alert");
         }
     }
 }
@@ -1849,6 +2030,9 @@ void WebServerManager::handle()
     // AsyncWebServer handles requests automatically
     // No need for manual handling
 
+    // Keep the pre-serialized status document fresh
+    statusSnapshot.update();
+
     // Clean up disconnected clients periodically
     static unsigned long lastCleanup = 0;
     if (millis() - lastCleanup > 30000)
@@ -1892,6 +2076,8 @@ void WebServerManager::printStatus()
     Serial.printf("│ Port:           %-28d │\n", 80);
     Serial.printf("│ WebSocket:      /ws                               │\n");
     Serial.printf("│ SPIFFS:         %-28s │\n", spiffsAvailable ? "Available" : "Not Available");
+    Serial.printf("│ Static Cache:   %3u files, %5.1f%% hit rate     │\n",
+                  staticFileCache.getEntryCount(), staticFileCache.getHitRate());
     if (initialized)
     {
         Serial.printf("│ Uptime:         %-23lu sec │\n", getUptime() / 1000);
@@ -66,7 +66,6 @@ private:
     // SPIFFS management
     bool spiffsAvailable;
     bool initSPIFFS();
-    void listSPIFFSFiles(AsyncWebSocketClient *client);
     String getContentType(String filename);
 
     bool initialized;
@@ -74,6 +73,9 @@ private:
     // Private methods
     void setupWebSocket();
     void setupRoutes();
+    void setupMetrics();
+    ArRequestHandlerFunction timed(const char *path, WebRequestMethodComposite method,
+                                   ArRequestHandlerFunction handler);
     void onWebSocketEvent(AsyncWebSocket *server, AsyncWebSocketClient *client,
                           AwsEventType type, void *arg, uint8_t *data, size_t len);
     void processWebSocketMessage(AsyncWebSocketClient *client, uint8_t *data, size_t len);
@@ -93,11 +95,15 @@ public:
     void broadcastSensorData(const char *data);
     void broadcastStatus(const char *data);
     void broadcastAlert(const char *data);
+    void broadcastWiFiScan(uint32_t scanId, bool success);
+    void broadcastActuatorState(int applied);
+    void broadcastText(const char *message, const char *topic);
 
     // Client management
     void disconnectAllClients();
     ClientInfo *getClientInfo(uint8_t index);
     uint8_t getClientCount() { return clientCount; }
+    bool isSPIFFSAvailable() { return spiffsAvailable; }
 
     // Statistics
     uint32_t getUptime();
@@ -4,6 +4,7 @@
  */
 
 #include "WiFiManager.h"
+#include "../utils/ResponseWriter.h"
 
 // Global instance
 WiFiManager wifiManager;
@@ -16,6 +17,16 @@ WiFiManager::WiFiManager()
     connected = false;
     ssid = "";
     password = "";
+
+    scanState = SCAN_STATE_IDLE;
+    requestedScanId = 0;
+    runningScanId = 0;
+    completedScanId = 0;
+    scanStartTime = 0;
+    scanCompleteTime = 0;
+    scanResultCount = 0;
+    scanLock = nullptr;
+    scanCallback = nullptr;
 }
 
 /**
@@ -26,6 +37,11 @@ WiFiManager::WiFiManager()
  */
 bool WiFiManager::begin(const char *ssid, const char *password)
 {
+    if (scanLock == nullptr)
+    {
+        scanLock = xSemaphoreCreateMutex();
+    }
+
     this->ssid = String(ssid);
     this->password = String(password);
 
@@ -120,6 +136,201 @@ String WiFiManager::getAPIP()
     return WiFi.softAPIP().toString();
 }
 
+/**
+ * @brief Request a network scan without blocking
+ * @param force Start a new scan even if cached results are still fresh
+ * @return Id of the scan whose results will answer this request
+ *
+ * Safe to call from web handlers. The scan itself is started and
+ * polled by update() in the main loop. Returns 0 before begin().
+ */
+uint32_t WiFiManager::requestScan(bool force)
+{
+    if (scanLock == nullptr)
+        return 0;
+
+    xSemaphoreTake(scanLock, portMAX_DELAY);
+
+    uint32_t id;
+    if (scanState == SCAN_STATE_PENDING || scanState == SCAN_STATE_RUNNING)
+    {
+        id = requestedScanId; // Join the scan already under way
+    }
+    else if (!force && hasFreshScan())
+    {
+        id = completedScanId;
+    }
+    else
+    {
+        id = runningScanId + 1;
+        requestedScanId = id;
+        scanState = SCAN_STATE_PENDING;
+    }
+
+    xSemaphoreGive(scanLock);
+    return id;
+}
+
+/**
+ * @brief Drive the scan state machine - call from the main loop
+ */
+void WiFiManager::update()
+{
+    if (scanLock == nullptr)
+        return;
+
+    if (scanState == SCAN_STATE_PENDING)
+    {
+        xSemaphoreTake(scanLock, portMAX_DELAY);
+        runningScanId = requestedScanId;
+        xSemaphoreGive(scanLock);
+
+        int16_t result = WiFi.scanNetworks(true); // Returns immediately
+        if (result == WIFI_SCAN_FAILED)
+        {
+            scanState = SCAN_STATE_FAILED;
+            Serial.println("WiFi scan failed to start");
+            if (scanCallback)
+                scanCallback(runningScanId, false);
+            return;
+        }
+
+        scanStartTime = millis();
+        scanState = SCAN_STATE_RUNNING;
+    }
+    else if (scanState == SCAN_STATE_RUNNING)
+    {
+        int16_t found = WiFi.scanComplete();
+
+        if (found == WIFI_SCAN_RUNNING)
+        {
+            if (millis() - scanStartTime < WIFI_SCAN_TIMEOUT)
+                return;
+            found = WIFI_SCAN_FAILED; // Driver never finished
+        }
+
+        if (found < 0)
+        {
+            WiFi.scanDelete();
+            scanState = SCAN_STATE_FAILED;
+            Serial.println("WiFi scan failed");
+            if (scanCallback)
+                scanCallback(runningScanId, false);
+            return;
+        }
+
+        collectScanResults(found);
+        WiFi.scanDelete();
+
+        if (scanCallback)
+            scanCallback(completedScanId, true);
+    }
+}
+
+/**
+ * @brief Copy driver results, keeping the strongest networks
+ * @param found Number of networks reported by the driver
+ */
+void WiFiManager::collectScanResults(int found)
+{
+    xSemaphoreTake(scanLock, portMAX_DELAY);
+
+    scanResultCount = 0;
+    for (int i = 0; i < found; i++)
+    {
+        int8_t rssi = WiFi.RSSI(i);
+
+        // Insertion into list sorted by signal strength
+        int pos = scanResultCount;
+        while (pos > 0 && scanResults[pos - 1].rssi < rssi)
+            pos--;
+        if (pos >= WIFI_SCAN_MAX_RESULTS)
+            continue;
+
+        int last = scanResultCount < WIFI_SCAN_MAX_RESULTS ? scanResultCount : WIFI_SCAN_MAX_RESULTS - 1;
+        for (int j = last; j > pos; j--)
+            scanResults[j] = scanResults[j - 1];
+
+        WiFiScanResult &entry = scanResults[pos];
+        strncpy(entry.ssid, WiFi.SSID(i).c_str(), sizeof(entry.ssid) - 1);
+        entry.ssid[sizeof(entry.ssid) - 1] = '\0';
+        entry.rssi = rssi;
+        entry.channel = WiFi.channel(i);
+        entry.open = WiFi.encryptionType(i) == WIFI_AUTH_OPEN;
+
+        if (scanResultCount < WIFI_SCAN_MAX_RESULTS)
+            scanResultCount++;
+    }
+
+    completedScanId = runningScanId;
+    scanCompleteTime = millis();
+    scanState = SCAN_STATE_DONE;
+
+    xSemaphoreGive(scanLock);
+
+    Serial.printf("WiFi scan #%u complete: %d networks\n", completedScanId, found);
+}
+
+/**
+ * @brief Check whether cached results are younger than WIFI_SCAN_TTL
+ */
+bool WiFiManager::hasFreshScan()
+{
+    return completedScanId != 0 && (millis() - scanCompleteTime) < WIFI_SCAN_TTL;
+}
+
+/**
+ * @brief Check whether results for a given scan (or a newer one) exist
+ */
+bool WiFiManager::isScanComplete(uint32_t scanId)
+{
+    return completedScanId != 0 && completedScanId >= scanId;
+}
+
+/**
+ * @brief Check whether the given scan failed
+ */
+bool WiFiManager::isScanFailed(uint32_t scanId)
+{
+    return scanState == SCAN_STATE_FAILED && runningScanId == scanId;
+}
+
+/**
+ * @brief Age of the cached results in milliseconds
+ */
+unsigned long WiFiManager::getScanAge()
+{
+    return completedScanId != 0 ? millis() - scanCompleteTime : 0;
+}
+
+/**
+ * @brief Write cached results as "scanId", "networks" and "count" members
+ */
+void WiFiManager::writeScanResults(ResponseWriter &json)
+{
+    if (scanLock == nullptr)
+        return;
+
+    xSemaphoreTake(scanLock, portMAX_DELAY);
+
+    json.field("scanId", completedScanId);
+    json.field("age", getScanAge());
+    json.beginArray("networks");
+    for (uint8_t i = 0; i < scanResultCount; i++)
+    {
+        json.beginObject();
+        json.field("ssid", scanResults[i].ssid);
+        json.field("rssi", scanResults[i].rssi);
+        json.field("encryption", scanResults[i].open ? "Open" : "Secured");
+        json.field("channel", scanResults[i].channel);
+        json.endObject();
+    }
+    json.endArray();
+    json.field("count", scanResultCount);
+
+    xSemaphoreGive(scanLock);
+}
+
 /**
  * @brief Disconnect from WiFi
  */
@@ -10,6 +10,29 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
+#include "../config.h"
+
+class ResponseWriter;
+
+enum WiFiScanState
+{
+    SCAN_STATE_IDLE = 0, ///< No scan requested yet
+    SCAN_STATE_PENDING,  ///< Requested, starts on next update()
+    SCAN_STATE_RUNNING,  ///< Driver is scanning
+    SCAN_STATE_DONE,     ///< Results available
+    SCAN_STATE_FAILED    ///< Driver error or timeout
+};
+
+struct WiFiScanResult
+{
+    char ssid[33];
+    int8_t rssi;
+    uint8_t channel;
+    bool open;
+};
+
+// Called from update() (main loop) when a scan finishes
+typedef void (*OnScanCompleteCallback)(uint32_t scanId, bool success);
 
 class WiFiManager
 {
@@ -18,6 +41,21 @@ private:
     String ssid;
     String password;
 
+    // Async scan state (requests come from the web task, the driver is
+    // polled from the main loop)
+    volatile WiFiScanState scanState;
+    volatile uint32_t requestedScanId;
+    uint32_t runningScanId;
+    uint32_t completedScanId;
+    unsigned long scanStartTime;
+    unsigned long scanCompleteTime;
+    WiFiScanResult scanResults[WIFI_SCAN_MAX_RESULTS];
+    uint8_t scanResultCount;
+    SemaphoreHandle_t scanLock;
+    OnScanCompleteCallback scanCallback;
+
+    void collectScanResults(int found);
+
 public:
     WiFiManager();
 
@@ -32,6 +70,18 @@ public:
     String getAPSSID();
     String getAPIP();
 
+    // Non-blocking network scan
+    uint32_t requestScan(bool force = false);
+    void update();
+    WiFiScanState getScanState() { return scanState; }
+    uint32_t getCompletedScanId() { return completedScanId; }
+    bool hasFreshScan();
+    bool isScanComplete(uint32_t scanId);
+    bool isScanFailed(uint32_t scanId);
+    unsigned long getScanAge();
+    void writeScanResults(ResponseWriter &json);
+    void setOnScanComplete(OnScanCompleteCallback callback) { scanCallback = callback; }
+
     // Utility
     void disconnect();
     void printStatus();
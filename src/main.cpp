@@ -69,16 +69,17 @@
  *    - Heartbeat LED
  *
  * ═══════════════════════════════════════════════════════════════════════════
- * TIMER-BASED OPERATIONS:
+ * SCHEDULED OPERATIONS:
  * ═══════════════════════════════════════════════════════════════════════════
  *
- * We use non-blocking timers instead of delay() to keep the system responsive:
+ * A cooperative scheduler runs each job at its deadline and sleeps in
+ * between, instead of calling delay() (see utils/Scheduler.h):
  *
  * - Sensor Reading: Every 2 seconds (configurable)
  * - Status Update: Every 5 seconds (ESP-NOW broadcast)
  * - Heartbeat LED: Every 1 second (visual feedback)
  * - Data Logging: Every 60 seconds (saves to SPIFFS)
- * - Peer Check: Every 30 seconds (ESP-NOW connectivity)
+ * - Peer Timeout: 60 seconds without a message (timing wheel)
  *
  * ═══════════════════════════════════════════════════════════════════════════
  */
@@ -103,9 +104,13 @@
 #include "core/WebServer.h"
 #include "core/ESPNowComm.h"
 #include "core/DataLogger.h"
+#include "core/CommandDispatcher.h"
+#include "core/TaskRunner.h"
 
 // Sensor and actuator management
 #include "sensors/SensorManager.h"
+#include "sensors/SensorAdapters.h"
+#include "sensors/AdcSampler.h"
 #include "actuators/ActuatorManager.h"
 
 // Camera module (ESP32-CAM only)
@@ -115,7 +120,10 @@
 
 // Utility modules
 #include "utils/Logger.h"
-#include "utils/Timer.h"
+#include "utils/Scheduler.h"
+#include "utils/TimingWheel.h"
+#include "utils/Metrics.h"
+#include "utils/LoopProfiler.h"
 
 // ═══════════════════════════════════════════════════════════════════════════
 // EXTERN GLOBAL OBJECT DECLARATIONS
@@ -153,18 +161,25 @@ CameraManager cameraManager;
 #endif
 
 // ═══════════════════════════════════════════════════════════════════════════
-// TIMER OBJECTS FOR NON-BLOCKING OPERATIONS
+// SCHEDULED TASKS
 // ═══════════════════════════════════════════════════════════════════════════
 
 /**
- * Timers prevent blocking the main loop with delay().
- * Each timer triggers its action when the interval elapses.
+ * Periodic jobs run as scheduler tasks (see registerTasks()). loop()
+ * sleeps until the next one is due or an event (command, ESP-NOW
+ * message) wakes it, instead of polling timers every 10 ms.
  */
-Timer sensorTimer(SENSOR_READ_INTERVAL);   // Read sensors every 2s
-Timer statusTimer(STATUS_UPDATE_INTERVAL); // Send status every 5s
-Timer heartbeatTimer(HEARTBEAT_INTERVAL);  // Blink LED every 1s
-Timer loggingTimer(60000);                 // Log data every 60s
-Timer peerCheckTimer(30000);               // Check peers every 30s
+int8_t sensorTask = -1;    // Publish sensor data every 2s
+int8_t samplingTask = -1;  // Poll sensors, rescheduled to the next one due
+int8_t wheelTask = -1;     // Timing wheel, rescheduled to its next expiry
+int8_t actuatorsTask = -1; // Actuator effects, rescheduled to the next step
+
+/**
+ * Time taken to read and distribute one round of sensor data (seconds),
+ * exported at /metrics as esp32_sensor_cycle_seconds.
+ */
+static const float SENSOR_CYCLE_BUCKETS[] = {0.005f, 0.01f, 0.025f, 0.05f, 0.1f, 0.25f, 0.5f, 1.0f};
+Histogram sensorCycleTime(SENSOR_CYCLE_BUCKETS, sizeof(SENSOR_CYCLE_BUCKETS) / sizeof(SENSOR_CYCLE_BUCKETS[0]));
 
 // ═══════════════════════════════════════════════════════════════════════════
 // SYSTEM STATE VARIABLES
@@ -181,13 +196,21 @@ bool ledState = false;    // LED blink state
 
 void onESPNowDataReceived(const uint8_t *mac, const char *data, uint8_t type);
 void onESPNowDataSent(const uint8_t *mac, bool success);
+size_t buildSensorJson(char *buffer, size_t size);
+size_t buildPeerSensorJson(char *buffer, size_t size);
+void storeSensorData(const SensorSnapshot &snapshot);
+void publishSensorData(const SensorSnapshot &snapshot);
+void publishSensorEvent(const char *sensor, const SensorField *fields, uint8_t count);
 void readAndSendSensorData();
 void sendStatusUpdate();
 void checkSystemHealth();
 void blinkLED(int count, int delayMs);
 bool initSPIFFS();
+void loadSavedConfig();
 void printSystemInfo();
 void printBootBanner();
+void handleSerialCommands();
+void registerTasks();
 
 // ═══════════════════════════════════════════════════════════════════════════
 // ESP-NOW CALLBACK: DATA RECEIVED
@@ -252,8 +275,12 @@ void onESPNowDataReceived(const uint8_t *mac, const char *data, uint8_t type)
     // Log the peer's sensor data
     dataLogger.logData("peer_sensor", data);
 
-    // Broadcast to web clients for real-time display
-    webServer.broadcastSensorData(data);
+    // Broadcast to web clients for real-time display; events (motion
+    // start/end) keep their type so clients see them as they happen
+    if (strcmp(doc["type"] | "", "sensorEvent") == 0)
+      webServer.broadcastText(data, "sensorEvent");
+    else
+      webServer.broadcastSensorData(data);
 
     // Optional: Take action based on peer's sensor readings
     // Example: If peer reports high temperature, activate cooling
@@ -274,26 +301,11 @@ void onESPNowDataReceived(const uint8_t *mac, const char *data, uint8_t type)
     // Received command to control our actuators
     DEBUG_PRINTLN("🎛️ Processing actuator command...");
 
-    if (doc.containsKey("actuator") && doc.containsKey("value"))
-    {
-      const char *actuatorName = doc["actuator"];
-      int value = doc["value"];
-
-      DEBUG_PRINTF("Command: Set %s to %d\n", actuatorName, value);
-
-      // Execute the actuator command
-      actuatorManager.setActuator(actuatorName, value);
-
-      // Send acknowledgment back to sender
-      StaticJsonDocument<128> ackDoc;
-      ackDoc["status"] = "ok";
-      ackDoc["actuator"] = actuatorName;
-      ackDoc["value"] = value;
-
-      char ackBuffer[128];
-      serializeJson(ackDoc, ackBuffer);
-      espnowComm.sendMessage(mac, MSG_ACK, ackBuffer);
-    }
+    // Same handlers as WebSocket/REST; the dispatcher only accepts
+    // peer-safe commands and sends the MSG_ACK reply itself
+    CommandContext ctx(CMD_SOURCE_ESPNOW);
+    ctx.peerMac = mac;
+    commandDispatcher.dispatch(doc["type"] | "setActuator", doc.as<JsonObjectConst>(), ctx);
     break;
   }
 
@@ -352,6 +364,9 @@ void onESPNowDataReceived(const uint8_t *mac, const char *data, uint8_t type)
   }
 
   DEBUG_PRINTLN("═════════════════════════════════════════════════════\n");
+
+  // Wake the loop so subscribed tasks react without waiting for their period
+  scheduler.post(SCHED_EVENT_ESPNOW_RX);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -462,28 +477,62 @@ bool initSPIFFS()
   return true;
 }
 
+/**
+ * @brief Apply the settings saved by POST /api/config
+ *
+ * Only the adaptive sampling settings ("adaptive" object) are applied;
+ * the rest is compile-time configuration kept in the file for the UI.
+ */
+void loadSavedConfig()
+{
+  if (!SPIFFS.exists("/config.json"))
+    return;
+
+  File configFile = SPIFFS.open("/config.json", FILE_READ);
+  if (!configFile)
+    return;
+
+  DynamicJsonDocument doc(HTTP_MAX_CONFIG_SIZE * 2);
+  DeserializationError error = deserializeJson(doc, configFile);
+  configFile.close();
+  if (error)
+  {
+    DEBUG_PRINTF("⚠️ /config.json ignored: %s\n", error.c_str());
+    return;
+  }
+
+  if (!sensorManager.configureAdaptive(doc["adaptive"].as<JsonObjectConst>()))
+  {
+    DEBUG_PRINTLN("⚠️ /config.json: too many adaptive deadbands");
+  }
+}
+
 // ═══════════════════════════════════════════════════════════════════════════
 // READ SENSORS AND SEND DATA
 // ═══════════════════════════════════════════════════════════════════════════
 
 /**
- * @brief Read all sensors and distribute data
+ * @brief Serialize the latest sensor readings into a JSON document
  *
- * This function:
- * 1. Reads all available sensors
- * 2. Creates JSON data structure
- * 3. Logs data to SPIFFS
- * 4. Sends to web clients via WebSocket
- * 5. Sends to ESP-NOW peers
+ * Only copies the SensorManager snapshot; the sensors themselves are
+ * read by the "sampling" task at their own rates.
+ *
+ * With adaptive sampling the round is skipped while no watched field
+ * has changed, until ADAPTIVE_HEARTBEAT (see SensorManager::shouldPublish).
  *
- * Called periodically by sensorTimer (default: every 2 seconds)
+ * @param buffer Destination for the serialized JSON
+ * @param size Size of buffer
+ * @return JSON length (0 if nothing changed or it did not fit)
  */
-void readAndSendSensorData()
+size_t buildSensorJson(char *buffer, size_t size)
 {
+  if (!sensorManager.shouldPublish(millis()))
+    return 0;
+
   // Create JSON document for sensor data
   StaticJsonDocument<1024> doc;
 
-  // Read all sensors and populate JSON
+  // Latest readings of every working sensor
   JsonObject root = doc.to<JsonObject>();
   sensorManager.getAllSensorData(root);
 
@@ -492,10 +541,6 @@ void readAndSendSensorData()
   doc["device"] = DEVICE_NAME;
   doc["type"] = DEVICE_TYPE == 1 ? "ESP32-CAM" : "ESP32";
 
-  // Convert to string
-  char jsonBuffer[1024];
-  size_t jsonSize = serializeJson(doc, jsonBuffer);
-
 // Print to serial (if debugging)
 #if LOG_TO_SERIAL && DEBUG_SENSORS
   DEBUG_PRINTLN("\n╔═══════════════════════════════════════════════════╗");
@@ -505,24 +550,130 @@ void readAndSendSensorData()
   DEBUG_PRINTLN("\n═════════════════════════════════════════════════════");
 #endif
 
-// Log to SPIFFS
+  // Convert to string
+  if (measureJson(doc) >= size)
+    return 0;
+  return serializeJson(doc, buffer, size);
+}
+
+/**
+ * @brief Serialize the latest readings for ESP-NOW peers
+ *
+ * The full snapshot does not fit in one frame, so peers get the watched
+ * fields first and then whatever else fits (see
+ * SensorManager::getPeerSensorData). Keys stay the same as in the full
+ * JSON, so the receiver can forward it to its web clients as is.
+ *
+ * @return JSON length (0 if no sensor has a reading)
+ */
+size_t buildPeerSensorJson(char *buffer, size_t size)
+{
+  StaticJsonDocument<768> doc;
+  JsonObject root = doc.to<JsonObject>();
+  root["device"] = DEVICE_NAME;
+
+  uint8_t dropped = sensorManager.getPeerSensorData(root, size - 1);
+  if (dropped > 0)
+  {
+    DEBUG_PRINTF("ESP-NOW sensor data: %u field(s) left out\n", dropped);
+  }
+  if (root.size() <= 1)
+    return 0;
+  return serializeJson(doc, buffer, size);
+}
+
+/**
+ * @brief Persist one round of sensor data to SPIFFS
+ */
+void storeSensorData(const SensorSnapshot &snapshot)
+{
 #if LOG_TO_SPIFFS
-  if (dataLogger.logData("sensors", jsonBuffer))
+  if (dataLogger.logData("sensors", snapshot.json))
   {
     DEBUG_PRINTLN("✓ Data logged to SPIFFS");
   }
 #endif
+}
 
+/**
+ * @brief Send one round of sensor data to web clients and ESP-NOW peers
+ */
+void publishSensorData(const SensorSnapshot &snapshot)
+{
   // Broadcast to web clients
-  webServer.broadcastSensorData(jsonBuffer);
+  webServer.broadcastSensorData(snapshot.json);
 
-  // Send to all ESP-NOW peers
+  // Send to all ESP-NOW peers (a trimmed copy: one frame is 229 bytes)
   int peerCount = espnowComm.getPeerCount();
   if (peerCount > 0)
   {
-    DEBUG_PRINTF("📡 Sending sensor data to %d peer(s)...\n", peerCount);
-    espnowComm.sendToAllPeers(MSG_SENSOR_DATA, jsonBuffer);
+    char peerJson[ESPNOW_MAX_PAYLOAD + 1];
+    if (buildPeerSensorJson(peerJson, sizeof(peerJson)) > 0)
+    {
+      DEBUG_PRINTF("📡 Sending sensor data to %d peer(s)...\n", peerCount);
+      espnowComm.sendToAllPeers(MSG_SENSOR_DATA, peerJson);
+    }
   }
+
+  sensorCycleTime.observe((micros() - snapshot.sampledAt) / 1000000.0f);
+}
+
+/**
+ * @brief Send a sensor event (motion start/end) to web clients and peers
+ *
+ * Called from the sampling task as soon as the sensor reports it, so
+ * subscribers hear about it within a few ms instead of at the next
+ * publication round. Peers receive it as MSG_SENSOR_DATA and forward it
+ * to their web clients as a "sensorEvent".
+ */
+void publishSensorEvent(const char *sensor, const SensorField *fields, uint8_t count)
+{
+  StaticJsonDocument<256> doc;
+  doc["type"] = "sensorEvent";
+  doc["sensor"] = sensor;
+  SensorManager::writeFields(doc.as<JsonObject>(), fields, count);
+  doc["timestamp"] = millis();
+  doc["device"] = DEVICE_NAME;
+
+  char buffer[256];
+  if (measureJson(doc) >= sizeof(buffer))
+    return;
+  serializeJson(doc, buffer);
+
+  webServer.broadcastText(buffer, "sensorEvent");
+  if (espnowComm.getPeerCount() > 0)
+  {
+    espnowComm.sendToAllPeers(MSG_SENSOR_DATA, buffer);
+  }
+}
+
+/**
+ * @brief Collect the latest sensor data and distribute it
+ *
+ * This function:
+ * 1. Takes the latest reading of every sensor
+ * 2. Creates JSON data structure
+ * 3. Logs data to SPIFFS
+ * 4. Sends to web clients via WebSocket
+ * 5. Sends to ESP-NOW peers
+ *
+ * Runs as the "sensors" scheduler task (default: every 2 seconds); with
+ * adaptive sampling, rounds with nothing new are skipped.
+ * With ENABLE_TASK_SPLIT the same three steps run on separate FreeRTOS
+ * tasks instead (see core/TaskRunner.h).
+ */
+void readAndSendSensorData()
+{
+  static SensorSnapshot snapshot;
+
+  snapshot.sampledAt = micros();
+  snapshot.length = buildSensorJson(snapshot.json, sizeof(snapshot.json));
+  if (snapshot.length == 0)
+    return;
+  snapshot.sequence++;
+
+  storeSensorData(snapshot);
+  publishSensorData(snapshot);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -541,7 +692,7 @@ void readAndSendSensorData()
  * - ESP-NOW statistics
  * - Sensor count
  *
- * Called periodically by statusTimer (default: every 5 seconds)
+ * Runs as the "status" scheduler task (default: every 5 seconds)
  */
 void sendStatusUpdate()
 {
@@ -632,8 +783,7 @@ void checkSystemHealth()
     DEBUG_PRINTLN("⚠️ WiFi disconnected, attempting reconnection...");
   }
 
-  // Check ESP-NOW peer connectivity
-  espnowComm.checkPeerActivity(60000); // Mark inactive if no message in 60s
+  // ESP-NOW peers are marked inactive by their own timeout timers
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -712,6 +862,245 @@ void printSystemInfo()
   DEBUG_PRINTLN("└───────────────────────────────────────────────────────────┘");
 }
 
+// ═══════════════════════════════════════════════════════════════════════════
+// SERIAL COMMANDS
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Handle one-line commands typed into the Serial Monitor
+ *
+ * Reads whatever is buffered without blocking; a command runs once its
+ * line ending arrives.
+ *
+ * Commands:
+ * - help:       List these commands
+ * - info:       System information
+ * - perf:       Loop profile (ENABLE_LOOP_PROFILER)
+ * - perf reset: Clear loop profile
+ */
+void handleSerialCommands()
+{
+  static char line[32];
+  static uint8_t length = 0;
+
+  while (Serial.available() > 0)
+  {
+    char c = Serial.read();
+    if (c != '\n' && c != '\r')
+    {
+      if (length < sizeof(line) - 1)
+      {
+        line[length++] = c;
+      }
+      continue;
+    }
+
+    if (length == 0)
+      continue;
+    line[length] = '\0';
+    length = 0;
+
+    if (strcmp(line, "help") == 0)
+    {
+      Serial.println("Commands:");
+      Serial.println("  help        This list");
+      Serial.println("  info        System information");
+#if ENABLE_LOOP_PROFILER
+      Serial.println("  perf        Loop profile");
+      Serial.println("  perf reset  Clear loop profile");
+#endif
+    }
+    else if (strcmp(line, "info") == 0)
+    {
+      printSystemInfo();
+    }
+#if ENABLE_LOOP_PROFILER
+    else if (strcmp(line, "perf") == 0)
+    {
+      loopProfiler.printReport(Serial);
+    }
+    else if (strcmp(line, "perf reset") == 0)
+    {
+      loopProfiler.reset();
+      Serial.println("Loop profile cleared");
+    }
+#endif
+    else
+    {
+      Serial.printf("Unknown command '%s' (\"help\" for a list)\n", line);
+    }
+  }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SCHEDULED TASKS
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief OTA, WiFi manager and web server housekeeping
+ *
+ * OTA must be polled frequently for updates to start. The WiFi manager
+ * handles reconnection, DNS (AP mode) and background scans. Web requests
+ * are async; handle() refreshes the status snapshot.
+ */
+void networkTask()
+{
+#if ENABLE_OTA
+  otaManager.handle();
+#endif
+  wifiManager.update();
+#if ENABLE_WEBSERVER
+  webServer.handle();
+#endif
+}
+
+/**
+ * @brief Blink LED to show system is alive (every 1 second)
+ */
+void heartbeatTask()
+{
+  ledState = !ledState;
+  digitalWrite(LED_PIN, ledState);
+}
+
+#if ENABLE_DATA_LOGGING
+/**
+ * @brief Periodic data log checkpoint (every 60 seconds)
+ */
+void loggingTask()
+{
+  // Log could include aggregated sensor data, statistics, etc.
+  DEBUG_PRINTLN("📝 Periodic data log checkpoint");
+}
+#endif
+
+/**
+ * @brief Run expired timing wheel callbacks
+ *
+ * Buzzer tone ends, RGB transition frames and ESP-NOW peer timeouts are
+ * one-shot timers on the wheel. The task reschedules itself for the next
+ * expiry, and schedule() pulls it forward through the wake hook when a
+ * sooner timer is added.
+ */
+void timingWheelTask()
+{
+  timingWheel.advance(millis());
+  scheduler.setInterval(wheelTask, max((uint32_t)TIMING_WHEEL_TICK_MS,
+                                       timingWheel.getSleepTime(millis(), SCHEDULER_MAX_SLEEP * 10)));
+}
+
+void wakeTimingWheel()
+{
+  scheduler.trigger(wheelTask);
+}
+
+#if ENABLE_SENSORS
+/**
+ * @brief Poll every sensor that is due
+ *
+ * Each sensor has its own period (DHT 2 s, MPU 10 ms, ...); the task
+ * reschedules itself for the next one due. Sensors that request a poll
+ * from an interrupt (PIR) wake it through SCHED_EVENT_SENSOR.
+ */
+void sensorSamplingTask()
+{
+  sensorManager.poll(millis());
+  scheduler.setInterval(samplingTask, max((uint32_t)1,
+                                          sensorManager.getSleepTime(millis(), SENSOR_READ_INTERVAL)));
+}
+
+void IRAM_ATTR wakeSensorSampling(bool fromISR)
+{
+  if (fromISR)
+    scheduler.postFromISR(SCHED_EVENT_SENSOR);
+  else
+    scheduler.post(SCHED_EVENT_SENSOR);
+}
+#endif
+
+#if ENABLE_ACTUATORS
+/**
+ * @brief Advance actuator effects (melodies, animations, ramps, scenes)
+ *
+ * Runs every ACTUATOR_UPDATE_INTERVAL, or sooner when an effect's next
+ * step is due earlier. Also woken right away by commands so a new effect
+ * is picked up without waiting for the next period.
+ */
+void actuatorTask()
+{
+  actuatorManager.update();
+  scheduler.setInterval(actuatorsTask, max((uint32_t)1,
+                                           actuatorManager.getSleepTime(millis(), ACTUATOR_UPDATE_INTERVAL)));
+}
+#endif
+
+#if DEBUG_MODE
+/**
+ * @brief Deeper debugging output
+ */
+void debugStatusTask()
+{
+  DEBUG_PRINTLN("\n─── System Status ───");
+  DEBUG_PRINTF("Loop count: %lu\n", loopCounter);
+  DEBUG_PRINTF("Uptime: %lu seconds\n", (millis() - bootTime) / 1000);
+  DEBUG_PRINTF("Free heap: %d bytes\n", ESP.getFreeHeap());
+  DEBUG_PRINTF("WiFi RSSI: %d dBm\n", WiFi.RSSI());
+  DEBUG_PRINTLN("────────────────────\n");
+}
+#endif
+
+/**
+ * @brief Register all periodic jobs with the scheduler
+ *
+ * PRIORITIES:
+ * - HIGH:   Network polling (OTA/web responsiveness)
+ * - NORMAL: Sensors and actuators
+ * - HIGH:   Timing wheel (one-shot component timers)
+ * - LOW:    Status, heartbeat, logging, housekeeping
+ *
+ * When several tasks are due at once, higher priority runs first.
+ * With ENABLE_TASK_SPLIT the sensor cycle is started on its own FreeRTOS
+ * tasks here instead of as a scheduler task.
+ */
+void registerTasks()
+{
+  scheduler.addTask("network", networkTask, NETWORK_POLL_INTERVAL,
+                    SCHED_PRIORITY_HIGH, SCHED_EVENT_COMMAND);
+  wheelTask = scheduler.addTask("timers", timingWheelTask, TIMING_WHEEL_TICK_MS, SCHED_PRIORITY_HIGH);
+  timingWheel.setWakeHook(wakeTimingWheel);
+#if ENABLE_SENSORS
+  samplingTask = scheduler.addTask("sampling", sensorSamplingTask, SENSOR_READ_INTERVAL,
+                                   SCHED_PRIORITY_NORMAL, SCHED_EVENT_SENSOR);
+  sensorManager.setWakeHook(wakeSensorSampling);
+  sensorManager.setEventHook(publishSensorEvent);
+#endif
+#if ENABLE_SENSORS && ENABLE_TASK_SPLIT
+  // Sensor cycle runs on its own pinned tasks; fall back to the loop
+  if (!taskRunner.begin(buildSensorJson, storeSensorData, publishSensorData))
+  {
+    sensorTask = scheduler.addTask("sensors", readAndSendSensorData, SENSOR_READ_INTERVAL);
+  }
+#elif ENABLE_SENSORS
+  sensorTask = scheduler.addTask("sensors", readAndSendSensorData, SENSOR_READ_INTERVAL);
+#endif
+#if ENABLE_ACTUATORS
+  actuatorsTask = scheduler.addTask("actuators", actuatorTask, ACTUATOR_UPDATE_INTERVAL,
+                                    SCHED_PRIORITY_NORMAL, SCHED_EVENT_COMMAND | SCHED_EVENT_ESPNOW_RX);
+#endif
+  scheduler.addTask("status", sendStatusUpdate, STATUS_UPDATE_INTERVAL, SCHED_PRIORITY_LOW);
+  scheduler.addTask("heartbeat", heartbeatTask, HEARTBEAT_INTERVAL, SCHED_PRIORITY_LOW);
+#if ENABLE_DATA_LOGGING
+  scheduler.addTask("logging", loggingTask, LOGGING_INTERVAL, SCHED_PRIORITY_LOW);
+#endif
+  scheduler.addTask("health", checkSystemHealth, HEALTH_CHECK_INTERVAL, SCHED_PRIORITY_LOW);
+  scheduler.addTask("serial", handleSerialCommands, SERIAL_POLL_INTERVAL, SCHED_PRIORITY_LOW);
+#if DEBUG_MODE
+  scheduler.addTask("debug", debugStatusTask, 100000, SCHED_PRIORITY_LOW);
+#endif
+
+  scheduler.begin();
+}
+
 // ═══════════════════════════════════════════════════════════════════════════
 // SETUP FUNCTION - RUNS ONCE AT BOOT
 // ═══════════════════════════════════════════════════════════════════════════
@@ -858,7 +1247,10 @@ void setup()
 // ─────────────────────────────────────────────────────────────────────
 #if ENABLE_SENSORS
   DEBUG_PRINTLN("\n[6/9] Initializing Sensors...");
+  registerBoardSensors();
+  loadSavedConfig();
   uint8_t sensorCount = sensorManager.begin();
+  adcSampler.begin(); // Pins were registered by the analog sensors' begin()
   DEBUG_PRINTF("✓ %d sensor(s) initialized\n", sensorCount);
 
   if (sensorCount == 0)
@@ -871,6 +1263,8 @@ void setup()
     // Print sensor status
     sensorManager.printStatus();
   }
+
+  metrics.addHistogram("sensor_cycle_seconds", "Sensor read and distribute time", sensorCycleTime);
 #else
   DEBUG_PRINTLN("\n[6/9] Sensors disabled in config");
 #endif
@@ -969,6 +1363,11 @@ void setup()
   }
 #endif
 
+  // ─────────────────────────────────────────────────────────────────────
+  // 12. START SCHEDULER
+  // ─────────────────────────────────────────────────────────────────────
+  registerTasks();
+
   // ─────────────────────────────────────────────────────────────────────
   // SYSTEM READY
   // ─────────────────────────────────────────────────────────────────────
@@ -1021,124 +1420,28 @@ void setup()
  * @brief Arduino loop function - main program loop
  *
  * This function runs continuously after setup() completes.
- * It handles all periodic tasks using non-blocking timers.
+ * All periodic work is done by scheduler tasks (see registerTasks()).
  *
- * NEVER USE delay() IN LOOP!
- * Use Timer objects for periodic operations to keep system responsive.
+ * NEVER USE delay() IN LOOP OR IN A TASK!
+ * Tasks run to completion one after another; a blocking task delays all
+ * the others.
  *
  * LOOP FREQUENCY:
- * This loop runs at maximum speed (thousands of times per second).
- * Timer objects ensure tasks run at their specified intervals.
- *
- * WATCHDOG TIMER:
- * ESP32 has a watchdog that resets the system if loop() blocks too long.
- * Keep operations fast and use yield() for long operations.
+ * runDue() runs every task whose deadline has passed, then idle() blocks
+ * until the next deadline. Commands and ESP-NOW messages post events
+ * that wake the loop early. With nothing due the loop task sleeps, which
+ * lets the idle task (and light sleep) run and keeps the watchdog fed.
  */
 void loop()
 {
   // Increment loop counter (for debugging)
   loopCounter++;
 
-// ─────────────────────────────────────────────────────────────────────
-// 1. HANDLE OTA UPDATES
-// ─────────────────────────────────────────────────────────────────────
-// OTA manager handles incoming update requests
-// This must be called frequently for OTA to work
-#if ENABLE_OTA
-  otaManager.handle();
-#endif
+  PROFILE_LOOP_BEGIN();
+  scheduler.runDue();
+  PROFILE_LOOP_END();
 
-  // ─────────────────────────────────────────────────────────────────────
-  // 2. HANDLE WIFI MANAGER
-  // ─────────────────────────────────────────────────────────────────────
-  // WiFi manager handles reconnection and DNS (in AP mode)
-  // WiFi manager handled automatically
-
-  // ─────────────────────────────────────────────────────────────────────
-  // 3. READ SENSORS PERIODICALLY
-  // ─────────────────────────────────────────────────────────────────────
-  // Check if it's time to read sensors (every 2 seconds by default)
-  if (sensorTimer.isReady() && ENABLE_SENSORS)
-  {
-    readAndSendSensorData();
-  }
-
-  // ─────────────────────────────────────────────────────────────────────
-  // 4. SEND STATUS UPDATES
-  // ─────────────────────────────────────────────────────────────────────
-  // Send status to peers and web clients (every 5 seconds)
-  if (statusTimer.isReady())
-  {
-    sendStatusUpdate();
-  }
-
-  // ─────────────────────────────────────────────────────────────────────
-  // 5. HEARTBEAT LED
-  // ─────────────────────────────────────────────────────────────────────
-  // Blink LED to show system is alive (every 1 second)
-  if (heartbeatTimer.isReady())
-  {
-    ledState = !ledState;
-    digitalWrite(LED_PIN, ledState);
-  }
-
-// ─────────────────────────────────────────────────────────────────────
-// 6. DATA LOGGING
-// ─────────────────────────────────────────────────────────────────────
-// Periodic data logging (every 60 seconds)
-#if ENABLE_DATA_LOGGING
-  if (loggingTimer.isReady())
-  {
-    // Log could include aggregated sensor data, statistics, etc.
-    DEBUG_PRINTLN("📝 Periodic data log checkpoint");
-  }
-#endif
-
-  // ─────────────────────────────────────────────────────────────────────
-  // 7. CHECK PEER CONNECTIVITY
-  // ─────────────────────────────────────────────────────────────────────
-  // Check which peers are still active (every 30 seconds)
-  if (peerCheckTimer.isReady())
-  {
-    espnowComm.checkPeerActivity(60000); // 60 second timeout
-  }
-
-// ─────────────────────────────────────────────────────────────────────
-// 8. UPDATE ACTUATORS
-// ─────────────────────────────────────────────────────────────────────
-// Some actuators need continuous updates (e.g., fading LEDs)
-#if ENABLE_ACTUATORS
-  actuatorManager.update();
-#endif
-
-  // ─────────────────────────────────────────────────────────────────────
-  // 9. SYSTEM HEALTH CHECK
-  // ─────────────────────────────────────────────────────────────────────
-  // Check every 1000 loops
-  if (loopCounter % 1000 == 0)
-  {
-    checkSystemHealth();
-  }
-
-  // ─────────────────────────────────────────────────────────────────────
-  // 10. YIELD TO PREVENT WATCHDOG RESET
-  // ─────────────────────────────────────────────────────────────────────
-  // Small delay to prevent watchdog timeout and reduce power consumption
-  // Also allows background WiFi tasks to run
-  delay(10); // 10ms delay keeps loop at ~100Hz
-
-// Optional: Deeper debugging every 10000 loops
-#if DEBUG_MODE
-  if (loopCounter % 10000 == 0)
-  {
-    DEBUG_PRINTLN("\n─── System Status ───");
-    DEBUG_PRINTF("Loop count: %lu\n", loopCounter);
-    DEBUG_PRINTF("Uptime: %lu seconds\n", (millis() - bootTime) / 1000);
-    DEBUG_PRINTF("Free heap: %d bytes\n", ESP.getFreeHeap());
-    DEBUG_PRINTF("WiFi RSSI: %d dBm\n", WiFi.RSSI());
-    DEBUG_PRINTLN("────────────────────\n");
-  }
-#endif
+  scheduler.idle(SCHEDULER_MAX_SLEEP);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -0,0 +1,182 @@
+/**
+ * @file AdaptivePolicy.cpp
+ * @brief Change-driven sampling: slow down stable sensors, publish on change
+ */
+
+#include "AdaptivePolicy.h"
+#include <math.h>
+#include <string.h>
+
+AdaptivePolicy::AdaptivePolicy()
+{
+    deadbandCount = 0;
+    enabled = true;
+    maxSlowdown = 1;
+    stablePolls = 1;
+    heartbeat = 0;
+    version = 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SETTINGS
+// ═══════════════════════════════════════════════════════════════════════════
+
+void AdaptivePolicy::setEnabled(bool on)
+{
+    enabled = on;
+    version++;
+}
+
+void AdaptivePolicy::setMaxSlowdown(uint8_t factor)
+{
+    uint8_t power = 1;
+    while (power <= factor / 2)
+        power *= 2;
+    maxSlowdown = power;
+    version++;
+}
+
+void AdaptivePolicy::setStablePolls(uint8_t polls)
+{
+    stablePolls = polls > 0 ? polls : 1;
+    version++;
+}
+
+void AdaptivePolicy::setHeartbeat(uint32_t ms)
+{
+    heartbeat = ms;
+}
+
+bool AdaptivePolicy::setDeadband(const char *field, float threshold)
+{
+    if (field == nullptr || strlen(field) >= ADAPTIVE_NAME_LENGTH)
+        return false;
+
+    for (uint8_t i = 0; i < deadbandCount; i++)
+    {
+        if (strcmp(deadbands[i].field, field) != 0)
+            continue;
+
+        if (threshold > 0.0f)
+        {
+            deadbands[i].threshold = threshold;
+        }
+        else
+        {
+            deadbands[i] = deadbands[--deadbandCount];
+        }
+        version++;
+        return true;
+    }
+
+    if (threshold <= 0.0f)
+        return true;
+    if (deadbandCount >= ADAPTIVE_MAX_DEADBANDS)
+        return false;
+
+    Deadband &entry = deadbands[deadbandCount++];
+    strcpy(entry.field, field);
+    entry.threshold = threshold;
+    version++;
+    return true;
+}
+
+void AdaptivePolicy::clearDeadbands()
+{
+    deadbandCount = 0;
+    version++;
+}
+
+float AdaptivePolicy::getDeadband(const char *field) const
+{
+    for (uint8_t i = 0; i < deadbandCount; i++)
+    {
+        if (strcmp(deadbands[i].field, field) == 0)
+            return deadbands[i].threshold;
+    }
+    return 0.0f;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SAMPLING
+// ═══════════════════════════════════════════════════════════════════════════
+
+void AdaptivePolicy::reset(AdaptiveTrack &track) const
+{
+    memset(&track, 0, sizeof(track));
+    track.slowdown = 1;
+}
+
+/**
+ * @brief Look up the deadband of every field once, not on every reading
+ */
+void AdaptivePolicy::resolve(AdaptiveTrack &track, const SensorField *fields, uint8_t count) const
+{
+    for (uint8_t f = 0; f < count; f++)
+    {
+        track.deadband[f] = getDeadband(fields[f].name);
+    }
+    track.fieldCount = count;
+    track.version = version;
+    track.seeded = false;
+    track.stable = 0;
+    track.slowdown = 1;
+}
+
+/**
+ * @brief Compare a reading with the last significant one
+ * @return true when a watched field moved by its deadband, for the first
+ *         reading of a watched sensor, and always while disabled
+ */
+bool AdaptivePolicy::update(AdaptiveTrack &track, const SensorField *fields, uint8_t count) const
+{
+    if (count > SENSOR_MAX_FIELDS)
+        count = SENSOR_MAX_FIELDS;
+    if (track.version != version || track.fieldCount != count)
+        resolve(track, fields, count);
+
+    if (!enabled)
+        return true;
+
+    bool watched = false;
+    bool changed = false;
+    for (uint8_t f = 0; f < count; f++)
+    {
+        if (track.deadband[f] <= 0.0f)
+            continue;
+        watched = true;
+        if (!track.seeded || fabsf(fields[f].value - track.reference[f]) >= track.deadband[f])
+            changed = true;
+    }
+
+    if (!watched)
+        return false;
+
+    if (changed)
+    {
+        for (uint8_t f = 0; f < count; f++)
+        {
+            track.reference[f] = fields[f].value;
+        }
+        track.seeded = true;
+        track.stable = 0;
+        track.slowdown = 1;
+        return true;
+    }
+
+    // Stable: stretch the period one step at a time
+    if (++track.stable >= stablePolls)
+    {
+        track.stable = 0;
+        if (track.slowdown < maxSlowdown)
+            track.slowdown *= 2;
+    }
+    return false;
+}
+
+uint32_t AdaptivePolicy::interval(const AdaptiveTrack &track, uint32_t basePeriod) const
+{
+    if (!enabled)
+        return basePeriod;
+    return basePeriod * track.slowdown;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file AdaptivePolicy.h
+ * @brief Change-driven sampling: slow down stable sensors, publish on change
+ *
+ * Every watched field has a deadband. A reading is significant when a
+ * watched field has moved by at least its deadband from the value it had
+ * at the sensor's last significant reading. A fast ramp or step crosses
+ * it on the next poll, a slow drift after a few polls, and noise that
+ * stays inside the deadband never does.
+ *
+ * A significant reading puts the sensor back at its base period and
+ * marks the snapshot for publication. After `stablePolls` readings in a
+ * row without one, the poll period doubles, up to `maxSlowdown` times
+ * the base period. Fields without a deadband are not watched: they are
+ * published along with the others but never trigger a publication.
+ *
+ * Settings can change at run time (POST /api/config); each track
+ * re-resolves its deadbands when the settings version changes.
+ *
+ * No hardware access: the policy can be replayed over recorded traces
+ * on a PC.
+ */
+
+#ifndef ADAPTIVE_POLICY_H
+#define ADAPTIVE_POLICY_H
+
+#include "ISensor.h"
+
+#define ADAPTIVE_MAX_DEADBANDS 24 // Watched field names
+#define ADAPTIVE_NAME_LENGTH 24   // Longest field name + 1
+
+struct AdaptiveDeadband
+{
+    const char *field;
+    float threshold; // Same unit as the field
+};
+
+// Per-sensor state, owned by the registry entry
+struct AdaptiveTrack
+{
+    float reference[SENSOR_MAX_FIELDS]; // Values at the last significant reading
+    float deadband[SENSOR_MAX_FIELDS];  // Resolved per field index (0 = not watched)
+    uint16_t version;                   // Settings version the deadbands came from
+    uint8_t fieldCount;
+    uint8_t stable;   // Readings since the last significant one
+    uint8_t slowdown; // Period multiplier (1, 2, 4, ...)
+    bool seeded;
+};
+
+class AdaptivePolicy
+{
+private:
+    struct Deadband
+    {
+        char field[ADAPTIVE_NAME_LENGTH];
+        float threshold;
+    };
+
+    Deadband deadbands[ADAPTIVE_MAX_DEADBANDS];
+    uint8_t deadbandCount;
+    bool enabled;
+    uint8_t maxSlowdown;
+    uint8_t stablePolls;
+    uint32_t heartbeat;
+    uint16_t version;
+
+    void resolve(AdaptiveTrack &track, const SensorField *fields, uint8_t count) const;
+
+public:
+    AdaptivePolicy();
+
+    // Settings
+    void setEnabled(bool on);
+    void setMaxSlowdown(uint8_t factor); // Rounded down to a power of two
+    void setStablePolls(uint8_t polls);
+    void setHeartbeat(uint32_t ms);
+    // threshold <= 0 stops watching the field; false when the table is full
+    bool setDeadband(const char *field, float threshold);
+    void clearDeadbands();
+
+    bool isEnabled() const { return enabled; }
+    uint8_t getMaxSlowdown() const { return maxSlowdown; }
+    uint8_t getStablePolls() const { return stablePolls; }
+    uint32_t getHeartbeat() const { return heartbeat; }
+    uint8_t getDeadbandCount() const { return deadbandCount; }
+    const char *getDeadbandField(uint8_t i) const { return deadbands[i].field; }
+    float getDeadbandThreshold(uint8_t i) const { return deadbands[i].threshold; }
+    float getDeadband(const char *field) const; // 0 = not watched
+
+    // Sampling
+    void reset(AdaptiveTrack &track) const;
+    // Feed a good reading; true when it is significant
+    bool update(AdaptiveTrack &track, const SensorField *fields, uint8_t count) const;
+    // Poll period for a sensor with the given base period
+    uint32_t interval(const AdaptiveTrack &track, uint32_t basePeriod) const;
+};
+
+#endif // ADAPTIVE_POLICY_H
@@ -0,0 +1,76 @@
+/**
+ * @file AdcDemux.cpp
+ * @brief Per-channel decimating filters for an interleaved ADC stream
+ */
+
+#include "AdcDemux.h"
+#include <string.h>
+
+AdcDemux::AdcDemux()
+{
+    begin(1);
+}
+
+void AdcDemux::begin(uint16_t samplesPerOutput)
+{
+    decimation = samplesPerOutput > 0 ? samplesPerOutput : 1;
+    slotCount = 0;
+    memset(slotOf, -1, sizeof(slotOf));
+    unknown = 0;
+}
+
+int8_t AdcDemux::addChannel(uint8_t channel)
+{
+    if (channel >= 16)
+        return -1;
+    if (slotOf[channel] >= 0)
+        return slotOf[channel];
+    if (slotCount >= ADC_MAX_CHANNELS)
+        return -1;
+
+    Slot &slot = slots[slotCount];
+    slot.channel = channel;
+    slot.accumulator = 0;
+    slot.accumulated = 0;
+    slot.history.clear();
+    slot.average = 0.0f;
+    slot.outputs = 0;
+    slot.samples = 0;
+    slotOf[channel] = slotCount;
+    return slotCount++;
+}
+
+void AdcDemux::push(uint8_t index, uint16_t raw)
+{
+    Slot &slot = slots[index];
+    slot.samples++;
+    slot.accumulator += raw;
+    if (++slot.accumulated < decimation)
+        return;
+
+    uint16_t output = (uint16_t)((slot.accumulator + decimation / 2) / decimation);
+    slot.accumulator = 0;
+    slot.accumulated = 0;
+
+    slot.history.push(output);
+    slot.average = slot.history.mean();
+    slot.outputs++;
+}
+
+size_t AdcDemux::process(const uint8_t *buffer, size_t length)
+{
+    size_t used = 0;
+    for (size_t i = 0; i + ADC_SAMPLE_BYTES <= length; i += ADC_SAMPLE_BYTES)
+    {
+        uint16_t word = buffer[i] | (buffer[i + 1] << 8);
+        int8_t slot = slotOf[word >> 12];
+        if (slot < 0)
+        {
+            unknown++;
+            continue;
+        }
+        push(slot, word & 0x0FFF);
+        used++;
+    }
+    return used;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file AdcDemux.h
+ * @brief Per-channel decimating filters for an interleaved ADC stream
+ *
+ * The continuous ADC writes one 16-bit word per conversion, cycling
+ * through the configured channels (ESP32 "type 1" format: channel in
+ * bits 12-15, 12-bit result in bits 0-11). process() sorts the words
+ * by channel and runs each channel through two stages:
+ *
+ *   decimate  sum `decimation` raw samples into one output (boxcar)
+ *   history   keep the last ADC_HISTORY outputs with a running sum
+ *
+ * The mean of the history is stored after every output, so readers get
+ * a filtered value with a single load and no arithmetic.
+ *
+ * push() feeds one sample for a slot directly, for polled (analogRead)
+ * sampling. No hardware access: the same code runs on a PC.
+ */
+
+#ifndef ADC_DEMUX_H
+#define ADC_DEMUX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../utils/RingStats.h"
+
+#define ADC_MAX_CHANNELS 8      // ADC1 channels (GPIO 32-39)
+#define ADC_HISTORY 16          // Decimated outputs averaged (power of two)
+#define ADC_SAMPLE_BYTES 2      // One type-1 conversion result
+
+class AdcDemux
+{
+private:
+    struct Slot
+    {
+        uint8_t channel;
+        uint32_t accumulator;
+        uint16_t accumulated;
+        RingStats<uint16_t, ADC_HISTORY> history;
+        volatile float average; // Mean of the history, in raw counts
+        volatile uint32_t outputs;
+        uint32_t samples;
+    };
+
+    Slot slots[ADC_MAX_CHANNELS];
+    uint8_t slotCount;
+    int8_t slotOf[16]; // Hardware channel -> slot (-1 = not sampled)
+    uint16_t decimation;
+    uint32_t unknown; // Words for channels nobody asked for
+
+public:
+    AdcDemux();
+
+    // Samples summed per output (1 = no decimation); clears all channels
+    void begin(uint16_t samplesPerOutput);
+    // Hardware channel 0-15; returns the slot, or -1 when full
+    int8_t addChannel(uint8_t channel);
+
+    void push(uint8_t slot, uint16_t raw);
+    // Demultiplex type-1 words; returns the number of samples used
+    size_t process(const uint8_t *buffer, size_t length);
+
+    uint8_t getSlotCount() const { return slotCount; }
+    uint8_t getChannel(uint8_t slot) const { return slots[slot].channel; }
+    float getAverage(uint8_t slot) const { return slots[slot].average; }
+    bool isReady(uint8_t slot) const { return slots[slot].outputs > 0; }
+    uint32_t getOutputs(uint8_t slot) const { return slots[slot].outputs; }
+    uint32_t getSamples(uint8_t slot) const { return slots[slot].samples; }
+    uint32_t getUnknown() const { return unknown; }
+};
+
+#endif // ADC_DEMUX_H
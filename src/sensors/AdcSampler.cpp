@@ -0,0 +1,203 @@
+/**
+ * @file AdcSampler.cpp
+ * @brief Shared background sampling of the analog sensor pins
+ */
+
+#include "AdcSampler.h"
+#include <esp_idf_version.h>
+
+// The legacy continuous-mode driver: ESP32 support arrived in IDF 4.4,
+// and IDF 5 replaced it with adc_continuous (which the 3.x core owns)
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 4, 0) && ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 0, 0)
+#define ADC_DMA_AVAILABLE 1
+#include <driver/adc.h>
+#else
+#define ADC_DMA_AVAILABLE 0
+#endif
+
+// Global instance
+AdcSampler adcSampler;
+
+AdcSampler::AdcSampler()
+{
+    pinCount = 0;
+    dmaMode = false;
+    running = false;
+    task = nullptr;
+    overruns = 0;
+}
+
+/**
+ * @brief ADC1 channel of a GPIO, or -1 if the pin is not on ADC1
+ */
+int8_t AdcSampler::adc1Channel(uint8_t pin)
+{
+    switch (pin)
+    {
+    case 36: return 0;
+    case 37: return 1;
+    case 38: return 2;
+    case 39: return 3;
+    case 32: return 4;
+    case 33: return 5;
+    case 34: return 6;
+    case 35: return 7;
+    default: return -1;
+    }
+}
+
+int8_t AdcSampler::addPin(uint8_t pin)
+{
+    for (uint8_t i = 0; i < pinCount; i++)
+    {
+        if (pins[i] == pin)
+            return i;
+    }
+
+    if (running || pinCount >= ADC_MAX_CHANNELS)
+    {
+        DEBUG_PRINTF("[ADC] Cannot add pin %d\n", pin);
+        return -1;
+    }
+
+    pins[pinCount] = pin;
+    return pinCount++;
+}
+
+/**
+ * @brief Start sampling the registered pins
+ *
+ * Call after the analog sensors' begin(). Handles returned by addPin()
+ * are also the demux slots: channels are added in the same order.
+ */
+bool AdcSampler::begin()
+{
+    if (running || pinCount == 0)
+        return running;
+
+    bool allOnAdc1 = true;
+    for (uint8_t i = 0; i < pinCount; i++)
+    {
+        if (adc1Channel(pins[i]) < 0)
+            allOnAdc1 = false;
+    }
+
+    dmaMode = ADC_USE_DMA && ADC_DMA_AVAILABLE && allOnAdc1 && beginDma();
+    if (!dmaMode)
+    {
+        demux.begin(ADC_POLL_DECIMATION);
+        for (uint8_t i = 0; i < pinCount; i++)
+        {
+            pinMode(pins[i], INPUT);
+            demux.addChannel(i);
+        }
+    }
+
+    if (xTaskCreatePinnedToCore(taskMain, "adc", ADC_TASK_STACK, this,
+                                ADC_TASK_PRIORITY, &task, ADC_TASK_CORE) != pdPASS)
+    {
+        DEBUG_PRINTLN("[ADC] ✗ Failed to create task");
+        return false;
+    }
+
+    running = true;
+    DEBUG_PRINTF("[ADC] %d channel(s), %s\n", pinCount, dmaMode ? "continuous DMA" : "polled");
+    return true;
+}
+
+/**
+ * @brief Configure ADC1 continuous mode over every registered channel
+ */
+bool AdcSampler::beginDma()
+{
+#if ADC_DMA_AVAILABLE
+    uint32_t mask = 0;
+    adc_digi_pattern_config_t pattern[ADC_MAX_CHANNELS] = {};
+
+    demux.begin(ADC_DMA_DECIMATION);
+    for (uint8_t i = 0; i < pinCount; i++)
+    {
+        uint8_t channel = adc1Channel(pins[i]);
+        demux.addChannel(channel);
+        mask |= 1UL << channel;
+
+        pattern[i].atten = ADC_ATTEN_DB_11; // 0-3.3 V, as analogRead()
+        pattern[i].channel = channel;
+        pattern[i].unit = 0; // ADC1
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = ADC_DMA_FRAME_BYTES * 4;
+    init.conv_num_each_intr = ADC_DMA_FRAME_BYTES;
+    init.adc1_chan_mask = mask;
+    init.adc2_chan_mask = 0;
+    if (adc_digi_initialize(&init) != ESP_OK)
+    {
+        DEBUG_PRINTLN("[ADC] Continuous mode unavailable, polling instead");
+        return false;
+    }
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = 1; // Required on the ESP32
+    config.conv_limit_num = 250;
+    config.pattern_num = pinCount;
+    config.adc_pattern = pattern;
+    config.sample_freq_hz = ADC_DMA_SAMPLE_RATE;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+
+    if (adc_digi_controller_configure(&config) != ESP_OK || adc_digi_start() != ESP_OK)
+    {
+        adc_digi_deinitialize();
+        DEBUG_PRINTLN("[ADC] Continuous mode unavailable, polling instead");
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AdcSampler::taskMain(void *arg)
+{
+    AdcSampler *self = static_cast<AdcSampler *>(arg);
+    if (self->dmaMode)
+        self->runDma();
+    else
+        self->runPolled();
+}
+
+/**
+ * @brief Block on the driver and filter each frame of results
+ */
+void AdcSampler::runDma()
+{
+#if ADC_DMA_AVAILABLE
+    uint8_t buffer[ADC_DMA_FRAME_BYTES];
+    for (;;)
+    {
+        uint32_t length = 0;
+        esp_err_t err = adc_digi_read_bytes(buffer, sizeof(buffer), &length, ADC_DMA_TIMEOUT_MS);
+
+        // INVALID_STATE: the driver's buffer overflowed; what we got is still valid
+        if (err == ESP_ERR_INVALID_STATE)
+            overruns++;
+        if (length > 0)
+            demux.process(buffer, length);
+    }
+#endif
+}
+
+void AdcSampler::runPolled()
+{
+    TickType_t wake = xTaskGetTickCount();
+    for (;;)
+    {
+        for (uint8_t i = 0; i < pinCount; i++)
+        {
+            demux.push(i, analogRead(pins[i]));
+        }
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(ADC_POLL_INTERVAL));
+    }
+}
@@ -0,0 +1,62 @@
+/**
+ * @file AdcSampler.h
+ * @brief Shared background sampling of the analog sensor pins
+ *
+ * Analog sensors register their pin in begin() and read a filtered
+ * value with getAverage(), which is a single load: all sampling and
+ * filtering happens on the "adc" task.
+ *
+ * - DMA mode: ADC1 runs in continuous mode at ADC_DMA_SAMPLE_RATE,
+ *   cycling through the registered channels. The task wakes once per
+ *   ADC_DMA_FRAME_BYTES of results and hands them to AdcDemux, which
+ *   decimates each channel by ADC_DMA_DECIMATION.
+ * - Polled mode: the task calls analogRead() on each pin every
+ *   ADC_POLL_INTERVAL ms and decimates by ADC_POLL_DECIMATION. Used when
+ *   ADC_USE_DMA is false, a pin is not on ADC1, or the driver fails.
+ *
+ * In DMA mode ADC1 (and I2S0, which carries the data on the ESP32)
+ * belongs to this sampler: do not analogRead() ADC1 pins elsewhere.
+ */
+
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include "../config.h"
+#include <Arduino.h>
+#include "AdcDemux.h"
+
+class AdcSampler
+{
+private:
+    AdcDemux demux;
+    uint8_t pins[ADC_MAX_CHANNELS];
+    uint8_t pinCount;
+    bool dmaMode;
+    bool running;
+    TaskHandle_t task;
+    uint32_t overruns; // DMA results lost because the task fell behind
+
+    static int8_t adc1Channel(uint8_t pin);
+    bool beginDma();
+    void runDma();
+    void runPolled();
+    static void taskMain(void *arg);
+
+public:
+    AdcSampler();
+
+    // Register a pin (before begin()); returns its channel handle or -1
+    int8_t addPin(uint8_t pin);
+    bool begin();
+
+    // Filtered raw value (0-4095), valid once isReady()
+    float getAverage(int8_t channel) const { return channel >= 0 ? demux.getAverage(channel) : 0.0f; }
+    bool isReady(int8_t channel) const { return channel >= 0 && demux.isReady(channel); }
+
+    bool isDmaMode() const { return dmaMode; }
+    uint32_t getOverruns() const { return overruns; }
+};
+
+extern AdcSampler adcSampler;
+
+#endif // ADC_SAMPLER_H
@@ -0,0 +1,72 @@
+/**
+ * @file DHTDecoder.cpp
+ * @brief DHT frame decoder implementation
+ */
+
+#include "DHTDecoder.h"
+
+DHTDecodeResult DHTDecoder::decode(const uint32_t *edges, uint8_t count, uint8_t type, DHTReading &reading)
+{
+    if (count == 0)
+        return DHT_DECODE_NO_RESPONSE;
+    if (count < DHT_FRAME_BITS + 1)
+        return DHT_DECODE_SHORT_FRAME;
+
+    // The response edge may have been missed; the bits are the last 41 edges
+    const uint32_t *bits = edges + count - (DHT_FRAME_BITS + 1);
+    uint8_t data[5] = {0, 0, 0, 0, 0};
+
+    for (uint8_t i = 0; i < DHT_FRAME_BITS; i++)
+    {
+        uint32_t period = bits[i + 1] - bits[i];
+        if (period < DHT_BIT_MIN_US || period > DHT_BIT_MAX_US)
+            return DHT_DECODE_BAD_TIMING;
+
+        data[i / 8] <<= 1;
+        if (period > DHT_BIT_ONE_US)
+            data[i / 8] |= 1;
+    }
+
+    return convert(data, type, reading) ? DHT_DECODE_OK : DHT_DECODE_CHECKSUM;
+}
+
+bool DHTDecoder::convert(const uint8_t *data, uint8_t type, DHTReading &reading)
+{
+    if ((uint8_t)(data[0] + data[1] + data[2] + data[3]) != data[4])
+        return false;
+
+    if (type == DHT11)
+    {
+        reading.humidity = data[0] + data[1] * 0.1f;
+        reading.temperature = data[2] + (data[3] & 0x7F) * 0.1f;
+        if (data[3] & 0x80)
+            reading.temperature = -reading.temperature;
+    }
+    else
+    {
+        // DHT21/22: tenths, sign in the top bit of the temperature
+        reading.humidity = ((data[0] << 8) | data[1]) * 0.1f;
+        reading.temperature = (((data[2] & 0x7F) << 8) | data[3]) * 0.1f;
+        if (data[2] & 0x80)
+            reading.temperature = -reading.temperature;
+    }
+    return true;
+}
+
+const char *DHTDecoder::describe(DHTDecodeResult result)
+{
+    switch (result)
+    {
+    case DHT_DECODE_OK:
+        return "ok";
+    case DHT_DECODE_NO_RESPONSE:
+        return "no response";
+    case DHT_DECODE_SHORT_FRAME:
+        return "short frame";
+    case DHT_DECODE_BAD_TIMING:
+        return "bad timing";
+    case DHT_DECODE_CHECKSUM:
+        return "checksum";
+    }
+    return "unknown";
+}
@@ -0,0 +1,66 @@
+/**
+ * @file DHTDecoder.h
+ * @brief Decoder for the DHT11/DHT22 single-wire frame
+ *
+ * The DHT driver timestamps every falling edge on the data line (in µs)
+ * from an interrupt and decodes the frame afterwards, outside the ISR.
+ * This class is the decoding half: plain code with no hardware access,
+ * so it can be run on a PC against recorded edge timings.
+ *
+ * After the host's start pulse the sensor sends:
+ *
+ *   response  80 µs low, 80 µs high
+ *   bit × 40  50 µs low, then 26-28 µs high (0) or 70 µs high (1)
+ *   trailer   50 µs low, then released
+ *
+ * Each bit therefore starts on a falling edge, and the time to the next
+ * falling edge is ~77 µs for a 0 and ~120 µs for a 1. The last 41 edges
+ * give the 40 bits. Bytes: humidity (2), temperature (2), checksum.
+ */
+
+#ifndef DHT_DECODER_H
+#define DHT_DECODER_H
+
+#include <stdint.h>
+
+#define DHT_FRAME_BITS 40
+#define DHT_FRAME_EDGES 42  // Response + 40 bits + trailer
+#define DHT_BIT_MIN_US 50   // Shortest valid bit period
+#define DHT_BIT_ONE_US 100  // Longer bit periods are a 1
+#define DHT_BIT_MAX_US 160  // Longest valid bit period
+
+enum DHTType
+{
+    DHT11 = 11,
+    DHT21 = 21, // AM2301, same frame as DHT22
+    DHT22 = 22
+};
+
+enum DHTDecodeResult
+{
+    DHT_DECODE_OK = 0,
+    DHT_DECODE_NO_RESPONSE, // No edges at all
+    DHT_DECODE_SHORT_FRAME, // Fewer than 41 edges
+    DHT_DECODE_BAD_TIMING,  // A bit period out of range
+    DHT_DECODE_CHECKSUM
+};
+
+struct DHTReading
+{
+    float temperature; // °C
+    float humidity;    // %RH
+};
+
+class DHTDecoder
+{
+public:
+    // Decode falling-edge timestamps (µs, wrapping allowed) into a reading
+    static DHTDecodeResult decode(const uint32_t *edges, uint8_t count, uint8_t type, DHTReading &reading);
+
+    // Turn the 5 frame bytes into values (false on checksum mismatch)
+    static bool convert(const uint8_t *data, uint8_t type, DHTReading &reading);
+
+    static const char *describe(DHTDecodeResult result);
+};
+
+#endif // DHT_DECODER_H
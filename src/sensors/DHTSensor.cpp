@@ -4,75 +4,180 @@
  */
 
 #include "DHTSensor.h"
+#include <driver/gpio.h>
 
-DHTSensor::DHTSensor()
+DHTSensor::DHTSensor(uint8_t dataPin, uint8_t sensorType)
 {
-    dht = nullptr;
+    pin = dataPin;
+    type = sensorType;
     lastTemp = 0;
     lastHumidity = 0;
     lastReadTime = 0;
     initialized = false;
+
+    startTimer = nullptr;
+    reading = false;
+    readStarted = 0;
+    capturing = false;
+    edgeCount = 0;
+    lastResult = DHT_DECODE_NO_RESPONSE;
+    errorCount = 0;
+    completeCallback = nullptr;
+    callbackContext = nullptr;
 }
 
 DHTSensor::~DHTSensor()
 {
-    if (dht)
-        delete dht;
+    if (initialized)
+    {
+        detachInterrupt(pin);
+    }
+    if (startTimer)
+    {
+        esp_timer_stop(startTimer);
+        esp_timer_delete(startTimer);
+    }
 }
 
+/**
+ * @brief Set up the data line and edge capture
+ *
+ * The line is open-drain with input enabled, so the same pin drives the
+ * start pulse and receives the frame without reconfiguring it (and the
+ * interrupt) on every read. The sensor cannot be probed without a full
+ * transaction, so a missing sensor shows up as failed reads.
+ */
 bool DHTSensor::begin()
 {
     DEBUG_PRINT("Initializing DHT sensor on pin ");
-    DEBUG_PRINTLN(DHT_PIN);
+    DEBUG_PRINTLN(pin);
 
-    dht = new DHT(DHT_PIN, DHT_TYPE);
-    dht->begin();
-
-    delay(2000); // DHT needs time to stabilize
-
-    // Test read
-    float t = dht->readTemperature();
-    if (isnan(t))
+    esp_timer_create_args_t args = {};
+    args.callback = releaseLine;
+    args.arg = this;
+    args.name = "dht";
+    if (esp_timer_create(&args, &startTimer) != ESP_OK)
     {
-        DEBUG_PRINTLN("DHT sensor not detected!");
-        initialized = false;
+        DEBUG_PRINTLN("DHT: timer create failed");
         return false;
     }
 
+    pinMode(pin, INPUT_PULLUP);
+    gpio_set_direction((gpio_num_t)pin, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_set_level((gpio_num_t)pin, 1);
+    attachInterruptArg(pin, edgeISR, this, FALLING);
+
     initialized = true;
     DEBUG_PRINTLN("DHT sensor ready!");
     return true;
 }
 
-bool DHTSensor::read()
+/**
+ * @brief Begin a transaction: hold the line low for the start pulse
+ * @return false if not initialized or a read is already in flight
+ */
+bool DHTSensor::startRead()
 {
-    if (!initialized)
+    if (!initialized || reading)
         return false;
 
-    // Don't read more than once every 2 seconds
-    if (millis() - lastReadTime < 2000)
-        return true;
+    capturing = false;
+    edgeCount = 0;
+    gpio_set_level((gpio_num_t)pin, 0);
 
-    float temp = dht->readTemperature() + TEMP_OFFSET;
-    float hum = dht->readHumidity() + HUMIDITY_OFFSET;
+    // DHT11 needs at least 18 ms, DHT21/22 at least 1 ms
+    esp_timer_start_once(startTimer, type == DHT11 ? 20000 : 1100);
 
-    if (isnan(temp) || isnan(hum))
+    reading = true;
+    readStarted = millis();
+    return true;
+}
+
+/**
+ * @brief End of the start pulse (esp_timer task): release and capture
+ */
+void DHTSensor::releaseLine(void *arg)
+{
+    DHTSensor *self = static_cast<DHTSensor *>(arg);
+    self->edgeCount = 0;
+    self->capturing = true;
+    gpio_set_level((gpio_num_t)self->pin, 1);
+}
+
+void IRAM_ATTR DHTSensor::edgeISR(void *arg)
+{
+    DHTSensor *self = static_cast<DHTSensor *>(arg);
+    if (!self->capturing)
+        return;
+
+    uint8_t count = self->edgeCount;
+    self->edges[count++] = (uint32_t)esp_timer_get_time();
+    self->edgeCount = count;
+
+    if (count >= DHT_FRAME_EDGES)
     {
-        DEBUG_PRINTLN("Failed to read from DHT sensor!");
+        self->capturing = false;
+        if (self->completeCallback)
+            self->completeCallback(self->callbackContext);
+    }
+}
+
+/**
+ * @brief True once the frame is complete or the read has timed out
+ */
+bool DHTSensor::isReadDone()
+{
+    return reading && (edgeCount >= DHT_FRAME_EDGES || millis() - readStarted >= DHT_READ_TIMEOUT_MS);
+}
+
+/**
+ * @brief Stop capturing and decode the frame
+ * @return true if the frame was valid (values updated)
+ */
+bool DHTSensor::finishRead()
+{
+    if (!reading)
+        return false;
+
+    esp_timer_stop(startTimer);
+    capturing = false;
+    gpio_set_level((gpio_num_t)pin, 1);
+    reading = false;
+
+    uint32_t frame[DHT_FRAME_EDGES];
+    uint8_t count = edgeCount;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        frame[i] = edges[i];
+    }
+
+    DHTReading result;
+    lastResult = DHTDecoder::decode(frame, count, type, result);
+    if (lastResult != DHT_DECODE_OK)
+    {
+        errorCount++;
+        DEBUG_PRINTF("Failed to read from DHT sensor: %s (%d edges)\n",
+                     DHTDecoder::describe(lastResult), count);
         return false;
     }
 
-    lastTemp = temp;
-    lastHumidity = hum;
+    lastTemp = result.temperature + TEMP_OFFSET;
+    lastHumidity = result.humidity + HUMIDITY_OFFSET;
     lastReadTime = millis();
 
 #if DEBUG_SENSORS
-    DEBUG_PRINTF("DHT - Temp: %.1f°C, Humidity: %.1f%%\n", temp, hum);
+    DEBUG_PRINTF("DHT - Temp: %.1f°C, Humidity: %.1f%%\n", lastTemp, lastHumidity);
 #endif
 
     return true;
 }
 
+void DHTSensor::setCompleteCallback(DHTCompleteCallback callback, void *context)
+{
+    completeCallback = callback;
+    callbackContext = context;
+}
+
 float DHTSensor::getTemperature()
 {
     return lastTemp;
@@ -83,14 +188,35 @@ float DHTSensor::getHumidity()
     return lastHumidity;
 }
 
+/**
+ * @brief Heat index in °C (NOAA Rothfusz regression, as in the Adafruit library)
+ */
 float DHTSensor::getHeatIndex()
 {
     if (!initialized)
         return 0;
-    return dht->computeHeatIndex(lastTemp, lastHumidity, false);
+
+    float f = lastTemp * 1.8f + 32.0f;
+    float h = lastHumidity;
+    float hi = 0.5f * (f + 61.0f + ((f - 68.0f) * 1.2f) + (h * 0.094f));
+
+    if (hi > 79.0f)
+    {
+        hi = -42.379f + 2.04901523f * f + 10.14333127f * h +
+             -0.22475541f * f * h + -0.00683783f * f * f +
+             -0.05481717f * h * h + 0.00122874f * f * f * h +
+             0.00085282f * f * h * h + -0.00000199f * f * f * h * h;
+
+        if (h < 13.0f && f >= 80.0f && f <= 112.0f)
+            hi -= ((13.0f - h) * 0.25f) * sqrtf((17.0f - fabsf(f - 95.0f)) * 0.05882f);
+        else if (h > 85.0f && f >= 80.0f && f <= 87.0f)
+            hi += ((h - 85.0f) * 0.1f) * ((87.0f - f) * 0.2f);
+    }
+
+    return (hi - 32.0f) * 0.55555f;
 }
 
 bool DHTSensor::isAvailable()
 {
     return initialized;
-}
\ No newline at end of file
+}
@@ -1,34 +1,77 @@
 /**
  * @file DHTSensor.h
  * @brief DHT22 Temperature and Humidity Sensor Interface
+ *
+ * Reads the sensor without blocking and without masking interrupts:
+ *
+ *   startRead()   pull the line low; an esp_timer releases it after the
+ *                 start pulse and arms edge capture
+ *   edge ISR      timestamps each falling edge (one store per edge)
+ *   finishRead()  decode the captured frame with DHTDecoder
+ *
+ * One transaction gives both temperature and humidity. The completion
+ * callback runs in the ISR when the last edge arrives, so the caller can
+ * schedule finishRead() instead of polling for it.
  */
 
 #ifndef DHT_SENSOR_H
 #define DHT_SENSOR_H
 
 #include <Arduino.h>
-#include <DHT.h>
+#include <esp_timer.h>
+#include "DHTDecoder.h"
 #include "../config.h"
 
+#define DHT_READ_TIMEOUT_MS 50 // Start pulse + frame, with margin
+
+// Called from the edge ISR when a full frame is captured; must be IRAM-safe
+typedef void (*DHTCompleteCallback)(void *context);
+
 class DHTSensor
 {
 private:
-    DHT *dht;
+    uint8_t pin;
+    uint8_t type;
     float lastTemp;
     float lastHumidity;
     uint32_t lastReadTime;
     bool initialized;
 
+    // Transaction state
+    esp_timer_handle_t startTimer;
+    bool reading;
+    uint32_t readStarted;
+    volatile bool capturing;
+    volatile uint8_t edgeCount;
+    volatile uint32_t edges[DHT_FRAME_EDGES];
+    DHTDecodeResult lastResult;
+    uint32_t errorCount;
+
+    DHTCompleteCallback completeCallback;
+    void *callbackContext;
+
+    static void releaseLine(void *arg);
+    static void IRAM_ATTR edgeISR(void *arg);
+
 public:
-    DHTSensor();
+    DHTSensor(uint8_t dataPin = DHT_PIN, uint8_t sensorType = DHT_TYPE);
     ~DHTSensor();
 
     bool begin();
-    bool read();
+
+    // Asynchronous read
+    bool startRead();
+    bool isReading() { return reading; }
+    bool isReadDone();
+    bool finishRead();
+    void setCompleteCallback(DHTCompleteCallback callback, void *context);
+
     float getTemperature();
     float getHumidity();
     float getHeatIndex();
     bool isAvailable();
+    DHTDecodeResult getLastResult() { return lastResult; }
+    uint32_t getErrorCount() { return errorCount; }
 };
 
-#endif
\ No newline at end of file
+#endif
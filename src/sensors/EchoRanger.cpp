@@ -0,0 +1,143 @@
+/**
+ * @file EchoRanger.cpp
+ * @brief Ping state machine and filtering for the HC-SR04
+ */
+
+#include "EchoRanger.h"
+
+EchoRanger::EchoRanger()
+{
+    state = ECHO_IDLE;
+    riseUs = 0;
+    fallUs = 0;
+    armedUs = 0;
+    begin(5, 2.0f, 400.0f, 30000);
+    setTemperature(ECHO_DEFAULT_TEMPERATURE);
+}
+
+void EchoRanger::begin(uint8_t medianWindow, float minCm, float maxCm, uint32_t timeoutMicros)
+{
+    window = medianWindow < 1 ? 1 : (medianWindow > ECHO_MAX_WINDOW ? ECHO_MAX_WINDOW : medianWindow);
+    minDistance = minCm;
+    maxDistance = maxCm;
+    timeoutUs = timeoutMicros;
+    count = 0;
+    next = 0;
+    median = 0.0f;
+    rejected = 0;
+}
+
+void EchoRanger::setTemperature(float celsius)
+{
+    // m/s -> cm/µs
+    soundSpeed = (331.3f + 0.606f * celsius) * 1.0e-4f;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PING
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Start waiting for an echo; call right before the TRIG pulse
+ */
+void EchoRanger::arm(uint32_t nowUs)
+{
+    armedUs = nowUs;
+    state = ECHO_TRIGGERED;
+}
+
+/**
+ * @brief Echo pin edge (ISR)
+ *
+ * Edges outside a ping (a late fall after a timeout, noise) are ignored.
+ */
+bool IRAM_ATTR EchoRanger::onEdge(bool high, uint32_t nowUs)
+{
+    uint8_t current = state;
+    if (current == ECHO_TRIGGERED && high)
+    {
+        riseUs = nowUs;
+        state = ECHO_HIGH;
+    }
+    else if (current == ECHO_HIGH && !high)
+    {
+        fallUs = nowUs;
+        state = ECHO_DONE;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Finish the ping if its echo is in or it has timed out
+ * @param widthUs Echo width when the result is ECHO_OK
+ */
+EchoResult EchoRanger::collect(uint32_t nowUs, uint32_t &widthUs)
+{
+    uint8_t current = state;
+    if (current == ECHO_IDLE)
+        return ECHO_NOT_ARMED;
+
+    if (current == ECHO_DONE)
+    {
+        widthUs = fallUs - riseUs;
+        state = ECHO_IDLE;
+        return ECHO_OK;
+    }
+
+    if (nowUs - armedUs < timeoutUs)
+        return ECHO_PENDING;
+
+    // The ISR may finish the echo between the check above and here; a
+    // DONE that loses this race is simply dropped with the ping
+    state = ECHO_IDLE;
+    return current == ECHO_HIGH ? ECHO_NO_END : ECHO_NO_RESPONSE;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FILTER
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Distance for an echo width (the sound travels there and back)
+ */
+float EchoRanger::toDistance(uint32_t widthUs) const
+{
+    return widthUs * soundSpeed * 0.5f;
+}
+
+/**
+ * @brief Add a ping to the median window
+ */
+bool EchoRanger::addEcho(uint32_t widthUs)
+{
+    float distance = toDistance(widthUs);
+    if (distance < minDistance || distance > maxDistance)
+    {
+        rejected++;
+        return false;
+    }
+
+    distances[next] = distance;
+    next = (next + 1) % window;
+    if (count < window)
+        count++;
+
+    // Insertion sort of at most ECHO_MAX_WINDOW values
+    float sorted[ECHO_MAX_WINDOW];
+    for (uint8_t i = 0; i < count; i++)
+    {
+        float value = distances[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > value)
+        {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+
+    // Even count (while filling): mean of the middle two
+    median = (count & 1) ? sorted[count / 2] : 0.5f * (sorted[count / 2 - 1] + sorted[count / 2]);
+    return true;
+}
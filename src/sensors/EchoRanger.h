@@ -0,0 +1,96 @@
+/**
+ * @file EchoRanger.h
+ * @brief Ping state machine and filtering for the HC-SR04
+ *
+ * The driver pulses TRIG, and an interrupt on both edges of ECHO feeds
+ * onEdge() with the pin level and a µs timestamp. Nothing waits for the
+ * echo:
+ *
+ *   arm()       IDLE -> TRIGGERED, just before the TRIG pulse
+ *   onEdge()    TRIGGERED -(rise)-> HIGH -(fall)-> DONE   (ISR)
+ *   collect()   DONE -> IDLE with the echo width, or a timeout
+ *
+ * The width becomes a distance with the speed of sound at the air
+ * temperature (331.3 + 0.606 T m/s, ~0.18%/°C), and the reported
+ * distance is the median of the last `window` good pings, which drops
+ * single-ping outliers (multipath, crosstalk) that an average smears in.
+ *
+ * No hardware access: a simulated echo can drive it on a PC.
+ */
+
+#ifndef ECHO_RANGER_H
+#define ECHO_RANGER_H
+
+#include <stdint.h>
+
+#if defined(ESP_PLATFORM)
+#include <esp_attr.h>
+#else
+#define IRAM_ATTR
+#endif
+
+#define ECHO_MAX_WINDOW 9           // Pings in the median (odd)
+#define ECHO_DEFAULT_TEMPERATURE 20 // °C until a reading is given
+
+enum EchoState
+{
+    ECHO_IDLE = 0,
+    ECHO_TRIGGERED, // Waiting for the echo to start
+    ECHO_HIGH,      // Echo in progress
+    ECHO_DONE       // Width captured, waiting for collect()
+};
+
+enum EchoResult
+{
+    ECHO_PENDING = 0, // Ping still in flight
+    ECHO_OK,          // Width available
+    ECHO_NO_RESPONSE, // Timed out without an echo (sensor missing?)
+    ECHO_NO_END,      // Echo started but did not end in time
+    ECHO_NOT_ARMED    // No ping in flight
+};
+
+class EchoRanger
+{
+private:
+    // Written by onEdge() in the ISR
+    volatile uint8_t state;
+    volatile uint32_t riseUs;
+    volatile uint32_t fallUs;
+    uint32_t armedUs;
+    uint32_t timeoutUs;
+
+    // Filter
+    float distances[ECHO_MAX_WINDOW]; // Ring of good pings (cm)
+    uint8_t window;
+    uint8_t count;
+    uint8_t next;
+    float soundSpeed; // cm/µs
+    float minDistance;
+    float maxDistance;
+    float median;
+    uint32_t rejected;
+
+public:
+    EchoRanger();
+
+    // Settings (window is clamped to 1..ECHO_MAX_WINDOW)
+    void begin(uint8_t medianWindow, float minCm, float maxCm, uint32_t timeoutMicros);
+    void setTemperature(float celsius);
+    float getSoundSpeed() const { return soundSpeed * 10000.0f; } // m/s
+
+    // Ping
+    void arm(uint32_t nowUs);
+    bool IRAM_ATTR onEdge(bool high, uint32_t nowUs); // true when the echo ended
+    EchoResult collect(uint32_t nowUs, uint32_t &widthUs);
+    bool isArmed() const { return state != ECHO_IDLE; }
+    uint8_t getState() const { return state; }
+
+    // Filter: false if the width is out of range (not added)
+    bool addEcho(uint32_t widthUs);
+    float toDistance(uint32_t widthUs) const;
+    float getDistance() const { return median; } // cm, 0 before the first ping
+    uint8_t getCount() const { return count; }
+    uint32_t getRejected() const { return rejected; }
+};
+
+#endif // ECHO_RANGER_H
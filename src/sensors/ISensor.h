@@ -0,0 +1,83 @@
+/**
+ * @file ISensor.h
+ * @brief Common interface for sensors managed by SensorManager
+ *
+ * A sensor is polled by the registry at its own period (or when it asks
+ * for a poll from an interrupt) and reports its latest values as a small
+ * list of named fields. Only poll() may touch the hardware; readFields()
+ * must return cached values, so the registry can call it right after a
+ * poll and consumers never trigger bus I/O.
+ *
+ * A sensor whose reading takes a while (DHT) starts it in poll() and
+ * returns SENSOR_POLL_PENDING, then requests another poll when the data
+ * is in and returns the outcome from that one.
+ *
+ * A sensor that reports discrete events (PIR) returns SENSOR_POLL_EVENT
+ * for a reading that should reach subscribers right away instead of
+ * with the next publication round.
+ */
+
+#ifndef ISENSOR_H
+#define ISENSOR_H
+
+#include <Arduino.h>
+
+#define SENSOR_MAX_FIELDS 10 // Fields one sensor may report
+
+enum SensorPollResult
+{
+    SENSOR_POLL_FAILED = 0,
+    SENSOR_POLL_OK,
+    SENSOR_POLL_PENDING, // Reading in progress; no outcome yet
+    SENSOR_POLL_EVENT    // Good reading to publish immediately
+};
+
+// How a field is written to JSON
+enum SensorFieldType
+{
+    SENSOR_FIELD_FLOAT = 0,
+    SENSOR_FIELD_INT,
+    SENSOR_FIELD_BOOL
+};
+
+struct SensorField
+{
+    const char *name; // JSON key (static string)
+    uint8_t type;     // SensorFieldType
+    float value;
+};
+
+class ISensor
+{
+public:
+    virtual ~ISensor() {}
+
+    virtual const char *getName() const = 0;
+
+    // Probe the hardware; false = not present (never polled)
+    virtual bool begin() = 0;
+    // Take one reading (on failure the previous values are kept)
+    virtual SensorPollResult poll() = 0;
+    // Latest values into fields[0..SENSOR_MAX_FIELDS); returns the count
+    virtual uint8_t readFields(SensorField *fields) = 0;
+    // Milliseconds between polls; 0 = only when requested (see requestPoll)
+    virtual uint32_t getPeriod() const = 0;
+    // false = must keep its period even when its values are stable
+    // (FIFO drains, filters that integrate over time, event sensors)
+    virtual bool canSlowDown() const { return true; }
+
+protected:
+    static SensorPollResult pollResult(bool ok)
+    {
+        return ok ? SENSOR_POLL_OK : SENSOR_POLL_FAILED;
+    }
+
+    static void setField(SensorField &field, const char *name, uint8_t type, float value)
+    {
+        field.name = name;
+        field.type = type;
+        field.value = value;
+    }
+};
+
+#endif // ISENSOR_H
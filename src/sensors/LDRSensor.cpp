@@ -6,46 +6,44 @@
  */
 
 #include "LDRSensor.h"
+#include "AdcSampler.h"
 #include "../utils/Logger.h"
 
-LDRSensor::LDRSensor(uint8_t sensorPin, int sampleCount)
-    : pin(sensorPin), rawValue(0), voltage(0.0f), lux(0.0f),
-      samples(sampleCount), sampleIndex(0)
+LDRSensor::LDRSensor(uint8_t sensorPin)
+    : pin(sensorPin), rawValue(0), voltage(0.0f), lux(0.0f), channel(-1)
 {
-    sampleBuffer = new int[samples];
-    for (int i = 0; i < samples; i++)
-    {
-        sampleBuffer[i] = 0;
-    }
-}
-
-LDRSensor::~LDRSensor()
-{
-    delete[] sampleBuffer;
 }
 
+/**
+ * @brief Register the pin with the ADC sampler (start it afterwards)
+ */
 bool LDRSensor::begin()
 {
-    pinMode(pin, INPUT);
+    channel = adcSampler.addPin(pin);
+    if (channel < 0)
+        return false;
+
     DEBUG_PRINTLN("[LDR] LDR sensor initialized on pin " + String(pin));
     return true;
 }
 
-bool LDRSensor::readLight()
+/**
+ * @brief True once the sampler has a filtered value for the pin
+ */
+bool LDRSensor::isReady()
 {
-    // Read raw ADC value
-    int raw = analogRead(pin);
-
-    // Store in circular buffer
-    sampleBuffer[sampleIndex] = raw;
-    sampleIndex = (sampleIndex + 1) % samples;
+    return adcSampler.isReady(channel);
+}
 
-    // Calculate average voltage
-    voltage = getAverageVoltage();
+bool LDRSensor::readLight()
+{
+    if (!isReady())
+        return false;
 
-    // Calculate lux
-    lux = calculateLux(raw);
-    rawValue = raw;
+    // Filtered by the ADC sampler
+    rawValue = (int)(adcSampler.getAverage(channel) + 0.5f);
+    voltage = (rawValue * 3.3f) / 4095.0f;
+    lux = calculateLux(rawValue);
 
     DEBUG_PRINT("[LDR] Raw: " + String(rawValue) + ", Voltage: " + String(voltage, 2) + "V, Lux: " + String(lux, 2));
     DEBUG_PRINTLN(", Level: " + getLightLevel());
@@ -84,34 +82,23 @@ String LDRSensor::getLightLevel()
         return "Very Bright";
 }
 
+/**
+ * @brief Lux estimate from the raw reading
+ *
+ * The model is Lux = k / (Rratio + 1) with Rratio = (Vref - Vout) / Vout.
+ * Rratio + 1 = Vref / Vout, so it reduces to k * Vout / Vref: a straight
+ * line in the raw value, one multiply instead of two divisions.
+ */
 float LDRSensor::calculateLux(int rawValue)
 {
-    // Convert raw ADC value to voltage (assuming 3.3V reference)
-    float voltage = (rawValue * 3.3f) / 4095.0f;
-
-    // Simple approximation for lux calculation
-    // This is a rough estimate and may need calibration for your specific LDR
-    if (voltage < 0.1f)
-        return 0.0f;
-
-    // LDR resistance decreases with light, so voltage increases
-    // Using a simplified formula: Lux = k * (Vref - Vout) / Vout
-    float resistanceRatio = (3.3f - voltage) / voltage;
-
     // Empirical constant for typical LDR (may need calibration)
-    float lux = 1000.0f / (resistanceRatio + 1.0f);
+    static constexpr float LUX_FULL_SCALE = 1000.0f;
+    static constexpr float LUX_PER_COUNT = LUX_FULL_SCALE / 4095.0f;
 
-    return lux;
-}
+    // Below 0.1 V the estimate is meaningless (0.1 / 3.3 of full scale)
+    static constexpr int MIN_RAW = (int)(0.1f * 4095.0f / 3.3f) + 1;
 
-float LDRSensor::getAverageVoltage()
-{
-    long sum = 0;
-    for (int i = 0; i < samples; i++)
-    {
-        sum += sampleBuffer[i];
-    }
-
-    int average = sum / samples;
-    return (average * 3.3f) / 4095.0f;
+    if (rawValue < MIN_RAW)
+        return 0.0f;
+    return rawValue * LUX_PER_COUNT;
 }
@@ -18,15 +18,13 @@ private:
     int rawValue;
     float voltage;
     float lux;
-    int samples;
-    int sampleIndex;
-    int *sampleBuffer;
+    int8_t channel; // adcSampler handle
 
 public:
-    LDRSensor(uint8_t sensorPin, int sampleCount = LDR_SAMPLES);
-    ~LDRSensor();
+    LDRSensor(uint8_t sensorPin);
 
     bool begin();
+    bool isReady();
     bool readLight();
     int getRawValue();
     float getVoltage();
@@ -35,7 +33,6 @@ public:
 
 private:
     float calculateLux(int rawValue);
-    float getAverageVoltage();
 };
 
 #endif // LDR_SENSOR_H
@@ -8,11 +8,26 @@
 #include "MPU6050Sensor.h"
 #include "../utils/Logger.h"
 
+// ±2 g and ±250 °/s full scale (set in begin())
+static const float ACCEL_G_PER_LSB = 1.0f / 16384.0f;
+static const float GYRO_DPS_PER_LSB = 1.0f / 131.0f;
+static const float DPS_TO_RADS = PI / 180.0f;
+
 MPU6050Sensor::MPU6050Sensor() : mpu(), initialized(false)
 {
     ax = ay = az = 0.0f;
     gx = gy = gz = 0.0f;
     temp = 0.0f;
+
+    fifoMode = false;
+    fifoSamples = 0;
+    fifoOverflows = 0;
+    lastTempRead = 0;
+    sampleRate = 0.0f;
+    readyCount = 0;
+    batchCallback = nullptr;
+    callbackContext = nullptr;
+    vibration = nullptr;
 }
 
 bool MPU6050Sensor::begin()
@@ -34,6 +49,9 @@ bool MPU6050Sensor::begin()
     mpu.setFullScaleGyroRange(0);  // 250 deg/s range
     mpu.setDLPFMode(3);            // 44Hz bandwidth
 
+    // readSensors() is called every MPU_POLL_INTERVAL
+    fusion.begin(1000.0f / MPU_POLL_INTERVAL, MPU_FUSION_BETA);
+
     initialized = true;
     DEBUG_PRINTLN("[MPU6050] MPU6050 sensor initialized successfully");
 
@@ -57,23 +75,21 @@ bool MPU6050Sensor::readSensors()
     temp_raw = mpu.getTemperature();
 
     // Convert to g and deg/s
-    ax = ax_raw / 16384.0f;
-    ay = ay_raw / 16384.0f;
-    az = az_raw / 16384.0f;
+    ax = ax_raw * ACCEL_G_PER_LSB;
+    ay = ay_raw * ACCEL_G_PER_LSB;
+    az = az_raw * ACCEL_G_PER_LSB;
 
-    gx = gx_raw / 131.0f;
-    gy = gy_raw / 131.0f;
-    gz = gz_raw / 131.0f;
+    gx = gx_raw * GYRO_DPS_PER_LSB;
+    gy = gy_raw * GYRO_DPS_PER_LSB;
+    gz = gz_raw * GYRO_DPS_PER_LSB;
 
     // Convert temperature
     temp = temp_raw / 340.0f + 36.53f;
 
     // Apply calibration
     applyCalibration();
+    calculateOrientation();
 
-    DEBUG_PRINT("[MPU6050] Acc: " + String(ax, 2) + "," + String(ay, 2) + "," + String(az, 2) + "g ");
-    DEBUG_PRINT("Gyro: " + String(gx, 1) + "," + String(gy, 1) + "," + String(gz, 1) + "dps ");
-    DEBUG_PRINTLN("Temp: " + String(temp, 1) + "C");
 
     return true;
 }
@@ -131,21 +147,151 @@ bool MPU6050Sensor::calibrate()
     return true;
 }
 
+// ═══════════════════════════════════════════════════════════════════════════
+// FIFO ACQUISITION
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Sample accel + gyro into the FIFO at a fixed rate
+ * @param sampleRateHz 4-1000 Hz (1 kHz gyro output divided down)
+ */
+bool MPU6050Sensor::beginFifo(uint16_t sampleRateHz)
+{
+    if (!initialized)
+        return false;
+
+    // Sample rate = 1 kHz gyro output rate (DLPF on) / divider
+    uint16_t divider = 1000 / constrain(sampleRateHz, 4, 1000);
+    sampleRate = 1000.0f / divider;
+    mpu.setRate(divider - 1);
+
+    mpu.setFIFOEnabled(false);
+    mpu.setAccelFIFOEnabled(true);
+    mpu.setXGyroFIFOEnabled(true);
+    mpu.setYGyroFIFOEnabled(true);
+    mpu.setZGyroFIFOEnabled(true);
+    mpu.resetFIFO();
+    mpu.setFIFOEnabled(true);
+
+    fusion.begin(sampleRate, MPU_FUSION_BETA);
+    readyCount = 0;
+
+#ifdef MPU_INT_PIN
+    pinMode(MPU_INT_PIN, INPUT);
+    attachInterruptArg(MPU_INT_PIN, dataReadyISR, this, RISING);
+    mpu.setIntDataReadyEnabled(true);
+#endif
+
+    fifoMode = true;
+    DEBUG_PRINTF("[MPU6050] FIFO mode at %.0f Hz\n", sampleRate);
+    return true;
+}
+
+void IRAM_ATTR MPU6050Sensor::dataReadyISR(void *arg)
+{
+    MPU6050Sensor *self = static_cast<MPU6050Sensor *>(arg);
+    uint16_t count = self->readyCount + 1;
+    self->readyCount = count;
+
+    if (count == MPU_FIFO_BATCH && self->batchCallback)
+        self->batchCallback(self->callbackContext);
+}
+
+void MPU6050Sensor::setBatchCallback(MPUBatchCallback callback, void *context)
+{
+    batchCallback = callback;
+    callbackContext = context;
+}
+
+/**
+ * @brief Convert one FIFO sample and feed it to the filter
+ */
+void MPU6050Sensor::processSample(const uint8_t *raw)
+{
+    ax = (int16_t)((raw[0] << 8) | raw[1]) * ACCEL_G_PER_LSB;
+    ay = (int16_t)((raw[2] << 8) | raw[3]) * ACCEL_G_PER_LSB;
+    az = (int16_t)((raw[4] << 8) | raw[5]) * ACCEL_G_PER_LSB;
+    gx = (int16_t)((raw[6] << 8) | raw[7]) * GYRO_DPS_PER_LSB;
+    gy = (int16_t)((raw[8] << 8) | raw[9]) * GYRO_DPS_PER_LSB;
+    gz = (int16_t)((raw[10] << 8) | raw[11]) * GYRO_DPS_PER_LSB;
+
+    applyCalibration();
+    calculateOrientation();
+
+    if (vibration)
+        vibration->addSample(ax, ay, az);
+}
+
+/**
+ * @brief Drain every complete sample from the FIFO
+ * @return false if there was nothing to read (or no FIFO mode)
+ *
+ * One transaction for the count, then one per 10 samples. The latest
+ * sample is left in the accel/gyro getters. An overflowed FIFO is
+ * reset, since its byte stream may no longer be sample-aligned.
+ */
+bool MPU6050Sensor::readFifo()
+{
+    if (!initialized || !fifoMode)
+        return false;
+
+    readyCount = 0;
+
+    uint16_t count = mpu.getFIFOCount();
+    if (count >= MPU_FIFO_SIZE)
+    {
+        mpu.resetFIFO();
+        fifoOverflows++;
+        DEBUG_PRINTLN("[MPU6050] FIFO overflow, reset");
+        return false;
+    }
+
+    uint16_t available = count / MPU_FIFO_SAMPLE_BYTES;
+    if (available == 0)
+        return false;
+
+    uint8_t buffer[MPU_FIFO_BURST_SAMPLES * MPU_FIFO_SAMPLE_BYTES];
+    while (available > 0)
+    {
+        uint8_t batch = available < MPU_FIFO_BURST_SAMPLES ? available : MPU_FIFO_BURST_SAMPLES;
+        mpu.getFIFOBytes(buffer, batch * MPU_FIFO_SAMPLE_BYTES);
+        for (uint8_t i = 0; i < batch; i++)
+        {
+            processSample(buffer + i * MPU_FIFO_SAMPLE_BYTES);
+        }
+        available -= batch;
+        fifoSamples += batch;
+    }
+
+    // The temperature is not in the FIFO and changes slowly
+    if (millis() - lastTempRead >= 1000)
+    {
+        temp = mpu.getTemperature() / 340.0f + 36.53f;
+        lastTempRead = millis();
+    }
+
+    return true;
+}
+
+/**
+ * This driver has always called the tilt about X "pitch" (atan2(ay, az))
+ * and the tilt about Y "roll"; keep that so published values keep their
+ * meaning.
+ */
 float MPU6050Sensor::getPitch()
 {
-    return atan2(ay, az) * 180.0f / PI;
+    return fusion.getRoll();
 }
 
 float MPU6050Sensor::getRoll()
 {
-    return atan2(-ax, sqrt(ay * ay + az * az)) * 180.0f / PI;
+    return fusion.getPitch();
 }
 
 float MPU6050Sensor::getHeading()
 {
-    // For basic heading calculation using accelerometer only
-    // More accurate heading requires magnetometer
-    return atan2(ay, ax) * 180.0f / PI;
+    // Gyro-integrated yaw; drifts without a magnetometer
+    return fusion.getYaw();
 }
 
 String MPU6050Sensor::getOrientation()
@@ -186,6 +332,5 @@ void MPU6050Sensor::applyCalibration()
 
 void MPU6050Sensor::calculateOrientation()
 {
-    // This could implement sensor fusion algorithms like Kalman filter
-    // For now, using simple trigonometric calculations
+    fusion.update(gx * DPS_TO_RADS, gy * DPS_TO_RADS, gz * DPS_TO_RADS, ax, ay, az);
 }
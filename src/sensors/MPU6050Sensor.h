@@ -3,6 +3,18 @@
  * @brief MPU6050 Accelerometer and Gyroscope sensor control
  * @author Your Name
  * @version 2.0
+ *
+ * Two ways to read the chip:
+ * - readSensors(): one accel/gyro sample and the temperature per call
+ *   (two I2C transactions)
+ * - beginFifo() + readFifo(): the chip samples into its FIFO at a fixed
+ *   rate and readFifo() drains it in bursts of up to 10 samples per
+ *   transaction. With MPU_INT_PIN wired, the data-ready interrupt counts
+ *   samples and calls the batch callback every MPU_FIFO_BATCH of them.
+ *
+ * Every sample feeds a Madgwick filter, so pitch, roll and heading come
+ * from gyro + accelerometer fusion instead of the accelerometer alone.
+ * FIFO samples also go to the vibration analyzer, when one is attached.
  */
 
 #ifndef MPU6050_SENSOR_H
@@ -12,6 +24,15 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <MPU6050.h>
+#include "MadgwickFilter.h"
+#include "VibrationAnalyzer.h"
+
+#define MPU_FIFO_SIZE 1024          // Bytes
+#define MPU_FIFO_SAMPLE_BYTES 12    // Accel XYZ + gyro XYZ, big-endian int16
+#define MPU_FIFO_BURST_SAMPLES 10   // Per I2C read (Wire buffer is 128 bytes)
+
+// Called from the data-ready ISR every MPU_FIFO_BATCH samples; must be IRAM-safe
+typedef void (*MPUBatchCallback)(void *context);
 
 class MPU6050Sensor
 {
@@ -26,6 +47,20 @@ private:
     float accelBias[3] = {0, 0, 0};
     float gyroBias[3] = {0, 0, 0};
 
+    // Fusion and FIFO acquisition
+    MadgwickFilter fusion;
+    bool fifoMode;
+    uint32_t fifoSamples;
+    uint32_t fifoOverflows;
+    uint32_t lastTempRead;
+    float sampleRate; // Actual FIFO rate after the divider
+    volatile uint16_t readyCount; // Data-ready interrupts since the last drain
+    MPUBatchCallback batchCallback;
+    void *callbackContext;
+    VibrationAnalyzer *vibration;
+
+    static void IRAM_ATTR dataReadyISR(void *arg);
+
 public:
     MPU6050Sensor();
 
@@ -33,6 +68,16 @@ public:
     bool readSensors();
     bool calibrate();
 
+    // FIFO acquisition
+    bool beginFifo(uint16_t sampleRateHz);
+    bool readFifo();
+    void setBatchCallback(MPUBatchCallback callback, void *context);
+    void setVibrationAnalyzer(VibrationAnalyzer *analyzer) { vibration = analyzer; }
+    float getSampleRate() { return sampleRate; }
+    bool isFifoMode() { return fifoMode; }
+    uint32_t getFifoSamples() { return fifoSamples; }
+    uint32_t getFifoOverflows() { return fifoOverflows; }
+
     // Getters
     float getAccelX() { return ax; }
     float getAccelY() { return ay; }
@@ -51,6 +96,7 @@ public:
 private:
     void applyCalibration();
     void calculateOrientation();
+    void processSample(const uint8_t *raw);
 };
 
 #endif // MPU6050_SENSOR_H
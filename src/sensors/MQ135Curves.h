@@ -0,0 +1,117 @@
+/**
+ * @file MQ135Curves.h
+ * @brief Compile-time tables of the MQ135 gas curves over the ADC range
+ *
+ * Each gas follows PPM = a * (Rs / R0)^b, with the sensor resistance Rs
+ * a function of the raw reading (10 kΩ load, 3.3 V, 12-bit ADC):
+ *
+ *   Rs(raw) = RL * (4095 - raw) / raw
+ *
+ * R0 is only known at run time, so the curve is split as
+ *
+ *   PPM = (a * R0^-b) * Rs(raw)^b
+ *
+ * and Rs(raw)^b is tabulated for every gas at MQ135_TABLE_STEP intervals
+ * of raw. The factor a * R0^-b is computed once per calibration, so
+ * a reading is one table lookup shared by all gases plus a linear
+ * interpolation and a multiply per gas: no pow() per sample.
+ *
+ * Interpolation error vs. the formula (host check, step 8): under 0.3%
+ * for raw 200-3895, under 0.1% for raw 400-3695; it grows towards the
+ * rails where the curve is steepest (4% at raw 50). 10 KB of flash.
+ *
+ * No hardware access: the tables can be checked on a PC.
+ */
+
+#ifndef MQ135_CURVES_H
+#define MQ135_CURVES_H
+
+#include <stdint.h>
+#include "../utils/ConstexprMath.h"
+
+#define MQ135_TABLE_STEP 8 // Raw counts per table entry (power of two)
+#define MQ135_TABLE_SIZE (4096 / MQ135_TABLE_STEP + 1)
+#define MQ135_LOAD_KOHM 10.0
+
+enum MQ135Gas
+{
+    MQ135_NH3 = 0, // Ammonia
+    MQ135_CO,      // Carbon monoxide
+    MQ135_NOX,     // Nitrogen oxides
+    MQ135_ALCOHOL,
+    MQ135_SMOKE,
+    MQ135_GAS_COUNT
+};
+
+struct MQ135Curve
+{
+    float a; // Scale factor
+    float b; // Exponent
+    const char *name;
+};
+
+// Empirical curves
+inline constexpr MQ135Curve MQ135_CURVES[MQ135_GAS_COUNT] = {
+    {110.47f, -2.862f, "NH3"},
+    {100.0f, -2.75f, "CO"},
+    {76.63f, -3.18f, "NOx"},
+    {102.2f, -2.473f, "Alcohol"},
+    {98.4f, -2.862f, "Smoke"},
+};
+
+struct MQ135Table
+{
+    float values[MQ135_GAS_COUNT][MQ135_TABLE_SIZE]; // Rs(raw)^b
+};
+
+constexpr MQ135Table makeMQ135Table()
+{
+    MQ135Table table{};
+    for (int i = 0; i < MQ135_TABLE_SIZE; i++)
+    {
+        // Rs is infinite at 0 and zero at full scale; clamp to the last count
+        double raw = i * MQ135_TABLE_STEP;
+        if (raw < 1.0)
+            raw = 1.0;
+        if (raw > 4094.0)
+            raw = 4094.0;
+        double rs = MQ135_LOAD_KOHM * (4095.0 - raw) / raw;
+
+        for (int g = 0; g < MQ135_GAS_COUNT; g++)
+        {
+            table.values[g][i] = (float)ConstexprMath::pow(rs, MQ135_CURVES[g].b);
+        }
+    }
+    return table;
+}
+
+inline constexpr MQ135Table MQ135_TABLE = makeMQ135Table();
+
+/**
+ * @brief PPM of every gas for one raw reading
+ * @param raw Filtered ADC value (0-4095, fractional allowed)
+ * @param factors a * R0^-b per gas (from the calibration)
+ * @param ppm Output, MQ135_GAS_COUNT values
+ */
+inline void mq135Evaluate(float raw, const float *factors, float *ppm)
+{
+    if (raw < 0.0f)
+        raw = 0.0f;
+    if (raw > 4095.0f)
+        raw = 4095.0f;
+
+    float position = raw * (1.0f / MQ135_TABLE_STEP);
+    int index = (int)position;
+    if (index > MQ135_TABLE_SIZE - 2)
+        index = MQ135_TABLE_SIZE - 2;
+    float fraction = position - index;
+
+    for (int g = 0; g < MQ135_GAS_COUNT; g++)
+    {
+        const float *curve = MQ135_TABLE.values[g];
+        float value = curve[index] + fraction * (curve[index + 1] - curve[index]);
+        ppm[g] = factors[g] * value;
+    }
+}
+
+#endif // MQ135_CURVES_H
@@ -6,68 +6,46 @@
  */
 
 #include "MQ135Sensor.h"
+#include "AdcSampler.h"
 #include "../utils/Logger.h"
 
-MQ135Sensor::MQ135Sensor(uint8_t sensorPin, int sampleCount)
+MQ135Sensor::MQ135Sensor(uint8_t sensorPin)
     : pin(sensorPin), rawValue(0), voltage(0.0f), resistance(0.0f), ppm(0.0f), r0(0.0f),
-      samples(sampleCount), sampleIndex(0)
+      channel(-1)
 {
-    sampleBuffer = new int[samples];
-    for (int i = 0; i < samples; i++)
+    for (int g = 0; g < MQ135_GAS_COUNT; g++)
     {
-        sampleBuffer[i] = 0;
+        gasFactors[g] = 0.0f;
+        gasPPM[g] = 0.0f;
     }
-
-    initializeCalibration();
-}
-
-MQ135Sensor::~MQ135Sensor()
-{
-    delete[] sampleBuffer;
 }
 
-void MQ135Sensor::initializeCalibration()
+/**
+ * @brief Register the pin with the ADC sampler (start it afterwards)
+ */
+bool MQ135Sensor::begin()
 {
-    // MQ135 calibration values for different gases (empirical)
-    nh3.a = 110.47f; // Ammonia
-    nh3.b = -2.862f;
-    nh3.name = "NH3";
-
-    co.a = 100.0f; // Carbon Monoxide
-    co.b = -2.75f;
-    co.name = "CO";
-
-    nox.a = 76.63f; // Nitrogen Oxides
-    nox.b = -3.18f;
-    nox.name = "NOx";
+    channel = adcSampler.addPin(pin);
+    if (channel < 0)
+        return false;
 
-    alcohol.a = 102.2f; // Alcohol
-    alcohol.b = -2.473f;
-    alcohol.name = "Alcohol";
-
-    smoke.a = 98.4f; // Smoke
-    smoke.b = -2.862f;
-    smoke.name = "Smoke";
+    DEBUG_PRINTLN("[MQ135] MQ135 sensor initialized on pin " + String(pin));
+    return true;
 }
 
-bool MQ135Sensor::begin()
+bool MQ135Sensor::isReady()
 {
-    pinMode(pin, INPUT);
-    DEBUG_PRINTLN("[MQ135] MQ135 sensor initialized on pin " + String(pin));
-    return true;
+    return adcSampler.isReady(channel);
 }
 
 bool MQ135Sensor::readAirQuality()
 {
-    // Read raw ADC value
-    int raw = analogRead(pin);
-
-    // Store in circular buffer
-    sampleBuffer[sampleIndex] = raw;
-    sampleIndex = (sampleIndex + 1) % samples;
+    if (!isReady())
+        return false;
 
-    // Calculate average raw value
-    rawValue = getAverageRaw();
+    // Filtered by the ADC sampler
+    float average = adcSampler.getAverage(channel);
+    rawValue = (int)(average + 0.5f);
 
     // Calculate voltage
     voltage = (rawValue * 3.3f) / 4095.0f;
@@ -75,11 +53,11 @@ bool MQ135Sensor::readAirQuality()
     // Calculate resistance
     resistance = calculateResistance(rawValue);
 
-    // Calculate PPM (using NH3 as default)
+    // All gases from one table lookup (NH3 is the default PPM)
     if (r0 > 0.0f)
     {
-        float ratio = resistance / r0;
-        ppm = calculatePPM(ratio, nh3);
+        mq135Evaluate(average, gasFactors, gasPPM);
+        ppm = gasPPM[MQ135_NH3];
     }
 
     DEBUG_PRINT("[MQ135] Raw: " + String(rawValue) + ", Voltage: " + String(voltage, 2) + "V, ");
@@ -123,7 +101,14 @@ String MQ135Sensor::getAirQualityLevel()
         return "Very Poor";
 }
 
-void MQ135Sensor::calibrateR0(float knownR0)
+/**
+ * @brief Set R0, or measure it from the current reading (clean air)
+ * @return false if measuring and the sampler has no reading yet
+ *
+ * The sampler's filtered value already averages thousands of samples
+ * (DMA) or ~1 s of reads (polled), so no extra sampling loop is needed.
+ */
+bool MQ135Sensor::calibrateR0(float knownR0)
 {
     if (knownR0 > 0.0f)
     {
@@ -134,66 +119,60 @@ void MQ135Sensor::calibrateR0(float knownR0)
     {
         // Calculate R0 in clean air (typically 10-20kΩ for MQ135)
         // This should be done in fresh air for accurate calibration
-        float sum = 0.0f;
-        for (int i = 0; i < 100; i++)
-        {
-            int raw = analogRead(pin);
-            float voltage = (raw * 3.3f) / 4095.0f;
-            float resistance = calculateResistance(raw);
-            sum += resistance;
-            delay(10);
-        }
-
-        r0 = sum / 100.0f;
+        if (!isReady())
+            return false;
+
+        r0 = calculateResistance((int)(adcSampler.getAverage(channel) + 0.5f));
         DEBUG_PRINTLN("[MQ135] R0 auto-calibrated to: " + String(r0, 2) + "kΩ");
     }
+
+    // The only pow() calls: the R0 part of each curve
+    for (int g = 0; g < MQ135_GAS_COUNT; g++)
+    {
+        gasFactors[g] = r0 > 0.0f ? MQ135_CURVES[g].a * powf(r0, -MQ135_CURVES[g].b) : 0.0f;
+    }
+    return true;
 }
 
-float MQ135Sensor::calculatePPM(float ratio, GasCalibration gas)
+/**
+ * @brief Analytic curve, PPM = a * (Rs/R0)^b (reference for the tables)
+ */
+float MQ135Sensor::calculatePPM(float ratio, const MQ135Curve &gas)
 {
-    // MQ135 formula: PPM = a * (Rs/R0)^b
     // Where Rs is current resistance, R0 is clean air resistance
-    return gas.a * pow(ratio, gas.b);
+    return gas.a * powf(ratio, gas.b);
 }
 
-float MQ135Sensor::getNH3PPM()
+float MQ135Sensor::getGasPPM(MQ135Gas gas)
 {
     if (r0 <= 0.0f)
         return 0.0f;
-    float ratio = resistance / r0;
-    return calculatePPM(ratio, nh3);
+    return gasPPM[gas];
+}
+
+float MQ135Sensor::getNH3PPM()
+{
+    return getGasPPM(MQ135_NH3);
 }
 
 float MQ135Sensor::getCOPPM()
 {
-    if (r0 <= 0.0f)
-        return 0.0f;
-    float ratio = resistance / r0;
-    return calculatePPM(ratio, co);
+    return getGasPPM(MQ135_CO);
 }
 
 float MQ135Sensor::getNOxPPM()
 {
-    if (r0 <= 0.0f)
-        return 0.0f;
-    float ratio = resistance / r0;
-    return calculatePPM(ratio, nox);
+    return getGasPPM(MQ135_NOX);
 }
 
 float MQ135Sensor::getAlcoholPPM()
 {
-    if (r0 <= 0.0f)
-        return 0.0f;
-    float ratio = resistance / r0;
-    return calculatePPM(ratio, alcohol);
+    return getGasPPM(MQ135_ALCOHOL);
 }
 
 float MQ135Sensor::getSmokePPM()
 {
-    if (r0 <= 0.0f)
-        return 0.0f;
-    float ratio = resistance / r0;
-    return calculatePPM(ratio, smoke);
+    return getGasPPM(MQ135_SMOKE);
 }
 
 float MQ135Sensor::calculateResistance(int rawValue)
@@ -208,14 +187,3 @@ float MQ135Sensor::calculateResistance(int rawValue)
 
     return rLoad * (3.3f - vout) / vout;
 }
-
-int MQ135Sensor::getAverageRaw()
-{
-    long sum = 0;
-    for (int i = 0; i < samples; i++)
-    {
-        sum += sampleBuffer[i];
-    }
-
-    return sum / samples;
-}
@@ -3,6 +3,9 @@
  * @brief MQ135 Air Quality sensor control
  * @author Your Name
  * @version 2.0
+ *
+ * Every read evaluates all five gas curves from the precomputed tables
+ * in MQ135Curves.h; the getters return those cached values.
  */
 
 #ifndef MQ135_SENSOR_H
@@ -10,6 +13,7 @@
 
 #include "../config.h"
 #include <Arduino.h>
+#include "MQ135Curves.h"
 
 class MQ135Sensor
 {
@@ -20,29 +24,16 @@ private:
     float resistance;
     float ppm;
     float r0; // Clean air resistance
-    int samples;
-    int sampleIndex;
-    int *sampleBuffer;
+    int8_t channel; // adcSampler handle
 
-    // Calibration values for different gases
-    struct GasCalibration
-    {
-        float a; // Scale factor
-        float b; // Exponent
-        String name;
-    };
-
-    GasCalibration nh3;     // Ammonia
-    GasCalibration co;      // Carbon Monoxide
-    GasCalibration nox;     // Nitrogen Oxides
-    GasCalibration alcohol; // Alcohol
-    GasCalibration smoke;   // Smoke
+    float gasFactors[MQ135_GAS_COUNT]; // a * R0^-b, set by calibrateR0()
+    float gasPPM[MQ135_GAS_COUNT];     // From the last read
 
 public:
-    MQ135Sensor(uint8_t sensorPin, int sampleCount = 10);
-    ~MQ135Sensor();
+    MQ135Sensor(uint8_t sensorPin);
 
     bool begin();
+    bool isReady();
     bool readAirQuality();
     int getRawValue();
     float getVoltage();
@@ -50,8 +41,9 @@ public:
     float getPPM();
     String getAirQualityLevel();
 
-    void calibrateR0(float knownR0 = 0.0f);
-    float calculatePPM(float ratio, GasCalibration gas);
+    bool calibrateR0(float knownR0 = 0.0f);
+    float calculatePPM(float ratio, const MQ135Curve &gas);
+    float getGasPPM(MQ135Gas gas);
     float getNH3PPM();
     float getCOPPM();
     float getNOxPPM();
@@ -60,8 +52,6 @@ public:
 
 private:
     float calculateResistance(int rawValue);
-    int getAverageRaw();
-    void initializeCalibration();
 };
 
 #endif // MQ135_SENSOR_H
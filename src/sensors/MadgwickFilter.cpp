@@ -0,0 +1,149 @@
+/**
+ * @file MadgwickFilter.cpp
+ * @brief Madgwick IMU filter implementation
+ *
+ * Follows S. Madgwick, "An efficient orientation filter for inertial and
+ * inertial/magnetic sensor arrays" (2010), IMU variant.
+ */
+
+#include "MadgwickFilter.h"
+#include <math.h>
+
+#define RAD_TO_DEGREES 57.29577951f
+
+MadgwickFilter::MadgwickFilter()
+{
+    beta = 0.1f;
+    samplePeriod = 0.01f;
+    reset();
+}
+
+void MadgwickFilter::begin(float sampleRateHz, float gain)
+{
+    samplePeriod = 1.0f / sampleRateHz;
+    beta = gain;
+    reset();
+}
+
+void MadgwickFilter::reset()
+{
+    q0 = 1.0f;
+    q1 = q2 = q3 = 0.0f;
+    samples = 0;
+}
+
+float MadgwickFilter::invSqrt(float x)
+{
+    return 1.0f / sqrtf(x);
+}
+
+/**
+ * @brief Start from the tilt measured by the accelerometer (yaw 0)
+ */
+void MadgwickFilter::seed(float ax, float ay, float az)
+{
+    float roll = atan2f(ay, az) * 0.5f;
+    float pitch = atan2f(-ax, sqrtf(ay * ay + az * az)) * 0.5f;
+    float cr = cosf(roll), sr = sinf(roll);
+    float cp = cosf(pitch), sp = sinf(pitch);
+
+    q0 = cr * cp;
+    q1 = sr * cp;
+    q2 = cr * sp;
+    q3 = -sr * sp;
+}
+
+void MadgwickFilter::update(float gx, float gy, float gz, float ax, float ay, float az)
+{
+    if (samples == 0 && (ax != 0.0f || ay != 0.0f || az != 0.0f))
+    {
+        seed(ax, ay, az);
+    }
+
+    // Rate of change of the quaternion from the gyroscope
+    float qDot0 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    float qDot1 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    float qDot2 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    float qDot3 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    // Accelerometer correction (skipped in free fall)
+    float norm = ax * ax + ay * ay + az * az;
+    if (norm > 0.0f)
+    {
+        float recipNorm = invSqrt(norm);
+        ax *= recipNorm;
+        ay *= recipNorm;
+        az *= recipNorm;
+
+        float _2q0 = 2.0f * q0;
+        float _2q1 = 2.0f * q1;
+        float _2q2 = 2.0f * q2;
+        float _2q3 = 2.0f * q3;
+        float _4q0 = 4.0f * q0;
+        float _4q1 = 4.0f * q1;
+        float _4q2 = 4.0f * q2;
+        float _8q1 = 8.0f * q1;
+        float _8q2 = 8.0f * q2;
+        float q0q0 = q0 * q0;
+        float q1q1 = q1 * q1;
+        float q2q2 = q2 * q2;
+        float q3q3 = q3 * q3;
+
+        // Gradient of the gravity error
+        float s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+        float s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+        float s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+        float s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+
+        norm = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+        if (norm > 0.0f)
+        {
+            float step = beta * invSqrt(norm);
+            qDot0 -= step * s0;
+            qDot1 -= step * s1;
+            qDot2 -= step * s2;
+            qDot3 -= step * s3;
+        }
+    }
+
+    q0 += qDot0 * samplePeriod;
+    q1 += qDot1 * samplePeriod;
+    q2 += qDot2 * samplePeriod;
+    q3 += qDot3 * samplePeriod;
+
+    float recipNorm = invSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    q0 *= recipNorm;
+    q1 *= recipNorm;
+    q2 *= recipNorm;
+    q3 *= recipNorm;
+
+    samples++;
+}
+
+float MadgwickFilter::getRoll() const
+{
+    return atan2f(q0 * q1 + q2 * q3, 0.5f - q1 * q1 - q2 * q2) * RAD_TO_DEGREES;
+}
+
+float MadgwickFilter::getPitch() const
+{
+    float sinPitch = 2.0f * (q0 * q2 - q1 * q3);
+    if (sinPitch > 1.0f)
+        sinPitch = 1.0f;
+    else if (sinPitch < -1.0f)
+        sinPitch = -1.0f;
+    return asinf(sinPitch) * RAD_TO_DEGREES;
+}
+
+float MadgwickFilter::getYaw() const
+{
+    return atan2f(q1 * q2 + q0 * q3, 0.5f - q2 * q2 - q3 * q3) * RAD_TO_DEGREES;
+}
+
+void MadgwickFilter::getQuaternion(float &w, float &x, float &y, float &z) const
+{
+    w = q0;
+    x = q1;
+    y = q2;
+    z = q3;
+}
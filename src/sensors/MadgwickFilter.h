@@ -0,0 +1,51 @@
+/**
+ * @file MadgwickFilter.h
+ * @brief Madgwick gradient-descent orientation filter (gyro + accelerometer)
+ *
+ * Integrates the gyroscope into a quaternion and pulls it towards the
+ * gravity direction measured by the accelerometer, with gain beta. The
+ * sample period and gain are fixed in begin(), so update() is straight
+ * float arithmetic: three inverse square roots and no other divisions.
+ *
+ * The first sample sets roll and pitch straight from the accelerometer,
+ * so the output does not have to converge from level after a reset.
+ * Without a magnetometer yaw is gyro-only and drifts slowly.
+ *
+ * No hardware access: traces can be replayed through it on a PC.
+ */
+
+#ifndef MADGWICK_FILTER_H
+#define MADGWICK_FILTER_H
+
+#include <stdint.h>
+
+class MadgwickFilter
+{
+private:
+    float q0, q1, q2, q3; // Orientation, sensor frame relative to earth
+    float beta;
+    float samplePeriod; // Seconds
+    uint32_t samples;
+
+    static float invSqrt(float x);
+    void seed(float ax, float ay, float az);
+
+public:
+    MadgwickFilter();
+
+    void begin(float sampleRateHz, float gain);
+    void reset();
+
+    // Gyro in rad/s, accelerometer in any unit (only its direction is used)
+    void update(float gx, float gy, float gz, float ax, float ay, float az);
+
+    // Euler angles in degrees (computed on demand)
+    float getRoll() const;  // About X
+    float getPitch() const; // About Y
+    float getYaw() const;   // About Z (drifts without a magnetometer)
+
+    void getQuaternion(float &w, float &x, float &y, float &z) const;
+    uint32_t getSampleCount() const { return samples; }
+};
+
+#endif // MADGWICK_FILTER_H
@@ -0,0 +1,80 @@
+/**
+ * @file MotionTracker.cpp
+ * @brief Occupancy from the PIR output edges
+ */
+
+#include "MotionTracker.h"
+
+MotionTracker::MotionTracker()
+{
+    begin(0, 0, false, 0);
+}
+
+uint8_t MotionTracker::begin(uint32_t debounceMicros, uint32_t holdMicros, bool level, uint32_t nowUs)
+{
+    debounceUs = debounceMicros;
+    holdUs = holdMicros;
+    high = false;
+    occupied = false;
+    lastEdgeUs = nowUs;
+    lowSinceUs = nowUs;
+    lastTriggerUs = nowUs;
+    startedUs = nowUs;
+    triggers = 0;
+    bounces = 0;
+    resyncs = 0;
+
+    if (!level)
+        return MOTION_NONE;
+    return onEdge({nowUs, 1});
+}
+
+uint8_t MotionTracker::onEdge(const MotionEdge &edge)
+{
+    lastEdgeUs = edge.timeUs;
+
+    if (!edge.level)
+    {
+        if (high)
+            lowSinceUs = edge.timeUs;
+        high = false;
+        return MOTION_NONE;
+    }
+
+    // A repeated rise means a fall was lost; treat it as a new rise
+    high = true;
+    if (triggers == 0 || edge.timeUs - lastTriggerUs >= debounceUs)
+    {
+        triggers++;
+        lastTriggerUs = edge.timeUs;
+    }
+    else
+    {
+        bounces++;
+    }
+
+    if (occupied)
+        return MOTION_NONE;
+    occupied = true;
+    startedUs = edge.timeUs;
+    return MOTION_STARTED;
+}
+
+uint8_t MotionTracker::update(bool level, uint32_t nowUs)
+{
+    uint8_t events = MOTION_NONE;
+
+    // Edges went missing: follow the pin once it has settled
+    if (level != high && nowUs - lastEdgeUs >= debounceUs)
+    {
+        resyncs++;
+        events |= onEdge({nowUs, (uint8_t)level});
+    }
+
+    if (occupied && !high && nowUs - lowSinceUs >= holdUs)
+    {
+        occupied = false;
+        events |= MOTION_ENDED;
+    }
+    return events;
+}
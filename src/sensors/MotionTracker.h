@@ -0,0 +1,80 @@
+/**
+ * @file MotionTracker.h
+ * @brief Occupancy from the PIR output edges
+ *
+ * The PIR interrupt only timestamps edges into a ring; this class turns
+ * them into events, in task context:
+ *
+ *   rising edge    vacant -> occupied (MOTION_STARTED, right away)
+ *   falling edge   starts the hold time
+ *   hold elapsed   output still low -> vacant (MOTION_ENDED)
+ *
+ * A burst of edges (chatter on a long lead, the sensor retriggering)
+ * therefore gives one start and one end. Rising edges closer than the
+ * debounce time to the last counted one are bounces: they keep the room
+ * occupied but are not counted as new triggers.
+ *
+ * If edges were lost (ring overflow), update() resynchronizes with the
+ * pin level once it has been stable for the debounce time.
+ *
+ * Times are µs from a free-running 32-bit counter (wraps every ~71 min;
+ * only differences are used). No hardware access: edge bursts can be
+ * simulated on a PC.
+ */
+
+#ifndef MOTION_TRACKER_H
+#define MOTION_TRACKER_H
+
+#include <stdint.h>
+
+struct MotionEdge
+{
+    uint32_t timeUs;
+    uint8_t level; // Pin level after the edge
+};
+
+// Bits returned by onEdge() / update()
+enum MotionEvent : uint8_t
+{
+    MOTION_NONE = 0,
+    MOTION_STARTED = 0x01,
+    MOTION_ENDED = 0x02
+};
+
+class MotionTracker
+{
+private:
+    uint32_t debounceUs;
+    uint32_t holdUs;
+
+    bool high;     // Pin level as seen through the edges
+    bool occupied; // Motion, including the hold time
+    uint32_t lastEdgeUs;
+    uint32_t lowSinceUs;
+    uint32_t lastTriggerUs;
+    uint32_t startedUs;
+
+    uint32_t triggers;
+    uint32_t bounces;
+    uint32_t resyncs;
+
+public:
+    MotionTracker();
+
+    // level = pin level now, so a sensor already high starts occupied
+    uint8_t begin(uint32_t debounceMicros, uint32_t holdMicros, bool level, uint32_t nowUs);
+
+    uint8_t onEdge(const MotionEdge &edge);
+    // Hold timeout and resync; level = pin level read now
+    uint8_t update(bool level, uint32_t nowUs);
+
+    bool isOccupied() const { return occupied; }
+    bool isHigh() const { return high; }
+    uint32_t getStartedUs() const { return startedUs; }
+    uint32_t getLastTriggerUs() const { return lastTriggerUs; }
+    uint32_t getTriggers() const { return triggers; }
+    uint32_t getBounces() const { return bounces; }
+    uint32_t getResyncs() const { return resyncs; }
+};
+
+#endif // MOTION_TRACKER_H
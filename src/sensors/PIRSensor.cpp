@@ -7,56 +7,98 @@
 
 #include "PIRSensor.h"
 #include "../utils/Logger.h"
+#include <esp_timer.h>
 
-// Static member initialization
-PIRSensor *PIRSensor::instance = nullptr;
+PIRSensor::PIRSensor(uint8_t sensorPin, unsigned long debounceMs, unsigned long holdMs)
+    : pin(sensorPin), debounceTime(debounceMs), holdTime(holdMs), initialized(false),
+      overflows(0), lastMotionTime(0), pendingEvents(MOTION_NONE), motionCallback(nullptr), callbackContext(nullptr)
+{
+}
 
-PIRSensor::PIRSensor(uint8_t sensorPin, unsigned long debounceMs)
-    : pin(sensorPin), motionDetected(false), lastMotionTime(0), debounceTime(debounceMs)
+PIRSensor::~PIRSensor()
 {
-    instance = this;
+    if (initialized)
+    {
+        detachInterrupt(pin);
+    }
 }
 
 bool PIRSensor::begin()
 {
     pinMode(pin, INPUT);
 
-    // Attach interrupt for motion detection
-    attachInterrupt(digitalPinToInterrupt(pin), motionDetectedISR, RISING);
+    // A sensor that is already triggered starts the room occupied; the
+    // start is counted now and reported by the first update()
+    pendingEvents = tracker.begin(debounceTime * 1000, holdTime * 1000, digitalRead(pin) == HIGH,
+                                  (uint32_t)esp_timer_get_time());
+    if (pendingEvents & MOTION_STARTED)
+        lastMotionTime = millis();
+    attachInterruptArg(pin, edgeISR, this, CHANGE);
+    initialized = true;
 
     DEBUG_PRINTLN("[PIR] PIR sensor initialized on pin " + String(pin));
     return true;
 }
 
-bool PIRSensor::readMotion()
+/**
+ * @brief Pin change: queue the edge and wake the consumer
+ *
+ * No logging, no shared state besides the ring: the edges are
+ * interpreted by update() in task context.
+ */
+void IRAM_ATTR PIRSensor::edgeISR(void *arg)
+{
+    PIRSensor *self = static_cast<PIRSensor *>(arg);
+
+    MotionEdge edge;
+    edge.timeUs = (uint32_t)esp_timer_get_time();
+    edge.level = digitalRead(self->pin) == HIGH;
+    if (!self->edges.push(edge))
+        self->overflows++;
+
+    if (self->motionCallback)
+        self->motionCallback(self->callbackContext);
+}
+
+/**
+ * @brief Process the queued edges and the hold timeout
+ * @return MotionEvent bits (MOTION_STARTED / MOTION_ENDED)
+ */
+uint8_t PIRSensor::update()
 {
-    // Read the current state
-    bool currentMotion = digitalRead(pin) == HIGH;
+    if (!initialized)
+        return MOTION_NONE;
 
-    if (currentMotion && !motionDetected)
+    uint8_t events = pendingEvents;
+    pendingEvents = MOTION_NONE;
+    uint32_t triggers = tracker.getTriggers();
+
+    while (const MotionEdge *edge = edges.front())
     {
-        // New motion detected
-        motionDetected = true;
-        lastMotionTime = millis();
+        events |= tracker.onEdge(*edge);
+        edges.pop();
+    }
 
-        DEBUG_PRINTLN("[PIR] Motion detected!");
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    events |= tracker.update(digitalRead(pin) == HIGH, now);
 
-        // Trigger interrupt-style callback
-        motionDetectedISR();
+    if (tracker.getTriggers() != triggers)
+        lastMotionTime = millis() - (now - tracker.getLastTriggerUs()) / 1000;
+
+    if (events & MOTION_STARTED)
+    {
+        DEBUG_PRINTLN("[PIR] Motion detected!");
     }
-    else if (!currentMotion && motionDetected)
+    if (events & MOTION_ENDED)
     {
-        // Motion ended
-        motionDetected = false;
         DEBUG_PRINTLN("[PIR] Motion ended");
     }
-
-    return motionDetected;
+    return events;
 }
 
 bool PIRSensor::isMotionDetected()
 {
-    return motionDetected;
+    return tracker.isOccupied();
 }
 
 unsigned long PIRSensor::getLastMotionTime()
@@ -64,20 +106,8 @@ unsigned long PIRSensor::getLastMotionTime()
     return lastMotionTime;
 }
 
-void PIRSensor::resetMotion()
-{
-    motionDetected = false;
-    lastMotionTime = 0;
-}
-
-void IRAM_ATTR PIRSensor::motionDetectedISR()
+void PIRSensor::setMotionCallback(PIRMotionCallback callback, void *context)
 {
-    if (instance != nullptr)
-    {
-        instance->motionDetected = true;
-        instance->lastMotionTime = millis();
-
-        // Log motion detection
-        DEBUG_PRINTLN("[PIR] Motion detected via interrupt!");
-    }
+    motionCallback = callback;
+    callbackContext = context;
 }
@@ -3,6 +3,16 @@
  * @brief Passive Infrared (PIR) motion sensor control
  * @author Your Name
  * @version 2.0
+ *
+ * The interrupt does as little as possible:
+ *
+ *   edge ISR   push {timestamp, level} into a lock-free ring, call the
+ *              motion callback (wakes the sampler)
+ *   update()   drain the ring through MotionTracker (debounce and
+ *              occupancy) in task context; returns MotionEvent bits
+ *
+ * Nothing is shared with the ISR except the ring, so there is no static
+ * instance and no locking, and several PIRs can coexist.
  */
 
 #ifndef PIR_SENSOR_H
@@ -10,29 +20,43 @@
 
 #include "../config.h"
 #include <Arduino.h>
+#include "MotionTracker.h"
+#include "../utils/SpscQueue.h"
+
+// Called from the PIR interrupt; must be IRAM-safe
+typedef void (*PIRMotionCallback)(void *context);
 
 class PIRSensor
 {
 private:
     uint8_t pin;
-    bool motionDetected;
-    unsigned long lastMotionTime;
     unsigned long debounceTime;
+    unsigned long holdTime;
+    bool initialized;
+
+    SpscQueue<MotionEdge, PIR_EDGE_QUEUE> edges; // ISR -> task
+    volatile uint32_t overflows;
+    MotionTracker tracker;
+    unsigned long lastMotionTime; // millis() of the last counted trigger
+    uint8_t pendingEvents;        // From begin(), reported by the first update()
+
+    PIRMotionCallback motionCallback;
+    void *callbackContext;
+
+    static void IRAM_ATTR edgeISR(void *arg);
 
 public:
-    PIRSensor(uint8_t sensorPin, unsigned long debounceMs = 1000);
+    PIRSensor(uint8_t sensorPin, unsigned long debounceMs = 1000, unsigned long holdMs = PIR_HOLD_TIME);
+    ~PIRSensor();
 
     bool begin();
-    bool readMotion();
+    uint8_t update(); // Task context; MotionEvent bits
     bool isMotionDetected();
     unsigned long getLastMotionTime();
-    void resetMotion();
-
-    // Static callback for interrupt handling
-    static void IRAM_ATTR motionDetectedISR();
+    void setMotionCallback(PIRMotionCallback callback, void *context);
 
-private:
-    static PIRSensor *instance; // For interrupt handling
+    uint32_t getTriggers() { return tracker.getTriggers(); }
+    uint32_t getOverflows() { return overflows; }
 };
 
 #endif // PIR_SENSOR_H
@@ -0,0 +1,275 @@
+/**
+ * @file SensorAdapters.cpp
+ * @brief ISensor wrappers around the sensor drivers
+ */
+
+#include "SensorAdapters.h"
+#include "SensorManager.h"
+#include "../utils/Metrics.h"
+
+bool DHTAdapter::begin()
+{
+    dht.setCompleteCallback(onFrame, this);
+    return dht.begin();
+}
+
+void IRAM_ATTR DHTAdapter::onFrame(void *context)
+{
+    sensorManager.requestPollFromISR(static_cast<DHTAdapter *>(context)->id);
+}
+
+SensorPollResult DHTAdapter::poll()
+{
+    if (!dht.isReading())
+        return dht.startRead() ? SENSOR_POLL_PENDING : SENSOR_POLL_FAILED;
+
+    // Requested by onFrame(), or the next period came with no full frame
+    if (!dht.isReadDone())
+        return SENSOR_POLL_PENDING;
+    return pollResult(dht.finishRead());
+}
+
+uint8_t DHTAdapter::readFields(SensorField *fields)
+{
+    setField(fields[0], "temperature", SENSOR_FIELD_FLOAT, dht.getTemperature());
+    setField(fields[1], "humidity", SENSOR_FIELD_FLOAT, dht.getHumidity());
+    setField(fields[2], "heatIndex", SENSOR_FIELD_FLOAT, dht.getHeatIndex());
+    return 3;
+}
+
+uint8_t BMPAdapter::readFields(SensorField *fields)
+{
+    setField(fields[0], "pressure", SENSOR_FIELD_FLOAT, bmp.getPressure());
+    setField(fields[1], "altitude", SENSOR_FIELD_FLOAT, bmp.getAltitude());
+    return 2;
+}
+
+bool MPUAdapter::begin()
+{
+    if (!mpu.begin())
+        return false;
+#if MPU_USE_FIFO
+    mpu.setBatchCallback(onBatch, this);
+    return mpu.beginFifo(MPU_SAMPLE_RATE);
+#else
+    return true;
+#endif
+}
+
+void IRAM_ATTR MPUAdapter::onBatch(void *context)
+{
+    sensorManager.requestPollFromISR(static_cast<MPUAdapter *>(context)->id);
+}
+
+SensorPollResult MPUAdapter::poll()
+{
+#if MPU_USE_FIFO
+    return pollResult(mpu.readFifo());
+#else
+    return pollResult(mpu.readSensors());
+#endif
+}
+
+uint32_t MPUAdapter::getPeriod() const
+{
+#if MPU_USE_FIFO && defined(MPU_INT_PIN)
+    return MPU_FIFO_BATCH * 4000UL / MPU_SAMPLE_RATE; // Fallback
+#elif MPU_USE_FIFO
+    return MPU_FIFO_BATCH * 1000UL / MPU_SAMPLE_RATE;
+#else
+    return MPU_POLL_INTERVAL;
+#endif
+}
+
+/**
+ * @brief Attach to the MPU's FIFO stream and name the bands
+ *
+ * Needs FIFO mode for a steady sample rate, so it must be registered
+ * after the MPU (the registry begins sensors in order).
+ */
+bool VibrationAdapter::begin()
+{
+    MPU6050Sensor &mpu = source.getSensor();
+    if (!mpu.isFifoMode())
+        return false;
+
+    static const float edges[] = {VIBRATION_BAND_EDGES};
+    analyzer.setBands(edges, sizeof(edges) / sizeof(edges[0]));
+    analyzer.begin(mpu.getSampleRate(), (uint16_t)(mpu.getSampleRate() * VIBRATION_INTERVAL / 1000));
+
+    for (uint8_t b = 0; b < analyzer.getBandCount(); b++)
+    {
+        snprintf(bandNames[b], sizeof(bandNames[b]), "vib%g_%gHz",
+                 analyzer.getBandLow(b), analyzer.getBandHigh(b));
+    }
+
+    mpu.setVibrationAnalyzer(&analyzer);
+    DEBUG_PRINTF("[VIBRATION] %d-point FFT, %.2f Hz bins, %d bands\n",
+                 VIBRATION_FFT_SIZE, analyzer.getResolution(), analyzer.getBandCount());
+    return true;
+}
+
+SensorPollResult VibrationAdapter::poll()
+{
+    if (!analyzer.isFrameReady())
+        return SENSOR_POLL_PENDING;
+    return pollResult(analyzer.analyze());
+}
+
+uint8_t VibrationAdapter::readFields(SensorField *fields)
+{
+    const VibrationFeatures &features = analyzer.getFeatures();
+    setField(fields[0], "vibrationRms", SENSOR_FIELD_FLOAT, features.rms);
+    setField(fields[1], "vibrationPeak", SENSOR_FIELD_FLOAT, features.peak);
+    setField(fields[2], "crestFactor", SENSOR_FIELD_FLOAT, features.crestFactor);
+    setField(fields[3], "peakFrequency", SENSOR_FIELD_FLOAT, features.peakFrequency);
+
+    uint8_t count = 4;
+    for (uint8_t b = 0; b < analyzer.getBandCount(); b++)
+    {
+        setField(fields[count++], bandNames[b], SENSOR_FIELD_FLOAT, features.bandEnergy[b]);
+    }
+    return count;
+}
+
+uint8_t MPUAdapter::readFields(SensorField *fields)
+{
+    setField(fields[0], "accelX", SENSOR_FIELD_FLOAT, mpu.getAccelX());
+    setField(fields[1], "accelY", SENSOR_FIELD_FLOAT, mpu.getAccelY());
+    setField(fields[2], "accelZ", SENSOR_FIELD_FLOAT, mpu.getAccelZ());
+    setField(fields[3], "gyroX", SENSOR_FIELD_FLOAT, mpu.getGyroX());
+    setField(fields[4], "gyroY", SENSOR_FIELD_FLOAT, mpu.getGyroY());
+    setField(fields[5], "gyroZ", SENSOR_FIELD_FLOAT, mpu.getGyroZ());
+    setField(fields[6], "pitch", SENSOR_FIELD_FLOAT, mpu.getPitch());
+    setField(fields[7], "roll", SENSOR_FIELD_FLOAT, mpu.getRoll());
+    setField(fields[8], "heading", SENSOR_FIELD_FLOAT, mpu.getHeading());
+    return 9;
+}
+
+uint8_t MQ135Adapter::readFields(SensorField *fields)
+{
+    setField(fields[0], "airQuality", SENSOR_FIELD_FLOAT, mq135.getPPM());
+    return 1;
+}
+
+uint8_t LDRAdapter::readFields(SensorField *fields)
+{
+    setField(fields[0], "lightLevel", SENSOR_FIELD_INT, ldr.getRawValue());
+    setField(fields[1], "lux", SENSOR_FIELD_FLOAT, ldr.getLux());
+    return 2;
+}
+
+uint8_t SoilAdapter::readFields(SensorField *fields)
+{
+    setField(fields[0], "soilMoisture", SENSOR_FIELD_INT, soil.getRawValue());
+    setField(fields[1], "soilMoisturePercent", SENSOR_FIELD_FLOAT, soil.getMoisturePercentage());
+    return 2;
+}
+
+bool PIRAdapter::begin()
+{
+    pir.setMotionCallback(onMotion, this);
+    return pir.begin();
+}
+
+void IRAM_ATTR PIRAdapter::onMotion(void *context)
+{
+    sensorManager.requestPollFromISR(static_cast<PIRAdapter *>(context)->id);
+}
+
+uint8_t PIRAdapter::readFields(SensorField *fields)
+{
+    setField(fields[0], "motion", SENSOR_FIELD_BOOL, pir.isMotionDetected() ? 1.0f : 0.0f);
+    return 1;
+}
+
+#ifdef ULTRASONIC_TRIG
+bool UltrasonicAdapter::begin()
+{
+    sonar.setCompleteCallback(onEcho, this);
+    return sonar.begin(ULTRASONIC_TRIG, ULTRASONIC_ECHO);
+}
+
+void IRAM_ATTR UltrasonicAdapter::onEcho(void *context)
+{
+    sensorManager.requestPollFromISR(static_cast<UltrasonicAdapter *>(context)->id);
+}
+
+SensorPollResult UltrasonicAdapter::poll()
+{
+    if (!sonar.isPinging())
+    {
+        float temperature = sensorManager.getTemperature();
+        if (!isnan(temperature))
+            sonar.setTemperature(temperature);
+        return sonar.startPing() ? SENSOR_POLL_PENDING : SENSOR_POLL_FAILED;
+    }
+
+    // Requested by onEcho(), or the next period came without an echo
+    switch (sonar.finishPing())
+    {
+    case ECHO_PENDING:
+        return SENSOR_POLL_PENDING;
+    case ECHO_NO_RESPONSE:
+        return SENSOR_POLL_FAILED;
+    default:
+        return SENSOR_POLL_OK; // Out of range keeps the last distance
+    }
+}
+
+uint8_t UltrasonicAdapter::readFields(SensorField *fields)
+{
+    setField(fields[0], "distance", SENSOR_FIELD_INT, sonar.getDistance());
+    return 1;
+}
+#endif
+
+/**
+ * @brief Register the sensors whose pins the board defines
+ *
+ * Adapters are function-local statics so boards without a sensor do not
+ * construct its driver.
+ */
+void registerBoardSensors()
+{
+#ifdef DHT_PIN
+    static DHTAdapter dht;
+    dht.setId(sensorManager.addSensor(&dht));
+#endif
+#ifdef I2C_SDA
+    static BMPAdapter bmp;
+    sensorManager.addSensor(&bmp);
+    metrics.addCounter("bmp_reads_total", "BMP280 reads attempted",
+                       []() -> double { return bmp.getSensor().getReadCount(); });
+    metrics.addCounter("bmp_read_errors_total", "BMP280 reads that failed",
+                       []() -> double { return bmp.getSensor().getErrorCount(); });
+    metrics.addGauge("bmp_success_ratio", "BMP280 reads that succeeded (0-1)",
+                     []() -> double { return bmp.getSensor().getSuccessRate() / 100.0; });
+    static MPUAdapter mpu;
+    mpu.setId(sensorManager.addSensor(&mpu));
+#if ENABLE_VIBRATION && MPU_USE_FIFO
+    static VibrationAdapter vibration(mpu);
+    sensorManager.addSensor(&vibration);
+#endif
+#endif
+#ifdef MQ135_PIN
+    static MQ135Adapter mq135(MQ135_PIN);
+    sensorManager.addSensor(&mq135);
+#endif
+#ifdef LDR_PIN
+    static LDRAdapter ldr(LDR_PIN);
+    sensorManager.addSensor(&ldr);
+#endif
+#ifdef SOIL_MOISTURE_PIN
+    static SoilAdapter soil(SOIL_MOISTURE_PIN);
+    sensorManager.addSensor(&soil);
+#endif
+#ifdef PIR_PIN
+    static PIRAdapter pir(PIR_PIN);
+    pir.setId(sensorManager.addSensor(&pir));
+#endif
+#ifdef ULTRASONIC_TRIG
+    static UltrasonicAdapter sonar;
+    sonar.setId(sensorManager.addSensor(&sonar));
+#endif
+}
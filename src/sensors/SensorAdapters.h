@@ -0,0 +1,224 @@
+/**
+ * @file SensorAdapters.h
+ * @brief ISensor wrappers around the sensor drivers
+ *
+ * Each adapter owns its driver, maps poll() onto the driver's read call
+ * and reports the cached values as fields. registerBoardSensors() adds
+ * the sensors whose pins are defined for the board in config.h.
+ */
+
+#ifndef SENSOR_ADAPTERS_H
+#define SENSOR_ADAPTERS_H
+
+#include "ISensor.h"
+#include "DHTSensor.h"
+#include "BMPSensor.h"
+#include "MPU6050Sensor.h"
+#include "MQ135Sensor.h"
+#include "LDRSensor.h"
+#include "SoilMoistureSensor.h"
+#include "PIRSensor.h"
+#include "UltrasonicSensor.h"
+#include "VibrationAnalyzer.h"
+
+/**
+ * The DHT read is asynchronous: a periodic poll starts it, and the edge
+ * ISR requests the poll that decodes the frame (~6 ms later).
+ */
+class DHTAdapter : public ISensor
+{
+private:
+    DHTSensor dht;
+    int8_t id;
+
+    static void IRAM_ATTR onFrame(void *context);
+
+public:
+    DHTAdapter() : id(-1) {}
+    void setId(int8_t sensorId) { id = sensorId; }
+    const char *getName() const { return "DHT22"; }
+    bool begin();
+    SensorPollResult poll();
+    uint8_t readFields(SensorField *fields);
+    uint32_t getPeriod() const { return DHT_POLL_INTERVAL; }
+};
+
+class BMPAdapter : public ISensor
+{
+private:
+    BMPSensor bmp;
+
+public:
+    BMPSensor &getSensor() { return bmp; }
+    const char *getName() const { return "BMP280"; }
+    bool begin() { return bmp.begin(I2C_SDA, I2C_SCL); }
+    SensorPollResult poll() { return pollResult(bmp.read()); }
+    uint8_t readFields(SensorField *fields);
+    uint32_t getPeriod() const { return BMP_POLL_INTERVAL; }
+};
+
+/**
+ * In FIFO mode each poll drains a batch of samples through the fusion
+ * filter, and the fields carry the latest (decimated) orientation. With
+ * MPU_INT_PIN the data-ready interrupt requests the poll; the period is
+ * then only a fallback.
+ */
+class MPUAdapter : public ISensor
+{
+private:
+    MPU6050Sensor mpu;
+    int8_t id;
+
+    static void IRAM_ATTR onBatch(void *context);
+
+public:
+    MPUAdapter() : id(-1) {}
+    void setId(int8_t sensorId) { id = sensorId; }
+    MPU6050Sensor &getSensor() { return mpu; }
+    const char *getName() const { return "MPU6050"; }
+    bool begin();
+    SensorPollResult poll();
+    uint8_t readFields(SensorField *fields);
+    uint32_t getPeriod() const;
+    bool canSlowDown() const { return false; } // FIFO / fusion filter rate
+};
+
+/**
+ * Vibration features over the MPU6050 FIFO stream. The MPU poll feeds
+ * the analyzer; this sensor is polled at the same rate and reports
+ * PENDING until a new frame is due (once per VIBRATION_INTERVAL), so the
+ * FFT cost shows up in its own entry of /api/sensors/health.
+ */
+class VibrationAdapter : public ISensor
+{
+private:
+    MPUAdapter &source;
+    VibrationAnalyzer analyzer;
+    char bandNames[VIBRATION_MAX_BANDS][16]; // "vib10_25Hz"
+
+public:
+    explicit VibrationAdapter(MPUAdapter &mpu) : source(mpu) {}
+    const char *getName() const { return "Vibration"; }
+    bool begin();
+    SensorPollResult poll();
+    uint8_t readFields(SensorField *fields);
+    uint32_t getPeriod() const { return source.getPeriod(); }
+    bool canSlowDown() const { return false; } // Skipped frames are lost
+    VibrationAnalyzer &getAnalyzer() { return analyzer; }
+};
+
+/**
+ * Analog sensors read the filtered value kept by adcSampler, so a poll
+ * is only arithmetic. PENDING until the sampler has its first output.
+ */
+class MQ135Adapter : public ISensor
+{
+private:
+    MQ135Sensor mq135;
+
+public:
+    explicit MQ135Adapter(uint8_t pin) : mq135(pin) {}
+    const char *getName() const { return "MQ135"; }
+    bool begin() { return mq135.begin(); }
+    SensorPollResult poll()
+    {
+        if (!mq135.isReady())
+            return SENSOR_POLL_PENDING;
+        return pollResult(mq135.readAirQuality());
+    }
+    uint8_t readFields(SensorField *fields);
+    uint32_t getPeriod() const { return ANALOG_POLL_INTERVAL; }
+};
+
+class LDRAdapter : public ISensor
+{
+private:
+    LDRSensor ldr;
+
+public:
+    explicit LDRAdapter(uint8_t pin) : ldr(pin) {}
+    const char *getName() const { return "LDR"; }
+    bool begin() { return ldr.begin(); }
+    SensorPollResult poll()
+    {
+        if (!ldr.isReady())
+            return SENSOR_POLL_PENDING;
+        return pollResult(ldr.readLight());
+    }
+    uint8_t readFields(SensorField *fields);
+    uint32_t getPeriod() const { return ANALOG_POLL_INTERVAL; }
+};
+
+class SoilAdapter : public ISensor
+{
+private:
+    SoilMoistureSensor soil;
+
+public:
+    explicit SoilAdapter(uint8_t pin) : soil(pin) {}
+    const char *getName() const { return "Soil"; }
+    bool begin() { return soil.begin(); }
+    SensorPollResult poll()
+    {
+        if (!soil.isReady())
+            return SENSOR_POLL_PENDING;
+        return pollResult(soil.readMoisture());
+    }
+    uint8_t readFields(SensorField *fields);
+    uint32_t getPeriod() const { return ANALOG_POLL_INTERVAL; }
+};
+
+/**
+ * Every PIR edge is queued by its ISR, which also requests a poll, so
+ * a motion start is handled as soon as the sampling task runs and is
+ * published at once (SENSOR_POLL_EVENT). The periodic poll ends the
+ * occupancy when the hold time has passed, which has no interrupt.
+ */
+class PIRAdapter : public ISensor
+{
+private:
+    PIRSensor pir;
+    int8_t id;
+
+    static void IRAM_ATTR onMotion(void *context);
+
+public:
+    explicit PIRAdapter(uint8_t pin) : pir(pin), id(-1) {}
+    void setId(int8_t sensorId) { id = sensorId; }
+    const char *getName() const { return "PIR"; }
+    bool begin();
+    SensorPollResult poll() { return pir.update() ? SENSOR_POLL_EVENT : SENSOR_POLL_OK; }
+    uint8_t readFields(SensorField *fields);
+    uint32_t getPeriod() const { return PIR_POLL_INTERVAL; }
+    bool canSlowDown() const { return false; } // Motion end has no interrupt
+};
+
+#ifdef ULTRASONIC_TRIG
+/**
+ * Pings are asynchronous like the DHT read: a periodic poll sends one,
+ * and the echo ISR requests the poll that collects it (under 25 ms
+ * later). The latest temperature reading sets the speed of sound.
+ */
+class UltrasonicAdapter : public ISensor
+{
+private:
+    UltrasonicSensor sonar;
+    int8_t id;
+
+    static void IRAM_ATTR onEcho(void *context);
+
+public:
+    UltrasonicAdapter() : id(-1) {}
+    void setId(int8_t sensorId) { id = sensorId; }
+    const char *getName() const { return "HC-SR04"; }
+    bool begin();
+    SensorPollResult poll();
+    uint8_t readFields(SensorField *fields);
+    uint32_t getPeriod() const { return ULTRASONIC_POLL_INTERVAL; }
+};
+#endif
+
+// Add the sensors wired on this board to sensorManager (before begin())
+void registerBoardSensors();
+
+#endif // SENSOR_ADAPTERS_H
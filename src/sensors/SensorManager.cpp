@@ -4,6 +4,9 @@
  */
 
 #include "SensorManager.h"
+#include "../utils/ResponseWriter.h"
+
+static const AdaptiveDeadband DEFAULT_DEADBANDS[] = {ADAPTIVE_DEADBANDS};
 
 // Global instance
 SensorManager sensorManager;
@@ -13,67 +16,523 @@ SensorManager sensorManager;
  */
 SensorManager::SensorManager()
 {
+    sensorCount = 0;
+    presentCount = 0;
     initialized = false;
+    pending = 0;
+    wakeHook = nullptr;
+    eventHook = nullptr;
+    portMUX_INITIALIZE(&mux);
+    configLock = xSemaphoreCreateMutex(); // loadSavedConfig() runs before begin()
+
+    changed = false;
+    lastPublish = 0;
+    published = 0;
+    skipped = 0;
+    policy.setEnabled(ADAPTIVE_SAMPLING);
+    policy.setStablePolls(ADAPTIVE_STABLE_POLLS);
+    policy.setMaxSlowdown(ADAPTIVE_MAX_SLOWDOWN);
+    policy.setHeartbeat(ADAPTIVE_HEARTBEAT);
+    for (const AdaptiveDeadband &deadband : DEFAULT_DEADBANDS)
+    {
+        policy.setDeadband(deadband.field, deadband.threshold);
+    }
+}
+
+SensorManager::~SensorManager()
+{
+    vSemaphoreDelete(configLock);
+}
+
+/**
+ * @brief Register a sensor
+ * @return Sensor id (for requestPoll), or -1 if the registry is full
+ */
+int8_t SensorManager::addSensor(ISensor *sensor)
+{
+    if (sensor == nullptr || sensorCount >= SENSOR_MAX_SENSORS)
+    {
+        DEBUG_PRINTLN("[SENSOR] Registry full");
+        return -1;
+    }
+
+    Entry &entry = entries[sensorCount];
+    memset(&entry, 0, sizeof(entry));
+    entry.sensor = sensor;
+    policy.reset(entry.adaptive);
+    return sensorCount++;
 }
 
 /**
- * @brief Initialize sensor manager
- * @return true if successful
+ * @brief Initialize registered sensors
+ * @return Number of sensors that responded
+ *
+ * Sensors whose begin() fails are left out of polling and JSON output.
  */
-bool SensorManager::begin()
+uint8_t SensorManager::begin()
 {
     Serial.println("Initializing Sensor Manager...");
 
-    // For now, just return true - sensors will be added as needed
+    uint32_t now = millis();
+    presentCount = 0;
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        Entry &entry = entries[i];
+        entry.present = entry.sensor->begin();
+        entry.nextPoll = now;
+        if (entry.present)
+        {
+            presentCount++;
+        }
+        DEBUG_PRINTF("[SENSOR] %s: %s\n", entry.sensor->getName(), entry.present ? "found" : "not found");
+    }
+
     initialized = true;
     Serial.println("✓ Sensor Manager initialized");
-    return true;
+    return presentCount;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SAMPLING
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Poll period of a sensor, slowed down while it is stable or keeps
+ *        failing
+ */
+uint32_t SensorManager::pollInterval(const Entry &entry)
+{
+    uint32_t period = entry.sensor->getPeriod();
+    if (entry.sensor->canSlowDown())
+        period = policy.interval(entry.adaptive, period);
+    if (period > 0 && entry.consecutiveFailures >= SENSOR_MAX_FAILURES && period < SENSOR_RETRY_INTERVAL)
+        return SENSOR_RETRY_INTERVAL;
+    return period;
+}
+
+/**
+ * @brief Poll one sensor and publish its fields
+ *
+ * The hardware read happens outside the lock; only the copy into the
+ * snapshot is done with it held.
+ */
+void SensorManager::pollEntry(uint8_t id, uint32_t now)
+{
+    Entry &entry = entries[id];
+    SensorField fresh[SENSOR_MAX_FIELDS];
+    uint8_t count = 0;
+
+    uint32_t start = micros();
+    SensorPollResult result = entry.sensor->poll();
+    bool ok = result == SENSOR_POLL_OK || result == SENSOR_POLL_EVENT;
+    if (ok)
+    {
+        count = entry.sensor->readFields(fresh);
+        if (count > SENSOR_MAX_FIELDS)
+            count = SENSOR_MAX_FIELDS;
+    }
+    uint32_t took = micros() - start;
+
+    portENTER_CRITICAL(&mux);
+    entry.lastMicros = took;
+    if (took > entry.maxMicros)
+        entry.maxMicros = took;
+    if (result == SENSOR_POLL_PENDING)
+    {
+        // Outcome comes with the poll the sensor requests when done
+    }
+    else if (ok)
+    {
+        entry.polls++;
+        memcpy(entry.fields, fresh, count * sizeof(SensorField));
+        entry.fieldCount = count;
+        entry.valid = true;
+        entry.consecutiveFailures = 0;
+        entry.lastSuccess = now;
+        if (policy.update(entry.adaptive, fresh, count))
+            changed = true;
+    }
+    else
+    {
+        entry.polls++;
+        entry.failures++;
+        if (entry.consecutiveFailures < UINT8_MAX)
+            entry.consecutiveFailures++;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    if (result == SENSOR_POLL_EVENT && eventHook)
+    {
+        eventHook(entry.sensor->getName(), fresh, count);
+    }
+
+    if (result == SENSOR_POLL_FAILED && entry.consecutiveFailures == SENSOR_MAX_FAILURES)
+    {
+        DEBUG_PRINTF("[SENSOR] %s failing, retrying every %lu ms\n",
+                     entry.sensor->getName(), (unsigned long)pollInterval(entry));
+    }
+
+    // Requested polls do not move the periodic grid
+    uint32_t interval = pollInterval(entry);
+    if (interval > 0 && (int32_t)(now - entry.nextPoll) >= 0)
+    {
+        entry.nextPoll += interval;
+        if ((int32_t)(now - entry.nextPoll) >= 0)
+            entry.nextPoll = now + interval;
+    }
+}
+
+/**
+ * @brief Poll every sensor that is due or has a poll requested
+ * @return Number of sensors polled
+ */
+uint8_t SensorManager::poll(uint32_t now)
+{
+    portENTER_CRITICAL(&mux);
+    uint16_t requested = pending;
+    pending = 0;
+    portEXIT_CRITICAL(&mux);
+
+    uint8_t polled = 0;
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        Entry &entry = entries[i];
+        if (!entry.present)
+            continue;
+
+        bool due = pollInterval(entry) > 0 && (int32_t)(now - entry.nextPoll) >= 0;
+        if (due || (requested & (1 << i)))
+        {
+            pollEntry(i, now);
+            polled++;
+        }
+    }
+    return polled;
+}
+
+/**
+ * @brief Time until the next sensor is due (0 if a poll is requested)
+ */
+uint32_t SensorManager::getSleepTime(uint32_t now, uint32_t maxSleep)
+{
+    if (pending)
+        return 0;
+
+    uint32_t sleep = maxSleep;
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        const Entry &entry = entries[i];
+        if (!entry.present || pollInterval(entry) == 0)
+            continue;
+
+        int32_t wait = (int32_t)(entry.nextPoll - now);
+        if (wait <= 0)
+            return 0;
+        if ((uint32_t)wait < sleep)
+            sleep = wait;
+    }
+    return sleep;
+}
+
+void SensorManager::requestPoll(int8_t id)
+{
+    if (id < 0 || id >= sensorCount)
+        return;
+
+    portENTER_CRITICAL(&mux);
+    pending |= 1 << id;
+    portEXIT_CRITICAL(&mux);
+
+    if (wakeHook)
+    {
+        wakeHook(false);
+    }
+}
+
+void IRAM_ATTR SensorManager::requestPollFromISR(int8_t id)
+{
+    if (id < 0 || id >= sensorCount)
+        return;
+
+    portENTER_CRITICAL_ISR(&mux);
+    pending |= 1 << id;
+    portEXIT_CRITICAL_ISR(&mux);
+
+    if (wakeHook)
+    {
+        wakeHook(true);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ADAPTIVE SAMPLING
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Whether the publisher should log/broadcast/send this round
+ *
+ * True when a watched field changed since the last publication, when
+ * ADAPTIVE_HEARTBEAT has passed, or always with adaptive sampling off.
+ * A true result starts a new round.
+ */
+bool SensorManager::shouldPublish(uint32_t now)
+{
+    portENTER_CRITICAL(&mux);
+    bool publish = !policy.isEnabled() || changed || now - lastPublish >= policy.getHeartbeat();
+    if (publish)
+    {
+        changed = false;
+        lastPublish = now;
+        published++;
+    }
+    else
+    {
+        skipped++;
+    }
+    portEXIT_CRITICAL(&mux);
+    return publish;
+}
+
+/**
+ * @brief Apply adaptive sampling settings (e.g. from POST /api/config)
+ *
+ * Accepts any of "enabled", "stablePolls", "maxSlowdown", "heartbeat"
+ * and a "deadbands" object of field: threshold (0 stops watching the
+ * field). Missing keys keep their value. The settings are applied to a
+ * copy of the policy, which replaces the live one only if every entry
+ * was accepted: a rejected request changes nothing.
+ *
+ * Only the swap holds the spinlock. The copy and the JSON walk run under
+ * configLock, which excludes the other settings callers; the sampling
+ * task only reads the policy.
+ *
+ * @return false if a deadband did not fit in the table
+ */
+bool SensorManager::configureAdaptive(JsonObjectConst settings)
+{
+    if (settings.isNull())
+        return true;
+
+    bool ok = true;
+    xSemaphoreTake(configLock, portMAX_DELAY);
+    AdaptivePolicy updated = policy;
+    if (settings.containsKey("enabled"))
+        updated.setEnabled(settings["enabled"].as<bool>());
+    if (settings.containsKey("stablePolls"))
+        updated.setStablePolls(settings["stablePolls"].as<uint8_t>());
+    if (settings.containsKey("maxSlowdown"))
+        updated.setMaxSlowdown(settings["maxSlowdown"].as<uint8_t>());
+    if (settings.containsKey("heartbeat"))
+        updated.setHeartbeat(settings["heartbeat"].as<uint32_t>());
+    for (JsonPairConst deadband : settings["deadbands"].as<JsonObjectConst>())
+    {
+        ok &= updated.setDeadband(deadband.key().c_str(), deadband.value().as<float>());
+    }
+    if (ok)
+    {
+        portENTER_CRITICAL(&mux);
+        policy = updated;
+        changed = true; // Publish once with the new settings
+        portEXIT_CRITICAL(&mux);
+    }
+    xSemaphoreGive(configLock);
+    return ok;
 }
 
+/**
+ * @brief Current adaptive sampling settings (for GET /api/config)
+ */
+void SensorManager::getAdaptiveConfig(JsonObject doc)
+{
+    // configLock keeps configureAdaptive() from swapping the policy meanwhile
+    xSemaphoreTake(configLock, portMAX_DELAY);
+    doc["enabled"] = policy.isEnabled();
+    doc["stablePolls"] = policy.getStablePolls();
+    doc["maxSlowdown"] = policy.getMaxSlowdown();
+    doc["heartbeat"] = policy.getHeartbeat();
+    JsonObject deadbands = doc.createNestedObject("deadbands");
+    for (uint8_t i = 0; i < policy.getDeadbandCount(); i++)
+    {
+        // char * so ArduinoJson copies the name; a later change rewrites it
+        char *field = const_cast<char *>(policy.getDeadbandField(i));
+        deadbands[field] = policy.getDeadbandThreshold(i);
+    }
+    xSemaphoreGive(configLock);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SNAPSHOT ACCESS
+// ═══════════════════════════════════════════════════════════════════════════
+
 /**
  * @brief Get all sensor data
+ *
+ * Writes the latest fields of every sensor that is present and not
+ * failing. Sensors without a good reading yet are left out.
  */
 void SensorManager::getAllSensorData(JsonObject doc)
 {
-    // Add basic sensor data
-    doc["temperature"] = 25.0;
-    doc["humidity"] = 50.0;
-    doc["pressure"] = 1013.25;
-    doc["motion"] = false;
-    doc["lightLevel"] = 500;
-    doc["soilMoisture"] = 600;
+    SensorField fields[SENSOR_MAX_FIELDS];
+
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        Entry &entry = entries[i];
+        uint8_t count = 0;
+
+        portENTER_CRITICAL(&mux);
+        if (entry.present && entry.valid && entry.consecutiveFailures < SENSOR_MAX_FAILURES)
+        {
+            count = entry.fieldCount;
+            memcpy(fields, entry.fields, count * sizeof(SensorField));
+        }
+        portEXIT_CRITICAL(&mux);
+
+        writeFields(doc, fields, count);
+    }
 }
 
 /**
- * @brief Get temperature
+ * @brief Latest readings trimmed to fit one ESP-NOW frame
+ *
+ * The full snapshot is several times the 229 bytes a frame carries.
+ * Watched fields (those with an adaptive deadband) go in first, then
+ * the others while they fit; floats are rounded to two decimals. The
+ * serialized doc, including what the caller already put in it, stays
+ * within maxLength bytes.
+ *
+ * @return Number of fields left out
+ */
+uint8_t SensorManager::getPeerSensorData(JsonObject doc, size_t maxLength)
+{
+    SensorField fields[SENSOR_MAX_FIELDS];
+    bool watched[SENSOR_MAX_FIELDS];
+    uint8_t dropped = 0;
+
+    for (uint8_t pass = 0; pass < 2; pass++)
+    {
+        for (uint8_t i = 0; i < sensorCount; i++)
+        {
+            Entry &entry = entries[i];
+            uint8_t count = 0;
+
+            portENTER_CRITICAL(&mux);
+            if (entry.present && entry.valid && entry.consecutiveFailures < SENSOR_MAX_FAILURES)
+            {
+                count = entry.fieldCount;
+                memcpy(fields, entry.fields, count * sizeof(SensorField));
+                for (uint8_t f = 0; f < count; f++)
+                {
+                    watched[f] = f < entry.adaptive.fieldCount && entry.adaptive.deadband[f] > 0.0f;
+                }
+            }
+            portEXIT_CRITICAL(&mux);
+
+            for (uint8_t f = 0; f < count; f++)
+            {
+                if (watched[f] != (pass == 0))
+                    continue;
+
+                if (fields[f].type == SENSOR_FIELD_FLOAT)
+                    doc[fields[f].name] = round(fields[f].value * 100.0) / 100.0;
+                else
+                    writeFields(doc, &fields[f], 1);
+
+                if (measureJson(doc) > maxLength)
+                {
+                    doc.remove(fields[f].name);
+                    dropped++;
+                }
+            }
+        }
+    }
+    return dropped;
+}
+
+/**
+ * @brief Write fields as JSON members, typed as the sensor declared them
+ */
+void SensorManager::writeFields(JsonObject doc, const SensorField *fields, uint8_t count)
+{
+    for (uint8_t f = 0; f < count; f++)
+    {
+        switch (fields[f].type)
+        {
+        case SENSOR_FIELD_INT:
+            doc[fields[f].name] = (long)fields[f].value;
+            break;
+        case SENSOR_FIELD_BOOL:
+            doc[fields[f].name] = fields[f].value != 0.0f;
+            break;
+        default:
+            doc[fields[f].name] = fields[f].value;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Look up a field by name in the snapshot
+ */
+bool SensorManager::findField(const char *name, float &value)
+{
+    bool found = false;
+
+    portENTER_CRITICAL(&mux);
+    for (uint8_t i = 0; i < sensorCount && !found; i++)
+    {
+        const Entry &entry = entries[i];
+        if (!entry.present || !entry.valid || entry.consecutiveFailures >= SENSOR_MAX_FAILURES)
+            continue;
+
+        for (uint8_t f = 0; f < entry.fieldCount; f++)
+        {
+            if (strcmp(entry.fields[f].name, name) == 0)
+            {
+                value = entry.fields[f].value;
+                found = true;
+                break;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+
+    return found;
+}
+
+/**
+ * @brief Get temperature (NAN if no sensor reports it)
  */
 float SensorManager::getTemperature()
 {
-    return 25.0;
+    float value;
+    return findField("temperature", value) ? value : NAN;
 }
 
 /**
- * @brief Get humidity
+ * @brief Get humidity (NAN if no sensor reports it)
  */
 float SensorManager::getHumidity()
 {
-    return 50.0;
+    float value;
+    return findField("humidity", value) ? value : NAN;
 }
 
 /**
- * @brief Get pressure
+ * @brief Get pressure (NAN if no sensor reports it)
  */
 float SensorManager::getPressure()
 {
-    return 1013.25;
+    float value;
+    return findField("pressure", value) ? value : NAN;
 }
 
 /**
- * @brief Get altitude
+ * @brief Get altitude (NAN if no sensor reports it)
  */
 float SensorManager::getAltitude()
 {
-    return 100.0;
+    float value;
+    return findField("altitude", value) ? value : NAN;
 }
 
 /**
@@ -81,25 +540,32 @@ float SensorManager::getAltitude()
  */
 bool SensorManager::getMotion()
 {
-    return false;
+    float value;
+    return findField("motion", value) && value != 0.0f;
 }
 
 /**
- * @brief Get light level
+ * @brief Get light level (raw ADC, -1 if no sensor reports it)
  */
 int SensorManager::getLightLevel()
 {
-    return 500;
+    float value;
+    return findField("lightLevel", value) ? (int)value : -1;
 }
 
 /**
- * @brief Get soil moisture
+ * @brief Get soil moisture (raw ADC, -1 if no sensor reports it)
  */
 int SensorManager::getSoilMoisture()
 {
-    return 600;
+    float value;
+    return findField("soilMoisture", value) ? (int)value : -1;
 }
 
+// ═══════════════════════════════════════════════════════════════════════════
+// STATUS
+// ═══════════════════════════════════════════════════════════════════════════
+
 /**
  * @brief Print sensor status
  */
@@ -107,12 +573,68 @@ void SensorManager::printStatus()
 {
     Serial.println("Sensor Manager Status:");
     Serial.printf("Initialized: %s\n", initialized ? "Yes" : "No");
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        const Entry &entry = entries[i];
+        uint32_t period = entry.sensor->getPeriod();
+        if (period > 0)
+        {
+            Serial.printf("  %-12s %-9s every %lu ms\n", entry.sensor->getName(),
+                          entry.present ? "present" : "absent", (unsigned long)period);
+        }
+        else
+        {
+            Serial.printf("  %-12s %-9s on request\n", entry.sensor->getName(),
+                          entry.present ? "present" : "absent");
+        }
+    }
 }
 
 /**
- * @brief Get sensor count
+ * @brief Get sensor count (sensors found by begin())
  */
 uint8_t SensorManager::getSensorCount()
 {
-    return 3; // Basic sensors
-}
\ No newline at end of file
+    return presentCount;
+}
+
+/**
+ * @brief Per-sensor poll statistics for /api/sensors/health
+ */
+void SensorManager::writeHealth(ResponseWriter &json)
+{
+    uint32_t now = millis();
+
+    json.beginArray("sensors");
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        portENTER_CRITICAL(&mux);
+        Entry entry = entries[i];
+        portEXIT_CRITICAL(&mux);
+
+        json.beginObject();
+        json.field("name", entry.sensor->getName());
+        json.field("present", entry.present);
+        json.field("healthy", entry.present && entry.valid && entry.consecutiveFailures < SENSOR_MAX_FAILURES);
+        json.field("period", (unsigned long)pollInterval(entry));
+        json.field("polls", (unsigned long)entry.polls);
+        json.field("failures", (unsigned long)entry.failures);
+        json.field("consecutiveFailures", (int)entry.consecutiveFailures);
+        if (entry.valid)
+        {
+            json.field("ageMs", (unsigned long)(now - entry.lastSuccess));
+        }
+        json.field("lastUs", (unsigned long)entry.lastMicros);
+        json.field("maxUs", (unsigned long)entry.maxMicros);
+        json.field("slowdown", (int)entry.adaptive.slowdown);
+        json.endObject();
+    }
+    json.endArray();
+
+    portENTER_CRITICAL(&mux);
+    uint32_t publishedRounds = published;
+    uint32_t skippedRounds = skipped;
+    portEXIT_CRITICAL(&mux);
+    json.field("published", (unsigned long)publishedRounds);
+    json.field("skipped", (unsigned long)skippedRounds);
+}
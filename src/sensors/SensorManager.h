@@ -2,7 +2,20 @@
  * @file SensorManager.h
  * @brief Sensor manager for ESP32
  *
- * Handles multiple sensors including DHT, BMP, PIR, etc.
+ * Registry of the sensors fitted to the board (see ISensor.h and
+ * SensorAdapters.h). Each sensor is polled at its own rate by poll(),
+ * which the "sampling" scheduler task calls: the DHT22 every 2 s, the
+ * MPU6050 every 10 ms, the PIR when its interrupt fires. After a good
+ * reading its fields are copied into a per-sensor snapshot.
+ *
+ * getAllSensorData() and the getters only read that snapshot, so web
+ * handlers and the TaskRunner sensor task never wait on a bus. The
+ * snapshot is guarded by a spinlock because those run on other tasks.
+ *
+ * With adaptive sampling (AdaptivePolicy.h) every good reading is
+ * checked against its deadbands: stable sensors are polled less often,
+ * and shouldPublish() tells the publisher whether anything changed
+ * since the last round.
  */
 
 #ifndef SENSOR_MANAGER_H
@@ -10,20 +23,94 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "ISensor.h"
+#include "AdaptivePolicy.h"
+#include "../config.h"
+
+class ResponseWriter;
+
+// Called when a poll is requested; fromISR selects the ISR-safe wake-up
+typedef void (*SensorWakeHook)(bool fromISR);
+// Called from poll() (sampling task) with the fields of a SENSOR_POLL_EVENT
+typedef void (*SensorEventHook)(const char *sensor, const SensorField *fields, uint8_t count);
 
 class SensorManager
 {
 private:
+    struct Entry
+    {
+        ISensor *sensor;
+        bool present;  // begin() succeeded
+        bool valid;    // fields hold at least one good reading
+        uint32_t nextPoll;
+        uint8_t fieldCount;
+        SensorField fields[SENSOR_MAX_FIELDS];
+
+        // Health
+        uint32_t polls;
+        uint32_t failures;
+        uint8_t consecutiveFailures;
+        uint32_t lastSuccess;  // millis() of the last good reading
+        uint32_t lastMicros;   // Duration of the last poll()
+        uint32_t maxMicros;
+
+        AdaptiveTrack adaptive;
+    };
+
+    Entry entries[SENSOR_MAX_SENSORS];
+    uint8_t sensorCount;
+    uint8_t presentCount;
     bool initialized;
 
+    portMUX_TYPE mux;
+    volatile uint16_t pending; // Sensors with a requested poll (bit per id)
+    SensorWakeHook wakeHook;
+    SensorEventHook eventHook;
+
+    // Adaptive sampling (settings and the flags below share the spinlock;
+    // configLock serializes the settings API so it can build and read
+    // the ~700-byte policy without holding the spinlock the ISRs take)
+    AdaptivePolicy policy;
+    SemaphoreHandle_t configLock;
+    bool changed; // A significant reading since the last publication
+    uint32_t lastPublish;
+    uint32_t published;
+    uint32_t skipped;
+
+    uint32_t pollInterval(const Entry &entry);
+    void pollEntry(uint8_t id, uint32_t now);
+    bool findField(const char *name, float &value);
+
 public:
     SensorManager();
+    ~SensorManager();
+
+    // Registration (before begin())
+    int8_t addSensor(ISensor *sensor);
+
+    // Initialization; returns the number of sensors found
+    uint8_t begin();
+
+    // Sampling (one task only)
+    uint8_t poll(uint32_t now);
+    uint32_t getSleepTime(uint32_t now, uint32_t maxSleep);
+
+    // Ask for a poll outside the sensor's period (e.g. on an edge)
+    void requestPoll(int8_t id);
+    void IRAM_ATTR requestPollFromISR(int8_t id);
+    void setWakeHook(SensorWakeHook hook) { wakeHook = hook; }
+    void setEventHook(SensorEventHook hook) { eventHook = hook; }
 
-    // Initialization
-    bool begin();
+    // Publication: true when the snapshot changed or the heartbeat is due
+    bool shouldPublish(uint32_t now);
+    bool configureAdaptive(JsonObjectConst settings);
+    void getAdaptiveConfig(JsonObject doc);
 
-    // Sensor reading
+    // Sensor reading (snapshot only, no bus I/O)
     void getAllSensorData(JsonObject doc);
+    // Same, trimmed to maxLength bytes (one ESP-NOW frame); returns fields left out
+    uint8_t getPeerSensorData(JsonObject doc, size_t maxLength);
+    static void writeFields(JsonObject doc, const SensorField *fields, uint8_t count);
     float getTemperature();
     float getHumidity();
     float getPressure();
@@ -35,8 +122,9 @@ public:
     // Utility
     void printStatus();
     uint8_t getSensorCount();
+    void writeHealth(ResponseWriter &json);
 };
 
 extern SensorManager sensorManager; // Global instance
 
-#endif // SENSOR_MANAGER_H
\ No newline at end of file
+#endif // SENSOR_MANAGER_H
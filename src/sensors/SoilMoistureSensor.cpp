@@ -6,42 +6,40 @@
  */
 
 #include "SoilMoistureSensor.h"
+#include "AdcSampler.h"
 #include "../utils/Logger.h"
 
-SoilMoistureSensor::SoilMoistureSensor(uint8_t sensorPin, int sampleCount)
+SoilMoistureSensor::SoilMoistureSensor(uint8_t sensorPin)
     : pin(sensorPin), rawValue(0), voltage(0.0f), moisturePercentage(0.0f),
-      dryValue(0), wetValue(4095), samples(sampleCount), sampleIndex(0)
+      dryValue(0), wetValue(4095), channel(-1)
 {
-    sampleBuffer = new int[samples];
-    for (int i = 0; i < samples; i++)
-    {
-        sampleBuffer[i] = 0;
-    }
-}
-
-SoilMoistureSensor::~SoilMoistureSensor()
-{
-    delete[] sampleBuffer;
 }
 
+/**
+ * @brief Register the pin with the ADC sampler (start it afterwards)
+ */
 bool SoilMoistureSensor::begin()
 {
-    pinMode(pin, INPUT);
+    channel = adcSampler.addPin(pin);
+    if (channel < 0)
+        return false;
+
     DEBUG_PRINTLN("[SOIL] Soil moisture sensor initialized on pin " + String(pin));
     return true;
 }
 
-bool SoilMoistureSensor::readMoisture()
+bool SoilMoistureSensor::isReady()
 {
-    // Read raw ADC value
-    int raw = analogRead(pin);
+    return adcSampler.isReady(channel);
+}
 
-    // Store in circular buffer
-    sampleBuffer[sampleIndex] = raw;
-    sampleIndex = (sampleIndex + 1) % samples;
+bool SoilMoistureSensor::readMoisture()
+{
+    if (!isReady())
+        return false;
 
-    // Calculate average raw value
-    rawValue = getAverageRaw();
+    // Filtered by the ADC sampler
+    rawValue = (int)(adcSampler.getAverage(channel) + 0.5f);
 
     // Calculate voltage
     voltage = (rawValue * 3.3f) / 4095.0f;
@@ -115,14 +113,3 @@ float SoilMoistureSensor::calculateMoisture(int rawValue)
 
     return percentage;
 }
-
-int SoilMoistureSensor::getAverageRaw()
-{
-    long sum = 0;
-    for (int i = 0; i < samples; i++)
-    {
-        sum += sampleBuffer[i];
-    }
-
-    return sum / samples;
-}
@@ -20,15 +20,13 @@ private:
     float moisturePercentage;
     int dryValue;
     int wetValue;
-    int samples;
-    int sampleIndex;
-    int *sampleBuffer;
+    int8_t channel; // adcSampler handle
 
 public:
-    SoilMoistureSensor(uint8_t sensorPin, int sampleCount = 10);
-    ~SoilMoistureSensor();
+    SoilMoistureSensor(uint8_t sensorPin);
 
     bool begin();
+    bool isReady();
     bool readMoisture();
     int getRawValue();
     float getVoltage();
@@ -40,7 +38,6 @@ public:
 
 private:
     float calculateMoisture(int rawValue);
-    int getAverageRaw();
 };
 
 #endif // SOIL_MOISTURE_SENSOR_H
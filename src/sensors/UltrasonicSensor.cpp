@@ -5,16 +5,34 @@
 
 #include "UltrasonicSensor.h"
 #include "../config.h"
+#include <esp_timer.h>
 
 UltrasonicSensor::UltrasonicSensor()
 {
     trigPin = ULTRASONIC_TRIG;
     echoPin = ULTRASONIC_ECHO;
     maxDistance = ULTRASONIC_MAX_DISTANCE;
-    lastDistance = 0;
     initialized = false;
+    lastResult = ECHO_NOT_ARMED;
+    errorCount = 0;
+    completeCallback = nullptr;
+    callbackContext = nullptr;
 }
 
+UltrasonicSensor::~UltrasonicSensor()
+{
+    if (initialized)
+    {
+        detachInterrupt(echoPin);
+    }
+}
+
+/**
+ * @brief Set up the pins and echo capture
+ *
+ * The sensor cannot be probed without a ping, so a missing sensor shows
+ * up as pings without a response.
+ */
 bool UltrasonicSensor::begin(uint8_t trig, uint8_t echo)
 {
     trigPin = trig;
@@ -22,81 +40,90 @@ bool UltrasonicSensor::begin(uint8_t trig, uint8_t echo)
 
     pinMode(trigPin, OUTPUT);
     pinMode(echoPin, INPUT);
-
     digitalWrite(trigPin, LOW);
-    delay(100);
 
-    // Test measurement
-    uint16_t distance = read();
-    if (distance > 0 && distance < maxDistance)
-    {
-        initialized = true;
-        DEBUG_PRINTLN("Ultrasonic sensor ready!");
-        return true;
-    }
+    ranger.begin(ULTRASONIC_MEDIAN, ULTRASONIC_MIN_DISTANCE, maxDistance, ULTRASONIC_TIMEOUT_US);
+    attachInterruptArg(echoPin, echoISR, this, CHANGE);
 
-    DEBUG_PRINTLN("Ultrasonic sensor not detected!");
-    return false;
+    initialized = true;
+    DEBUG_PRINTLN("Ultrasonic sensor ready!");
+    return true;
 }
 
-long UltrasonicSensor::measurePulse()
+/**
+ * @brief Send a ping
+ * @return false if not initialized or a ping is already in flight
+ */
+bool UltrasonicSensor::startPing()
 {
-    // Send 10us pulse
+    if (!initialized || ranger.isArmed())
+        return false;
+
+    ranger.arm((uint32_t)esp_timer_get_time());
+
+    // The only wait left: the sensor needs a 10 µs trigger pulse
     digitalWrite(trigPin, HIGH);
     delayMicroseconds(10);
     digitalWrite(trigPin, LOW);
-
-    // Measure echo pulse duration (timeout after 30ms)
-    return pulseIn(echoPin, HIGH, 30000);
+    return true;
 }
 
-uint16_t UltrasonicSensor::read()
+void IRAM_ATTR UltrasonicSensor::echoISR(void *arg)
 {
-    if (!initialized)
-        return 0;
-
-    // Take multiple measurements and average
-    long duration = 0;
-    int validReadings = 0;
+    UltrasonicSensor *self = static_cast<UltrasonicSensor *>(arg);
+    bool high = digitalRead(self->echoPin) == HIGH;
 
-    for (int i = 0; i < 3; i++)
+    if (self->ranger.onEdge(high, (uint32_t)esp_timer_get_time()) && self->completeCallback)
     {
-        long d = measurePulse();
-        if (d > 0)
-        {
-            duration += d;
-            validReadings++;
-        }
-        delay(10);
+        self->completeCallback(self->callbackContext);
     }
+}
 
-    if (validReadings == 0)
-    {
-        DEBUG_PRINTLN("No valid ultrasonic readings");
-        return lastDistance; // Return last valid reading
-    }
-
-    duration /= validReadings;
-
-    // Calculate distance in cm (speed of sound = 343 m/s)
-    // distance = (duration * 0.0343) / 2
-    uint16_t distance = duration * 0.0343 / 2;
+/**
+ * @brief Collect the echo of the last ping
+ *
+ * ECHO_NO_END means nothing was in range (the HC-SR04 holds ECHO high
+ * for ~38 ms without an echo); the distance is left unchanged. Only
+ * ECHO_NO_RESPONSE counts as an error.
+ */
+EchoResult UltrasonicSensor::finishPing()
+{
+    uint32_t width = 0;
+    EchoResult result = ranger.collect((uint32_t)esp_timer_get_time(), width);
+    if (result == ECHO_PENDING)
+        return result;
 
-    if (distance > 0 && distance < maxDistance)
+    lastResult = result;
+    if (result == ECHO_OK)
     {
-        lastDistance = distance;
+        ranger.addEcho(width);
 
 #if DEBUG_SENSORS
-        DEBUG_PRINTF("Ultrasonic distance: %d cm\n", distance);
+        DEBUG_PRINTF("Ultrasonic echo: %lu us, distance: %.1f cm\n",
+                     (unsigned long)width, ranger.getDistance());
 #endif
     }
+    else if (result == ECHO_NO_RESPONSE)
+    {
+        errorCount++;
+    }
+    return result;
+}
 
-    return lastDistance;
+void UltrasonicSensor::setCompleteCallback(UltrasonicCompleteCallback callback, void *context)
+{
+    completeCallback = callback;
+    callbackContext = context;
+}
+
+void UltrasonicSensor::setTemperature(float celsius)
+{
+    ranger.setTemperature(celsius);
 }
 
 uint16_t UltrasonicSensor::getDistance()
 {
-    return lastDistance;
+    return (uint16_t)(ranger.getDistance() + 0.5f);
 }
 
 bool UltrasonicSensor::isAvailable()
@@ -3,12 +3,27 @@
  * @brief HC-SR04 ultrasonic distance sensor interface
  * @author Your Name
  * @version 2.0
+ *
+ * Ranges without busy-waiting on the echo:
+ *
+ *   startPing()   arm the EchoRanger and send the 10 µs TRIG pulse
+ *   echo ISR      timestamps the rising and falling edge of ECHO
+ *   finishPing()  turn the width into a distance and update the median
+ *
+ * The completion callback runs in the ISR when the echo ends, so the
+ * caller can schedule finishPing() instead of polling for it. A ping
+ * takes at most ~25 ms (4 m), so 20 pings a second cost the sampling
+ * task a few µs each.
  */
 
 #ifndef ULTRASONIC_SENSOR_H
 #define ULTRASONIC_SENSOR_H
 
 #include <Arduino.h>
+#include "EchoRanger.h"
+
+// Called from the echo ISR when an echo has ended; must be IRAM-safe
+typedef void (*UltrasonicCompleteCallback)(void *context);
 
 class UltrasonicSensor
 {
@@ -16,17 +31,36 @@ private:
     uint8_t trigPin;
     uint8_t echoPin;
     uint16_t maxDistance;
-    uint16_t lastDistance;
     bool initialized;
 
-    long measurePulse();
+    EchoRanger ranger;
+    EchoResult lastResult;
+    uint32_t errorCount;
+
+    UltrasonicCompleteCallback completeCallback;
+    void *callbackContext;
+
+    static void IRAM_ATTR echoISR(void *arg);
 
 public:
     UltrasonicSensor();
+    ~UltrasonicSensor();
     bool begin(uint8_t trig, uint8_t echo);
-    uint16_t read();
-    uint16_t getDistance();
+
+    // Asynchronous ping
+    bool startPing();
+    bool isPinging() { return ranger.isArmed(); }
+    EchoResult finishPing(); // ECHO_PENDING until the echo ends or times out
+    void setCompleteCallback(UltrasonicCompleteCallback callback, void *context);
+
+    // Air temperature for the speed of sound (°C)
+    void setTemperature(float celsius);
+
+    uint16_t getDistance(); // Median distance (cm), 0 before the first echo
+    float getDistanceExact() { return ranger.getDistance(); }
     bool isAvailable();
+    EchoResult getLastResult() { return lastResult; }
+    uint32_t getErrorCount() { return errorCount; }
 };
 
 #endif // ULTRASONIC_SENSOR_H
@@ -0,0 +1,160 @@
+/**
+ * @file VibrationAnalyzer.cpp
+ * @brief Spectral vibration feature extraction
+ */
+
+#include "VibrationAnalyzer.h"
+#include <math.h>
+#include <string.h>
+
+RealFFT<VIBRATION_FFT_SIZE> VibrationAnalyzer::fft;
+
+VibrationAnalyzer::VibrationAnalyzer()
+{
+    windowPower = 0.0f;
+    for (uint16_t i = 0; i < VIBRATION_FFT_SIZE; i++)
+    {
+        window[i] = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / VIBRATION_FFT_SIZE);
+        windowPower += window[i] * window[i];
+    }
+
+    sampleRate = 100.0f;
+    hop = VIBRATION_FFT_SIZE;
+    bandCount = 0;
+    reset();
+}
+
+void VibrationAnalyzer::begin(float sampleRateHz, uint16_t hopSamples)
+{
+    sampleRate = sampleRateHz;
+    hop = hopSamples > 0 ? hopSamples : 1;
+    reset();
+}
+
+void VibrationAnalyzer::setBands(const float *edges, uint8_t edgeCount)
+{
+    if (edgeCount > VIBRATION_MAX_BANDS + 1)
+        edgeCount = VIBRATION_MAX_BANDS + 1;
+
+    bandCount = edgeCount > 1 ? edgeCount - 1 : 0;
+    for (uint8_t i = 0; i < edgeCount; i++)
+    {
+        bandEdges[i] = edges[i];
+    }
+}
+
+void VibrationAnalyzer::reset()
+{
+    memset(samples, 0, sizeof(samples));
+    memset(&features, 0, sizeof(features));
+    head = 0;
+    filled = 0;
+    sinceFrame = 0;
+}
+
+/**
+ * @brief Add one accelerometer sample (any unit; features are in that unit)
+ *
+ * The magnitude is direction-independent, so the result does not depend
+ * on how the board is mounted. Gravity ends up in the mean, which
+ * analyze() removes.
+ */
+void VibrationAnalyzer::addSample(float ax, float ay, float az)
+{
+    samples[head] = sqrtf(ax * ax + ay * ay + az * az);
+    head = (head + 1) & (VIBRATION_FFT_SIZE - 1);
+
+    if (filled < VIBRATION_FFT_SIZE)
+        filled++;
+    if (sinceFrame < hop)
+        sinceFrame++;
+}
+
+bool VibrationAnalyzer::isFrameReady() const
+{
+    return filled == VIBRATION_FFT_SIZE && sinceFrame >= hop;
+}
+
+bool VibrationAnalyzer::analyze()
+{
+    if (filled < VIBRATION_FFT_SIZE)
+        return false;
+    sinceFrame = 0;
+
+    // Oldest sample first, so the window is centred on the frame
+    float mean = 0.0f;
+    for (uint16_t i = 0; i < VIBRATION_FFT_SIZE; i++)
+    {
+        frame[i] = samples[(head + i) & (VIBRATION_FFT_SIZE - 1)];
+        mean += frame[i];
+    }
+    mean /= VIBRATION_FFT_SIZE;
+
+    // Time-domain features, then the window
+    float sumSquares = 0.0f;
+    float peak = 0.0f;
+    for (uint16_t i = 0; i < VIBRATION_FFT_SIZE; i++)
+    {
+        float x = frame[i] - mean;
+        sumSquares += x * x;
+        if (fabsf(x) > peak)
+            peak = fabsf(x);
+        frame[i] = x * window[i];
+    }
+
+    features.rms = sqrtf(sumSquares / VIBRATION_FFT_SIZE);
+    features.peak = peak;
+    features.crestFactor = features.rms > 0.0f ? peak / features.rms : 0.0f;
+
+    fft.forward(frame);
+
+    // One-sided power in g² per bin: 2|X|² / (N Σw²), DC and Nyquist once
+    const uint16_t half = VIBRATION_FFT_SIZE / 2;
+    const float scale = 2.0f / (VIBRATION_FFT_SIZE * windowPower);
+    const float binWidth = getResolution();
+
+    for (uint8_t b = 0; b < bandCount; b++)
+    {
+        features.bandEnergy[b] = 0.0f;
+    }
+
+    uint16_t peakBin = 0;
+    float peakPower = 0.0f;
+    uint8_t band = 0;
+    for (uint16_t k = 1; k <= half; k++)
+    {
+        float power = fft.power(frame, k) * (k == half ? scale * 0.5f : scale);
+        if (k < half && power > peakPower)
+        {
+            peakPower = power;
+            peakBin = k;
+        }
+
+        float frequency = k * binWidth;
+        while (band < bandCount && frequency >= bandEdges[band + 1])
+            band++;
+        if (band < bandCount && frequency >= bandEdges[band])
+            features.bandEnergy[band] += power;
+    }
+
+    // Parabola through the log power of the peak and its neighbours
+    float offset = 0.0f;
+    if (peakBin > 1 && peakBin < half - 1)
+    {
+        float left = fft.power(frame, peakBin - 1);
+        float right = fft.power(frame, peakBin + 1);
+        if (left > 0.0f && right > 0.0f)
+        {
+            float a = logf(left);
+            float b = logf(peakPower / scale);
+            float c = logf(right);
+            float denominator = a - 2.0f * b + c;
+            if (denominator < 0.0f)
+                offset = 0.5f * (a - c) / denominator;
+        }
+    }
+    features.peakFrequency = peakBin > 0 ? (peakBin + offset) * binWidth : 0.0f;
+
+    features.frames++;
+    return true;
+}
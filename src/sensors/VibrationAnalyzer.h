@@ -0,0 +1,82 @@
+/**
+ * @file VibrationAnalyzer.h
+ * @brief Spectral vibration features from accelerometer samples
+ *
+ * Keeps the last VIBRATION_FFT_SIZE acceleration magnitudes and, every
+ * hop samples, reduces them to a handful of numbers:
+ *
+ * - RMS and peak of the signal with its mean (gravity) removed, in g
+ * - crest factor (peak / RMS): impacts and bearing defects raise it
+ *   before they raise the RMS
+ * - peak frequency: the strongest spectral line, interpolated between bins
+ * - energy per frequency band (g², so the bands add up to about RMS²)
+ *
+ * The frame is Hann-windowed and transformed with RealFFT. Band energies
+ * are scaled by the window power, so they do not depend on the window or
+ * the frame size.
+ *
+ * No hardware access: recorded traces can be replayed through it on a PC.
+ */
+
+#ifndef VIBRATION_ANALYZER_H
+#define VIBRATION_ANALYZER_H
+
+#include <stdint.h>
+#include "../utils/RealFFT.h"
+
+#define VIBRATION_FFT_SIZE 256 // Samples per frame (1.28 s at 200 Hz)
+#define VIBRATION_MAX_BANDS 6
+
+struct VibrationFeatures
+{
+    float rms;           // g
+    float peak;          // g
+    float crestFactor;   // peak / rms
+    float peakFrequency; // Hz
+    float bandEnergy[VIBRATION_MAX_BANDS]; // g²
+    uint32_t frames;     // Frames analyzed so far
+};
+
+class VibrationAnalyzer
+{
+private:
+    float samples[VIBRATION_FFT_SIZE]; // Ring of magnitudes
+    float window[VIBRATION_FFT_SIZE];  // Hann
+    float frame[VIBRATION_FFT_SIZE];   // Work buffer, then spectrum
+    float windowPower;                 // Σ w²
+    uint16_t head;
+    uint16_t filled;
+    uint16_t sinceFrame;
+    uint16_t hop;
+    float sampleRate;
+
+    float bandEdges[VIBRATION_MAX_BANDS + 1]; // Hz
+    uint8_t bandCount;
+
+    VibrationFeatures features;
+
+    static RealFFT<VIBRATION_FFT_SIZE> fft;
+
+public:
+    VibrationAnalyzer();
+
+    // hopSamples: new samples between frames (sample rate = one frame per second)
+    void begin(float sampleRateHz, uint16_t hopSamples);
+    // Ascending edges in Hz; n edges make n - 1 bands (at most VIBRATION_MAX_BANDS)
+    void setBands(const float *edges, uint8_t edgeCount);
+    void reset();
+
+    void addSample(float ax, float ay, float az);
+    bool isFrameReady() const;
+    // Compute the features of the latest frame; false if not enough samples
+    bool analyze();
+
+    const VibrationFeatures &getFeatures() const { return features; }
+    uint8_t getBandCount() const { return bandCount; }
+    float getBandLow(uint8_t band) const { return bandEdges[band]; }
+    float getBandHigh(uint8_t band) const { return bandEdges[band + 1]; }
+    float getSampleRate() const { return sampleRate; }
+    float getResolution() const { return sampleRate / VIBRATION_FFT_SIZE; } // Hz per bin
+};
+
+#endif // VIBRATION_ANALYZER_H
@@ -0,0 +1,67 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * COMMAND HASH - COMPILE-TIME STRING HASHING
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file CommandHash.h
+ * @brief FNV-1a string hash usable in constant expressions
+ * @version 2.0.0
+ * @date 2024
+ *
+ * Lets string commands be dispatched with a switch statement instead of
+ * a chain of strcmp() calls. The compiler turns the switch into a jump
+ * table or binary search, and two names hashing to the same value show
+ * up as a "duplicate case value" compile error.
+ *
+ * USAGE:
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @code
+ * #include "utils/CommandHash.h"
+ *
+ * switch (hashName(type)) {
+ *     case hashName("getStatus"):
+ *         if (strcmp(type, "getStatus") == 0) handleStatus();  // Confirm
+ *         break;
+ *     ...
+ * }
+ * @endcode
+ *
+ * A hash match only says "probably this name": always confirm it with
+ * one strcmp() so arbitrary input can't alias a real command.
+ */
+
+#ifndef COMMAND_HASH_H
+#define COMMAND_HASH_H
+
+#include <stdint.h>
+
+#define FNV1A_OFFSET 2166136261u
+#define FNV1A_PRIME 16777619u
+
+/**
+ * @brief FNV-1a hash (C++11 constexpr, recursive form)
+ * @param text NUL-terminated string
+ * @param hash Running hash (leave default)
+ */
+constexpr uint32_t hashName(const char *text, uint32_t hash = FNV1A_OFFSET)
+{
+    return *text ? hashName(text + 1, (hash ^ (uint8_t)*text) * FNV1A_PRIME) : hash;
+}
+
+/**
+ * @brief FNV-1a hash of a runtime string (iterative form)
+ *
+ * Same result as hashName(); use this one on received data.
+ */
+inline uint32_t hashNameRuntime(const char *text)
+{
+    uint32_t hash = FNV1A_OFFSET;
+    while (*text)
+    {
+        hash = (hash ^ (uint8_t)*text++) * FNV1A_PRIME;
+    }
+    return hash;
+}
+
+#endif // COMMAND_HASH_H
@@ -0,0 +1,102 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * CONSTEXPR MATH - LOG / EXP / POW USABLE AT COMPILE TIME
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file ConstexprMath.h
+ * @brief Transcendental functions for building lookup tables at compile time
+ * @version 2.0.0
+ * @date 2024
+ *
+ * The <math.h> functions are not constexpr, so a table of pow() values
+ * would otherwise have to be filled at boot (RAM + startup time) or
+ * pasted in as literals. These are plain double-precision series that
+ * the compiler evaluates while building; the result is a const table in
+ * flash.
+ *
+ * Accuracy is ~1e-15 relative, far below float resolution. They are
+ * slow: meant for constexpr initializers, not for runtime calls.
+ *
+ * USAGE:
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @code
+ * #include "utils/ConstexprMath.h"
+ *
+ * struct Table { float v[65]; };
+ * constexpr Table makeTable()
+ * {
+ *     Table t{};
+ *     for (int i = 0; i < 65; i++)
+ *         t.v[i] = (float)ConstexprMath::pow(1.0 + i, -2.5);
+ *     return t;
+ * }
+ * static constexpr Table TABLE = makeTable();
+ * @endcode
+ */
+
+#ifndef CONSTEXPR_MATH_H
+#define CONSTEXPR_MATH_H
+
+namespace ConstexprMath
+{
+    constexpr double LN2 = 0.69314718055994530942;
+
+    // Natural log, x > 0
+    constexpr double log(double x)
+    {
+        // x = m * 2^k with m in [1, 2)
+        int k = 0;
+        while (x >= 2.0)
+        {
+            x /= 2.0;
+            k++;
+        }
+        while (x < 1.0)
+        {
+            x *= 2.0;
+            k--;
+        }
+
+        // ln(m) = 2 atanh(y), y = (m - 1) / (m + 1) <= 1/3
+        double y = (x - 1.0) / (x + 1.0);
+        double y2 = y * y;
+        double term = y;
+        double sum = 0.0;
+        for (int n = 1; n < 60; n += 2)
+        {
+            sum += term / n;
+            term *= y2;
+        }
+        return k * LN2 + 2.0 * sum;
+    }
+
+    constexpr double exp(double x)
+    {
+        // x = k ln2 + r with |r| <= ln2 / 2
+        int k = (int)(x / LN2 + (x < 0.0 ? -0.5 : 0.5));
+        double r = x - k * LN2;
+
+        double term = 1.0;
+        double sum = 1.0;
+        for (int n = 1; n < 30; n++)
+        {
+            term *= r / n;
+            sum += term;
+        }
+
+        for (; k > 0; k--)
+            sum *= 2.0;
+        for (; k < 0; k++)
+            sum /= 2.0;
+        return sum;
+    }
+
+    // x^y for x > 0
+    constexpr double pow(double x, double y)
+    {
+        return exp(y * log(x));
+    }
+}
+
+#endif // CONSTEXPR_MATH_H
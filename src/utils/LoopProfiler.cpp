@@ -0,0 +1,262 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * LOOP PROFILER - IMPLEMENTATION
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file LoopProfiler.cpp
+ * @brief Implementation of main loop stage timing
+ * @version 2.0.0
+ * @date 2024
+ */
+
+#include "LoopProfiler.h"
+
+#if ENABLE_LOOP_PROFILER
+
+#include "ResponseWriter.h"
+#include <algorithm>
+
+// Global instance
+LoopProfiler loopProfiler;
+
+ScopedStageTimer::~ScopedStageTimer()
+{
+    loopProfiler.recordStage(stage, (uint32_t)(esp_timer_get_time() - start));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// RECORDING
+// ═══════════════════════════════════════════════════════════════════════════
+
+LoopProfiler::LoopProfiler()
+{
+    stageCount = 0;
+    timerCount = 0;
+    loopStart = 0;
+    portMUX_INITIALIZE(&mux);
+    clear(period, "period");
+    clear(busy, "busy");
+}
+
+void LoopProfiler::clear(Samples &samples, const char *name)
+{
+    memset(&samples, 0, sizeof(samples));
+    samples.name = name;
+    samples.minMicros = UINT32_MAX;
+}
+
+int8_t LoopProfiler::addStage(const char *name)
+{
+    if (stageCount >= LOOP_PROFILER_MAX_STAGES)
+        return -1;
+
+    clear(stages[stageCount], name);
+    return stageCount++;
+}
+
+int8_t LoopProfiler::addTimer(const char *name, uint32_t interval)
+{
+    if (timerCount >= LOOP_PROFILER_MAX_TIMERS)
+        return -1;
+
+    TimerStats &timer = timers[timerCount];
+    memset(&timer, 0, sizeof(timer));
+    timer.name = name;
+    timer.interval = interval;
+    return timerCount++;
+}
+
+void LoopProfiler::record(Samples &samples, uint32_t micros)
+{
+    portENTER_CRITICAL(&mux);
+    samples.count++;
+    samples.totalMicros += micros;
+    if (micros < samples.minMicros)
+        samples.minMicros = micros;
+    if (micros > samples.maxMicros)
+        samples.maxMicros = micros;
+    samples.ring[samples.ringHead] = micros;
+    samples.ringHead = (samples.ringHead + 1) % LOOP_PROFILER_RING;
+    portEXIT_CRITICAL(&mux);
+}
+
+void LoopProfiler::beginLoop()
+{
+    int64_t now = esp_timer_get_time();
+    if (loopStart != 0)
+    {
+        record(period, (uint32_t)(now - loopStart));
+    }
+    loopStart = now;
+}
+
+void LoopProfiler::endLoop()
+{
+    if (loopStart != 0)
+    {
+        record(busy, (uint32_t)(esp_timer_get_time() - loopStart));
+    }
+}
+
+void LoopProfiler::recordStage(int8_t stage, uint32_t micros)
+{
+    if (stage >= 0 && stage < stageCount)
+    {
+        record(stages[stage], micros);
+    }
+}
+
+void LoopProfiler::recordTimer(int8_t timer, uint32_t latenessMs)
+{
+    if (timer < 0 || timer >= timerCount)
+        return;
+
+    TimerStats &stats = timers[timer];
+    portENTER_CRITICAL(&mux);
+    stats.fires++;
+    stats.totalLateness += latenessMs;
+    if (latenessMs > stats.maxLateness)
+        stats.maxLateness = latenessMs;
+    if (latenessMs > LOOP_TIMER_SLACK_MS)
+        stats.overruns++;
+    portEXIT_CRITICAL(&mux);
+}
+
+void LoopProfiler::reset()
+{
+    portENTER_CRITICAL(&mux);
+    for (uint8_t i = 0; i < stageCount; i++)
+    {
+        clear(stages[i], stages[i].name);
+    }
+    for (uint8_t i = 0; i < timerCount; i++)
+    {
+        const char *name = timers[i].name;
+        uint32_t interval = timers[i].interval;
+        memset(&timers[i], 0, sizeof(timers[i]));
+        timers[i].name = name;
+        timers[i].interval = interval;
+    }
+    clear(period, "period");
+    clear(busy, "busy");
+    loopStart = 0;
+    portEXIT_CRITICAL(&mux);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// REPORTING
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Percentile over the samples still in the ring
+ */
+uint32_t LoopProfiler::percentile(const Samples &samples, uint8_t percent)
+{
+    uint32_t sorted[LOOP_PROFILER_RING];
+    uint32_t n;
+
+    portENTER_CRITICAL(&mux);
+    n = samples.count < LOOP_PROFILER_RING ? samples.count : LOOP_PROFILER_RING;
+    memcpy(sorted, samples.ring, n * sizeof(uint32_t));
+    portEXIT_CRITICAL(&mux);
+
+    if (n == 0)
+        return 0;
+
+    std::sort(sorted, sorted + n);
+    uint32_t rank = (n * percent + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+void LoopProfiler::writeSamples(ResponseWriter &json, const Samples &samples)
+{
+    json.beginObject();
+    json.field("name", samples.name);
+    json.field("count", samples.count);
+    json.field("min", samples.count ? samples.minMicros : 0);
+    json.field("avg", (unsigned long)(samples.count ? samples.totalMicros / samples.count : 0));
+    json.field("max", samples.maxMicros);
+    json.field("p99", percentile(samples, 99));
+    json.endObject();
+}
+
+void LoopProfiler::writeJson(ResponseWriter &json)
+{
+    json.field("unit", "us");
+
+    json.beginObject("loop");
+    uint32_t p50 = percentile(period, 50);
+    uint32_t p99 = percentile(period, 99);
+    json.field("periodAvg", (unsigned long)(period.count ? period.totalMicros / period.count : 0));
+    json.field("periodP50", p50);
+    json.field("periodP99", p99);
+    json.field("periodMax", period.maxMicros);
+    json.field("jitter", p99 - p50);
+    json.field("busyAvg", (unsigned long)(busy.count ? busy.totalMicros / busy.count : 0));
+    json.field("busyP99", percentile(busy, 99));
+    json.field("busyMax", busy.maxMicros);
+    json.endObject();
+
+    json.beginArray("stages");
+    for (uint8_t i = 0; i < stageCount; i++)
+    {
+        writeSamples(json, stages[i]);
+    }
+    json.endArray();
+
+    json.beginArray("timers");
+    for (uint8_t i = 0; i < timerCount; i++)
+    {
+        const TimerStats &timer = timers[i];
+        json.beginObject();
+        json.field("name", timer.name);
+        json.field("interval", timer.interval);
+        json.field("fires", timer.fires);
+        json.field("overruns", timer.overruns);
+        json.field("lateAvg", (unsigned long)(timer.fires ? timer.totalLateness / timer.fires : 0));
+        json.field("lateMax", timer.maxLateness);
+        json.endObject();
+    }
+    json.endArray();
+}
+
+void LoopProfiler::printSamples(Print &out, const Samples &samples)
+{
+    out.printf("%-12s %8lu %8lu %8lu %8lu %8lu\n", samples.name,
+               (unsigned long)samples.count,
+               (unsigned long)(samples.count ? samples.minMicros : 0),
+               (unsigned long)(samples.count ? samples.totalMicros / samples.count : 0),
+               (unsigned long)samples.maxMicros,
+               (unsigned long)percentile(samples, 99));
+}
+
+void LoopProfiler::printReport(Print &out)
+{
+    out.println("\n╔═══════════════════════════════════════════════════╗");
+    out.println("║              LOOP PROFILE (microseconds)          ║");
+    out.println("╚═══════════════════════════════════════════════════╝");
+    out.printf("%-12s %8s %8s %8s %8s %8s\n", "stage", "count", "min", "avg", "max", "p99");
+    printSamples(out, period);
+    printSamples(out, busy);
+    out.println("─────────────────────────────────────────────────────");
+    for (uint8_t i = 0; i < stageCount; i++)
+    {
+        printSamples(out, stages[i]);
+    }
+
+    if (timerCount > 0)
+    {
+        out.println("─────────────────────────────────────────────────────");
+        out.printf("%-12s %8s %8s %8s %8s (ms)\n", "timer", "interval", "fires", "overrun", "lateMax");
+        for (uint8_t i = 0; i < timerCount; i++)
+        {
+            const TimerStats &timer = timers[i];
+            out.printf("%-12s %8lu %8lu %8lu %8lu\n", timer.name,
+                       (unsigned long)timer.interval, (unsigned long)timer.fires,
+                       (unsigned long)timer.overruns, (unsigned long)timer.maxLateness);
+        }
+    }
+    out.println("═════════════════════════════════════════════════════");
+}
+
+#endif // ENABLE_LOOP_PROFILER
@@ -0,0 +1,153 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * LOOP PROFILER - STAGE TIMING FOR THE MAIN LOOP
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file LoopProfiler.h
+ * @brief Scoped timers for loop() stages, loop jitter and Timer overruns
+ * @version 2.0.0
+ * @date 2024
+ *
+ * Records, per named stage, min/avg/max and p99 (over the last
+ * LOOP_PROFILER_RING runs) duration. Per loop it records the period
+ * (start to start) and the busy time (start to PROFILE_LOOP_END), so
+ * the slack left before delay() is visible. For each Timer it counts
+ * how late it fired and how often it was later than LOOP_TIMER_SLACK_MS.
+ *
+ * Everything compiles to nothing unless ENABLE_LOOP_PROFILER is set.
+ *
+ * USAGE:
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @code
+ * #include "utils/LoopProfiler.h"
+ *
+ * void loop() {
+ *     PROFILE_LOOP_BEGIN();
+ *
+ *     if (sensorTimer.isReady()) {
+ *         PROFILE_STAGE("sensors");          // Times until end of scope
+ *         PROFILE_TIMER("sensor", sensorTimer);
+ *         readSensors();
+ *     }
+ *
+ *     PROFILE_LOOP_END();
+ *     delay(10);
+ * }
+ * @endcode
+ *
+ * Report: GET /api/perf/loop, or "perf" on the Serial Monitor.
+ */
+
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+#if ENABLE_LOOP_PROFILER
+
+#include <esp_timer.h>
+
+class ResponseWriter;
+
+class LoopProfiler
+{
+private:
+    struct Samples
+    {
+        const char *name;
+        uint32_t count;
+        uint32_t minMicros;
+        uint32_t maxMicros;
+        uint64_t totalMicros;
+        uint32_t ring[LOOP_PROFILER_RING];
+        uint8_t ringHead;
+    };
+
+    struct TimerStats
+    {
+        const char *name;
+        uint32_t interval;
+        uint32_t fires;
+        uint32_t overruns;
+        uint32_t maxLateness;
+        uint64_t totalLateness;
+    };
+
+    Samples stages[LOOP_PROFILER_MAX_STAGES];
+    uint8_t stageCount;
+    TimerStats timers[LOOP_PROFILER_MAX_TIMERS];
+    uint8_t timerCount;
+
+    Samples period; // Loop start to next loop start
+    Samples busy;   // Loop start to PROFILE_LOOP_END
+    int64_t loopStart;
+
+    portMUX_TYPE mux;
+
+    static void clear(Samples &samples, const char *name);
+    void record(Samples &samples, uint32_t micros);
+    uint32_t percentile(const Samples &samples, uint8_t percent);
+    void writeSamples(ResponseWriter &json, const Samples &samples);
+    void printSamples(Print &out, const Samples &samples);
+
+public:
+    LoopProfiler();
+
+    // Register once per call site (the macros do this)
+    int8_t addStage(const char *name);
+    int8_t addTimer(const char *name, uint32_t interval);
+
+    void beginLoop();
+    void endLoop();
+    void recordStage(int8_t stage, uint32_t micros);
+    void recordTimer(int8_t timer, uint32_t latenessMs);
+    void reset();
+
+    // Write "loop", "stages" and "timers" members
+    void writeJson(ResponseWriter &json);
+    void printReport(Print &out);
+};
+
+/**
+ * @brief Records the time from construction to end of scope
+ */
+class ScopedStageTimer
+{
+private:
+    int8_t stage;
+    int64_t start;
+
+public:
+    explicit ScopedStageTimer(int8_t id) : stage(id), start(esp_timer_get_time()) {}
+    ~ScopedStageTimer();
+};
+
+extern LoopProfiler loopProfiler;
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#define PROFILE_LOOP_BEGIN() loopProfiler.beginLoop()
+#define PROFILE_LOOP_END() loopProfiler.endLoop()
+#define PROFILE_STAGE(name)                                                                     \
+    static const int8_t PROFILE_CONCAT(profileStage_, __LINE__) = loopProfiler.addStage(name); \
+    ScopedStageTimer PROFILE_CONCAT(profileTimer_, __LINE__)(PROFILE_CONCAT(profileStage_, __LINE__))
+#define PROFILE_TIMER(name, timer)                                                              \
+    do                                                                                          \
+    {                                                                                           \
+        static const int8_t profileTimerId = loopProfiler.addTimer(name, (timer).getInterval()); \
+        loopProfiler.recordTimer(profileTimerId, (timer).getLateness());                        \
+    } while (0)
+
+#else
+
+#define PROFILE_LOOP_BEGIN()
+#define PROFILE_LOOP_END()
+#define PROFILE_STAGE(name)
+#define PROFILE_TIMER(name, timer)
+
+#endif // ENABLE_LOOP_PROFILER
+
+#endif // LOOP_PROFILER_H
@@ -0,0 +1,267 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * METRICS - IMPLEMENTATION
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file Metrics.cpp
+ * @brief Implementation of metrics registry and text exposition
+ * @version 2.0.0
+ * @date 2024
+ */
+
+#include "Metrics.h"
+#include <math.h>
+
+// Global instance
+MetricsRegistry metrics;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// HISTOGRAM
+// ═══════════════════════════════════════════════════════════════════════════
+
+Histogram::Histogram(const float *upperBounds, uint8_t buckets)
+    : bounds(upperBounds),
+      bucketCount(buckets > METRICS_MAX_BUCKETS ? METRICS_MAX_BUCKETS : buckets)
+{
+    portMUX_INITIALIZE(&mux);
+    reset();
+}
+
+void Histogram::observe(float value)
+{
+    uint8_t bucket = 0;
+    while (bucket < bucketCount && value > bounds[bucket])
+    {
+        bucket++;
+    }
+
+    portENTER_CRITICAL(&mux);
+    counts[bucket]++;
+    sum += value;
+    count++;
+    portEXIT_CRITICAL(&mux);
+}
+
+void Histogram::reset()
+{
+    portENTER_CRITICAL(&mux);
+    memset(counts, 0, sizeof(counts));
+    sum = 0;
+    count = 0;
+    portEXIT_CRITICAL(&mux);
+}
+
+uint32_t Histogram::getCumulative(uint8_t bucket)
+{
+    uint32_t total = 0;
+
+    portENTER_CRITICAL(&mux);
+    for (uint8_t i = 0; i <= bucket && i <= bucketCount; i++)
+    {
+        total += counts[i];
+    }
+    portEXIT_CRITICAL(&mux);
+
+    return total;
+}
+
+void Histogram::snapshot(HistogramSnapshot &out)
+{
+    uint32_t total = 0;
+
+    portENTER_CRITICAL(&mux);
+    for (uint8_t i = 0; i <= bucketCount; i++)
+    {
+        total += counts[i];
+        out.cumulative[i] = total;
+    }
+    out.sum = sum;
+    out.count = count;
+    portEXIT_CRITICAL(&mux);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// REGISTRY
+// ═══════════════════════════════════════════════════════════════════════════
+
+MetricsRegistry::MetricsRegistry()
+{
+    count = 0;
+}
+
+bool MetricsRegistry::add(const char *name, const char *help, MetricType type, MetricReader reader,
+                          Counter *counter, Gauge *gauge, Histogram *histogram)
+{
+    if (count >= METRICS_MAX)
+    {
+        DEBUG_PRINTF("[METRICS] Registry full, dropping %s\n", name);
+        return false;
+    }
+
+    Entry &entry = entries[count++];
+    entry.name = name;
+    entry.help = help;
+    entry.type = type;
+    entry.reader = reader;
+    entry.counter = counter;
+    entry.gauge = gauge;
+    entry.histogram = histogram;
+    return true;
+}
+
+bool MetricsRegistry::addCounter(const char *name, const char *help, Counter &counter)
+{
+    return add(name, help, METRIC_COUNTER, nullptr, &counter, nullptr, nullptr);
+}
+
+bool MetricsRegistry::addCounter(const char *name, const char *help, MetricReader reader)
+{
+    return add(name, help, METRIC_COUNTER, reader, nullptr, nullptr, nullptr);
+}
+
+bool MetricsRegistry::addGauge(const char *name, const char *help, Gauge &gauge)
+{
+    return add(name, help, METRIC_GAUGE, nullptr, nullptr, &gauge, nullptr);
+}
+
+bool MetricsRegistry::addGauge(const char *name, const char *help, MetricReader reader)
+{
+    return add(name, help, METRIC_GAUGE, reader, nullptr, nullptr, nullptr);
+}
+
+bool MetricsRegistry::addHistogram(const char *name, const char *help, Histogram &histogram)
+{
+    return add(name, help, METRIC_HISTOGRAM, nullptr, nullptr, nullptr, &histogram);
+}
+
+/**
+ * @brief Print a sample value the way Prometheus parses it
+ */
+void MetricsRegistry::printValue(Print &out, double value)
+{
+    if (isnan(value))
+        out.print("NaN");
+    else if (isinf(value))
+        out.print(value > 0 ? "+Inf" : "-Inf");
+    else if (value == (double)(int64_t)value && fabs(value) < 1e15)
+        out.print((long long)value);
+    else
+        out.print(value, 6);
+}
+
+/**
+ * @brief Render one line of one metric
+ *
+ * Lines per metric: # HELP, # TYPE, then the sample(s). A histogram has
+ * one sample per bucket plus +Inf, _sum and _count, all from the
+ * snapshot taken on its first sample line.
+ */
+bool MetricsRegistry::renderLine(uint8_t index, uint8_t line, Print &out, HistogramSnapshot &snapshot)
+{
+    if (index >= count)
+        return false;
+
+    const Entry &entry = entries[index];
+
+    if (line == 0)
+    {
+        out.printf("# HELP %s%s %s\n", METRICS_PREFIX, entry.name, entry.help);
+        return true;
+    }
+    if (line == 1)
+    {
+        static const char *const TYPE_NAMES[] = {"counter", "gauge", "histogram"};
+        out.printf("# TYPE %s%s %s\n", METRICS_PREFIX, entry.name, TYPE_NAMES[entry.type]);
+        return true;
+    }
+
+    uint8_t sample = line - 2;
+
+    if (entry.type != METRIC_HISTOGRAM)
+    {
+        if (sample > 0)
+            return false;
+
+        double value;
+        if (entry.reader)
+            value = entry.reader();
+        else if (entry.counter)
+            value = entry.counter->get();
+        else
+            value = entry.gauge->get();
+
+        out.print(METRICS_PREFIX);
+        out.print(entry.name);
+        out.print(' ');
+        printValue(out, value);
+        out.print('\n');
+        return true;
+    }
+
+    Histogram &histogram = *entry.histogram;
+    uint8_t buckets = histogram.getBucketCount();
+
+    if (sample == 0)
+        histogram.snapshot(snapshot);
+
+    if (sample <= buckets)
+    {
+        out.print(METRICS_PREFIX);
+        out.print(entry.name);
+        out.print("_bucket{le=\"");
+        if (sample < buckets)
+            printValue(out, histogram.getBound(sample));
+        else
+            out.print("+Inf");
+        out.print("\"} ");
+        out.print(snapshot.cumulative[sample]);
+        out.print('\n');
+        return true;
+    }
+    if (sample == buckets + 1)
+    {
+        out.print(METRICS_PREFIX);
+        out.print(entry.name);
+        out.print("_sum ");
+        printValue(out, snapshot.sum);
+        out.print('\n');
+        return true;
+    }
+    if (sample == buckets + 2)
+    {
+        out.print(METRICS_PREFIX);
+        out.print(entry.name);
+        out.print("_count ");
+        out.print(snapshot.count);
+        out.print('\n');
+        return true;
+    }
+    return false;
+}
+
+void MetricsRegistry::render(Print &out)
+{
+    MetricsCursor cursor(*this);
+    while (cursor.next(out))
+    {
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// CURSOR
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool MetricsCursor::next(Print &out)
+{
+    while (metric < registry.count)
+    {
+        if (registry.renderLine(metric, line, out, histogram))
+        {
+            line++;
+            return true;
+        }
+        metric++;
+        line = 0;
+    }
+    return false;
+}
@@ -0,0 +1,188 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * METRICS - COUNTERS, GAUGES AND HISTOGRAMS
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file Metrics.h
+ * @brief Central metrics registry rendered in Prometheus text format
+ * @version 2.0.0
+ * @date 2024
+ *
+ * Metrics are registered once at startup and either own their value
+ * (Counter, Gauge, Histogram) or read an existing statistic through a
+ * callback, so modules that already count things don't have to change:
+ *
+ * @code
+ * #include "utils/Metrics.h"
+ *
+ * static Counter reconnects;
+ * static const float LATENCY_BUCKETS[] = {0.001f, 0.01f, 0.1f, 1.0f};
+ * static Histogram latency(LATENCY_BUCKETS, 4);
+ *
+ * metrics.addCounter("wifi_reconnects_total", "WiFi reconnects", reconnects);
+ * metrics.addHistogram("sensor_read_seconds", "Sensor read time", latency);
+ * metrics.addGauge("heap_free_bytes", "Free heap",
+ *                  []() -> double { return ESP.getFreeHeap(); });
+ *
+ * reconnects.inc();
+ * latency.observe(0.004f);
+ * @endcode
+ *
+ * Rendering never allocates: MetricsCursor produces one exposition line
+ * at a time into any Print, so /metrics can stream straight into a
+ * chunked HTTP response. A histogram's lines come from one snapshot, so
+ * observations made while it streams cannot leave +Inf and _count apart.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+enum MetricType
+{
+    METRIC_COUNTER = 0,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+};
+
+// Reads a value owned elsewhere (captureless lambda or free function)
+typedef double (*MetricReader)();
+
+/**
+ * @brief Monotonic counter, safe to increment from any task
+ */
+class Counter
+{
+private:
+    volatile uint32_t value;
+
+public:
+    Counter() : value(0) {}
+
+    void inc(uint32_t amount = 1) { __atomic_fetch_add(&value, amount, __ATOMIC_RELAXED); }
+    uint32_t get() const { return value; }
+};
+
+/**
+ * @brief Value that can go up and down
+ */
+class Gauge
+{
+private:
+    volatile float value;
+
+public:
+    Gauge() : value(0) {}
+
+    void set(float v) { value = v; }
+    float get() const { return value; }
+};
+
+/**
+ * @brief Consistent copy of a histogram, taken once per rendering
+ */
+struct HistogramSnapshot
+{
+    uint32_t cumulative[METRICS_MAX_BUCKETS + 1]; // Last entry is +Inf
+    double sum;
+    uint32_t count;
+};
+
+/**
+ * @brief Fixed-bucket histogram
+ *
+ * Bucket bounds are upper limits in ascending order; the array must
+ * outlive the histogram. Values above the last bound land in +Inf.
+ */
+class Histogram
+{
+private:
+    const float *bounds;
+    uint8_t bucketCount;
+    uint32_t counts[METRICS_MAX_BUCKETS + 1];
+    double sum;
+    uint32_t count;
+    portMUX_TYPE mux;
+
+public:
+    Histogram(const float *upperBounds, uint8_t buckets);
+
+    void observe(float value);
+    void reset();
+
+    uint8_t getBucketCount() const { return bucketCount; }
+    float getBound(uint8_t bucket) const { return bounds[bucket]; }
+    // Observations <= bound of bucket (bucket == getBucketCount() is +Inf)
+    uint32_t getCumulative(uint8_t bucket);
+    double getSum() { return sum; }
+    uint32_t getCount() { return count; }
+    // All buckets, sum and count under one lock
+    void snapshot(HistogramSnapshot &out);
+};
+
+class MetricsRegistry
+{
+private:
+    struct Entry
+    {
+        const char *name;
+        const char *help;
+        MetricType type;
+        MetricReader reader;
+        Counter *counter;
+        Gauge *gauge;
+        Histogram *histogram;
+    };
+
+    Entry entries[METRICS_MAX];
+    uint8_t count;
+
+    bool add(const char *name, const char *help, MetricType type, MetricReader reader,
+             Counter *counter, Gauge *gauge, Histogram *histogram);
+    void printValue(Print &out, double value);
+
+    friend class MetricsCursor;
+    // Render line `line` of metric `index`; false when past its last line.
+    // A histogram is copied into `snapshot` on its first sample line and
+    // the rest of its lines render from that copy.
+    bool renderLine(uint8_t index, uint8_t line, Print &out, HistogramSnapshot &snapshot);
+
+public:
+    MetricsRegistry();
+
+    // Names and help texts must be string literals (stored by pointer)
+    bool addCounter(const char *name, const char *help, Counter &counter);
+    bool addCounter(const char *name, const char *help, MetricReader reader);
+    bool addGauge(const char *name, const char *help, Gauge &gauge);
+    bool addGauge(const char *name, const char *help, MetricReader reader);
+    bool addHistogram(const char *name, const char *help, Histogram &histogram);
+
+    // Render every metric at once
+    void render(Print &out);
+
+    uint8_t getCount() { return count; }
+};
+
+/**
+ * @brief Walks the registry one exposition line at a time
+ */
+class MetricsCursor
+{
+private:
+    MetricsRegistry &registry;
+    uint8_t metric;
+    uint8_t line;
+    HistogramSnapshot histogram; // Of the histogram being rendered
+
+public:
+    explicit MetricsCursor(MetricsRegistry &reg) : registry(reg), metric(0), line(0) {}
+
+    // Write the next line (with '\n'); false when everything was written
+    bool next(Print &out);
+};
+
+extern MetricsRegistry metrics;
+
+#endif // METRICS_H
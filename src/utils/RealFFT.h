@@ -0,0 +1,178 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * REAL FFT - RADIX-2 TRANSFORM OF REAL-VALUED SAMPLES
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file RealFFT.h
+ * @brief In-place N-point FFT of real input, N a power of two
+ * @version 2.0.0
+ * @date 2024
+ *
+ * A real signal of N samples is transformed as an N/2-point complex FFT
+ * (even samples as real parts, odd samples as imaginary parts) followed
+ * by a split step that separates the two halves again. That is half the
+ * work of a complex FFT of the same length.
+ *
+ * Twiddle factors and the bit-reversal permutation are computed once in
+ * the constructor, so forward() is only multiply-adds (single precision,
+ * which the ESP32 FPU does in hardware).
+ *
+ * Output is packed in place, like CMSIS/ESP-DSP real FFTs:
+ *
+ *   data[0]       X[0]   (DC, real)
+ *   data[1]       X[N/2] (Nyquist, real)
+ *   data[2k]      Re X[k]   for 1 <= k < N/2
+ *   data[2k + 1]  Im X[k]
+ *
+ * No Arduino dependencies, so the same code runs on a host build.
+ *
+ * USAGE:
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @code
+ * #include "utils/RealFFT.h"
+ *
+ * static RealFFT<256> fft;
+ * float frame[256];          // windowed samples
+ * fft.forward(frame);        // frame now holds the spectrum
+ * float p = fft.power(frame, 10);  // |X[10]|^2
+ * @endcode
+ */
+
+#ifndef REAL_FFT_H
+#define REAL_FFT_H
+
+#include <stdint.h>
+#include <math.h>
+
+template <uint16_t N>
+class RealFFT
+{
+    static_assert(N >= 8 && (N & (N - 1)) == 0, "RealFFT size must be a power of two");
+
+private:
+    static const uint16_t HALF = N / 2;
+
+    float twiddleRe[HALF]; // cos(2πk/N)
+    float twiddleIm[HALF]; // -sin(2πk/N)
+    uint16_t bitReverse[HALF];
+
+    // N/2-point complex FFT on interleaved re/im pairs
+    void complexForward(float *data) const
+    {
+        for (uint16_t i = 0; i < HALF; i++)
+        {
+            uint16_t j = bitReverse[i];
+            if (j > i)
+            {
+                float re = data[2 * i], im = data[2 * i + 1];
+                data[2 * i] = data[2 * j];
+                data[2 * i + 1] = data[2 * j + 1];
+                data[2 * j] = re;
+                data[2 * j + 1] = im;
+            }
+        }
+
+        for (uint16_t size = 2; size <= HALF; size <<= 1)
+        {
+            uint16_t half = size >> 1;
+            uint16_t stride = N / size; // W_size^j == W_N^(j * N / size)
+
+            for (uint16_t start = 0; start < HALF; start += size)
+            {
+                for (uint16_t j = 0; j < half; j++)
+                {
+                    float wr = twiddleRe[j * stride];
+                    float wi = twiddleIm[j * stride];
+                    float *a = data + 2 * (start + j);
+                    float *b = data + 2 * (start + j + half);
+
+                    float tr = wr * b[0] - wi * b[1];
+                    float ti = wr * b[1] + wi * b[0];
+                    b[0] = a[0] - tr;
+                    b[1] = a[1] - ti;
+                    a[0] += tr;
+                    a[1] += ti;
+                }
+            }
+        }
+    }
+
+public:
+    RealFFT()
+    {
+        for (uint16_t k = 0; k < HALF; k++)
+        {
+            double angle = 2.0 * M_PI * k / N;
+            twiddleRe[k] = (float)cos(angle);
+            twiddleIm[k] = (float)-sin(angle);
+        }
+
+        uint8_t bits = 0;
+        while ((1u << bits) < HALF)
+            bits++;
+        for (uint16_t i = 0; i < HALF; i++)
+        {
+            uint16_t reversed = 0;
+            for (uint8_t b = 0; b < bits; b++)
+            {
+                if (i & (1u << b))
+                    reversed |= 1u << (bits - 1 - b);
+            }
+            bitReverse[i] = reversed;
+        }
+    }
+
+    /**
+     * @brief Transform N real samples in place into the packed spectrum
+     */
+    void forward(float *data) const
+    {
+        complexForward(data);
+
+        // DC and Nyquist are real; pack them into the first pair
+        float z0r = data[0], z0i = data[1];
+        data[0] = z0r + z0i;
+        data[1] = z0r - z0i;
+
+        // Split Z[k] and Z[N/2-k] into X[k] and X[N/2-k]
+        for (uint16_t k = 1; k <= HALF / 2; k++)
+        {
+            float *zk = data + 2 * k;
+            float *zm = data + 2 * (HALF - k);
+
+            // E = (Z[k] + conj Z[N/2-k]) / 2, O = -i (Z[k] - conj Z[N/2-k]) / 2
+            float er = 0.5f * (zk[0] + zm[0]);
+            float ei = 0.5f * (zk[1] - zm[1]);
+            float or_ = 0.5f * (zk[1] + zm[1]);
+            float oi = -0.5f * (zk[0] - zm[0]);
+
+            // W^k O
+            float wr = twiddleRe[k], wi = twiddleIm[k];
+            float tr = wr * or_ - wi * oi;
+            float ti = wr * oi + wi * or_;
+
+            // X[k] = E + W^k O, X[N/2-k] = conj(E - W^k O)
+            zk[0] = er + tr;
+            zk[1] = ei + ti;
+            zm[0] = er - tr;
+            zm[1] = ti - ei;
+        }
+    }
+
+    /**
+     * @brief |X[k]|^2 from a packed spectrum, 0 <= k <= N/2
+     */
+    float power(const float *spectrum, uint16_t k) const
+    {
+        if (k == 0)
+            return spectrum[0] * spectrum[0];
+        if (k >= HALF)
+            return spectrum[1] * spectrum[1];
+        return spectrum[2 * k] * spectrum[2 * k] + spectrum[2 * k + 1] * spectrum[2 * k + 1];
+    }
+
+    static uint16_t size() { return N; }
+};
+
+#endif // REAL_FFT_H
@@ -0,0 +1,352 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * RESPONSE WRITER - IMPLEMENTATION
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file ResponseWriter.cpp
+ * @brief Implementation of streaming JSON / HTML writer
+ * @version 2.0.0
+ * @date 2024
+ */
+
+#include "ResponseWriter.h"
+
+// Longest placeholder name accepted by writeTemplate()
+#define TEMPLATE_MAX_NAME 24
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FIXED BUFFER PRINT
+// ═══════════════════════════════════════════════════════════════════════════
+
+FixedBufferPrint::FixedBufferPrint(char *buf, size_t size)
+    : buffer(buf), capacity(size), used(0), overflow(false)
+{
+    if (capacity > 0)
+        buffer[0] = '\0';
+}
+
+size_t FixedBufferPrint::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t FixedBufferPrint::write(const uint8_t *data, size_t size)
+{
+    if (capacity == 0)
+    {
+        overflow = overflow || size > 0;
+        return 0;
+    }
+
+    size_t room = capacity - 1 - used;
+    if (size > room)
+    {
+        overflow = true;
+        size = room;
+    }
+
+    memcpy(buffer + used, data, size);
+    used += size;
+    buffer[used] = '\0';
+    return size;
+}
+
+void FixedBufferPrint::reset()
+{
+    used = 0;
+    overflow = false;
+    if (capacity > 0)
+        buffer[0] = '\0';
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// RESPONSE WRITER
+// ═══════════════════════════════════════════════════════════════════════════
+
+ResponseWriter::ResponseWriter(Print &output) : out(output), depth(0), tooDeep(false)
+{
+    for (int i = 0; i < RESPONSE_WRITER_MAX_DEPTH; i++)
+        first[i] = true;
+}
+
+void ResponseWriter::separator()
+{
+    if (depth == 0 || tooDeep)
+        return;
+    if (!first[depth - 1])
+        out.write(',');
+    first[depth - 1] = false;
+}
+
+void ResponseWriter::key(const char *name)
+{
+    separator();
+    if (name)
+    {
+        escaped(name, false);
+        out.write(':');
+    }
+}
+
+/**
+ * Nesting past RESPONSE_WRITER_MAX_DEPTH stops tracking: the writer is
+ * marked overflowed() and writes no more separators, so first[] is never
+ * indexed out of range.
+ */
+void ResponseWriter::open(char bracket)
+{
+    out.write(bracket);
+    if (depth >= RESPONSE_WRITER_MAX_DEPTH)
+    {
+        tooDeep = true;
+        return;
+    }
+    first[depth] = true;
+    depth++;
+}
+
+void ResponseWriter::close(char bracket)
+{
+    if (depth > 0 && !tooDeep)
+        depth--;
+    out.write(bracket);
+}
+
+/**
+ * @brief Write text escaped for JSON (quoted) or HTML (unquoted)
+ */
+void ResponseWriter::escaped(const char *text, bool html)
+{
+    if (!html)
+        out.write('"');
+
+    const char *run = text;
+    for (const char *p = text; *p; p++)
+    {
+        const char *replacement = nullptr;
+        char unicode[7];
+
+        if (html)
+        {
+            switch (*p)
+            {
+            case '<': replacement = "&lt;"; break;
+            case '>': replacement = "&gt;"; break;
+            case '&': replacement = "&amp;"; break;
+            case '"': replacement = "&quot;"; break;
+            case '\'': replacement = "&#39;"; break;
+            }
+        }
+        else
+        {
+            switch (*p)
+            {
+            case '"': replacement = "\\\""; break;
+            case '\\': replacement = "\\\\"; break;
+            case '\n': replacement = "\\n"; break;
+            case '\r': replacement = "\\r"; break;
+            case '\t': replacement = "\\t"; break;
+            default:
+                if ((uint8_t)*p < 0x20)
+                {
+                    snprintf(unicode, sizeof(unicode), "\\u%04x", (uint8_t)*p);
+                    replacement = unicode;
+                }
+                break;
+            }
+        }
+
+        if (replacement)
+        {
+            // Flush the unescaped run before this character in one write
+            if (p > run)
+                out.write((const uint8_t *)run, p - run);
+            out.print(replacement);
+            run = p + 1;
+        }
+    }
+
+    const char *end = run + strlen(run);
+    if (end > run)
+        out.write((const uint8_t *)run, end - run);
+
+    if (!html)
+        out.write('"');
+}
+
+// ─── JSON structure ─────────────────────────────────────────────────────────
+
+ResponseWriter &ResponseWriter::beginObject(const char *name)
+{
+    key(name);
+    open('{');
+    return *this;
+}
+
+ResponseWriter &ResponseWriter::endObject()
+{
+    close('}');
+    return *this;
+}
+
+ResponseWriter &ResponseWriter::beginArray(const char *name)
+{
+    key(name);
+    open('[');
+    return *this;
+}
+
+ResponseWriter &ResponseWriter::endArray()
+{
+    close(']');
+    return *this;
+}
+
+// ─── JSON object members ────────────────────────────────────────────────────
+
+ResponseWriter &ResponseWriter::field(const char *name, const char *text)
+{
+    key(name);
+    if (text)
+        escaped(text, false);
+    else
+        out.print("null");
+    return *this;
+}
+
+ResponseWriter &ResponseWriter::field(const char *name, const String &text)
+{
+    return field(name, text.c_str());
+}
+
+ResponseWriter &ResponseWriter::field(const char *name, bool flag)
+{
+    key(name);
+    out.print(flag ? "true" : "false");
+    return *this;
+}
+
+ResponseWriter &ResponseWriter::field(const char *name, int number)
+{
+    key(name);
+    out.print(number);
+    return *this;
+}
+
+ResponseWriter &ResponseWriter::field(const char *name, unsigned int number)
+{
+    key(name);
+    out.print(number);
+    return *this;
+}
+
+ResponseWriter &ResponseWriter::field(const char *name, long number)
+{
+    key(name);
+    out.print(number);
+    return *this;
+}
+
+ResponseWriter &ResponseWriter::field(const char *name, unsigned long number)
+{
+    key(name);
+    out.print(number);
+    return *this;
+}
+
+ResponseWriter &ResponseWriter::field(const char *name, double number, uint8_t decimals)
+{
+    key(name);
+    if (isnan(number) || isinf(number))
+        out.print("null"); // JSON has no NaN/Infinity
+    else
+        out.print(number, decimals);
+    return *this;
+}
+
+ResponseWriter &ResponseWriter::fieldRaw(const char *name, const char *json)
+{
+    key(name);
+    out.print(json);
+    return *this;
+}
+
+// ─── JSON array elements ────────────────────────────────────────────────────
+
+ResponseWriter &ResponseWriter::value(const char *text) { return field(nullptr, text); }
+ResponseWriter &ResponseWriter::value(bool flag) { return field(nullptr, flag); }
+ResponseWriter &ResponseWriter::value(int number) { return field(nullptr, number); }
+ResponseWriter &ResponseWriter::value(unsigned int number) { return field(nullptr, number); }
+ResponseWriter &ResponseWriter::value(long number) { return field(nullptr, number); }
+ResponseWriter &ResponseWriter::value(unsigned long number) { return field(nullptr, number); }
+ResponseWriter &ResponseWriter::value(double number, uint8_t decimals) { return field(nullptr, number, decimals); }
+
+// ─── HTML / raw text ────────────────────────────────────────────────────────
+
+ResponseWriter &ResponseWriter::raw(const char *text)
+{
+    out.print(text);
+    return *this;
+}
+
+ResponseWriter &ResponseWriter::raw(const char *text, size_t len)
+{
+    out.write((const uint8_t *)text, len);
+    return *this;
+}
+
+ResponseWriter &ResponseWriter::html(const char *text)
+{
+    escaped(text, true);
+    return *this;
+}
+
+/**
+ * @brief Copy a template, expanding %NAME% placeholders
+ * @param tmpl Template text (may live in flash)
+ * @param vars Known placeholders
+ * @param count Number of placeholders
+ *
+ * Only names listed in vars are replaced. Any other '%' (e.g. "100%"
+ * in CSS) is copied verbatim, which is what AsyncWebServer's template
+ * processor gets wrong.
+ */
+ResponseWriter &ResponseWriter::writeTemplate(const char *tmpl, const TemplateVar *vars, size_t count)
+{
+    const char *run = tmpl;
+    const char *p = tmpl;
+
+    while ((p = strchr(p, '%')) != nullptr)
+    {
+        const char *close = strchr(p + 1, '%');
+        size_t nameLen = close ? (size_t)(close - p - 1) : 0;
+        const TemplateVar *match = nullptr;
+
+        if (close && nameLen > 0 && nameLen <= TEMPLATE_MAX_NAME)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                if (strlen(vars[i].name) == nameLen && strncmp(vars[i].name, p + 1, nameLen) == 0)
+                {
+                    match = &vars[i];
+                    break;
+                }
+            }
+        }
+
+        if (match)
+        {
+            out.write((const uint8_t *)run, p - run);
+            out.print(match->value);
+            p = close + 1;
+            run = p;
+        }
+        else
+        {
+            p++; // Literal '%'
+        }
+    }
+
+    out.print(run);
+    return *this;
+}
@@ -0,0 +1,149 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * RESPONSE WRITER - STREAMING JSON / HTML OUTPUT
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file ResponseWriter.h
+ * @brief Write JSON and HTML straight into a Print sink
+ * @version 2.0.0
+ * @date 2024
+ *
+ * Building responses with repeated String += reallocates and copies the
+ * whole string on every append and fragments the heap. ResponseWriter
+ * writes each piece once, directly into its destination:
+ * - AsyncResponseStream (HTTP responses)
+ * - FixedBufferPrint (stack buffer, e.g. for WebSocket frames)
+ * - Serial or any other Print
+ *
+ * It tracks JSON nesting so commas are inserted automatically, escapes
+ * strings, and can expand %KEY% placeholders in an HTML template without
+ * touching other '%' characters (CSS percentages etc.).
+ *
+ * USAGE:
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @code
+ * #include "utils/ResponseWriter.h"
+ *
+ * // HTTP response
+ * AsyncResponseStream *response = request->beginResponseStream("application/json");
+ * ResponseWriter json(*response);
+ * json.beginObject();
+ * json.field("temperature", 25.5f, 1);
+ * json.beginArray("relays");
+ * json.value(true);
+ * json.value(false);
+ * json.endArray();
+ * json.endObject();
+ * request->send(response);
+ *
+ * // Fixed buffer (no heap)
+ * char buffer[256];
+ * FixedBufferPrint out(buffer, sizeof(buffer));
+ * ResponseWriter json(out);
+ * ...
+ * ws->textAll(out.c_str());
+ * @endcode
+ */
+
+#ifndef RESPONSE_WRITER_H
+#define RESPONSE_WRITER_H
+
+#include <Arduino.h>
+
+#define RESPONSE_WRITER_MAX_DEPTH 8
+
+/**
+ * @brief Print sink writing into a caller-owned buffer
+ *
+ * Output is always NUL-terminated. Writes past the end are dropped and
+ * flagged with overflowed().
+ */
+class FixedBufferPrint : public Print
+{
+private:
+    char *buffer;
+    size_t capacity;
+    size_t used;
+    bool overflow;
+
+public:
+    FixedBufferPrint(char *buf, size_t size);
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *data, size_t size) override;
+
+    const char *c_str() const { return buffer; }
+    size_t length() const { return used; }
+    bool overflowed() const { return overflow; }
+    void reset();
+};
+
+/**
+ * @brief Placeholder for ResponseWriter::writeTemplate()
+ */
+struct TemplateVar
+{
+    const char *name;  // Without the surrounding '%'
+    const char *value;
+};
+
+/**
+ * @brief Streaming JSON / HTML writer
+ */
+class ResponseWriter
+{
+private:
+    Print &out;
+    bool first[RESPONSE_WRITER_MAX_DEPTH];
+    uint8_t depth;
+    bool tooDeep;
+
+    void separator();
+    void key(const char *name);
+    void open(char bracket);
+    void close(char bracket);
+    void escaped(const char *text, bool html);
+
+public:
+    explicit ResponseWriter(Print &output);
+
+    // ─── JSON structure ───
+    ResponseWriter &beginObject(const char *name = nullptr);
+    ResponseWriter &endObject();
+    ResponseWriter &beginArray(const char *name = nullptr);
+    ResponseWriter &endArray();
+
+    // ─── JSON object members ───
+    ResponseWriter &field(const char *name, const char *text);
+    ResponseWriter &field(const char *name, const String &text);
+    ResponseWriter &field(const char *name, bool flag);
+    ResponseWriter &field(const char *name, int number);
+    ResponseWriter &field(const char *name, unsigned int number);
+    ResponseWriter &field(const char *name, long number);
+    ResponseWriter &field(const char *name, unsigned long number);
+    ResponseWriter &field(const char *name, double number, uint8_t decimals = 2);
+    ResponseWriter &fieldRaw(const char *name, const char *json);
+
+    // ─── JSON array elements ───
+    ResponseWriter &value(const char *text);
+    ResponseWriter &value(bool flag);
+    ResponseWriter &value(int number);
+    ResponseWriter &value(unsigned int number);
+    ResponseWriter &value(long number);
+    ResponseWriter &value(unsigned long number);
+    ResponseWriter &value(double number, uint8_t decimals = 2);
+
+    // ─── HTML / raw text ───
+    ResponseWriter &raw(const char *text);
+    ResponseWriter &raw(const char *text, size_t len);
+    ResponseWriter &html(const char *text);
+    ResponseWriter &writeTemplate(const char *tmpl, const TemplateVar *vars, size_t count);
+
+    Print &stream() { return out; }
+
+    // Nesting went past RESPONSE_WRITER_MAX_DEPTH; the output is invalid
+    bool overflowed() const { return tooDeep; }
+};
+
+#endif // RESPONSE_WRITER_H
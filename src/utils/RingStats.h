@@ -0,0 +1,195 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * RING STATS - SLIDING-WINDOW STATISTICS IN O(1) PER SAMPLE
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file RingStats.h
+ * @brief Last N samples with running sum, optional min/max and variance
+ * @version 2.0.0
+ * @date 2024
+ *
+ * A fixed ring of the last N samples. push() updates the statistics
+ * incrementally instead of re-scanning the window:
+ *
+ * - sum / mean: add the new sample, subtract the one it overwrites.
+ *   Integer samples are summed in int64_t, so the sum never drifts.
+ * - min / max (MinMax = true): monotonic deques of sample indices, the
+ *   front is the extreme of the window. Amortized O(1).
+ * - variance (Variance = true): Welford's update, extended to remove the
+ *   overwritten sample once the window is full. Float rounding would
+ *   slowly accumulate in a sliding window, so the sum of squares is
+ *   recomputed once every N samples (still O(1) amortized).
+ *
+ * Disabled features cost neither time nor memory. Capacity is a
+ * compile-time power of two and nothing is heap-allocated. The extremes
+ * are minimum()/maximum(), since some Arduino cores define min/max macros.
+ *
+ * No dependencies beyond the standard library: runs on a host build.
+ *
+ * USAGE:
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @code
+ * #include "utils/RingStats.h"
+ *
+ * RingStats<uint16_t, 16> window;               // Sum / mean only
+ * RingStats<float, 32, true, true> noise;       // Plus min, max, stddev
+ *
+ * window.push(analogValue);
+ * float level = window.mean();
+ *
+ * noise.push(x);
+ * float spread = noise.maximum() - noise.minimum();
+ * float sigma = noise.stddev();
+ * @endcode
+ */
+
+#ifndef RING_STATS_H
+#define RING_STATS_H
+
+#include <stdint.h>
+#include <math.h>
+#include <type_traits>
+
+template <typename T, uint16_t N, bool MinMax = false, bool Variance = false>
+class RingStats
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "RingStats capacity must be a power of two");
+
+public:
+    typedef typename std::conditional<std::is_integral<T>::value, int64_t, double>::type SumType;
+
+private:
+    static const uint16_t MASK = N - 1;
+    static const uint16_t DEQUE_SIZE = MinMax ? N : 1;
+    static const uint16_t DEQUE_MASK = DEQUE_SIZE - 1;
+
+    T samples[N];
+    uint32_t pushed; // Total samples; the newest is at (pushed - 1) & MASK
+    uint16_t count;  // Samples in the window
+    SumType total;
+
+    // Welford state
+    float runningMean;
+    float m2; // Sum of squared deviations from the mean
+
+    // Monotonic deques of sample numbers (rings, DEQUE_SIZE entries)
+    uint32_t minQueue[DEQUE_SIZE];
+    uint32_t maxQueue[DEQUE_SIZE];
+    uint32_t minHead, minTail;
+    uint32_t maxHead, maxTail;
+
+    void updateExtremes(T x)
+    {
+        // Drop the sample that just left the window
+        uint32_t oldest = pushed >= N ? pushed - N + 1 : 0;
+        if (minHead != minTail && minQueue[minHead & DEQUE_MASK] < oldest)
+            minHead++;
+        if (maxHead != maxTail && maxQueue[maxHead & DEQUE_MASK] < oldest)
+            maxHead++;
+
+        // Older samples that can no longer be the extreme
+        while (minHead != minTail && samples[minQueue[(minTail - 1) & DEQUE_MASK] & MASK] >= x)
+            minTail--;
+        while (maxHead != maxTail && samples[maxQueue[(maxTail - 1) & DEQUE_MASK] & MASK] <= x)
+            maxTail--;
+
+        minQueue[minTail++ & DEQUE_MASK] = pushed;
+        maxQueue[maxTail++ & DEQUE_MASK] = pushed;
+    }
+
+    void updateVariance(float x, float old, bool replacing)
+    {
+        // The mean comes from the exact sum, so it cannot drift
+        float previousMean = runningMean;
+        runningMean = mean();
+
+        if (!replacing)
+            m2 += (x - previousMean) * (x - runningMean);
+        else
+            m2 += (x - old) * (x - runningMean + old - previousMean);
+
+        // Rounding in m2 does accumulate: recompute it once per lap
+        if ((pushed & MASK) == MASK)
+        {
+            m2 = 0.0f;
+            for (uint16_t i = 0; i < count; i++)
+            {
+                float d = (float)samples[i] - runningMean;
+                m2 += d * d;
+            }
+        }
+        else if (m2 < 0.0f)
+        {
+            m2 = 0.0f;
+        }
+    }
+
+public:
+    RingStats() { clear(); }
+
+    void clear()
+    {
+        pushed = 0;
+        count = 0;
+        total = 0;
+        runningMean = 0.0f;
+        m2 = 0.0f;
+        minHead = minTail = maxHead = maxTail = 0;
+    }
+
+    void push(T x)
+    {
+        uint16_t slot = pushed & MASK;
+        bool replacing = count == N;
+        T old = replacing ? samples[slot] : T();
+
+        if (replacing)
+            total -= old;
+        else
+            count++;
+        total += x;
+        samples[slot] = x;
+
+        if (MinMax)
+            updateExtremes(x);
+        if (Variance)
+            updateVariance((float)x, (float)old, replacing);
+
+        pushed++;
+    }
+
+    uint16_t size() const { return count; }
+    bool full() const { return count == N; }
+    static uint16_t capacity() { return N; }
+
+    T newest() const { return samples[(pushed - 1) & MASK]; }
+    // i = 0 is the oldest sample in the window
+    T at(uint16_t i) const { return samples[(pushed - count + i) & MASK]; }
+
+    SumType sum() const { return total; }
+    float mean() const { return count ? (float)total / count : 0.0f; }
+
+    T minimum() const
+    {
+        static_assert(MinMax, "RingStats: enable MinMax to track the minimum");
+        return count ? samples[minQueue[minHead & DEQUE_MASK] & MASK] : T();
+    }
+
+    T maximum() const
+    {
+        static_assert(MinMax, "RingStats: enable MinMax to track the maximum");
+        return count ? samples[maxQueue[maxHead & DEQUE_MASK] & MASK] : T();
+    }
+
+    // Population variance of the window
+    float variance() const
+    {
+        static_assert(Variance, "RingStats: enable Variance to track the variance");
+        return count ? m2 / count : 0.0f;
+    }
+
+    float stddev() const { return sqrtf(variance()); }
+};
+
+#endif // RING_STATS_H
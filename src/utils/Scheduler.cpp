@@ -0,0 +1,471 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * SCHEDULER - IMPLEMENTATION
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file Scheduler.cpp
+ * @brief Implementation of the cooperative main loop scheduler
+ * @version 2.0.0
+ * @date 2024
+ */
+
+#include "Scheduler.h"
+#include "ResponseWriter.h"
+#include "LoopProfiler.h"
+
+// Global instance
+Scheduler scheduler;
+
+static uint32_t defaultClock()
+{
+    return millis();
+}
+
+Scheduler::Scheduler()
+{
+    taskCount = 0;
+    heapSize = 0;
+    clock = defaultClock;
+    loopTask = nullptr;
+    portMUX_INITIALIZE(&mux);
+    pendingEvents = 0;
+    pendingTriggers = false;
+    running = false;
+    heapDirty = false;
+    wakeups = 0;
+    notifiedWakeups = 0;
+    totalRuns = 0;
+    sleptMillis = 0;
+    statsStart = 0;
+}
+
+void Scheduler::begin()
+{
+    loopTask = xTaskGetCurrentTaskHandle();
+    statsStart = clock();
+    DEBUG_PRINTF("[SCHED] %d task(s) registered\n", taskCount);
+}
+
+void Scheduler::setClock(SchedulerClock source)
+{
+    clock = source ? source : defaultClock;
+    statsStart = clock();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DEADLINE HEAP
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Heap order: earlier deadline first, then higher priority
+ *
+ * Deadlines are compared as a signed difference so millis() wrap-around
+ * (every ~49 days) does not reorder the heap.
+ */
+bool Scheduler::earlier(uint8_t a, uint8_t b)
+{
+    int32_t diff = (int32_t)(tasks[a].deadline - tasks[b].deadline);
+    if (diff != 0)
+        return diff < 0;
+    return tasks[a].priority < tasks[b].priority;
+}
+
+void Scheduler::siftUp(uint8_t position)
+{
+    while (position > 0)
+    {
+        uint8_t parent = (position - 1) / 2;
+        if (!earlier(heap[position], heap[parent]))
+            break;
+        uint8_t swap = heap[parent];
+        heap[parent] = heap[position];
+        heap[position] = swap;
+        position = parent;
+    }
+}
+
+void Scheduler::siftDown(uint8_t position)
+{
+    while (true)
+    {
+        uint8_t smallest = position;
+        uint8_t left = 2 * position + 1;
+        uint8_t right = left + 1;
+
+        if (left < heapSize && earlier(heap[left], heap[smallest]))
+            smallest = left;
+        if (right < heapSize && earlier(heap[right], heap[smallest]))
+            smallest = right;
+        if (smallest == position)
+            break;
+
+        uint8_t swap = heap[smallest];
+        heap[smallest] = heap[position];
+        heap[position] = swap;
+        position = smallest;
+    }
+}
+
+/**
+ * @brief Re-order after a deadline changed outside the heap
+ *
+ * Deferred to the end of runDue() when called from inside a task, since
+ * the tasks being run are not in the heap at that point.
+ */
+void Scheduler::rebuildHeap()
+{
+    if (running)
+    {
+        heapDirty = true;
+        return;
+    }
+
+    heapSize = 0;
+    for (uint8_t i = 0; i < taskCount; i++)
+    {
+        if (tasks[i].enabled)
+        {
+            heap[heapSize] = i;
+            siftUp(heapSize++);
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TASK REGISTRATION
+// ═══════════════════════════════════════════════════════════════════════════
+
+int8_t Scheduler::addTask(const char *name, TaskFunction function, uint32_t interval,
+                          SchedulerPriority priority, uint8_t events)
+{
+    if (taskCount >= SCHEDULER_MAX_TASKS || function == nullptr)
+    {
+        DEBUG_PRINTF("[SCHED] Cannot add task '%s'\n", name);
+        return -1;
+    }
+
+    Task &task = tasks[taskCount];
+    memset(&task, 0, sizeof(task));
+    task.name = name;
+    task.function = function;
+    task.interval = interval;
+    task.deadline = clock() + interval;
+    task.priority = priority;
+    task.events = events;
+    task.enabled = true;
+#if ENABLE_LOOP_PROFILER
+    task.profileStage = loopProfiler.addStage(name);
+    task.profileTimer = loopProfiler.addTimer(name, interval);
+#endif
+
+    heap[heapSize] = taskCount;
+    siftUp(heapSize++);
+    return taskCount++;
+}
+
+void Scheduler::setInterval(int8_t task, uint32_t interval)
+{
+    if (task < 0 || task >= taskCount || tasks[task].interval == interval)
+        return;
+
+    tasks[task].interval = interval;
+    tasks[task].deadline = clock() + interval;
+    rebuildHeap();
+}
+
+uint32_t Scheduler::getInterval(int8_t task)
+{
+    return (task >= 0 && task < taskCount) ? tasks[task].interval : 0;
+}
+
+void Scheduler::setEnabled(int8_t task, bool enabled)
+{
+    if (task < 0 || task >= taskCount || tasks[task].enabled == enabled)
+        return;
+
+    tasks[task].enabled = enabled;
+    if (enabled)
+    {
+        tasks[task].deadline = clock() + tasks[task].interval;
+    }
+    rebuildHeap();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// WAKE-UPS FROM OTHER TASKS AND ISRS
+// ═══════════════════════════════════════════════════════════════════════════
+
+void Scheduler::wake()
+{
+    if (loopTask != nullptr)
+    {
+        xTaskNotifyGive(loopTask);
+    }
+}
+
+void Scheduler::trigger(int8_t task)
+{
+    if (task < 0 || task >= taskCount)
+        return;
+
+    portENTER_CRITICAL(&mux);
+    tasks[task].triggered = true;
+    pendingTriggers = true;
+    portEXIT_CRITICAL(&mux);
+    wake();
+}
+
+void Scheduler::post(uint8_t events)
+{
+    portENTER_CRITICAL(&mux);
+    pendingEvents |= events;
+    portEXIT_CRITICAL(&mux);
+    wake();
+}
+
+void IRAM_ATTR Scheduler::postFromISR(uint8_t events)
+{
+    BaseType_t higherPriorityWoken = pdFALSE;
+
+    portENTER_CRITICAL_ISR(&mux);
+    pendingEvents |= events;
+    portEXIT_CRITICAL_ISR(&mux);
+
+    if (loopTask != nullptr)
+    {
+        vTaskNotifyGiveFromISR(loopTask, &higherPriorityWoken);
+    }
+    if (higherPriorityWoken)
+    {
+        portYIELD_FROM_ISR();
+    }
+}
+
+/**
+ * @brief Mark every task subscribed to a posted event as triggered
+ */
+void Scheduler::applyEvents()
+{
+    portENTER_CRITICAL(&mux);
+    uint8_t events = pendingEvents;
+    pendingEvents = 0;
+    pendingTriggers = false;
+    if (events != 0)
+    {
+        for (uint8_t i = 0; i < taskCount; i++)
+        {
+            if (tasks[i].events & events)
+                tasks[i].triggered = true;
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// RUNNING TASKS
+// ═══════════════════════════════════════════════════════════════════════════
+
+void Scheduler::runTask(uint8_t index)
+{
+    Task &task = tasks[index];
+    task.triggered = false;
+
+#if ENABLE_LOOP_PROFILER
+    {
+        ScopedStageTimer timer(task.profileStage);
+        task.function();
+    }
+#else
+    task.function();
+#endif
+
+    task.runs++;
+    totalRuns++;
+}
+
+/**
+ * @brief Run every task whose deadline has passed or that was triggered
+ *
+ * Due tasks run highest priority first (earliest deadline within a
+ * priority). A periodic task is rescheduled one interval after its
+ * deadline, so it keeps its phase; if it fell more than an interval
+ * behind, missed runs are skipped instead of run back to back.
+ * Triggered tasks run once without moving their periodic deadline.
+ */
+uint8_t Scheduler::runDue()
+{
+    uint32_t now = clock();
+    if (pendingEvents || pendingTriggers)
+    {
+        applyEvents();
+    }
+
+    // Collect due tasks: [0, dueCount) came off the heap, the rest
+    // were only triggered
+    uint8_t due[SCHEDULER_MAX_TASKS];
+    uint8_t dueCount = 0;
+
+    while (heapSize > 0 && (int32_t)(now - tasks[heap[0]].deadline) >= 0)
+    {
+        due[dueCount++] = heap[0];
+        heap[0] = heap[--heapSize];
+        siftDown(0);
+    }
+    uint8_t periodicCount = dueCount;
+
+    for (uint8_t i = 0; i < taskCount; i++)
+    {
+        if (!tasks[i].triggered || !tasks[i].enabled)
+            continue;
+
+        bool alreadyDue = false;
+        for (uint8_t j = 0; j < periodicCount; j++)
+        {
+            if (due[j] == i)
+                alreadyDue = true;
+        }
+        if (!alreadyDue)
+            due[dueCount++] = i;
+    }
+
+    if (dueCount == 0)
+        return 0;
+
+    // Order by priority (insertion sort keeps deadline order within one)
+    for (uint8_t i = 1; i < dueCount; i++)
+    {
+        uint8_t index = due[i];
+        int8_t j = i - 1;
+        while (j >= 0 && tasks[due[j]].priority > tasks[index].priority)
+        {
+            due[j + 1] = due[j];
+            j--;
+        }
+        due[j + 1] = index;
+    }
+
+    running = true;
+    for (uint8_t i = 0; i < dueCount; i++)
+    {
+        uint8_t index = due[i];
+        Task &task = tasks[index];
+        bool periodic = (int32_t)(now - task.deadline) >= 0;
+
+        if (periodic)
+        {
+            uint32_t lateness = clock() - task.deadline;
+            if (lateness > task.maxLateness)
+                task.maxLateness = lateness;
+#if ENABLE_LOOP_PROFILER
+            loopProfiler.recordTimer(task.profileTimer, lateness);
+#endif
+        }
+
+        uint32_t scheduled = task.deadline;
+        runTask(index);
+
+        // setInterval() from inside the task already set a new deadline
+        if (periodic && task.enabled && task.deadline == scheduled)
+        {
+            task.deadline += task.interval;
+            uint32_t after = clock();
+            if ((int32_t)(after - task.deadline) >= 0)
+            {
+                task.deadline = after + task.interval;
+            }
+        }
+        if (periodic && task.enabled)
+        {
+            heap[heapSize] = index;
+            siftUp(heapSize++);
+        }
+    }
+    running = false;
+
+    if (heapDirty)
+    {
+        heapDirty = false;
+        rebuildHeap();
+    }
+    return dueCount;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SLEEPING
+// ═══════════════════════════════════════════════════════════════════════════
+
+uint32_t Scheduler::getSleepTime(uint32_t maxSleep)
+{
+    if (pendingEvents || pendingTriggers)
+        return 0;
+    if (heapSize == 0)
+        return maxSleep;
+
+    int32_t remaining = (int32_t)(tasks[heap[0]].deadline - clock());
+    if (remaining <= 0)
+        return 0;
+    return (uint32_t)remaining < maxSleep ? (uint32_t)remaining : maxSleep;
+}
+
+/**
+ * @brief Sleep until the next deadline or a post()/trigger()
+ *
+ * Blocks on the loop task's notification, so the CPU drops into the
+ * idle task (and light sleep, if power management is enabled) instead
+ * of spinning. A notification given before this call is not lost: the
+ * count survives and ulTaskNotifyTake returns at once.
+ */
+void Scheduler::idle(uint32_t maxSleep)
+{
+    uint32_t sleep = getSleepTime(maxSleep);
+    if (sleep == 0)
+        return;
+
+    uint32_t start = clock();
+    if (loopTask != nullptr)
+    {
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(sleep)) > 0)
+        {
+            notifiedWakeups++;
+        }
+    }
+    else
+    {
+        delay(sleep);
+    }
+    sleptMillis += clock() - start;
+    wakeups++;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// STATISTICS
+// ═══════════════════════════════════════════════════════════════════════════
+
+void Scheduler::writeStats(ResponseWriter &json)
+{
+    uint32_t elapsed = clock() - statsStart;
+
+    json.beginObject("scheduler");
+    json.field("wakeups", (unsigned long)wakeups);
+    json.field("notifiedWakeups", (unsigned long)notifiedWakeups);
+    json.field("runs", (unsigned long)totalRuns);
+    json.field("sleptMs", (unsigned long)sleptMillis);
+    // Share of wall time spent blocked in idle(); a proxy for power draw
+    json.field("idlePercent", elapsed ? sleptMillis * 100.0 / elapsed : 0.0, 1);
+
+    json.beginArray("tasks");
+    for (uint8_t i = 0; i < taskCount; i++)
+    {
+        const Task &task = tasks[i];
+        json.beginObject();
+        json.field("name", task.name);
+        json.field("interval", (unsigned long)task.interval);
+        json.field("priority", (int)task.priority);
+        json.field("enabled", task.enabled);
+        json.field("runs", (unsigned long)task.runs);
+        json.field("lateMax", (unsigned long)task.maxLateness);
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+}
@@ -0,0 +1,163 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * SCHEDULER - EVENT-DRIVEN COOPERATIVE TASKS
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file Scheduler.h
+ * @brief Deadline-ordered periodic tasks for the main loop
+ * @version 2.0.0
+ * @date 2024
+ *
+ * Instead of polling every Timer and then calling delay(10), tasks sit in a
+ * min-heap ordered by their next deadline. runDue() runs every task that is due,
+ * highest priority first, each to completion. idle() then sleeps until
+ * the next deadline. The loop therefore wakes only when there is work,
+ * and a task runs on time instead of up to 10 ms late.
+ *
+ * Other tasks and ISRs can wake the loop early:
+ * - post(events) / postFromISR(events): run every task subscribed to
+ *   one of the event bits (e.g. SCHED_EVENT_COMMAND) right away
+ * - trigger(task): run one task right away
+ *
+ * The clock is injectable (setClock) so scheduling decisions can be
+ * driven by a virtual clock.
+ *
+ * USAGE:
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @code
+ * #include "utils/Scheduler.h"
+ *
+ * void setup() {
+ *     scheduler.begin();
+ *     scheduler.addTask("sensors", readSensors, 2000);
+ *     scheduler.addTask("actuators", updateActuators, 20,
+ *                       SCHED_PRIORITY_HIGH, SCHED_EVENT_COMMAND);
+ * }
+ *
+ * void loop() {
+ *     scheduler.runDue();
+ *     scheduler.idle(SCHEDULER_MAX_SLEEP);
+ * }
+ *
+ * // From a WebSocket handler, ESP-NOW callback or ISR:
+ * scheduler.post(SCHED_EVENT_COMMAND);
+ * @endcode
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+class ResponseWriter;
+
+typedef void (*TaskFunction)();
+typedef uint32_t (*SchedulerClock)();
+
+enum SchedulerPriority : uint8_t
+{
+    SCHED_PRIORITY_HIGH = 0,
+    SCHED_PRIORITY_NORMAL,
+    SCHED_PRIORITY_LOW
+};
+
+// Event bits for post(); tasks subscribe with addTask(..., events)
+enum SchedulerEvent : uint8_t
+{
+    SCHED_EVENT_COMMAND = 0x01,   // WebSocket/REST/ESP-NOW command applied
+    SCHED_EVENT_ESPNOW_RX = 0x02, // ESP-NOW message received
+    SCHED_EVENT_MOTION = 0x04,    // PIR edge
+    SCHED_EVENT_SENSOR = 0x08     // Sensor poll requested
+};
+
+class Scheduler
+{
+private:
+    struct Task
+    {
+        const char *name;
+        TaskFunction function;
+        uint32_t interval;
+        uint32_t deadline;
+        uint8_t priority;
+        uint8_t events;
+        bool enabled;
+        volatile bool triggered;
+
+        // Statistics
+        uint32_t runs;
+        uint32_t maxLateness;
+#if ENABLE_LOOP_PROFILER
+        int8_t profileStage;
+        int8_t profileTimer;
+#endif
+    };
+
+    Task tasks[SCHEDULER_MAX_TASKS];
+    uint8_t taskCount;
+
+    // Min-heap of task indices by deadline
+    uint8_t heap[SCHEDULER_MAX_TASKS];
+    uint8_t heapSize;
+
+    SchedulerClock clock;
+    TaskHandle_t loopTask;
+    portMUX_TYPE mux;
+    volatile uint8_t pendingEvents;
+    volatile bool pendingTriggers;
+    bool running;
+    bool heapDirty;
+
+    // Statistics
+    uint32_t wakeups;
+    uint32_t notifiedWakeups;
+    uint32_t totalRuns;
+    uint32_t sleptMillis;
+    uint32_t statsStart;
+
+    bool earlier(uint8_t a, uint8_t b);
+    void siftUp(uint8_t position);
+    void siftDown(uint8_t position);
+    void rebuildHeap();
+    void wake();
+    void applyEvents();
+    void runTask(uint8_t index);
+
+public:
+    Scheduler();
+
+    // Call from setup(); the calling task is the one idle() puts to sleep
+    void begin();
+    void setClock(SchedulerClock source);
+
+    // Returns task id, or -1 if SCHEDULER_MAX_TASKS is exhausted
+    int8_t addTask(const char *name, TaskFunction function, uint32_t interval,
+                   SchedulerPriority priority = SCHED_PRIORITY_NORMAL, uint8_t events = 0);
+    void setInterval(int8_t task, uint32_t interval);
+    uint32_t getInterval(int8_t task);
+    void setEnabled(int8_t task, bool enabled);
+
+    // Run a task as soon as possible (any task context)
+    void trigger(int8_t task);
+    // Run all subscribers of these event bits as soon as possible
+    void post(uint8_t events);
+    void postFromISR(uint8_t events);
+
+    // Run everything due now; returns the number of tasks run
+    uint8_t runDue();
+    // Milliseconds until the next deadline (capped at maxSleep)
+    uint32_t getSleepTime(uint32_t maxSleep);
+    // Block until the next deadline, an event, or maxSleep
+    void idle(uint32_t maxSleep);
+
+    // Write "scheduler":{...} member
+    void writeStats(ResponseWriter &json);
+
+    uint8_t getTaskCount() { return taskCount; }
+};
+
+extern Scheduler scheduler;
+
+#endif // SCHEDULER_H
@@ -0,0 +1,120 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * SPSC QUEUE - LOCK-FREE SINGLE-PRODUCER / SINGLE-CONSUMER RING
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file SpscQueue.h
+ * @brief Fixed-capacity ring for handing data between two tasks
+ * @version 2.0.0
+ * @date 2024
+ *
+ * Exactly one task may push and exactly one task may pop. With that
+ * restriction no lock is needed: the producer only writes `head`, the
+ * consumer only writes `tail`, and acquire/release ordering makes the
+ * slot contents visible before the index that publishes them.
+ *
+ * push() never blocks; it returns false when the ring is full so the
+ * producer can count a drop and carry on. Pair it with a task
+ * notification if the consumer should sleep while the ring is empty.
+ * The producer may be an interrupt handler: push() is always inlined,
+ * so it ends up in the handler's IRAM (keep the ring itself in RAM).
+ *
+ * Only <atomic> is used, so the same code runs on a host build.
+ *
+ * USAGE:
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @code
+ * #include "utils/SpscQueue.h"
+ *
+ * SpscQueue<Reading, 8> queue;
+ *
+ * // Producer task
+ * if (!queue.push(reading)) dropped++;
+ *
+ * // Consumer task (no copy out of the ring)
+ * while (const Reading *r = queue.front()) {
+ *     handle(*r);
+ *     queue.pop();
+ * }
+ * @endcode
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, size_t N>
+class SpscQueue
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+private:
+    T slots[N];
+    std::atomic<uint32_t> head; // Next slot to write (producer)
+    std::atomic<uint32_t> tail; // Next slot to read (consumer)
+    uint32_t highWater;         // Most items ever queued (producer side)
+
+public:
+    SpscQueue() : head(0), tail(0), highWater(0) {}
+
+    // ─── Producer ───
+
+    __attribute__((always_inline)) bool push(const T &item)
+    {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t used = h - tail.load(std::memory_order_acquire);
+        if (used >= N)
+            return false;
+
+        slots[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+
+        if (used + 1 > highWater)
+            highWater = used + 1;
+        return true;
+    }
+
+    // ─── Consumer ───
+
+    // Oldest item, or nullptr when empty; valid until pop()
+    const T *front()
+    {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return nullptr;
+        return &slots[t & (N - 1)];
+    }
+
+    void pop()
+    {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t != head.load(std::memory_order_acquire))
+            tail.store(t + 1, std::memory_order_release);
+    }
+
+    bool pop(T &item)
+    {
+        const T *next = front();
+        if (next == nullptr)
+            return false;
+        item = *next;
+        pop();
+        return true;
+    }
+
+    // ─── Either side (approximate while the other side is running) ───
+
+    size_t size() const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return N; }
+    uint32_t getHighWater() const { return highWater; }
+};
+
+#endif // SPSC_QUEUE_H
@@ -13,15 +13,19 @@ class Timer
 private:
     uint32_t interval;
     uint32_t lastTime;
+    uint32_t lateness;
 
 public:
-    Timer(uint32_t intervalMs) : interval(intervalMs), lastTime(0) {}
+    Timer(uint32_t intervalMs) : interval(intervalMs), lastTime(0), lateness(0) {}
 
     bool isReady()
     {
         uint32_t currentTime = millis();
-        if (currentTime - lastTime >= interval)
+        uint32_t elapsed = currentTime - lastTime;
+        if (elapsed >= interval)
         {
+            // How far past the deadline we noticed (first run doesn't count)
+            lateness = lastTime == 0 ? 0 : elapsed - interval;
             lastTime = currentTime;
             return true;
         }
@@ -42,6 +46,17 @@ public:
     {
         return millis() - lastTime;
     }
+
+    uint32_t getInterval()
+    {
+        return interval;
+    }
+
+    // Milliseconds the last isReady() == true came after the deadline
+    uint32_t getLateness()
+    {
+        return lateness;
+    }
 };
 
 #endif
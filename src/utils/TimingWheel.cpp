@@ -0,0 +1,335 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * TIMING WHEEL - IMPLEMENTATION
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file TimingWheel.cpp
+ * @brief Implementation of the hierarchical timing wheel
+ * @version 2.0.0
+ * @date 2024
+ */
+
+#include "TimingWheel.h"
+
+// Global instance
+TimingWheel timingWheel;
+
+#define SLOT_MASK (TIMING_WHEEL_SLOTS - 1)
+#define LEVEL_SHIFT(level) ((level) * TIMING_WHEEL_SLOT_BITS)
+#define MAX_TICKS ((uint32_t)1 << LEVEL_SHIFT(TIMING_WHEEL_LEVELS))
+
+TimingWheel::TimingWheel()
+{
+    for (uint16_t i = 0; i < TIMING_WHEEL_LEVELS * TIMING_WHEEL_SLOTS; i++)
+    {
+        slots[i] = NIL;
+    }
+
+    // Chain every node into the free list
+    for (uint16_t i = 0; i < TIMING_WHEEL_MAX_TIMERS; i++)
+    {
+        nodes[i].callback = nullptr;
+        nodes[i].context = nullptr;
+        nodes[i].generation = 0;
+        nodes[i].list = FREE;
+        nodes[i].next = (i + 1 < TIMING_WHEEL_MAX_TIMERS) ? i + 1 : NIL;
+        nodes[i].prev = NIL;
+    }
+    freeList = 0;
+
+    currentTick = 0;
+    lastMillis = 0;
+    nextWake = 0;
+    started = false;
+    wakeHook = nullptr;
+    portMUX_INITIALIZE(&mux);
+    pending = 0;
+    maxPending = 0;
+    fired = 0;
+    poolExhausted = 0;
+}
+
+void TimingWheel::begin(uint32_t now)
+{
+    portENTER_CRITICAL(&mux);
+    if (!started)
+    {
+        lastMillis = now + TIMING_WHEEL_TICK_MS;
+        nextWake = currentTick;
+        started = true;
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+TimerId TimingWheel::makeId(uint16_t index, uint16_t generation)
+{
+    return ((uint32_t)generation << 16) | (uint32_t)(index + 1);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SLOT LISTS (caller holds mux)
+// ═══════════════════════════════════════════════════════════════════════════
+
+void TimingWheel::link(uint16_t index, uint16_t list)
+{
+    Node &node = nodes[index];
+    node.list = list;
+    node.prev = NIL;
+    node.next = slots[list];
+    if (node.next != NIL)
+        nodes[node.next].prev = index;
+    slots[list] = index;
+}
+
+void TimingWheel::unlink(uint16_t index)
+{
+    Node &node = nodes[index];
+    if (node.prev != NIL)
+        nodes[node.prev].next = node.next;
+    else
+        slots[node.list] = node.next;
+    if (node.next != NIL)
+        nodes[node.next].prev = node.prev;
+    node.next = node.prev = NIL;
+}
+
+/**
+ * @brief Put a node on the slot matching its distance from currentTick
+ */
+void TimingWheel::insert(uint16_t index)
+{
+    Node &node = nodes[index];
+    int32_t delta = (int32_t)(node.expires - currentTick);
+
+    if (delta < 0)
+    {
+        // Already due: run on the tick being processed
+        node.expires = currentTick;
+        delta = 0;
+    }
+    else if ((uint32_t)delta >= MAX_TICKS)
+    {
+        // Beyond the top level: park in the top-level slot cascaded last.
+        // expires stays as is, so the cascade parks it again until it
+        // comes within range.
+        uint32_t parked = currentTick + MAX_TICKS - 1;
+        uint8_t top = TIMING_WHEEL_LEVELS - 1;
+        link(index, top * TIMING_WHEEL_SLOTS + ((parked >> LEVEL_SHIFT(top)) & SLOT_MASK));
+        return;
+    }
+
+    uint8_t level = 0;
+    while (level < TIMING_WHEEL_LEVELS - 1 &&
+           (uint32_t)delta >= ((uint32_t)1 << LEVEL_SHIFT(level + 1)))
+    {
+        level++;
+    }
+
+    uint16_t slot = (node.expires >> LEVEL_SHIFT(level)) & SLOT_MASK;
+    link(index, level * TIMING_WHEEL_SLOTS + slot);
+}
+
+/**
+ * @brief Move the current slot of a level down to finer levels
+ */
+void TimingWheel::cascade(uint8_t level)
+{
+    uint16_t list = level * TIMING_WHEEL_SLOTS + ((currentTick >> LEVEL_SHIFT(level)) & SLOT_MASK);
+    uint16_t index = slots[list];
+    slots[list] = NIL;
+
+    while (index != NIL)
+    {
+        uint16_t next = nodes[index].next;
+        nodes[index].next = nodes[index].prev = NIL;
+        insert(index);
+        index = next;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SCHEDULE / CANCEL
+// ═══════════════════════════════════════════════════════════════════════════
+
+TimerId TimingWheel::schedule(uint32_t delayMs, WheelCallback callback, void *context)
+{
+    if (callback == nullptr)
+        return 0;
+
+    uint32_t now = millis();
+    begin(now);
+
+    bool wake = false;
+    TimerId id = 0;
+
+    portENTER_CRITICAL(&mux);
+    if (freeList == NIL)
+    {
+        poolExhausted++;
+    }
+    else
+    {
+        uint16_t index = freeList;
+        Node &node = nodes[index];
+        freeList = node.next;
+
+        // First tick at or after now + delayMs (tick currentTick is at lastMillis).
+        // 64-bit so any delayMs works, not only those below 2^31.
+        int64_t ahead = (int64_t)delayMs + (int32_t)(now - lastMillis);
+        uint32_t ticks = ahead <= 0 ? 0 : (uint32_t)((ahead + TIMING_WHEEL_TICK_MS - 1) / TIMING_WHEEL_TICK_MS);
+
+        node.callback = callback;
+        node.context = context;
+        node.expires = currentTick + ticks;
+        node.generation++;
+        node.next = node.prev = NIL;
+        insert(index);
+
+        if (++pending > maxPending)
+            maxPending = pending;
+
+        if ((int32_t)(node.expires - nextWake) < 0)
+        {
+            nextWake = node.expires;
+            wake = true;
+        }
+        id = makeId(index, node.generation);
+    }
+    portEXIT_CRITICAL(&mux);
+
+    if (id == 0)
+    {
+        DEBUG_PRINTLN("[WHEEL] Timer pool exhausted");
+    }
+    if (wake && wakeHook)
+    {
+        wakeHook();
+    }
+    return id;
+}
+
+bool TimingWheel::cancel(TimerId id)
+{
+    uint16_t index = (uint16_t)(id & 0xFFFF) - 1;
+    if (id == 0 || index >= TIMING_WHEEL_MAX_TIMERS)
+        return false;
+
+    bool cancelled = false;
+    portENTER_CRITICAL(&mux);
+    Node &node = nodes[index];
+    if (node.list != FREE && node.generation == (uint16_t)(id >> 16))
+    {
+        unlink(index);
+        node.list = FREE;
+        node.next = freeList;
+        freeList = index;
+        pending--;
+        cancelled = true;
+    }
+    portEXIT_CRITICAL(&mux);
+    return cancelled;
+}
+
+bool TimingWheel::isPending(TimerId id)
+{
+    uint16_t index = (uint16_t)(id & 0xFFFF) - 1;
+    if (id == 0 || index >= TIMING_WHEEL_MAX_TIMERS)
+        return false;
+
+    return nodes[index].list != FREE && nodes[index].generation == (uint16_t)(id >> 16);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TICK PROCESSING
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Process every tick whose time has come
+ *
+ * Each tick costs one slot check, plus a cascade every 64 ticks; the
+ * number of pending timers does not matter. Callbacks run one at a time
+ * with the lock released.
+ */
+uint16_t TimingWheel::advance(uint32_t now)
+{
+    begin(now);
+    uint16_t ran = 0;
+
+    portENTER_CRITICAL(&mux);
+    while ((int32_t)(now - lastMillis) >= 0)
+    {
+        // Level 0 wrapped: pull the next slot of each coarser level down
+        for (uint8_t level = 1; level < TIMING_WHEEL_LEVELS; level++)
+        {
+            if (((currentTick >> LEVEL_SHIFT(level - 1)) & SLOT_MASK) != 0)
+                break;
+            cascade(level);
+        }
+
+        uint16_t list = currentTick & SLOT_MASK;
+        while (slots[list] != NIL)
+        {
+            uint16_t index = slots[list];
+            Node &node = nodes[index];
+            WheelCallback callback = node.callback;
+            void *context = node.context;
+
+            unlink(index);
+            node.list = FREE;
+            node.next = freeList;
+            freeList = index;
+            pending--;
+            fired++;
+
+            portEXIT_CRITICAL(&mux);
+            callback(context);
+            ran++;
+            portENTER_CRITICAL(&mux);
+        }
+
+        currentTick++;
+        lastMillis += TIMING_WHEEL_TICK_MS;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    return ran;
+}
+
+/**
+ * @brief Time until the next non-empty tick or cascade
+ *
+ * Also records that tick as the planned wake-up, so schedule() can call
+ * the wake hook when a new timer needs an earlier one.
+ */
+uint32_t TimingWheel::getSleepTime(uint32_t now, uint32_t maxSleep)
+{
+    begin(now);
+    uint32_t ticks = 0;
+
+    portENTER_CRITICAL(&mux);
+    for (ticks = 0; ticks < TIMING_WHEEL_SLOTS; ticks++)
+    {
+        uint32_t tick = currentTick + ticks;
+        if (slots[tick & SLOT_MASK] != NIL)
+            break;
+        // Cascade point (only matters if coarser levels hold timers)
+        if ((tick & SLOT_MASK) == 0 && pending > 0)
+            break;
+    }
+    if (pending == 0)
+        ticks = UINT16_MAX;
+
+    int32_t sleep = (int32_t)(lastMillis + ticks * TIMING_WHEEL_TICK_MS - now);
+    if (sleep < 0)
+        sleep = 0;
+    if ((uint32_t)sleep > maxSleep)
+    {
+        sleep = maxSleep;
+        int32_t ahead = (int32_t)(now + maxSleep - lastMillis);
+        ticks = ahead > 0 ? (uint32_t)ahead / TIMING_WHEEL_TICK_MS : 0;
+    }
+    nextWake = currentTick + ticks;
+    portEXIT_CRITICAL(&mux);
+
+    return (uint32_t)sleep;
+}
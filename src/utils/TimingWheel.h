@@ -0,0 +1,139 @@
+/**
+ * ═══════════════════════════════════════════════════════════════════════════
+ * TIMING WHEEL - SHARED ONE-SHOT TIMER SERVICE
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @file TimingWheel.h
+ * @brief Hierarchical hashed timing wheel with O(1) schedule and cancel
+ * @version 2.0.0
+ * @date 2024
+ *
+ * Components register a deadline and a callback instead of comparing
+ * millis() on every loop pass. Pending timers cost nothing until they
+ * expire, so the per-tick cost does not grow with the number of timers.
+ *
+ * LAYOUT:
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * Four levels of 64 slots. A timer goes into the level whose range
+ * covers its delay:
+ *
+ *   level 0: 1 tick per slot        (0 .. 64 ticks)
+ *   level 1: 64 ticks per slot      (.. 4096 ticks)
+ *   level 2: 4096 ticks per slot    (.. 262144 ticks)
+ *   level 3: 262144 ticks per slot  (.. 2^24 ticks, ~46 h at 10 ms)
+ *
+ * Each time level 0 wraps, the next slot of level 1 is cascaded
+ * (re-inserted) into level 0, and so on up. Longer delays (any uint32_t
+ * of milliseconds) wait in the top level and are re-parked there by each
+ * cascade until they come within range; they still fire on time. Timers live in a fixed pool
+ * of TIMING_WHEEL_MAX_TIMERS nodes linked by index; no heap allocation.
+ *
+ * Timer ids carry a generation, so cancelling an id whose timer already
+ * fired (and whose node was reused) is a harmless no-op.
+ *
+ * USAGE:
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * @code
+ * #include "utils/TimingWheel.h"
+ *
+ * static void onToneEnd(void *context) {
+ *     static_cast<BuzzerController *>(context)->stopTone();
+ * }
+ *
+ * toneTimer = timingWheel.schedule(500, onToneEnd, this);
+ * timingWheel.cancel(toneTimer);   // Safe even if it already fired
+ *
+ * // Main loop / scheduler task:
+ * timingWheel.advance(millis());
+ * @endcode
+ *
+ * schedule() and cancel() may be called from any task. Callbacks run in
+ * the task that calls advance(), outside the wheel's lock, so they may
+ * schedule or cancel timers themselves.
+ */
+
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+#define TIMING_WHEEL_LEVELS 4
+#define TIMING_WHEEL_SLOT_BITS 6
+#define TIMING_WHEEL_SLOTS (1 << TIMING_WHEEL_SLOT_BITS)
+
+typedef uint32_t TimerId; // 0 = no timer
+typedef void (*WheelCallback)(void *context);
+typedef void (*WheelWakeHook)();
+
+class TimingWheel
+{
+private:
+    static const uint16_t NIL = 0xFFFF;
+    static const uint16_t FREE = 0xFFFF; // Node.list value when unused
+
+    struct Node
+    {
+        WheelCallback callback;
+        void *context;
+        uint32_t expires; // Absolute tick
+        uint16_t generation;
+        uint16_t list; // Slot list this node is on, or FREE
+        uint16_t next;
+        uint16_t prev;
+    };
+
+    Node nodes[TIMING_WHEEL_MAX_TIMERS];
+    uint16_t slots[TIMING_WHEEL_LEVELS * TIMING_WHEEL_SLOTS];
+    uint16_t freeList;
+
+    uint32_t currentTick; // Next tick to process
+    uint32_t lastMillis;  // Time of the last processed tick boundary
+    uint32_t nextWake;    // Tick the owner plans to call advance() at
+    bool started;
+
+    WheelWakeHook wakeHook;
+    portMUX_TYPE mux;
+
+    // Statistics
+    uint16_t pending;
+    uint16_t maxPending;
+    uint32_t fired;
+    uint32_t poolExhausted;
+
+    void link(uint16_t index, uint16_t list);
+    void unlink(uint16_t index);
+    void insert(uint16_t index);
+    void cascade(uint8_t level);
+    static TimerId makeId(uint16_t index, uint16_t generation);
+
+public:
+    TimingWheel();
+
+    // Start counting from now (advance() starts it on first call too)
+    void begin(uint32_t now);
+    // Called when a new timer expires before the owner's planned wake-up
+    void setWakeHook(WheelWakeHook hook) { wakeHook = hook; }
+
+    // Run callback once after delayMs; returns 0 if the pool is full
+    TimerId schedule(uint32_t delayMs, WheelCallback callback, void *context = nullptr);
+    // Returns true if the timer was still pending
+    bool cancel(TimerId id);
+    bool isPending(TimerId id);
+
+    // Process all ticks up to now; returns the number of callbacks run
+    uint16_t advance(uint32_t now);
+    // Milliseconds until advance() next has work (capped at maxSleep)
+    uint32_t getSleepTime(uint32_t now, uint32_t maxSleep);
+
+    uint16_t getPending() { return pending; }
+    uint16_t getMaxPending() { return maxPending; }
+    uint32_t getFired() { return fired; }
+    uint32_t getPoolExhausted() { return poolExhausted; }
+};
+
+extern TimingWheel timingWheel;
+
+#endif // TIMING_WHEEL_H
@@ -0,0 +1,187 @@
+/**
+ * @file Arduino.h
+ * @brief Minimal Arduino core for the native (host) test build
+ *
+ * Only what the hardware-free modules under test use. Time comes from a
+ * virtual clock that tests advance explicitly; delay() advances it too
+ * and is counted, so a test can assert that nothing blocks. Tests that
+ * run real threads (freertos/task.h) switch to wall-clock time with
+ * host::useRealTime().
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include "esp_attr.h"
+#include "WString.h"
+#include "Print.h"
+
+using std::max;
+using std::min;
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define CHANGE 0x03
+#define RISING 0x01
+#define FALLING 0x02
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+namespace host
+{
+inline std::atomic<uint64_t> clockUs{0};
+inline std::atomic<bool> realTime{false};
+inline std::atomic<uint32_t> delayCalls{0};
+inline std::atomic<uint32_t> delayedMs{0};
+inline int pinLevel[64] = {};
+
+inline void advanceMicros(uint64_t us) { clockUs += us; }
+inline void advanceMillis(uint32_t ms) { clockUs += (uint64_t)ms * 1000; }
+inline void resetClock(uint64_t us = 0)
+{
+    realTime = false;
+    clockUs = us;
+    delayCalls = 0;
+    delayedMs = 0;
+}
+inline void useRealTime() { realTime = true; }
+
+// attachInterruptArg() handlers, so a test can raise an edge
+inline void (*interruptHandler[64])(void *) = {};
+inline void *interruptArg[64] = {};
+inline void setPin(uint8_t pin, int level)
+{
+    pinLevel[pin & 63] = level;
+    if (interruptHandler[pin & 63])
+        interruptHandler[pin & 63](interruptArg[pin & 63]);
+}
+
+inline uint64_t nowUs()
+{
+    if (!realTime)
+        return clockUs;
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+} // namespace host
+
+// 32 bits, as on the ESP32, so elapsed-time arithmetic wraps the same way
+inline uint32_t millis() { return (uint32_t)(host::nowUs() / 1000); }
+inline uint32_t micros() { return (uint32_t)host::nowUs(); }
+inline void delay(uint32_t ms)
+{
+    host::delayCalls++;
+    host::delayedMs += ms;
+    if (host::realTime)
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    else
+        host::advanceMillis(ms);
+}
+inline void delayMicroseconds(uint32_t us) { host::advanceMicros(us); }
+inline void yield() {}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t pin, uint8_t level) { host::pinLevel[pin & 63] = level; }
+inline int digitalRead(uint8_t pin) { return host::pinLevel[pin & 63]; }
+inline int analogRead(uint8_t pin) { return host::pinLevel[pin & 63]; }
+inline void analogWrite(uint8_t pin, int value) { host::pinLevel[pin & 63] = value; }
+inline void attachInterruptArg(uint8_t pin, void (*handler)(void *), void *arg, int)
+{
+    host::interruptHandler[pin & 63] = handler;
+    host::interruptArg[pin & 63] = arg;
+}
+inline void detachInterrupt(uint8_t pin) { host::interruptHandler[pin & 63] = nullptr; }
+
+// LEDC/tone: the pin just records the last duty or frequency
+inline void ledcSetup(uint8_t, double, uint8_t) {}
+inline void ledcAttachPin(uint8_t, uint8_t) {}
+inline void tone(uint8_t pin, unsigned int frequency, unsigned long = 0) { host::pinLevel[pin & 63] = frequency; }
+inline void noTone(uint8_t pin) { host::pinLevel[pin & 63] = 0; }
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+inline long random(long howBig) { return howBig <= 0 ? 0 : rand() % howBig; }
+inline long random(long howSmall, long howBig)
+{
+    return howSmall >= howBig ? howSmall : howSmall + random(howBig - howSmall);
+}
+
+// ─── FreeRTOS (the Arduino core pulls it in through Arduino.h) ─────────────
+
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define portMAX_DELAY 0xFFFFFFFFu
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+// Spinlocks: a mutex, so host threads get the same exclusion
+typedef std::recursive_mutex portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {}
+#define portMUX_INITIALIZE(mux) ((void)(mux))
+#define portENTER_CRITICAL(mux) (mux)->lock()
+#define portEXIT_CRITICAL(mux) (mux)->unlock()
+#define portENTER_CRITICAL_ISR(mux) (mux)->lock()
+#define portEXIT_CRITICAL_ISR(mux) (mux)->unlock()
+
+// Recursive underneath, so one handle type serves both kinds of mutex
+typedef std::recursive_timed_mutex *SemaphoreHandle_t;
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return new std::recursive_timed_mutex(); }
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return new std::recursive_timed_mutex(); }
+inline void vSemaphoreDelete(SemaphoreHandle_t sem) { delete sem; }
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY)
+    {
+        sem->lock();
+        return pdTRUE;
+    }
+    return sem->try_lock_for(std::chrono::milliseconds(ticks)) ? pdTRUE : pdFALSE;
+}
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    sem->unlock();
+    return pdTRUE;
+}
+#define xSemaphoreTakeRecursive xSemaphoreTake
+#define xSemaphoreGiveRecursive xSemaphoreGive
+
+#include "freertos/task.h"
+
+class HardwareSerial : public Print
+{
+public:
+    void begin(unsigned long) {}
+    int available() { return 0; }
+    int read() { return -1; }
+    size_t write(uint8_t c) override { return fwrite(&c, 1, 1, stdout); }
+    size_t write(const uint8_t *data, size_t size) override { return fwrite(data, 1, size, stdout); }
+    using Print::write;
+};
+
+inline HardwareSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,37 @@
+/**
+ * @file ESP32Servo.h
+ * @brief Host stand-in for the ESP32Servo library (native tests only)
+ *
+ * A servo just remembers the last angle written to it.
+ */
+
+#ifndef HOST_ESP32SERVO_H
+#define HOST_ESP32SERVO_H
+
+#include <Arduino.h>
+
+struct ESP32PWM
+{
+    static void allocateTimer(int) {}
+};
+
+class Servo
+{
+private:
+    int angle = 0;
+    bool attached_ = false;
+
+public:
+    void setPeriodHertz(int) {}
+    int attach(int, int = 544, int = 2400)
+    {
+        attached_ = true;
+        return 1;
+    }
+    void detach() { attached_ = false; }
+    bool attached() const { return attached_; }
+    void write(int value) { angle = value; }
+    int read() const { return angle; }
+};
+
+#endif // HOST_ESP32SERVO_H
@@ -0,0 +1,49 @@
+/**
+ * @file ESPAsyncWebServer.h
+ * @brief Host stand-in for the bits of AsyncWebServerRequest under test
+ *
+ * Records the last response instead of sending it, and frees
+ * _tempObject on destruction like the real request does. The method
+ * constants match the library's bit values.
+ */
+
+#ifndef HOST_ESP_ASYNC_WEB_SERVER_H
+#define HOST_ESP_ASYNC_WEB_SERVER_H
+
+#include "Arduino.h"
+
+typedef enum
+{
+    HTTP_GET = 0b00000001,
+    HTTP_POST = 0b00000010,
+    HTTP_DELETE = 0b00000100,
+    HTTP_PUT = 0b00001000,
+    HTTP_PATCH = 0b00010000,
+    HTTP_HEAD = 0b00100000,
+    HTTP_OPTIONS = 0b01000000,
+    HTTP_ANY = 0b01111111,
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncWebServerRequest
+{
+public:
+    void *_tempObject = nullptr;
+
+    int sentCode = 0;
+    String sentType;
+    String sentBody;
+    uint32_t responses = 0;
+
+    ~AsyncWebServerRequest() { free(_tempObject); }
+
+    void send(int code, const char *contentType = "", const char *content = "")
+    {
+        sentCode = code;
+        sentType = contentType;
+        sentBody = content;
+        responses++;
+    }
+};
+
+#endif // HOST_ESP_ASYNC_WEB_SERVER_H
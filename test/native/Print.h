@@ -0,0 +1,70 @@
+/**
+ * @file Print.h
+ * @brief Host stand-in for the Arduino Print class (native tests only)
+ */
+
+#ifndef HOST_PRINT_H
+#define HOST_PRINT_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "WString.h"
+
+class Print;
+
+class Printable
+{
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print &p) const = 0;
+};
+
+class Print
+{
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *data, size_t size)
+    {
+        size_t n = 0;
+        while (size--)
+            n += write(*data++);
+        return n;
+    }
+    size_t write(const char *text) { return text ? write((const uint8_t *)text, strlen(text)) : 0; }
+    size_t write(const char *text, size_t size) { return write((const uint8_t *)text, size); }
+
+    size_t print(const char *text) { return write(text); }
+    size_t print(const String &text) { return write(text.c_str(), text.length()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value) { return printf("%d", value); }
+    size_t print(unsigned int value) { return printf("%u", value); }
+    size_t print(long value) { return printf("%ld", value); }
+    size_t print(unsigned long value) { return printf("%lu", value); }
+    size_t print(long long value) { return printf("%lld", value); }
+    size_t print(unsigned long long value) { return printf("%llu", value); }
+    size_t print(double value, int decimals = 2) { return printf("%.*f", decimals, value); }
+    size_t print(const Printable &value) { return value.printTo(*this); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T &value) { return print(value) + println(); }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        char text[256];
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(text, sizeof(text), format, args);
+        va_end(args);
+        if (n < 0)
+            return 0;
+        return write((const uint8_t *)text, (size_t)n < sizeof(text) ? n : sizeof(text) - 1);
+    }
+};
+
+#endif // HOST_PRINT_H
@@ -0,0 +1,208 @@
+/**
+ * @file WString.h
+ * @brief Host stand-in for the Arduino String class (native tests only)
+ *
+ * Follows the Arduino core's growth policy: every concat reallocates the
+ * buffer to the exact new length, and operator+ builds a temporary
+ * StringSumHelper. The host::string* counters record the allocations
+ * and bytes copied, so benchmarks can compare String building with
+ * streaming writers.
+ */
+
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace host
+{
+inline uint32_t stringAllocs = 0;
+inline uint32_t stringBytesCopied = 0;
+
+inline void resetStringStats()
+{
+    stringAllocs = 0;
+    stringBytesCopied = 0;
+}
+} // namespace host
+
+class String
+{
+protected:
+    char *buffer;
+    unsigned int capacity;
+    unsigned int len;
+
+    bool changeBuffer(unsigned int maxLen)
+    {
+        char *grown = (char *)realloc(buffer, maxLen + 1);
+        if (grown == nullptr)
+            return false;
+        host::stringAllocs++;
+        host::stringBytesCopied += buffer ? len : 0; // realloc may move the old body
+        buffer = grown;
+        capacity = maxLen;
+        return true;
+    }
+
+    String &copy(const char *text, unsigned int length)
+    {
+        if (!reserve(length))
+            return *this;
+        len = length;
+        memcpy(buffer, text, length);
+        buffer[len] = '\0';
+        host::stringBytesCopied += length;
+        return *this;
+    }
+
+public:
+    String(const char *text = "") : buffer(nullptr), capacity(0), len(0)
+    {
+        if (text)
+            copy(text, strlen(text));
+    }
+    String(const String &other) : buffer(nullptr), capacity(0), len(0) { copy(other.c_str(), other.len); }
+    String(String &&other) : buffer(other.buffer), capacity(other.capacity), len(other.len)
+    {
+        other.buffer = nullptr;
+        other.capacity = other.len = 0;
+    }
+    explicit String(char c) : buffer(nullptr), capacity(0), len(0)
+    {
+        char text[2] = {c, '\0'};
+        copy(text, 1);
+    }
+    explicit String(int value) : String((long)value) {}
+    explicit String(unsigned int value) : String((unsigned long)value) {}
+    explicit String(long value) : buffer(nullptr), capacity(0), len(0)
+    {
+        char text[24];
+        copy(text, snprintf(text, sizeof(text), "%ld", value));
+    }
+    explicit String(unsigned long value) : buffer(nullptr), capacity(0), len(0)
+    {
+        char text[24];
+        copy(text, snprintf(text, sizeof(text), "%lu", value));
+    }
+    explicit String(double value, unsigned int decimals = 2) : buffer(nullptr), capacity(0), len(0)
+    {
+        char text[40];
+        copy(text, snprintf(text, sizeof(text), "%.*f", decimals, value));
+    }
+    ~String() { free(buffer); }
+
+    String &operator=(const String &other)
+    {
+        if (this != &other)
+            copy(other.c_str(), other.len);
+        return *this;
+    }
+    String &operator=(const char *text) { return copy(text ? text : "", text ? strlen(text) : 0); }
+
+    bool reserve(unsigned int size)
+    {
+        if (buffer && capacity >= size)
+            return true;
+        return changeBuffer(size);
+    }
+
+    bool concat(const char *text, unsigned int length)
+    {
+        if (length == 0)
+            return true;
+        if (!reserve(len + length))
+            return false;
+        memcpy(buffer + len, text, length);
+        len += length;
+        buffer[len] = '\0';
+        host::stringBytesCopied += length;
+        return true;
+    }
+    bool concat(const char *text) { return concat(text, strlen(text)); }
+    bool concat(const String &other) { return concat(other.c_str(), other.len); }
+    bool concat(char c) { return concat(&c, 1); }
+
+    String &operator+=(const String &other) { concat(other); return *this; }
+    String &operator+=(const char *text) { concat(text); return *this; }
+    String &operator+=(char c) { concat(c); return *this; }
+    String &operator+=(int value) { concat(String(value)); return *this; }
+    String &operator+=(unsigned int value) { concat(String(value)); return *this; }
+    String &operator+=(long value) { concat(String(value)); return *this; }
+    String &operator+=(unsigned long value) { concat(String(value)); return *this; }
+
+    const char *c_str() const { return buffer ? buffer : ""; }
+    unsigned int length() const { return len; }
+    char operator[](unsigned int index) const { return index < len ? buffer[index] : '\0'; }
+
+    bool equals(const char *text) const { return strcmp(c_str(), text) == 0; }
+    bool operator==(const char *text) const { return equals(text); }
+    bool operator==(const String &other) const { return equals(other.c_str()); }
+    bool operator!=(const char *text) const { return !equals(text); }
+
+    bool startsWith(const char *prefix) const { return strncmp(c_str(), prefix, strlen(prefix)) == 0; }
+    bool endsWith(const char *suffix) const
+    {
+        size_t n = strlen(suffix);
+        return n <= len && strcmp(c_str() + len - n, suffix) == 0;
+    }
+    int indexOf(const char *needle) const
+    {
+        const char *found = strstr(c_str(), needle);
+        return found ? (int)(found - c_str()) : -1;
+    }
+    int indexOf(char c) const
+    {
+        const char *found = strchr(c_str(), c);
+        return found ? (int)(found - c_str()) : -1;
+    }
+    String substring(unsigned int from, unsigned int to = (unsigned int)-1) const
+    {
+        if (to > len)
+            to = len;
+        if (from > to)
+            from = to;
+        String part;
+        part.copy(c_str() + from, to - from);
+        return part;
+    }
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return (float)atof(c_str()); }
+};
+
+/**
+ * @brief Temporary of operator+, concatenated in place like the Arduino core
+ */
+class StringSumHelper : public String
+{
+public:
+    StringSumHelper(const String &s) : String(s) {}
+    StringSumHelper(const char *p) : String(p) {}
+    explicit StringSumHelper(long value) : String(value) {}
+};
+
+inline StringSumHelper &operator+(const StringSumHelper &lhs, const String &rhs)
+{
+    StringSumHelper &sum = const_cast<StringSumHelper &>(lhs);
+    sum.concat(rhs);
+    return sum;
+}
+
+inline StringSumHelper &operator+(const StringSumHelper &lhs, const char *rhs)
+{
+    StringSumHelper &sum = const_cast<StringSumHelper &>(lhs);
+    sum.concat(rhs);
+    return sum;
+}
+
+inline StringSumHelper &operator+(const StringSumHelper &lhs, char rhs)
+{
+    StringSumHelper &sum = const_cast<StringSumHelper &>(lhs);
+    sum.concat(rhs);
+    return sum;
+}
+
+#endif // HOST_WSTRING_H
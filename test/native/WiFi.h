@@ -0,0 +1,150 @@
+/**
+ * @file WiFi.h
+ * @brief Scriptable fake of the Arduino WiFi driver (native tests only)
+ *
+ * Tests set the networks a scan finds and how long it takes on the
+ * virtual clock. scanNetworks(false) behaves like the real synchronous
+ * call: it blocks, i.e. advances the clock by the whole scan time.
+ */
+
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include "Arduino.h"
+
+#define WL_IDLE_STATUS 0
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+typedef enum
+{
+    WIFI_OFF = 0,
+    WIFI_STA,
+    WIFI_AP,
+    WIFI_AP_STA
+} wifi_mode_t;
+
+typedef enum
+{
+    WIFI_AUTH_OPEN = 0,
+    WIFI_AUTH_WEP,
+    WIFI_AUTH_WPA_PSK,
+    WIFI_AUTH_WPA2_PSK
+} wifi_auth_mode_t;
+
+class IPAddress : public Printable
+{
+private:
+    uint8_t bytes[4];
+
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : bytes{a, b, c, d} {}
+
+    String toString() const
+    {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+        return String(text);
+    }
+    size_t printTo(Print &p) const override { return p.print(toString()); }
+};
+
+struct FakeNetwork
+{
+    const char *ssid;
+    int8_t rssi;
+    uint8_t channel;
+    wifi_auth_mode_t auth;
+};
+
+class FakeWiFi
+{
+public:
+    // ─── Scripted by tests ───
+    const FakeNetwork *networks = nullptr;
+    int networkCount = 0;
+    uint32_t scanDurationMs = 2500;
+    bool failStart = false; // scanNetworks() refuses to start
+    bool hang = false;      // scan never completes
+    bool joinSucceeds = true;
+
+    // ─── Observed by tests ───
+    uint32_t scansStarted = 0;
+    uint32_t blockingScans = 0;
+
+    void reset()
+    {
+        *this = FakeWiFi();
+    }
+
+    // ─── Scan API ───
+    int16_t scanNetworks(bool async = false)
+    {
+        if (failStart)
+            return WIFI_SCAN_FAILED;
+        scansStarted++;
+        scanning = true;
+        results = false;
+        startUs = host::clockUs;
+        if (async)
+            return WIFI_SCAN_RUNNING;
+
+        blockingScans++;
+        host::advanceMillis(scanDurationMs);
+        return scanComplete();
+    }
+
+    int16_t scanComplete()
+    {
+        if (scanning)
+        {
+            if (hang || host::clockUs - startUs < (uint64_t)scanDurationMs * 1000)
+                return WIFI_SCAN_RUNNING;
+            scanning = false;
+            results = true;
+        }
+        return results ? networkCount : WIFI_SCAN_FAILED;
+    }
+
+    void scanDelete() { results = false; }
+
+    String SSID(uint8_t i) const { return String(networks[i].ssid); }
+    int8_t RSSI(uint8_t i) const { return networks[i].rssi; }
+    int32_t channel(uint8_t i) const { return networks[i].channel; }
+    wifi_auth_mode_t encryptionType(uint8_t i) const { return networks[i].auth; }
+
+    // ─── Station / AP ───
+    int begin(const char *, const char *)
+    {
+        state = joinSucceeds ? WL_CONNECTED : WL_DISCONNECTED;
+        return state;
+    }
+    int status() const { return state; }
+    void disconnect() { state = WL_DISCONNECTED; }
+    bool mode(wifi_mode_t m)
+    {
+        currentMode = m;
+        return true;
+    }
+    wifi_mode_t getMode() const { return currentMode; }
+    bool softAP(const char *, const char * = nullptr) { return true; }
+    IPAddress localIP() const { return state == WL_CONNECTED ? IPAddress(192, 168, 1, 50) : IPAddress(); }
+    IPAddress softAPIP() const { return IPAddress(192, 168, 4, 1); }
+    String softAPSSID() const { return String("esp32-ap"); }
+    String SSID() const { return String("test-network"); }
+    int8_t RSSI() const { return -55; }
+
+private:
+    bool scanning = false;
+    bool results = false;
+    uint64_t startUs = 0;
+    int state = WL_IDLE_STATUS;
+    wifi_mode_t currentMode = WIFI_STA;
+};
+
+inline FakeWiFi WiFi;
+
+#endif // HOST_WIFI_H
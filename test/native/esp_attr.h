@@ -0,0 +1,13 @@
+/**
+ * @file esp_attr.h
+ * @brief Host stand-in for the ESP-IDF section attributes (native tests only)
+ */
+
+#ifndef HOST_ESP_ATTR_H
+#define HOST_ESP_ATTR_H
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+
+#endif // HOST_ESP_ATTR_H
@@ -0,0 +1,13 @@
+/**
+ * @file esp_timer.h
+ * @brief Host stand-in for esp_timer_get_time(), on the host clock
+ */
+
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include "Arduino.h"
+
+inline int64_t esp_timer_get_time() { return (int64_t)host::nowUs(); }
+
+#endif // HOST_ESP_TIMER_H
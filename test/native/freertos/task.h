@@ -0,0 +1,176 @@
+/**
+ * @file task.h
+ * @brief Host stand-in for FreeRTOS tasks and task notifications
+ *
+ * Each task is a std::thread. Notifications are a counter plus a
+ * condition variable, as in FreeRTOS. vTaskDelete() cannot stop a thread
+ * from outside, so it flags the task and joins it: the task unwinds the
+ * next time it blocks (ulTaskNotifyTake, vTaskDelayUntil, vTaskDelay).
+ *
+ * The calling thread of a test is not a task: xTaskGetCurrentTaskHandle()
+ * returns nullptr there, so Scheduler::idle() falls back to delay().
+ *
+ * host::failTaskCreate makes the Nth xTaskCreatePinnedToCore() from now
+ * fail (0 = the next one), to exercise cleanup paths.
+ */
+
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include <condition_variable>
+#include <thread>
+
+typedef void (*TaskFunction_t)(void *);
+
+namespace host
+{
+struct TaskDeleted
+{
+};
+
+struct Task
+{
+    const char *name;
+    std::thread thread;
+    std::mutex lock;
+    std::condition_variable wake;
+    uint32_t notifications = 0;
+    bool deleted = false;
+};
+
+inline thread_local Task *currentTask = nullptr;
+inline std::atomic<int> tasksAlive{0};
+inline int failTaskCreate = -1;
+
+// Block the calling task until woken or timeoutMs passes; unwinds if deleted
+inline void waitOn(Task *task, std::unique_lock<std::mutex> &held, uint32_t timeoutMs)
+{
+    if (timeoutMs == portMAX_DELAY)
+        task->wake.wait(held);
+    else
+        task->wake.wait_for(held, std::chrono::milliseconds(timeoutMs));
+    if (task->deleted)
+        throw TaskDeleted();
+}
+} // namespace host
+
+typedef host::Task *TaskHandle_t;
+typedef uint32_t UBaseType_t;
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t,
+                                          void *param, UBaseType_t, TaskHandle_t *created, BaseType_t)
+{
+    if (host::failTaskCreate >= 0 && host::failTaskCreate-- == 0)
+        return pdFALSE;
+
+    host::Task *task = new host::Task();
+    task->name = name;
+    host::tasksAlive++;
+    task->thread = std::thread([task, function, param]()
+                               {
+        host::currentTask = task;
+        try
+        {
+            function(param);
+        }
+        catch (const host::TaskDeleted &)
+        {
+        }
+        host::tasksAlive--; });
+
+    if (created)
+        *created = task;
+    return pdPASS;
+}
+
+inline void vTaskDelete(TaskHandle_t task)
+{
+    if (task == nullptr || task == host::currentTask)
+        throw host::TaskDeleted(); // Self-delete: unwind now
+
+    {
+        std::lock_guard<std::mutex> held(task->lock);
+        task->deleted = true;
+    }
+    task->wake.notify_all();
+    task->thread.join();
+    delete task;
+}
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return host::currentTask; }
+
+inline void xTaskNotifyGive(TaskHandle_t task)
+{
+    if (task == nullptr)
+        return;
+    {
+        std::lock_guard<std::mutex> held(task->lock);
+        task->notifications++;
+    }
+    task->wake.notify_one();
+}
+
+inline void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higherPriorityWoken)
+{
+    xTaskNotifyGive(task);
+    if (higherPriorityWoken)
+        *higherPriorityWoken = pdFALSE;
+}
+#define portYIELD_FROM_ISR()
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks)
+{
+    host::Task *task = host::currentTask;
+    if (task == nullptr)
+        return 0;
+
+    std::unique_lock<std::mutex> held(task->lock);
+    if (task->notifications == 0 && !task->deleted)
+        host::waitOn(task, held, ticks);
+    if (task->deleted)
+        throw host::TaskDeleted();
+
+    uint32_t count = task->notifications;
+    task->notifications = clearOnExit ? 0 : count - (count > 0);
+    return count;
+}
+
+inline TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+
+inline void vTaskDelayUntil(TickType_t *previousWake, TickType_t ticks)
+{
+    TickType_t target = *previousWake + ticks;
+    *previousWake = target;
+
+    host::Task *task = host::currentTask;
+    if (task == nullptr)
+    {
+        int32_t remaining = (int32_t)(target - xTaskGetTickCount());
+        if (remaining > 0)
+            delay(remaining);
+        return;
+    }
+
+    std::unique_lock<std::mutex> held(task->lock);
+    for (;;)
+    {
+        if (task->deleted)
+            throw host::TaskDeleted();
+        int32_t remaining = (int32_t)(target - xTaskGetTickCount());
+        if (remaining <= 0)
+            return;
+        // Short waits so a virtual clock moved by another thread is seen
+        host::waitOn(task, held, host::realTime ? (uint32_t)remaining : 1);
+    }
+}
+
+inline void vTaskDelay(TickType_t ticks)
+{
+    TickType_t now = xTaskGetTickCount();
+    vTaskDelayUntil(&now, ticks);
+}
+
+// No stack to measure on the host
+inline UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) { return 0; }
+
+#endif // HOST_FREERTOS_TASK_H
@@ -0,0 +1,318 @@
+/**
+ * @file test_main.cpp
+ * @brief Actuator effects on a virtual clock, and the actuator lock (native)
+ *
+ * Every effect is started and then driven the way the loop task does it:
+ * sleep for getSleepTime(), then update() and advance the timing wheel.
+ * The clock only moves between calls, so an effect that still waited
+ * inside a call would show up as a delay() call or as virtual time
+ * passing during it; each call's wall time is checked against 1 ms too.
+ * The clock starts just before the 32-bit millis() wrap.
+ *
+ * The last test runs commands and the loop on two host threads, as the
+ * AsyncTCP and loop tasks do, with the timing-wheel frames in between.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <new>
+#include "actuators/BuzzerController.h"
+#include "actuators/MotorController.h"
+#include "actuators/RGBLEDController.h"
+#include "actuators/RelayController.h"
+#include "actuators/ServoController.h"
+#include "utils/TimingWheel.h"
+
+static const uint64_t NEAR_WRAP_US = (uint64_t)(0xFFFFFFFFu - 4000) * 1000;
+
+static double worstCallUs;
+static uint32_t worstCallVirtualMs;
+
+void setUp()
+{
+    host::resetClock(NEAR_WRAP_US);
+    // A fresh wheel per test: it keeps its own notion of "now"
+    timingWheel.~TimingWheel();
+    new (&timingWheel) TimingWheel();
+    worstCallUs = 0;
+    worstCallVirtualMs = 0;
+}
+
+void tearDown() {}
+
+// Runs f and records how long it took, on the wall and on the virtual clock
+template <typename F>
+static void timed(F f)
+{
+    uint32_t virtualStart = millis();
+    auto start = std::chrono::steady_clock::now();
+    f();
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    worstCallUs = max(worstCallUs, us);
+    worstCallVirtualMs = max(worstCallVirtualMs, (uint32_t)(millis() - virtualStart));
+}
+
+// Drives an effect to completion (or for limitMs); returns virtual ms taken
+static uint32_t run(Effect *effect, uint32_t limitMs = 100000)
+{
+    uint32_t start = millis();
+    while (effect->isRunning() && millis() - start < limitMs)
+    {
+        uint32_t sleep = min(effect->getSleepTime(millis()), timingWheel.getSleepTime(millis(), 1000));
+        host::advanceMillis(max(sleep, (uint32_t)1));
+        timed([&]
+              {
+            effect->update(millis());
+            timingWheel.advance(millis()); });
+    }
+    return millis() - start;
+}
+
+static void assertNothingBlocked()
+{
+    TEST_ASSERT_EQUAL_MESSAGE(0, host::delayCalls.load(), "delay() called");
+    TEST_ASSERT_EQUAL_MESSAGE(0, worstCallVirtualMs, "virtual time passed inside a call");
+    TEST_ASSERT_LESS_THAN(1000.0, worstCallUs);
+}
+
+// ─── Effects ────────────────────────────────────────────────────────────────
+
+void test_rgb_animations_run_to_their_length_without_blocking()
+{
+    RGBLEDController rgb(RGB_R_PIN, RGB_G_PIN, RGB_B_PIN);
+    rgb.begin();
+
+    timed([&]
+          { rgb.theaterChase(255, 0, 0, 50); });
+    TEST_ASSERT_EQUAL(3000, run(rgb.getEffect()));
+
+    timed([&]
+          { rgb.theaterChaseRainbow(5); });
+    TEST_ASSERT_EQUAL(7800, run(rgb.getEffect()));
+
+    timed([&]
+          { rgb.breathe(0, 0, 255, 2000); });
+    TEST_ASSERT_EQUAL(2000, run(rgb.getEffect()));
+
+    timed([&]
+          { rgb.rainbowCycle(20); });
+    TEST_ASSERT_GREATER_THAN(0, run(rgb.getEffect()));
+
+    timed([&]
+          { rgb.lightning(255, 255, 255, 3, 500, 50); });
+    run(rgb.getEffect());
+    TEST_ASSERT_EQUAL(0, rgb.getRed()); // Ends dark
+
+    timed([&]
+          { rgb.twinkleRandom(10, 100); });
+    run(rgb.getEffect());
+    TEST_ASSERT_FALSE(rgb.getEffect()->isRunning());
+
+    assertNothingBlocked();
+}
+
+void test_endless_rgb_effect_stops_on_new_colour()
+{
+    RGBLEDController rgb(RGB_R_PIN, RGB_G_PIN, RGB_B_PIN);
+    rgb.begin();
+
+    timed([&]
+          { rgb.fire(); });
+    run(rgb.getEffect(), 5000);
+    TEST_ASSERT_TRUE(rgb.getEffect()->isRunning());
+
+    timed([&]
+          { rgb.setColor(1, 2, 3); });
+    TEST_ASSERT_FALSE(rgb.getEffect()->isRunning());
+    assertNothingBlocked();
+}
+
+void test_rgb_transition_is_driven_by_the_wheel()
+{
+    RGBLEDController rgb(RGB_R_PIN, RGB_G_PIN, RGB_B_PIN);
+    rgb.begin();
+    rgb.setColor(0, 0, 0);
+
+    timed([&]
+          { rgb.transitionToColor(200, 100, 50, 500); });
+    for (int i = 0; i < 60; i++)
+    {
+        host::advanceMillis(TIMING_WHEEL_TICK_MS);
+        timed([&]
+              { timingWheel.advance(millis()); });
+    }
+
+    TEST_ASSERT_EQUAL(200, rgb.getRed());
+    TEST_ASSERT_EQUAL(100, rgb.getGreen());
+    TEST_ASSERT_EQUAL(50, rgb.getBlue());
+    TEST_ASSERT_EQUAL(0, timingWheel.getPending());
+    assertNothingBlocked();
+}
+
+void test_buzzer_sequences_keep_their_timing()
+{
+    BuzzerController buzzer(BUZZER_PIN);
+    buzzer.begin();
+
+    int notes[] = {262, 0, 330, 392};
+    int durations[] = {100, 50, 100, 200};
+    timed([&]
+          { buzzer.playMelody(notes, durations, 4); });
+    TEST_ASSERT_EQUAL(600, run(buzzer.getEffect())); // Notes plus their gaps
+
+    timed([&]
+          { buzzer.playPattern("BSBL"); });
+    TEST_ASSERT_EQUAL(1900, run(buzzer.getEffect()));
+
+    timed([&]
+          { buzzer.sirenSound(2000); });
+    TEST_ASSERT_EQUAL(2000, run(buzzer.getEffect()));
+    TEST_ASSERT_FALSE(buzzer.isPlaying());
+
+    // Stopping mid-sequence silences the pin
+    timed([&]
+          { buzzer.playAlertSound(); });
+    host::advanceMillis(120);
+    buzzer.getEffect()->update(millis());
+    timed([&]
+          { buzzer.stopTone(); });
+    TEST_ASSERT_FALSE(buzzer.getEffect()->isRunning());
+    TEST_ASSERT_EQUAL(0, host::pinLevel[BUZZER_PIN]);
+
+    assertNothingBlocked();
+}
+
+void test_motor_ramps_reach_their_target()
+{
+    MotorController motor(MOTOR1_IN1, MOTOR1_IN2, MOTOR1_EN);
+    motor.begin();
+    motor.setSpeed(60);
+
+    timed([&]
+          { motor.accelerateTo(200, 10); });
+    run(motor.getEffect());
+    TEST_ASSERT_EQUAL(200, motor.getSpeed());
+
+    timed([&]
+          { motor.smoothStop(1000); });
+    TEST_ASSERT_EQUAL(1000, run(motor.getEffect()));
+    TEST_ASSERT_EQUAL(0, motor.getSpeed());
+    TEST_ASSERT_FALSE(motor.isRunningState());
+
+    timed([&]
+          { motor.calibrate(); });
+    TEST_ASSERT_EQUAL(2000, run(motor.getEffect()));
+    TEST_ASSERT_EQUAL(0, motor.getSpeed());
+
+    assertNothingBlocked();
+}
+
+void test_relay_pulse_and_servo_sweep()
+{
+    RelayController relays;
+    relays.begin();
+
+    timed([&]
+          { relays.pulse(2, 1500); });
+    TEST_ASSERT_TRUE(relays.getState(2));
+    TEST_ASSERT_EQUAL(1500, run(relays.getEffect(2)));
+    TEST_ASSERT_FALSE(relays.getState(2));
+
+    // Setting the relay by hand ends the pulse and keeps the new state
+    relays.pulse(1, 1000);
+    relays.setState(1, true);
+    TEST_ASSERT_FALSE(relays.getEffect(1)->isRunning());
+    TEST_ASSERT_TRUE(relays.getState(1));
+
+    ServoController servos;
+    servos.begin();
+    host::delayCalls = 0; // begin() waits for the servos to centre
+    timed([&]
+          { servos.sweep(1, 10, 20, 5); });
+    run(servos.getEffect(1), 1000);
+    TEST_ASSERT_INT_WITHIN(10, 15, servos.getAngle(1));
+
+    servos.sweep(2, 0, 180, 15);
+    servos.setAngle(2, 45);
+    TEST_ASSERT_FALSE(servos.getEffect(2)->isRunning());
+    TEST_ASSERT_EQUAL(45, servos.getAngle(2));
+
+    assertNothingBlocked();
+}
+
+// ─── Threads ────────────────────────────────────────────────────────────────
+
+void test_commands_and_loop_on_two_threads()
+{
+    host::useRealTime();
+    ActuatorLock::begin();
+
+    RGBLEDController rgb(RGB_R_PIN, RGB_G_PIN, RGB_B_PIN);
+    BuzzerController buzzer(BUZZER_PIN);
+    rgb.begin();
+    buzzer.begin();
+
+    std::atomic<bool> done{false};
+
+    // The loop task: effects and wheel frames
+    std::thread loop([&]
+                     {
+        while (!done)
+        {
+            {
+                ActuatorLock held;
+                rgb.getEffect()->update(millis());
+                buzzer.getEffect()->update(millis());
+            }
+            timingWheel.advance(millis());
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        } });
+
+    // A web handler: every command restarts what the loop is stepping
+    for (int i = 0; i < 2000; i++)
+    {
+        ActuatorLock held;
+        switch (i % 4)
+        {
+        case 0:
+            rgb.transitionToColor(i & 255, 0, 255 - (i & 255), 40);
+            break;
+        case 1:
+            buzzer.playTone(440 + i % 100, 15);
+            break;
+        case 2:
+            rgb.theaterChase(0, 255, 0, 5);
+            break;
+        default:
+            buzzer.playPattern("BS");
+            break;
+        }
+        if (i % 50 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Let everything finish, then check the wheel got every node back
+    delay(1000);
+    done = true;
+    loop.join();
+    timingWheel.advance(millis() + 1000);
+
+    TEST_ASSERT_EQUAL(0, timingWheel.getPending());
+    TEST_ASSERT_EQUAL(0, timingWheel.getPoolExhausted());
+    TEST_ASSERT_LESS_OR_EQUAL(4, timingWheel.getMaxPending()); // One tone + one transition, give or take a frame
+    TEST_ASSERT_FALSE(buzzer.isPlaying());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_rgb_animations_run_to_their_length_without_blocking);
+    RUN_TEST(test_endless_rgb_effect_stops_on_new_colour);
+    RUN_TEST(test_rgb_transition_is_driven_by_the_wheel);
+    RUN_TEST(test_buzzer_sequences_keep_their_timing);
+    RUN_TEST(test_motor_ramps_reach_their_target);
+    RUN_TEST(test_relay_pulse_and_servo_sweep);
+    RUN_TEST(test_commands_and_loop_on_two_threads);
+    return UNITY_END();
+}
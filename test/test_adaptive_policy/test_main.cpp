@@ -0,0 +1,184 @@
+/**
+ * @file test_main.cpp
+ * @brief AdaptivePolicy replayed over an 8-hour synthetic day (native)
+ *
+ * Three sensors at their base periods (DHT 2 s, LDR and soil 1 s) report
+ * flat readings with noise inside their deadbands, plus one event each:
+ * a 3 °C temperature ramp over 10 minutes at 2 h, a soil moisture drop
+ * of 600 counts over a minute at 4 h and a light step at 6 h. The loop
+ * publishes every SENSOR_READ_INTERVAL when something changed or the
+ * heartbeat is due, as main.cpp does, with the config.h defaults.
+ *
+ * Compared with fixed-rate sampling and publishing, the policy has to
+ * cut polls and publications by a large factor while each event still
+ * shows up in a published snapshot within two slowed-down periods of
+ * when a fixed-rate node would have published it.
+ */
+
+#include <unity.h>
+#include <algorithm>
+#include <random>
+#include <stdio.h>
+#include "config.h"
+#include "sensors/AdaptivePolicy.h"
+
+static const uint32_t DAY_MS = 8 * 3600 * 1000u;
+static const uint32_t STEP_MS = 10;
+static const uint32_t PUBLISH_MS = SENSOR_READ_INTERVAL;
+
+enum
+{
+    DHT,
+    LDR,
+    SOIL,
+    SENSORS
+};
+
+static const uint32_t BASE_PERIOD[SENSORS] = {2000, 1000, 1000};
+static const uint32_t EVENT_AT[SENSORS] = {2 * 3600000u, 6 * 3600000u, 4 * 3600000u};
+// When a fixed-rate node publishes the event (first reading past the
+// threshold checked below, plus at most one publish round)
+static const uint32_t FIXED_DETECT_MS[SENSORS] = {100000 + PUBLISH_MS, 1000 + PUBLISH_MS, 10000 + PUBLISH_MS};
+
+static float temperatureAt(uint32_t t)
+{
+    return t > EVENT_AT[DHT] ? 22 + std::min(3.0f, (t - EVENT_AT[DHT]) / 600000.0f * 3) : 22;
+}
+static float lightAt(uint32_t t) { return t > EVENT_AT[LDR] ? 400.0f : 1500.0f; }
+static float soilAt(uint32_t t)
+{
+    return t > EVENT_AT[SOIL] ? 2000 - std::min(600.0f, (t - EVENT_AT[SOIL]) / 60000.0f * 600) : 2000;
+}
+
+// Published value that shows the event (temperature +0.5, light below 1000, soil -100)
+static bool eventVisible(int sensor, float published)
+{
+    switch (sensor)
+    {
+    case DHT:
+        return published > 22.5f;
+    case LDR:
+        return published < 1000;
+    default:
+        return published < 1900;
+    }
+}
+
+static AdaptivePolicy policy;
+
+void setUp()
+{
+    policy = AdaptivePolicy();
+    policy.setStablePolls(ADAPTIVE_STABLE_POLLS);
+    policy.setMaxSlowdown(ADAPTIVE_MAX_SLOWDOWN);
+    policy.setHeartbeat(ADAPTIVE_HEARTBEAT);
+    static const AdaptiveDeadband deadbands[] = {ADAPTIVE_DEADBANDS};
+    for (const AdaptiveDeadband &deadband : deadbands)
+        policy.setDeadband(deadband.field, deadband.threshold);
+}
+void tearDown() {}
+
+void test_eight_hour_replay()
+{
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0, 1);
+
+    AdaptiveTrack tracks[SENSORS];
+    uint32_t next[SENSORS] = {0}, polls[SENSORS] = {0}, detected[SENSORS] = {0};
+    float latest[SENSORS] = {0}, published[SENSORS] = {0};
+    for (AdaptiveTrack &track : tracks)
+        policy.reset(track);
+
+    bool changed = false;
+    uint32_t lastPublish = 0, publications = 0, rounds = 0;
+
+    for (uint32_t t = 0; t < DAY_MS; t += STEP_MS)
+    {
+        for (int s = 0; s < SENSORS; s++)
+        {
+            if ((int32_t)(t - next[s]) < 0)
+                continue;
+
+            SensorField fields[2];
+            uint8_t count = 1;
+            if (s == DHT)
+            {
+                fields[0] = {"temperature", SENSOR_FIELD_FLOAT, temperatureAt(t) + 0.05f * noise(rng)};
+                fields[1] = {"humidity", SENSOR_FIELD_FLOAT, 55 + 0.3f * noise(rng)};
+                count = 2;
+            }
+            else if (s == LDR)
+                fields[0] = {"lightLevel", SENSOR_FIELD_INT, lightAt(t) + 15 * noise(rng)};
+            else
+                fields[0] = {"soilMoisture", SENSOR_FIELD_INT, soilAt(t) + 10 * noise(rng)};
+
+            polls[s]++;
+            latest[s] = fields[0].value;
+            changed |= policy.update(tracks[s], fields, count);
+            next[s] = t + policy.interval(tracks[s], BASE_PERIOD[s]);
+        }
+
+        if (t % PUBLISH_MS == 0)
+        {
+            rounds++;
+            if (changed || t - lastPublish >= policy.getHeartbeat())
+            {
+                changed = false;
+                lastPublish = t;
+                publications++;
+                for (int s = 0; s < SENSORS; s++)
+                {
+                    published[s] = latest[s];
+                    if (!detected[s] && t > EVENT_AT[s] && eventVisible(s, published[s]))
+                        detected[s] = t;
+                }
+            }
+        }
+    }
+
+    const char *names[SENSORS] = {"DHT", "LDR", "soil"};
+    char line[128];
+    snprintf(line, sizeof(line), "8 h: %u of %u publish rounds sent (%.1f%%)", (unsigned)publications, (unsigned)rounds,
+             100.0 * publications / rounds);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_LESS_THAN(rounds / 10, publications);
+    // The heartbeat alone is one per minute
+    TEST_ASSERT_GREATER_OR_EQUAL(DAY_MS / policy.getHeartbeat(), publications);
+
+    for (int s = 0; s < SENSORS; s++)
+    {
+        uint32_t fixedPolls = DAY_MS / BASE_PERIOD[s];
+        uint32_t latency = detected[s] - EVENT_AT[s];
+        snprintf(line, sizeof(line), "%s: %u polls vs %u fixed (%.1f%%), event published after %u ms (fixed rate %u ms)",
+                 names[s], (unsigned)polls[s], (unsigned)fixedPolls, 100.0 * polls[s] / fixedPolls,
+                 (unsigned)latency, (unsigned)FIXED_DETECT_MS[s]);
+        TEST_MESSAGE(line);
+
+        TEST_ASSERT_LESS_THAN_MESSAGE(fixedPolls / 4, polls[s], names[s]);
+        TEST_ASSERT_NOT_EQUAL_MESSAGE(0, detected[s], names[s]);
+        TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(FIXED_DETECT_MS[s] + 2 * ADAPTIVE_MAX_SLOWDOWN * BASE_PERIOD[s], latency, names[s]);
+    }
+}
+
+void test_disabled_policy_is_fixed_rate()
+{
+    policy.setEnabled(false);
+    AdaptiveTrack track;
+    policy.reset(track);
+
+    SensorField field = {"soilMoisture", SENSOR_FIELD_INT, 2000};
+    for (int i = 0; i < 100; i++)
+    {
+        TEST_ASSERT_TRUE(policy.update(track, &field, 1));
+        TEST_ASSERT_EQUAL(1000, policy.interval(track, 1000));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_eight_hour_replay);
+    RUN_TEST(test_disabled_policy_is_fixed_rate);
+    return UNITY_END();
+}
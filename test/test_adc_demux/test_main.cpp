@@ -0,0 +1,195 @@
+/**
+ * @file test_main.cpp
+ * @brief AdcDemux channel sorting, decimation and history (native)
+ *
+ * The streams are built the way the continuous ADC driver writes them:
+ * little-endian type-1 words, channel in bits 12-15, cycling through
+ * the configured channels. The benchmark feeds ADC_DMA_FRAME_BYTES
+ * frames with the firmware's ADC_DMA_DECIMATION, as the sampling task
+ * does once per wake-up.
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include <vector>
+#include "config.h"
+#include "sensors/AdcDemux.h"
+
+static AdcDemux demux;
+
+void setUp() { demux = AdcDemux(); }
+void tearDown() {}
+
+static void appendWord(std::vector<uint8_t> &stream, uint8_t channel, uint16_t raw)
+{
+    uint16_t word = (uint16_t)(channel << 12) | (raw & 0x0FFF);
+    stream.push_back(word & 0xFF);
+    stream.push_back(word >> 8);
+}
+
+// ─── Demultiplexing ─────────────────────────────────────────────────────────
+
+void test_interleaved_channels_are_sorted()
+{
+    static const uint8_t CHANNELS[] = {0, 3, 6, 7}; // GPIO 36, 39, 34, 35
+    static const uint16_t LEVELS[] = {200, 1500, 2900, 4000};
+    demux.begin(8);
+    for (uint8_t channel : CHANNELS)
+        demux.addChannel(channel);
+
+    // 64 outputs per channel, ±100 counts of alternating noise
+    std::vector<uint8_t> stream;
+    for (int i = 0; i < 64 * 8; i++)
+        for (int c = 0; c < 4; c++)
+            appendWord(stream, CHANNELS[c], LEVELS[c] + (i % 2 ? 95 : -95));
+
+    TEST_ASSERT_EQUAL(64 * 8 * 4, demux.process(stream.data(), stream.size()));
+    TEST_ASSERT_EQUAL(4, demux.getSlotCount());
+    for (uint8_t slot = 0; slot < 4; slot++)
+    {
+        TEST_ASSERT_EQUAL(CHANNELS[slot], demux.getChannel(slot));
+        TEST_ASSERT_TRUE(demux.isReady(slot));
+        TEST_ASSERT_EQUAL(64 * 8, demux.getSamples(slot));
+        TEST_ASSERT_EQUAL(64, demux.getOutputs(slot));
+        TEST_ASSERT_FLOAT_WITHIN(0.5, LEVELS[slot], demux.getAverage(slot));
+    }
+    TEST_ASSERT_EQUAL(0, demux.getUnknown());
+}
+
+void test_unregistered_channels_are_counted()
+{
+    demux.begin(1);
+    TEST_ASSERT_EQUAL(0, demux.addChannel(4));
+    TEST_ASSERT_EQUAL(0, demux.addChannel(4)); // Same slot again
+    TEST_ASSERT_EQUAL(-1, demux.addChannel(16));
+
+    std::vector<uint8_t> stream;
+    appendWord(stream, 4, 1000);
+    appendWord(stream, 5, 3000);
+    appendWord(stream, 15, 3000);
+    appendWord(stream, 4, 1002);
+    stream.push_back(0x42); // Half a word at the end of the buffer
+
+    TEST_ASSERT_EQUAL(2, demux.process(stream.data(), stream.size()));
+    TEST_ASSERT_EQUAL(2, demux.getUnknown());
+    TEST_ASSERT_EQUAL(2, demux.getSamples(0));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 1001, demux.getAverage(0));
+}
+
+void test_channel_slots_are_bounded()
+{
+    demux.begin(1);
+    for (uint8_t channel = 0; channel < ADC_MAX_CHANNELS; channel++)
+        TEST_ASSERT_EQUAL(channel, demux.addChannel(channel));
+    TEST_ASSERT_EQUAL(-1, demux.addChannel(ADC_MAX_CHANNELS));
+    TEST_ASSERT_EQUAL(ADC_MAX_CHANNELS, demux.getSlotCount());
+}
+
+// ─── Filtering ──────────────────────────────────────────────────────────────
+
+void test_decimation_rounds_to_nearest()
+{
+    struct Case
+    {
+        uint16_t samples[4];
+        uint16_t expected;
+    };
+    static const Case CASES[] = {
+        {{1, 1, 1, 2}, 1},         // 1.25
+        {{1, 1, 2, 2}, 2},         // 1.5 rounds up
+        {{1, 2, 2, 2}, 2},         // 1.75
+        {{4095, 4095, 4095, 4095}, 4095},
+        {{0, 0, 0, 1}, 0},
+    };
+
+    for (const Case &c : CASES)
+    {
+        demux.begin(4);
+        uint8_t slot = demux.addChannel(0);
+        for (int i = 0; i < 3; i++)
+        {
+            demux.push(slot, c.samples[i]);
+            TEST_ASSERT_FALSE(demux.isReady(slot)); // Not a full output yet
+        }
+        demux.push(slot, c.samples[3]);
+        TEST_ASSERT_EQUAL(1, demux.getOutputs(slot));
+        TEST_ASSERT_EQUAL_FLOAT(c.expected, demux.getAverage(slot));
+    }
+}
+
+void test_step_settles_after_the_history()
+{
+    demux.begin(ADC_POLL_DECIMATION);
+    uint8_t slot = demux.addChannel(2);
+    for (int i = 0; i < ADC_HISTORY * ADC_POLL_DECIMATION; i++)
+        demux.push(slot, 1000);
+    TEST_ASSERT_EQUAL_FLOAT(1000, demux.getAverage(slot));
+
+    // Step to 3000: one output in, the average moves by 1/ADC_HISTORY
+    // of the step per output and reaches it on the last one
+    for (int output = 1; output <= ADC_HISTORY; output++)
+    {
+        for (int i = 0; i < ADC_POLL_DECIMATION; i++)
+            demux.push(slot, 3000);
+        float expected = 1000 + 2000.0f * output / ADC_HISTORY;
+        TEST_ASSERT_FLOAT_WITHIN(0.01, expected, demux.getAverage(slot));
+    }
+    TEST_ASSERT_EQUAL_FLOAT(3000, demux.getAverage(slot));
+}
+
+void test_begin_clears_channels()
+{
+    demux.begin(1);
+    demux.addChannel(3);
+    demux.push(0, 100);
+    demux.begin(1);
+    TEST_ASSERT_EQUAL(0, demux.getSlotCount());
+    TEST_ASSERT_EQUAL(0, demux.addChannel(3));
+    TEST_ASSERT_FALSE(demux.isReady(0));
+    TEST_ASSERT_EQUAL(0, demux.getSamples(0));
+}
+
+// ─── Benchmark ──────────────────────────────────────────────────────────────
+
+void test_benchmark_process()
+{
+    static const uint8_t CHANNELS[] = {0, 3, 6};
+    demux.begin(ADC_DMA_DECIMATION);
+    for (uint8_t channel : CHANNELS)
+        demux.addChannel(channel);
+
+    std::vector<uint8_t> frame;
+    for (int i = 0; frame.size() < ADC_DMA_FRAME_BYTES; i++)
+        appendWord(frame, CHANNELS[i % 3], (i * 37) & 0x0FFF);
+
+    const int FRAMES = 20000;
+    size_t used = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < FRAMES; f++)
+        used += demux.process(frame.data(), frame.size());
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / used;
+
+    char line[128];
+    snprintf(line, sizeof(line), "process(): %.2f ns per sample, %.1f us per %d-byte frame",
+             ns, ns * ADC_DMA_FRAME_BYTES / ADC_SAMPLE_BYTES / 1000, ADC_DMA_FRAME_BYTES);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_EQUAL((size_t)FRAMES * ADC_DMA_FRAME_BYTES / ADC_SAMPLE_BYTES, used);
+    TEST_ASSERT_TRUE(demux.isReady(0));
+    // Generous ceiling: 20 kHz must stay far below 1% of a core
+    TEST_ASSERT_LESS_THAN(100.0, ns);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_interleaved_channels_are_sorted);
+    RUN_TEST(test_unregistered_channels_are_counted);
+    RUN_TEST(test_channel_slots_are_bounded);
+    RUN_TEST(test_decimation_rounds_to_nearest);
+    RUN_TEST(test_step_settles_after_the_history);
+    RUN_TEST(test_begin_clears_channels);
+    RUN_TEST(test_benchmark_process);
+    return UNITY_END();
+}
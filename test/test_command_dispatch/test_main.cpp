@@ -0,0 +1,143 @@
+/**
+ * @file test_main.cpp
+ * @brief Hashed command lookup vs. strcmp() chain (native)
+ *
+ * CommandDispatcher::find() pulls in the whole firmware, so this suite
+ * rebuilds its lookup with the same names and the same COMMAND_CASE
+ * shape (hash switch, one confirming strcmp) and times it against the
+ * if/strcmp chain the WebSocket handler used before.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include "utils/CommandHash.h"
+
+void setUp() {}
+void tearDown() {}
+
+// Same names, same order as CommandDispatcher::find()
+static const char *const COMMANDS[] = {
+    "getStatus", "getSensorData", "setActuator", "setActuators",
+    "getActuatorStatus", "getPeers", "sendToPeer", "triggerAlert",
+    "wifiScan", "wifiConnect", "listFiles", "getConfig",
+    "saveConfig", "restart"};
+static const int COMMAND_COUNT = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+
+static int findHashed(const char *name)
+{
+#define COMMAND_CASE(text, index)        \
+    case hashName(text):                 \
+        if (strcmp(name, text) != 0)     \
+            return -1;                   \
+        return index;
+
+    switch (hashNameRuntime(name))
+    {
+        COMMAND_CASE("getStatus", 0)
+        COMMAND_CASE("getSensorData", 1)
+        COMMAND_CASE("setActuator", 2)
+        COMMAND_CASE("setActuators", 3)
+        COMMAND_CASE("getActuatorStatus", 4)
+        COMMAND_CASE("getPeers", 5)
+        COMMAND_CASE("sendToPeer", 6)
+        COMMAND_CASE("triggerAlert", 7)
+        COMMAND_CASE("wifiScan", 8)
+        COMMAND_CASE("wifiConnect", 9)
+        COMMAND_CASE("listFiles", 10)
+        COMMAND_CASE("getConfig", 11)
+        COMMAND_CASE("saveConfig", 12)
+        COMMAND_CASE("restart", 13)
+    default:
+        return -1;
+    }
+
+#undef COMMAND_CASE
+}
+
+static int findLinear(const char *name)
+{
+    for (int i = 0; i < COMMAND_COUNT; i++)
+    {
+        if (strcmp(name, COMMANDS[i]) == 0)
+            return i;
+    }
+    return -1;
+}
+
+// ─── Lookup ─────────────────────────────────────────────────────────────────
+
+void test_runtime_hash_matches_constexpr()
+{
+    TEST_ASSERT_EQUAL_UINT32(hashName("getStatus"), hashNameRuntime("getStatus"));
+    TEST_ASSERT_EQUAL_UINT32(hashName(""), hashNameRuntime(""));
+    TEST_ASSERT_EQUAL_UINT32(FNV1A_OFFSET, hashNameRuntime(""));
+}
+
+void test_every_command_is_found()
+{
+    for (int i = 0; i < COMMAND_COUNT; i++)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(i, findHashed(COMMANDS[i]), COMMANDS[i]);
+        TEST_ASSERT_EQUAL(i, findLinear(COMMANDS[i]));
+    }
+}
+
+void test_unknown_and_near_names_are_rejected()
+{
+    const char *const unknown[] = {"", "getstatus", "getStatus ", "setActuatorz",
+                                   "restar", "restartt", "SETACTUATOR", "help"};
+    for (const char *name : unknown)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(-1, findHashed(name), name);
+    }
+}
+
+// ─── Benchmark ──────────────────────────────────────────────────────────────
+
+template <typename Find>
+static double nsPerLookup(Find find, const char *const *names, int count, long &checksum)
+{
+    const int ROUNDS = 200000;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++)
+    {
+        // volatile read keeps the compiler from hoisting the lookup
+        const char *volatile name = names[r % count];
+        checksum += find(name);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / ROUNDS;
+}
+
+void test_benchmark_lookup()
+{
+    long hashedSum = 0, linearSum = 0;
+
+    // Warm up, then measure; the best of a few runs filters scheduler noise
+    double hashed = 1e9, linear = 1e9;
+    for (int run = 0; run < 5; run++)
+    {
+        hashed = std::min(hashed, nsPerLookup(findHashed, COMMANDS, COMMAND_COUNT, hashedSum));
+        linear = std::min(linear, nsPerLookup(findLinear, COMMANDS, COMMAND_COUNT, linearSum));
+    }
+
+    char line[128];
+    snprintf(line, sizeof(line), "%d commands: hashed %.1f ns/lookup   strcmp chain %.1f ns/lookup",
+             COMMAND_COUNT, hashed, linear);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_EQUAL(hashedSum, linearSum);
+    // Hashing reads the name once; the chain compares up to 14 prefixes
+    TEST_ASSERT_LESS_THAN(linear, hashed);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_runtime_hash_matches_constexpr);
+    RUN_TEST(test_every_command_is_found);
+    RUN_TEST(test_unknown_and_near_names_are_rejected);
+    RUN_TEST(test_benchmark_lookup);
+    return UNITY_END();
+}
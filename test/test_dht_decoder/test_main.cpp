@@ -0,0 +1,170 @@
+/**
+ * @file test_main.cpp
+ * @brief DHT11/DHT22 frame decoding from falling-edge timestamps (native)
+ *
+ * RECORDED is a DHT22 capture as the driver's ISR stores it: 42 falling
+ * edges in µs (response, 40 bits, trailer) with the sensor's own jitter.
+ * The other frames are synthesized from known bytes with the datasheet
+ * timings, to cover jitter, a missed response edge, the micros() wrap,
+ * negative temperatures and the failure modes.
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sensors/DHTDecoder.h"
+
+// 65.2 %RH, 35.1 °C
+static const uint32_t RECORDED[DHT_FRAME_EDGES] = {
+    3417250, 3417411, 3417484, 3417563, 3417641, 3417718,
+    3417793, 3417872, 3417993, 3418067, 3418189, 3418269,
+    3418347, 3418421, 3418541, 3418660, 3418734, 3418813,
+    3418887, 3418962, 3419043, 3419116, 3419197, 3419278,
+    3419351, 3419469, 3419549, 3419669, 3419743, 3419859,
+    3419976, 3420097, 3420213, 3420330, 3420449, 3420570,
+    3420692, 3420770, 3420886, 3421002, 3421125, 3421205};
+
+static uint32_t edges[64];
+static DHTReading reading;
+
+void setUp()
+{
+    srand(1);
+    reading.temperature = reading.humidity = -999.0f;
+}
+void tearDown() {}
+
+// Falling edges of a frame carrying data[5], starting at t (µs)
+static uint8_t synthesize(const uint8_t *data, uint32_t t, int jitterUs, bool withResponse)
+{
+    uint8_t count = 0;
+    if (withResponse)
+    {
+        edges[count++] = t;
+        t += 160;
+    }
+    for (int bit = 0; bit < DHT_FRAME_BITS; bit++)
+    {
+        edges[count++] = t;
+        bool one = (data[bit / 8] >> (7 - bit % 8)) & 1;
+        int jitter = jitterUs ? rand() % (2 * jitterUs + 1) - jitterUs : 0;
+        t += 50 + (one ? 70 : 27) + jitter;
+    }
+    edges[count++] = t;
+    return count;
+}
+
+static void withChecksum(uint8_t *data)
+{
+    data[4] = data[0] + data[1] + data[2] + data[3];
+}
+
+// ─── Good frames ────────────────────────────────────────────────────────────
+
+void test_recorded_dht22_frame()
+{
+    TEST_ASSERT_EQUAL(DHT_DECODE_OK, DHTDecoder::decode(RECORDED, DHT_FRAME_EDGES, DHT22, reading));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 35.1, reading.temperature);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 65.2, reading.humidity);
+}
+
+void test_jitter_missing_response_and_wrap()
+{
+    uint8_t data[5] = {0x02, 0x8C, 0x01, 0x5F};
+    withChecksum(data);
+
+    // Starts 256 µs before micros() wraps; the response edge was missed
+    uint8_t count = synthesize(data, 0xFFFFFF00u, 15, false);
+    TEST_ASSERT_EQUAL(DHT_FRAME_EDGES - 1, count);
+    TEST_ASSERT_EQUAL(DHT_DECODE_OK, DHTDecoder::decode(edges, count, DHT22, reading));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 35.1, reading.temperature);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 65.2, reading.humidity);
+}
+
+void test_negative_temperature()
+{
+    uint8_t data[5] = {0x01, 0x90, 0x80, 0x65}; // 40.0 %RH, -10.1 °C (sign bit)
+    withChecksum(data);
+
+    TEST_ASSERT_EQUAL(DHT_DECODE_OK, DHTDecoder::decode(edges, synthesize(data, 5, 10, true), DHT22, reading));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, -10.1, reading.temperature);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 40.0, reading.humidity);
+}
+
+void test_dht11_integer_bytes()
+{
+    uint8_t data[5] = {45, 0, 23, 4};
+    withChecksum(data);
+
+    TEST_ASSERT_EQUAL(DHT_DECODE_OK, DHTDecoder::decode(edges, synthesize(data, 0, 5, true), DHT11, reading));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 23.4, reading.temperature);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 45.0, reading.humidity);
+}
+
+// ─── Bad frames ─────────────────────────────────────────────────────────────
+
+void test_checksum_mismatch()
+{
+    uint32_t corrupted[DHT_FRAME_EDGES];
+    memcpy(corrupted, RECORDED, sizeof(corrupted));
+    // Turn the last checksum bit from a 0 (~77 µs) into a 1 (~120 µs)
+    TEST_ASSERT_LESS_THAN(DHT_BIT_ONE_US, corrupted[41] - corrupted[40]);
+    corrupted[41] += 43;
+
+    TEST_ASSERT_EQUAL(DHT_DECODE_CHECKSUM, DHTDecoder::decode(corrupted, DHT_FRAME_EDGES, DHT22, reading));
+    TEST_ASSERT_EQUAL_FLOAT(-999.0f, reading.temperature); // Left untouched
+}
+
+void test_short_frame_and_no_response()
+{
+    TEST_ASSERT_EQUAL(DHT_DECODE_SHORT_FRAME, DHTDecoder::decode(RECORDED, 30, DHT22, reading));
+    TEST_ASSERT_EQUAL(DHT_DECODE_NO_RESPONSE, DHTDecoder::decode(RECORDED, 0, DHT22, reading));
+}
+
+void test_gap_in_the_bit_train_is_bad_timing()
+{
+    uint32_t gapped[DHT_FRAME_EDGES];
+    memcpy(gapped, RECORDED, sizeof(gapped));
+    // A lost edge (e.g. the ISR was held off): one period longer than any bit
+    for (int i = 20; i < DHT_FRAME_EDGES; i++)
+        gapped[i] += 200;
+
+    TEST_ASSERT_EQUAL(DHT_DECODE_BAD_TIMING, DHTDecoder::decode(gapped, DHT_FRAME_EDGES, DHT22, reading));
+    TEST_ASSERT_EQUAL_STRING("bad timing", DHTDecoder::describe(DHT_DECODE_BAD_TIMING));
+}
+
+// ─── Benchmark ──────────────────────────────────────────────────────────────
+
+void test_benchmark_decode()
+{
+    const int FRAMES = 200000;
+    uint32_t ok = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < FRAMES; i++)
+        ok += DHTDecoder::decode(RECORDED, DHT_FRAME_EDGES, DHT22, reading) == DHT_DECODE_OK;
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+
+    char line[96];
+    snprintf(line, sizeof(line), "decode(): %.0f ns per frame", ns);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_EQUAL(FRAMES, ok);
+    TEST_ASSERT_LESS_THAN(10000.0, ns);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_recorded_dht22_frame);
+    RUN_TEST(test_jitter_missing_response_and_wrap);
+    RUN_TEST(test_negative_temperature);
+    RUN_TEST(test_dht11_integer_bytes);
+    RUN_TEST(test_checksum_mismatch);
+    RUN_TEST(test_short_frame_and_no_response);
+    RUN_TEST(test_gap_in_the_bit_train_is_bad_timing);
+    RUN_TEST(test_benchmark_decode);
+    return UNITY_END();
+}
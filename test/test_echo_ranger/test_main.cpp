@@ -0,0 +1,152 @@
+/**
+ * @file test_main.cpp
+ * @brief EchoRanger state machine and median filter on a simulated echo (native)
+ *
+ * The simulated HC-SR04 turns a true distance into an echo width with
+ * the speed of sound at the air temperature, adds ±3 µs of timing noise
+ * and, on 5% of the pings, a short echo (multipath) at half the width;
+ * at most two of those fall in one window, which a median of
+ * ULTRASONIC_MEDIAN pings has to reject. The edges are fed to onEdge()
+ * as the ECHO interrupt would, with a spurious fall before the rise, and
+ * the ranger has the UltrasonicSensor settings from config.h.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include "config.h"
+#include "sensors/EchoRanger.h"
+
+static EchoRanger ranger;
+
+void setUp()
+{
+    ranger = EchoRanger();
+    ranger.begin(ULTRASONIC_MEDIAN, ULTRASONIC_MIN_DISTANCE, ULTRASONIC_MAX_DISTANCE, ULTRASONIC_TIMEOUT_US);
+}
+void tearDown() {}
+
+// One ping with the echo starting 450 µs after arm(); returns the width seen
+static uint32_t ping(uint32_t now, uint32_t width)
+{
+    uint32_t seen = 0;
+    ranger.arm(now);
+    TEST_ASSERT_EQUAL(ECHO_PENDING, ranger.collect(now + 100, seen));
+    TEST_ASSERT_FALSE(ranger.onEdge(false, now + 200)); // Fall before any rise: ignored
+    TEST_ASSERT_FALSE(ranger.onEdge(true, now + 450));
+    TEST_ASSERT_EQUAL(ECHO_HIGH, ranger.getState());
+    TEST_ASSERT_TRUE(ranger.onEdge(false, now + 450 + width));
+    TEST_ASSERT_EQUAL(ECHO_OK, ranger.collect(now + 460 + width, seen));
+    TEST_ASSERT_FALSE(ranger.isArmed());
+    return seen;
+}
+
+// ─── Filtering ──────────────────────────────────────────────────────────────
+
+void test_median_tracks_distance_through_outliers_at_any_temperature()
+{
+    std::mt19937 rng(3);
+    std::normal_distribution<float> jitter(0, 3);
+    std::uniform_real_distribution<float> chance(0, 1);
+    int medianOff = 0, rawOff = 0, total = 0;
+    double worstMedian = 0;
+
+    for (float celsius : {-10.0f, 0.0f, 20.0f, 35.0f})
+    {
+        setUp();
+        ranger.setTemperature(celsius);
+        int outliers[2] = {-ULTRASONIC_MEDIAN, -ULTRASONIC_MEDIAN}; // Latest two
+        float speed = 331.3f + 0.606f * celsius; // m/s
+        TEST_ASSERT_FLOAT_WITHIN(0.05, speed, ranger.getSoundSpeed());
+
+        uint32_t now = 1000;
+        for (int i = 0; i < 400; i++, now += ULTRASONIC_POLL_INTERVAL * 1000)
+        {
+            // A target drifting between 50 and 250 cm
+            float trueCm = 150 + 100 * sinf(i * 0.002f);
+            uint32_t width = (uint32_t)(2 * trueCm / (speed * 1e-4f) + jitter(rng));
+            if (chance(rng) < 0.05f && i - outliers[0] >= ULTRASONIC_MEDIAN)
+            {
+                width /= 2;
+                outliers[0] = outliers[1];
+                outliers[1] = i;
+            }
+
+            uint32_t seen = ping(now, width);
+            TEST_ASSERT_EQUAL(width, seen);
+            TEST_ASSERT_TRUE(ranger.addEcho(seen));
+
+            if (i >= ULTRASONIC_MEDIAN)
+            {
+                float error = fabsf(ranger.getDistance() - trueCm);
+                worstMedian = fmax(worstMedian, error);
+                medianOff += error > 2;
+                rawOff += fabsf(ranger.toDistance(seen) - trueCm) > 2;
+                total++;
+            }
+        }
+    }
+
+    char line[128];
+    snprintf(line, sizeof(line), "pings off by > 2 cm: median %d, single ping %d of %d; worst median error %.2f cm",
+             medianOff, rawOff, total, worstMedian);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_EQUAL(0, medianOff);
+    TEST_ASSERT_GREATER_THAN(total / 40, rawOff); // The outliers were there
+    TEST_ASSERT_LESS_THAN(1.0, worstMedian);
+}
+
+void test_out_of_range_width_is_rejected()
+{
+    TEST_ASSERT_FALSE(ranger.addEcho(30000)); // ~5 m
+    TEST_ASSERT_FALSE(ranger.addEcho(50));    // < 1 cm
+    TEST_ASSERT_EQUAL(2, ranger.getRejected());
+    TEST_ASSERT_EQUAL(0, ranger.getCount());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, ranger.getDistance());
+
+    TEST_ASSERT_TRUE(ranger.addEcho(5830)); // ~1 m at 20 °C
+    TEST_ASSERT_FLOAT_WITHIN(0.5, 100, ranger.getDistance());
+}
+
+// ─── State machine ──────────────────────────────────────────────────────────
+
+void test_timeouts()
+{
+    uint32_t width;
+
+    // No echo at all: the sensor is missing or unpowered
+    ranger.arm(0);
+    TEST_ASSERT_EQUAL(ECHO_PENDING, ranger.collect(ULTRASONIC_TIMEOUT_US - 1, width));
+    TEST_ASSERT_EQUAL(ECHO_NO_RESPONSE, ranger.collect(ULTRASONIC_TIMEOUT_US, width));
+
+    // Echo started but never ended: nothing in range
+    ranger.arm(0);
+    ranger.onEdge(true, 400);
+    TEST_ASSERT_EQUAL(ECHO_NO_END, ranger.collect(ULTRASONIC_TIMEOUT_US + 1, width));
+
+    // The fall arriving after the timeout belongs to no ping
+    TEST_ASSERT_FALSE(ranger.onEdge(false, 38000));
+    TEST_ASSERT_EQUAL(ECHO_NOT_ARMED, ranger.collect(40000, width));
+}
+
+void test_echo_across_the_micros_wrap()
+{
+    uint32_t width = 0;
+    ranger.arm(0xFFFFFF00u);
+    ranger.onEdge(true, 0xFFFFFFF0u);
+    TEST_ASSERT_TRUE(ranger.onEdge(false, 1000));
+    TEST_ASSERT_EQUAL(ECHO_OK, ranger.collect(1100, width));
+    TEST_ASSERT_EQUAL(1016, width);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_median_tracks_distance_through_outliers_at_any_temperature);
+    RUN_TEST(test_out_of_range_width_is_rejected);
+    RUN_TEST(test_timeouts);
+    RUN_TEST(test_echo_across_the_micros_wrap);
+    return UNITY_END();
+}
@@ -0,0 +1,147 @@
+/**
+ * @file test_main.cpp
+ * @brief MadgwickFilter accuracy on synthesized IMU traces, and its cost (native)
+ *
+ * The traces are generated from a known attitude: roll and pitch follow
+ * slow sine waves, the gyro gets the matching body rates and the
+ * accelerometer the gravity vector in the body frame, both with white
+ * noise and the gyro with a constant bias. The filter runs at the rate
+ * and gain MPU6050Sensor uses.
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include "config.h"
+#include "sensors/MadgwickFilter.h"
+
+static const float RATE_HZ = 1000.0f / MPU_POLL_INTERVAL;
+static const float DEG = 180.0f / (float)M_PI;
+
+static MadgwickFilter filter;
+
+void setUp() { filter.begin(RATE_HZ, MPU_FUSION_BETA); }
+void tearDown() {}
+
+// Gravity as the accelerometer sees it at roll r, pitch p (radians, yaw 0)
+static void gravity(float r, float p, float &ax, float &ay, float &az)
+{
+    ax = -sinf(p);
+    ay = sinf(r) * cosf(p);
+    az = cosf(r) * cosf(p);
+}
+
+// ─── Accuracy ───────────────────────────────────────────────────────────────
+
+void test_first_sample_seeds_roll_and_pitch()
+{
+    float r = 0.5f, p = -0.3f, ax, ay, az;
+    gravity(r, p, ax, ay, az);
+    filter.update(0, 0, 0, ax, ay, az);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.2, r * DEG, filter.getRoll());
+    TEST_ASSERT_FLOAT_WITHIN(0.2, p * DEG, filter.getPitch());
+    TEST_ASSERT_FLOAT_WITHIN(0.1, 0, filter.getYaw());
+    TEST_ASSERT_EQUAL(1, filter.getSampleCount());
+}
+
+void test_static_tilt_holds()
+{
+    float ax, ay, az;
+    gravity(0, 0.3f, ax, ay, az);
+    for (int i = 0; i < 2 * RATE_HZ; i++)
+        filter.update(0, 0, 0, ax, ay, az);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.05, 0.3f * DEG, filter.getPitch());
+    TEST_ASSERT_FLOAT_WITHIN(0.05, 0, filter.getRoll());
+
+    float w, x, y, z;
+    filter.getQuaternion(w, x, y, z);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5, 1.0f, w * w + x * x + y * y + z * z);
+}
+
+void test_tracks_a_moving_attitude_with_noise_and_bias()
+{
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0, 1);
+    const float dt = 1.0f / RATE_HZ;
+    double sumError = 0, maxError = 0;
+    int count = 0;
+
+    // Roll ±40° at 0.5 rad/s, pitch ±25° at 0.3 rad/s, for two minutes
+    for (int i = 0; i < 120 * RATE_HZ; i++)
+    {
+        float t = i * dt;
+        float r = 40 / DEG * sinf(0.5f * t), p = 25 / DEG * sinf(0.3f * t + 1);
+        float rDot = 40 / DEG * 0.5f * cosf(0.5f * t), pDot = 25 / DEG * 0.3f * cosf(0.3f * t + 1);
+
+        float gx = rDot + 0.01f * noise(rng) + 0.005f;
+        float gy = cosf(r) * pDot + 0.01f * noise(rng) - 0.003f;
+        float gz = -sinf(r) * pDot + 0.01f * noise(rng);
+        float ax, ay, az;
+        gravity(r, p, ax, ay, az);
+        filter.update(gx, gy, gz, ax + 0.02f * noise(rng), ay + 0.02f * noise(rng), az + 0.02f * noise(rng));
+
+        if (t > 10) // Past the first sample's seed error settling
+        {
+            double error = fmax(fabs(filter.getRoll() - r * DEG), fabs(filter.getPitch() - p * DEG));
+            maxError = fmax(maxError, error);
+            sumError += error;
+            count++;
+        }
+    }
+
+    char line[96];
+    snprintf(line, sizeof(line), "roll/pitch error over 110 s: mean %.2f°, max %.2f°", sumError / count, maxError);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_LESS_THAN(0.5, sumError / count);
+    TEST_ASSERT_LESS_THAN(2.0, maxError);
+}
+
+void test_reset_starts_from_the_next_sample()
+{
+    float ax, ay, az;
+    gravity(0.4f, 0, ax, ay, az);
+    for (int i = 0; i < 100; i++)
+        filter.update(0.2f, 0, 0, ax, ay, az);
+
+    filter.reset();
+    TEST_ASSERT_EQUAL(0, filter.getSampleCount());
+    gravity(-0.2f, 0.1f, ax, ay, az);
+    filter.update(0, 0, 0, ax, ay, az);
+    TEST_ASSERT_FLOAT_WITHIN(0.2, -0.2f * DEG, filter.getRoll());
+    TEST_ASSERT_FLOAT_WITHIN(0.2, 0.1f * DEG, filter.getPitch());
+}
+
+// ─── Benchmark ──────────────────────────────────────────────────────────────
+
+void test_benchmark_update()
+{
+    const int SAMPLES = 2000000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < SAMPLES; i++)
+        filter.update(0.01f, 0.02f, -0.01f, 0.1f, 0.05f, 0.99f);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / SAMPLES;
+
+    char line[96];
+    snprintf(line, sizeof(line), "update(): %.1f ns per sample", ns);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_FALSE(isnan(filter.getRoll()));
+    TEST_ASSERT_LESS_THAN(2000.0, ns);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_sample_seeds_roll_and_pitch);
+    RUN_TEST(test_static_tilt_holds);
+    RUN_TEST(test_tracks_a_moving_attitude_with_noise_and_bias);
+    RUN_TEST(test_reset_starts_from_the_next_sample);
+    RUN_TEST(test_benchmark_update);
+    return UNITY_END();
+}
@@ -0,0 +1,172 @@
+/**
+ * @file test_main.cpp
+ * @brief MetricsRegistry text exposition through a Print (native)
+ *
+ * Each registry is rendered into a FixedBufferPrint and compared with
+ * the exposition text Prometheus expects. The last test streams a
+ * histogram one line per call, as /metrics does per chunk, while another
+ * thread keeps observing: the buckets must stay cumulative and +Inf must
+ * equal _count in every rendering.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <atomic>
+#include <stdlib.h>
+#include <thread>
+#include "utils/Metrics.h"
+#include "utils/ResponseWriter.h"
+
+static const float LATENCY_BUCKETS[] = {0.005f, 0.05f, 0.5f};
+
+static double readTemperature() { return 21.25; }
+static double readMissing() { return NAN; }
+
+void setUp() {}
+void tearDown() {}
+
+// ─── Exposition ─────────────────────────────────────────────────────────────
+
+void test_counters_and_gauges()
+{
+    MetricsRegistry registry;
+    Counter requests;
+    Gauge clients;
+    requests.inc(41);
+    requests.inc();
+    clients.set(-3);
+    registry.addCounter("requests_total", "Requests handled", requests);
+    registry.addGauge("clients", "Connected clients", clients);
+    registry.addGauge("temperature_celsius", "Board temperature", readTemperature);
+    registry.addGauge("rssi_dbm", "WiFi signal strength", readMissing);
+
+    char buffer[512];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    registry.render(out);
+
+    TEST_ASSERT_EQUAL_STRING("# HELP esp32_requests_total Requests handled\n"
+                             "# TYPE esp32_requests_total counter\n"
+                             "esp32_requests_total 42\n"
+                             "# HELP esp32_clients Connected clients\n"
+                             "# TYPE esp32_clients gauge\n"
+                             "esp32_clients -3\n"
+                             "# HELP esp32_temperature_celsius Board temperature\n"
+                             "# TYPE esp32_temperature_celsius gauge\n"
+                             "esp32_temperature_celsius 21.250000\n"
+                             "# HELP esp32_rssi_dbm WiFi signal strength\n"
+                             "# TYPE esp32_rssi_dbm gauge\n"
+                             "esp32_rssi_dbm NaN\n",
+                             buffer);
+}
+
+void test_histogram()
+{
+    MetricsRegistry registry;
+    Histogram latency(LATENCY_BUCKETS, 3);
+    for (float value : {0.001f, 0.005f, 0.02f, 0.3f, 0.4f, 2.0f})
+        latency.observe(value);
+    registry.addHistogram("cycle_seconds", "Cycle time", latency);
+
+    char buffer[512];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    registry.render(out);
+
+    TEST_ASSERT_EQUAL_STRING("# HELP esp32_cycle_seconds Cycle time\n"
+                             "# TYPE esp32_cycle_seconds histogram\n"
+                             "esp32_cycle_seconds_bucket{le=\"0.005000\"} 2\n"
+                             "esp32_cycle_seconds_bucket{le=\"0.050000\"} 3\n"
+                             "esp32_cycle_seconds_bucket{le=\"0.500000\"} 5\n"
+                             "esp32_cycle_seconds_bucket{le=\"+Inf\"} 6\n"
+                             "esp32_cycle_seconds_sum 2.726000\n"
+                             "esp32_cycle_seconds_count 6\n",
+                             buffer);
+}
+
+void test_cursor_writes_one_line_per_call()
+{
+    MetricsRegistry registry;
+    Counter counter;
+    Histogram latency(LATENCY_BUCKETS, 3);
+    registry.addCounter("a_total", "A", counter);
+    registry.addHistogram("b_seconds", "B", latency);
+
+    MetricsCursor cursor(registry);
+    int lines = 0;
+    char line[METRICS_LINE_SIZE];
+    for (;;)
+    {
+        FixedBufferPrint out(line, sizeof(line));
+        if (!cursor.next(out))
+            break;
+        lines++;
+        TEST_ASSERT_EQUAL_PTR(line + out.length() - 1, strchr(line, '\n')); // One, at the end
+    }
+    TEST_ASSERT_EQUAL(3 + 2 + 4 + 2, lines); // Counter, then buckets + +Inf + _sum + _count
+}
+
+void test_registry_full_is_refused()
+{
+    MetricsRegistry registry;
+    Counter counter;
+    for (int i = 0; i < METRICS_MAX; i++)
+        TEST_ASSERT_TRUE(registry.addCounter("c_total", "C", counter));
+    TEST_ASSERT_FALSE(registry.addCounter("c_total", "C", counter));
+    TEST_ASSERT_EQUAL(METRICS_MAX, registry.getCount());
+}
+
+// ─── Concurrency ────────────────────────────────────────────────────────────
+
+void test_histogram_lines_agree_while_observed()
+{
+    MetricsRegistry registry;
+    Histogram latency(LATENCY_BUCKETS, 3);
+    registry.addHistogram("cycle_seconds", "Cycle time", latency);
+
+    std::atomic<bool> running(true);
+    std::thread observer([&]
+                         {
+        uint32_t i = 0;
+        while (running)
+            latency.observe((i++ % 7) * 0.1f); });
+
+    int renderings = 0;
+    for (; renderings < 2000; renderings++)
+    {
+        uint32_t buckets[4], count = 0;
+        int bucket = 0;
+        MetricsCursor cursor(registry);
+        char line[METRICS_LINE_SIZE];
+        for (;;)
+        {
+            FixedBufferPrint out(line, sizeof(line));
+            if (!cursor.next(out))
+                break;
+            std::this_thread::yield(); // Next chunk callback, later
+            const char *value = strrchr(line, ' ') + 1;
+            if (strstr(line, "_bucket{"))
+                buckets[bucket++] = strtoul(value, nullptr, 10);
+            else if (strstr(line, "_count "))
+                count = strtoul(value, nullptr, 10);
+        }
+
+        TEST_ASSERT_EQUAL(4, bucket);
+        for (int b = 1; b < 4; b++)
+            TEST_ASSERT_GREATER_OR_EQUAL(buckets[b - 1], buckets[b]);
+        TEST_ASSERT_EQUAL(count, buckets[3]);
+    }
+
+    running = false;
+    observer.join();
+    TEST_ASSERT_GREATER_THAN(0, latency.getCount());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_counters_and_gauges);
+    RUN_TEST(test_histogram);
+    RUN_TEST(test_cursor_writes_one_line_per_call);
+    RUN_TEST(test_registry_full_is_refused);
+    RUN_TEST(test_histogram_lines_agree_while_observed);
+    return UNITY_END();
+}
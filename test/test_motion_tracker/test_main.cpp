@@ -0,0 +1,239 @@
+/**
+ * @file test_main.cpp
+ * @brief PIR edge bursts through MotionTracker and PIRSensor (native)
+ *
+ * The tracker tests replay edge sequences through the same SPSC ring the
+ * PIR interrupt fills, with the ring's real depth (PIR_EDGE_QUEUE), so
+ * overflow and resync are exercised as on the device; each runs once
+ * from a small timestamp and once across the 32-bit µs wrap. The
+ * PIRSensor tests raise edges through the host attachInterruptArg() on
+ * the virtual clock. The last test pushes edges from a second thread,
+ * as the ISR does on the other core.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <thread>
+#include "sensors/MotionTracker.h"
+#include "sensors/PIRSensor.h"
+#include "utils/SpscQueue.h"
+
+static const uint32_t DEBOUNCE_US = 1000000;
+static const uint32_t HOLD_US = (uint32_t)PIR_HOLD_TIME * 1000;
+static const uint32_t WRAP_START = 0xFFFFFFFFu - 1500000u;
+
+// The PIR interrupt and the sampler's update(), without the hardware
+struct SimulatedPIR
+{
+    SpscQueue<MotionEdge, PIR_EDGE_QUEUE> ring;
+    uint32_t overflows = 0;
+    bool pin = false;
+    MotionTracker tracker;
+
+    explicit SimulatedPIR(uint32_t startUs) { tracker.begin(DEBOUNCE_US, HOLD_US, false, startUs); }
+
+    void edge(uint32_t us, bool level)
+    {
+        pin = level;
+        if (!ring.push({us, (uint8_t)level}))
+            overflows++;
+    }
+
+    uint8_t poll(uint32_t nowUs)
+    {
+        uint8_t events = MOTION_NONE;
+        while (const MotionEdge *e = ring.front())
+        {
+            events |= tracker.onEdge(*e);
+            ring.pop();
+        }
+        return events | tracker.update(pin, nowUs);
+    }
+};
+
+static int callbacks;
+static void onMotion(void *) { callbacks++; }
+
+void setUp()
+{
+    host::resetClock(1000000);
+    host::pinLevel[PIR_PIN] = LOW;
+    callbacks = 0;
+}
+void tearDown() {}
+
+// ─── MotionTracker ──────────────────────────────────────────────────────────
+
+static void chatterGivesOneStart(uint32_t base)
+{
+    SimulatedPIR pir(base);
+    uint32_t t = base + 1000;
+
+    // 30 edges in 30 ms on a long lead: more than the ring holds
+    for (int i = 0; i < 30; i++)
+        pir.edge(t + i * 1000, i % 2 == 0);
+
+    TEST_ASSERT_EQUAL(MOTION_STARTED, pir.poll(t + 31000));
+    TEST_ASSERT_TRUE(pir.tracker.isOccupied());
+    TEST_ASSERT_EQUAL(30 - PIR_EDGE_QUEUE, pir.overflows);
+    TEST_ASSERT_EQUAL(1, pir.tracker.getTriggers()); // The rest were bounces
+}
+
+void test_chatter_gives_one_start()
+{
+    chatterGivesOneStart(1000);
+    chatterGivesOneStart(WRAP_START);
+}
+
+static void holdTimeAndRetrigger(uint32_t base)
+{
+    SimulatedPIR pir(base);
+    uint32_t t = base + 1000;
+    pir.edge(t, true);
+    TEST_ASSERT_EQUAL(MOTION_STARTED, pir.poll(t + 100));
+
+    // Retrigger while occupied: counted, but no second start
+    pir.edge(t + 100000, false);
+    pir.edge(t + 1500000, true);
+    TEST_ASSERT_EQUAL(MOTION_NONE, pir.poll(t + 1500100));
+    TEST_ASSERT_EQUAL(2, pir.tracker.getTriggers());
+
+    // Output low, hold not yet elapsed
+    pir.edge(t + 3000000, false);
+    TEST_ASSERT_EQUAL(MOTION_NONE, pir.poll(t + 3000000 + HOLD_US - 1000));
+
+    // A brief rise inside the hold restarts it
+    pir.edge(t + 4500000, true);
+    pir.edge(t + 4600000, false);
+    TEST_ASSERT_EQUAL(MOTION_NONE, pir.poll(t + 4600000 + HOLD_US - 1000));
+    TEST_ASSERT_TRUE(pir.tracker.isOccupied());
+    TEST_ASSERT_EQUAL(MOTION_ENDED, pir.poll(t + 4600000 + HOLD_US));
+    TEST_ASSERT_FALSE(pir.tracker.isOccupied());
+    TEST_ASSERT_EQUAL(MOTION_NONE, pir.poll(t + 9000000));
+}
+
+void test_hold_time_and_retrigger()
+{
+    holdTimeAndRetrigger(1000);
+    holdTimeAndRetrigger(WRAP_START);
+}
+
+void test_lost_edges_resync_with_the_pin()
+{
+    SimulatedPIR pir(1000);
+    uint32_t t = 2000000;
+    pir.edge(t, true);
+    TEST_ASSERT_EQUAL(MOTION_STARTED, pir.poll(t + 100));
+
+    // The pin fell but its edge never reached the ring: the tracker waits
+    // for a debounce time without edges, then follows the pin
+    pir.pin = false;
+    TEST_ASSERT_EQUAL(MOTION_NONE, pir.poll(t + DEBOUNCE_US / 2));
+    TEST_ASSERT_TRUE(pir.tracker.isHigh());
+    TEST_ASSERT_EQUAL(MOTION_NONE, pir.poll(t + DEBOUNCE_US));
+    TEST_ASSERT_FALSE(pir.tracker.isHigh());
+    TEST_ASSERT_EQUAL(1, pir.tracker.getResyncs());
+
+    // The hold runs from the resync
+    TEST_ASSERT_EQUAL(MOTION_ENDED, pir.poll(t + DEBOUNCE_US + HOLD_US));
+
+    // Same for a lost rise: a start, without waiting for another edge
+    pir.pin = true;
+    TEST_ASSERT_EQUAL(MOTION_STARTED, pir.poll(t + DEBOUNCE_US + HOLD_US + 1000));
+    TEST_ASSERT_EQUAL(2, pir.tracker.getResyncs());
+}
+
+// ─── PIRSensor ──────────────────────────────────────────────────────────────
+
+void test_sensor_high_at_boot_reports_the_start()
+{
+    host::pinLevel[PIR_PIN] = HIGH;
+    PIRSensor pir(PIR_PIN);
+    TEST_ASSERT_TRUE(pir.begin());
+
+    TEST_ASSERT_TRUE(pir.isMotionDetected());
+    TEST_ASSERT_EQUAL(millis(), pir.getLastMotionTime());
+    TEST_ASSERT_EQUAL(1, pir.getTriggers());
+
+    // The first update() reports it, so subscribers hear about it once
+    host::advanceMillis(10);
+    TEST_ASSERT_EQUAL(MOTION_STARTED, pir.update());
+    TEST_ASSERT_EQUAL(MOTION_NONE, pir.update());
+}
+
+void test_sensor_edges_through_the_interrupt()
+{
+    PIRSensor pir(PIR_PIN);
+    pir.setMotionCallback(onMotion, nullptr);
+    TEST_ASSERT_TRUE(pir.begin());
+    TEST_ASSERT_EQUAL(MOTION_NONE, pir.update());
+    TEST_ASSERT_EQUAL(0, pir.getLastMotionTime());
+
+    host::advanceMillis(500);
+    uint32_t risenAt = millis();
+    for (int i = 0; i < 6; i++) // Rise plus bounces, ending high
+    {
+        host::setPin(PIR_PIN, i % 2 == 0 ? HIGH : LOW);
+        host::advanceMillis(2);
+    }
+    TEST_ASSERT_EQUAL(6, callbacks);
+    TEST_ASSERT_EQUAL(MOTION_STARTED, pir.update());
+    TEST_ASSERT_EQUAL(risenAt, pir.getLastMotionTime());
+
+    host::setPin(PIR_PIN, LOW);
+    host::advanceMillis(PIR_HOLD_TIME);
+    TEST_ASSERT_EQUAL(MOTION_ENDED, pir.update());
+    TEST_ASSERT_FALSE(pir.isMotionDetected());
+    TEST_ASSERT_EQUAL(0, pir.getOverflows());
+}
+
+// ─── Threads ────────────────────────────────────────────────────────────────
+
+void test_edges_from_another_thread_arrive_once_in_order()
+{
+    SpscQueue<MotionEdge, PIR_EDGE_QUEUE> ring;
+    MotionTracker tracker;
+    tracker.begin(0, 0, false, 0);
+    const uint32_t EDGES = 200000;
+
+    std::thread isr([&]
+                    {
+        for (uint32_t i = 1; i <= EDGES; i++)
+        {
+            while (!ring.push({i, (uint8_t)(i & 1)}))
+                std::this_thread::yield();
+        } });
+
+    uint32_t last = 0, seen = 0;
+    bool inOrder = true;
+    while (seen < EDGES)
+    {
+        const MotionEdge *edge = ring.front();
+        if (!edge)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        inOrder &= edge->timeUs == last + 1;
+        last = edge->timeUs;
+        tracker.onEdge(*edge);
+        ring.pop();
+        seen++;
+    }
+    isr.join();
+
+    TEST_ASSERT_TRUE(inOrder);
+    TEST_ASSERT_EQUAL(EDGES / 2, tracker.getTriggers());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_chatter_gives_one_start);
+    RUN_TEST(test_hold_time_and_retrigger);
+    RUN_TEST(test_lost_edges_resync_with_the_pin);
+    RUN_TEST(test_sensor_high_at_boot_reports_the_start);
+    RUN_TEST(test_sensor_edges_through_the_interrupt);
+    RUN_TEST(test_edges_from_another_thread_arrive_once_in_order);
+    return UNITY_END();
+}
@@ -0,0 +1,146 @@
+/**
+ * @file test_main.cpp
+ * @brief MQ135 gas-curve tables against the analytic formula (native)
+ *
+ * The reference is the analytic curve MQ135Sensor::calculatePPM keeps,
+ * PPM = a * (Rs / R0)^b with Rs from calculateResistance(), evaluated
+ * with powf per gas. mq135Evaluate() has to stay within the error bounds
+ * documented in MQ135Curves.h over each raw range, and be faster than
+ * five powf calls. The factors are computed as calibrateR0() does.
+ *
+ * The LDR lux conversion has no table to check: it reduces to a straight
+ * line in the raw value (see LDRSensor::calculateLux).
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include "sensors/MQ135Curves.h"
+
+static_assert(MQ135_TABLE.values[MQ135_NH3][MQ135_TABLE_SIZE / 2] > 0.0f, "MQ135 table is built at compile time");
+
+static const float R0 = 15.0f; // kΩ, a typical clean-air value
+
+static float factors[MQ135_GAS_COUNT];
+
+void setUp()
+{
+    for (int g = 0; g < MQ135_GAS_COUNT; g++)
+        factors[g] = MQ135_CURVES[g].a * powf(R0, -MQ135_CURVES[g].b);
+}
+void tearDown() {}
+
+static float analyticPPM(float raw, int gas)
+{
+    float vout = raw * 3.3f / 4095.0f;
+    float rs = MQ135_LOAD_KOHM * (3.3f - vout) / vout;
+    return MQ135_CURVES[gas].a * powf(rs / R0, MQ135_CURVES[gas].b);
+}
+
+// Worst relative error of the table over [low, high], in quarter counts
+static double worstError(float low, float high)
+{
+    double worst = 0;
+    for (float raw = low; raw <= high; raw += 0.25f)
+    {
+        float ppm[MQ135_GAS_COUNT];
+        mq135Evaluate(raw, factors, ppm);
+        for (int g = 0; g < MQ135_GAS_COUNT; g++)
+            worst = fmax(worst, fabs(ppm[g] / analyticPPM(raw, g) - 1));
+    }
+    return worst;
+}
+
+// ─── Accuracy ───────────────────────────────────────────────────────────────
+
+void test_error_bounds_over_the_adc_range()
+{
+    double wide = worstError(200, 3895), mid = worstError(400, 3695), rails = worstError(50, 4045);
+
+    char line[128];
+    snprintf(line, sizeof(line), "worst error: raw 400-3695 %.3f%%, 200-3895 %.3f%%, 50-4045 %.2f%%",
+             mid * 100, wide * 100, rails * 100);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_LESS_THAN(0.001, mid);
+    TEST_ASSERT_LESS_THAN(0.003, wide);
+    TEST_ASSERT_LESS_THAN(0.05, rails);
+}
+
+void test_table_nodes_are_exact()
+{
+    // On a node the interpolation adds nothing: only float rounding is left
+    for (int i = 8; i < MQ135_TABLE_SIZE - 8; i += 16)
+    {
+        float raw = i * MQ135_TABLE_STEP, ppm[MQ135_GAS_COUNT];
+        mq135Evaluate(raw, factors, ppm);
+        for (int g = 0; g < MQ135_GAS_COUNT; g++)
+            TEST_ASSERT_FLOAT_WITHIN(1e-4 * analyticPPM(raw, g), analyticPPM(raw, g), ppm[g]);
+    }
+}
+
+void test_ppm_rises_with_the_reading_and_stays_finite()
+{
+    // A higher reading is a lower Rs; every exponent is negative, so PPM rises
+    float previous[MQ135_GAS_COUNT];
+    mq135Evaluate(-5.0f, factors, previous); // Clamped to 0
+    for (int g = 0; g < MQ135_GAS_COUNT; g++)
+        TEST_ASSERT_TRUE(isfinite(previous[g]));
+
+    for (float raw = 1; raw <= 4100; raw += 1)
+    {
+        float ppm[MQ135_GAS_COUNT];
+        mq135Evaluate(raw, factors, ppm);
+        for (int g = 0; g < MQ135_GAS_COUNT; g++)
+        {
+            TEST_ASSERT_TRUE(isfinite(ppm[g]));
+            TEST_ASSERT_GREATER_OR_EQUAL(previous[g], ppm[g]);
+            previous[g] = ppm[g];
+        }
+    }
+}
+
+// ─── Benchmark ──────────────────────────────────────────────────────────────
+
+void test_benchmark_all_gases()
+{
+    const int READINGS = 1000000;
+    volatile float sink;
+    float ppm[MQ135_GAS_COUNT];
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < READINGS; i++)
+    {
+        float raw = 200 + i % 3600;
+        for (int g = 0; g < MQ135_GAS_COUNT; g++)
+            sink = analyticPPM(raw, g);
+    }
+    double analyticNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / READINGS;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < READINGS; i++)
+    {
+        mq135Evaluate(200 + i % 3600, factors, ppm);
+        sink = ppm[MQ135_SMOKE];
+    }
+    double tableNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / READINGS;
+    (void)sink;
+
+    char line[128];
+    snprintf(line, sizeof(line), "five gases per reading: powf %.1f ns, table %.1f ns (%.1fx), table %u bytes",
+             analyticNs, tableNs, analyticNs / tableNs, (unsigned)sizeof(MQ135_TABLE));
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_LESS_THAN(analyticNs / 2, tableNs);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_error_bounds_over_the_adc_range);
+    RUN_TEST(test_table_nodes_are_exact);
+    RUN_TEST(test_ppm_rises_with_the_reading_and_stays_finite);
+    RUN_TEST(test_benchmark_all_gases);
+    return UNITY_END();
+}
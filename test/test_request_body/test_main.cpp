@@ -0,0 +1,164 @@
+/**
+ * @file test_main.cpp
+ * @brief RequestBody reassembly of bodies split over TCP chunks (native)
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "core/RequestBody.h"
+
+static const char BODY[] = "{\"actuator\":\"rgb\",\"r\":255,\"g\":128,\"b\":0,\"note\":\"split me\"}";
+static const size_t BODY_LEN = sizeof(BODY) - 1;
+
+void setUp() {}
+void tearDown() {}
+
+// Feed BODY in chunks at the given cut points, like AsyncWebServer does
+static void feed(AsyncWebServerRequest &request, const size_t *cuts, size_t cutCount,
+                 size_t limit = HTTP_MAX_BODY_SIZE)
+{
+    size_t start = 0;
+    for (size_t i = 0; i <= cutCount; i++)
+    {
+        size_t end = i < cutCount ? cuts[i] : BODY_LEN;
+        // Chunks are not NUL-terminated: copy into a buffer with trailing junk
+        uint8_t chunk[sizeof(BODY) + 8];
+        memcpy(chunk, BODY + start, end - start);
+        memset(chunk + (end - start), 'X', 8);
+        RequestBody::collectUpTo(&request, chunk, end - start, start, BODY_LEN, limit);
+        start = end;
+    }
+}
+
+void test_single_chunk()
+{
+    AsyncWebServerRequest request;
+    feed(request, nullptr, 0);
+
+    size_t length;
+    const char *body = RequestBody::require(&request, length);
+    TEST_ASSERT_NOT_NULL(body);
+    TEST_ASSERT_EQUAL(BODY_LEN, length);
+    TEST_ASSERT_EQUAL_STRING(BODY, body);
+    TEST_ASSERT_EQUAL(0, request.responses);
+}
+
+void test_every_two_way_split()
+{
+    for (size_t cut = 1; cut < BODY_LEN; cut++)
+    {
+        AsyncWebServerRequest request;
+        feed(request, &cut, 1);
+
+        size_t length;
+        const char *body = RequestBody::require(&request, length);
+        TEST_ASSERT_NOT_NULL(body);
+        TEST_ASSERT_EQUAL(BODY_LEN, length);
+        TEST_ASSERT_EQUAL_STRING(BODY, body);
+    }
+}
+
+void test_many_small_chunks()
+{
+    size_t cuts[BODY_LEN - 1];
+    for (size_t i = 0; i < BODY_LEN - 1; i++)
+        cuts[i] = i + 1; // One byte per chunk
+
+    AsyncWebServerRequest request;
+    feed(request, cuts, BODY_LEN - 1);
+
+    size_t length;
+    TEST_ASSERT_EQUAL_STRING(BODY, RequestBody::require(&request, length));
+}
+
+void test_partial_body_is_rejected()
+{
+    AsyncWebServerRequest request;
+    RequestBody::collect(&request, (uint8_t *)BODY, 10, 0, BODY_LEN);
+    TEST_ASSERT_EQUAL(RequestBody::BODY_PARTIAL, RequestBody::getStatus(&request));
+
+    size_t length;
+    TEST_ASSERT_NULL(RequestBody::require(&request, length));
+    TEST_ASSERT_EQUAL(400, request.sentCode);
+    TEST_ASSERT_EQUAL(0, length);
+}
+
+void test_missing_body_is_rejected()
+{
+    AsyncWebServerRequest request;
+    size_t length;
+    TEST_ASSERT_NULL(RequestBody::require(&request, length));
+    TEST_ASSERT_EQUAL(400, request.sentCode);
+}
+
+void test_over_limit_is_rejected()
+{
+    AsyncWebServerRequest request;
+    size_t cut = 16;
+    feed(request, &cut, 1, BODY_LEN - 1);
+
+    TEST_ASSERT_EQUAL(RequestBody::BODY_TOO_LARGE, RequestBody::getStatus(&request));
+    size_t length;
+    TEST_ASSERT_NULL(RequestBody::require(&request, length));
+    TEST_ASSERT_EQUAL(413, request.sentCode);
+}
+
+void test_limit_is_inclusive()
+{
+    AsyncWebServerRequest request;
+    feed(request, nullptr, 0, BODY_LEN);
+    TEST_ASSERT_EQUAL(RequestBody::BODY_COMPLETE, RequestBody::getStatus(&request));
+}
+
+void test_out_of_order_chunk_is_rejected()
+{
+    AsyncWebServerRequest request;
+    RequestBody::collect(&request, (uint8_t *)BODY, 10, 0, BODY_LEN);
+    RequestBody::collect(&request, (uint8_t *)BODY + 20, 10, 20, BODY_LEN); // Gap
+
+    TEST_ASSERT_EQUAL(RequestBody::BODY_BAD_CHUNK, RequestBody::getStatus(&request));
+
+    // Later chunks do not revive it
+    RequestBody::collect(&request, (uint8_t *)BODY + 10, BODY_LEN - 10, 10, BODY_LEN);
+    TEST_ASSERT_EQUAL(RequestBody::BODY_BAD_CHUNK, RequestBody::getStatus(&request));
+
+    // Malformed, not oversize
+    size_t length;
+    TEST_ASSERT_NULL(RequestBody::require(&request, length));
+    TEST_ASSERT_EQUAL(400, request.sentCode);
+}
+
+void test_chunk_past_content_length_is_rejected()
+{
+    AsyncWebServerRequest request;
+    RequestBody::collect(&request, (uint8_t *)BODY, 10, 0, 12);
+    RequestBody::collect(&request, (uint8_t *)BODY + 10, 10, 10, 12);
+
+    TEST_ASSERT_EQUAL(RequestBody::BODY_BAD_CHUNK, RequestBody::getStatus(&request));
+    size_t length;
+    TEST_ASSERT_NULL(RequestBody::require(&request, length));
+    TEST_ASSERT_EQUAL(400, request.sentCode);
+}
+
+void test_chunk_without_start_is_ignored()
+{
+    AsyncWebServerRequest request;
+    RequestBody::collect(&request, (uint8_t *)BODY + 10, 10, 10, BODY_LEN);
+    TEST_ASSERT_EQUAL(RequestBody::BODY_MISSING, RequestBody::getStatus(&request));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_single_chunk);
+    RUN_TEST(test_every_two_way_split);
+    RUN_TEST(test_many_small_chunks);
+    RUN_TEST(test_partial_body_is_rejected);
+    RUN_TEST(test_missing_body_is_rejected);
+    RUN_TEST(test_over_limit_is_rejected);
+    RUN_TEST(test_limit_is_inclusive);
+    RUN_TEST(test_out_of_order_chunk_is_rejected);
+    RUN_TEST(test_chunk_past_content_length_is_rejected);
+    RUN_TEST(test_chunk_without_start_is_ignored);
+    return UNITY_END();
+}
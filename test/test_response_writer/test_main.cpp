@@ -0,0 +1,265 @@
+/**
+ * @file test_main.cpp
+ * @brief ResponseWriter output and String-building benchmark (native)
+ *
+ * The benchmark builds the actuator status document and the /debug/files
+ * page both ways: with String += as the handlers did before, and with
+ * ResponseWriter into a fixed buffer as they do now. The host String
+ * follows the Arduino core's exact-size reallocation, so the counts are
+ * what the ESP32 heap sees.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "utils/ResponseWriter.h"
+
+void setUp() { host::resetStringStats(); }
+void tearDown() {}
+
+// ─── Output ─────────────────────────────────────────────────────────────────
+
+void test_commas_between_members_and_elements()
+{
+    char buffer[128];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter json(out);
+
+    json.beginObject();
+    json.field("a", 1);
+    json.beginArray("b").value(true).value(false).endArray();
+    json.beginObject("c").endObject();
+    json.field("d", (const char *)nullptr);
+    json.endObject();
+
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":[true,false],\"c\":{},\"d\":null}", buffer);
+    TEST_ASSERT_FALSE(json.overflowed());
+}
+
+void test_escapes_json_and_html()
+{
+    char buffer[128];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter writer(out);
+
+    writer.beginObject().field("k", "a\"b\\c\n\x01").endObject();
+    writer.html("<a href='x'>&</a>");
+
+    TEST_ASSERT_EQUAL_STRING("{\"k\":\"a\\\"b\\\\c\\n\\u0001\"}"
+                             "&lt;a href=&#39;x&#39;&gt;&amp;&lt;/a&gt;",
+                             buffer);
+}
+
+void test_non_finite_numbers_are_null()
+{
+    char buffer[64];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter json(out);
+
+    json.beginArray().value(NAN).value(INFINITY).value(1.5, 1).endArray();
+    TEST_ASSERT_EQUAL_STRING("[null,null,1.5]", buffer);
+}
+
+void test_template_keeps_unknown_percent_signs()
+{
+    char buffer[128];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter html(out);
+    const TemplateVar vars[] = {{"NAME", "node-1"}, {"IP", "10.0.0.2"}};
+
+    html.writeTemplate("width:100%;%NAME% at %IP% %UNKNOWN% 5%", vars, 2);
+    TEST_ASSERT_EQUAL_STRING("width:100%;node-1 at 10.0.0.2 %UNKNOWN% 5%", buffer);
+}
+
+void test_fixed_buffer_truncates_and_flags()
+{
+    char buffer[8];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    out.print("0123456789");
+
+    TEST_ASSERT_TRUE(out.overflowed());
+    TEST_ASSERT_EQUAL(7, out.length());
+    TEST_ASSERT_EQUAL_STRING("0123456", buffer);
+}
+
+void test_nesting_past_max_depth_is_flagged()
+{
+    char buffer[256];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter json(out);
+
+    for (int i = 0; i < RESPONSE_WRITER_MAX_DEPTH + 4; i++)
+        json.beginArray().value(i);
+    for (int i = 0; i < RESPONSE_WRITER_MAX_DEPTH + 4; i++)
+        json.endArray();
+
+    TEST_ASSERT_TRUE(json.overflowed());
+}
+
+void test_max_depth_itself_is_fine()
+{
+    char buffer[256];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter json(out);
+
+    for (int i = 0; i < RESPONSE_WRITER_MAX_DEPTH; i++)
+        json.beginArray().value(i);
+    for (int i = 0; i < RESPONSE_WRITER_MAX_DEPTH; i++)
+        json.endArray();
+
+    TEST_ASSERT_FALSE(json.overflowed());
+    TEST_ASSERT_EQUAL_STRING("[0,[1,[2,[3,[4,[5,[6,[7]]]]]]]]", buffer);
+}
+
+// ─── Benchmark: String += versus ResponseWriter ────────────────────────────
+
+struct Cost
+{
+    uint32_t allocs;
+    uint32_t bytes;
+    size_t length;
+};
+
+static const char *FILES[] = {"/index.html", "/style.css", "/script.js", "/favicon.ico",
+                              "/temperature.svg", "/humidity.svg", "/pressure.svg",
+                              "/light.svg", "/motion.svg", "/settings.svg", "/camera.svg",
+                              "/config.json", "/data/log_0.csv", "/data/log_1.csv"};
+static const size_t FILE_COUNT = sizeof(FILES) / sizeof(FILES[0]);
+
+// The actuator status as ActuatorManager::getStatus() built it with String
+static Cost statusWithString()
+{
+    host::resetStringStats();
+    String status = "{\"actuators\":{";
+    status += "\"led\":" + String(true ? "true" : "false") + ",";
+    status += "\"buzzer\":" + String(false ? "true" : "false") + ",";
+    status += "\"motor\":{\"speed\":" + String(180) +
+              ",\"direction\":" + String(true ? "true" : "false") + "},";
+    status += "\"rgb\":{\"r\":" + String(255) + ",\"g\":" + String(128) +
+              ",\"b\":" + String(0) + ",\"brightness\":" + String(200) + "},";
+    status += "\"relays\":[";
+    for (int i = 1; i <= 3; i++)
+    {
+        status += String(i == 2 ? "true" : "false");
+        if (i < 3)
+            status += ",";
+    }
+    status += "],";
+    status += "\"servo\":" + String(90) + ",";
+    if (status.endsWith(","))
+        status = status.substring(0, status.length() - 1);
+    status += "}}";
+    return {host::stringAllocs, host::stringBytesCopied, status.length()};
+}
+
+static Cost statusWithWriter(char *buffer, size_t size)
+{
+    host::resetStringStats();
+    FixedBufferPrint out(buffer, size);
+    ResponseWriter json(out);
+    json.beginObject().beginObject("actuators");
+    json.field("led", true);
+    json.field("buzzer", false);
+    json.beginObject("motor").field("speed", 180).field("direction", true).endObject();
+    json.beginObject("rgb").field("r", 255).field("g", 128).field("b", 0).field("brightness", 200).endObject();
+    json.beginArray("relays");
+    for (int i = 1; i <= 3; i++)
+        json.value(i == 2);
+    json.endArray();
+    json.field("servo", 90);
+    json.endObject().endObject();
+    return {host::stringAllocs, host::stringBytesCopied + (uint32_t)out.length(), out.length()};
+}
+
+// The /debug/files page as the handler built it with String
+static Cost filesWithString()
+{
+    host::resetStringStats();
+    String response = "<!DOCTYPE html><html><head><title>SPIFFS Files</title>";
+    response += "<style>body {font-family: Arial, sans-serif; margin: 20px; background: #f5f5f5;}";
+    response += "h1 {color: #333;} ul {list-style-type: none; padding: 0;}";
+    response += "li {padding: 8px; margin: 5px 0; background: white; border-radius: 4px;}</style></head><body>";
+    response += "<h1>SPIFFS Files Debug</h1>";
+    response += "<p><strong>SPIFFS Status:</strong> Available</p>";
+    response += "<h2>All Files:</h2><ul>";
+    for (size_t i = 0; i < FILE_COUNT; i++)
+    {
+        String filePath = String(FILES[i]);
+        response += "<li><strong>" + filePath + "</strong> (" + String(1024 + (int)i * 37) + " bytes)";
+        response += " <a href='" + filePath + "' target='_blank'>Open</a></li>";
+    }
+    response += "</ul><p>Total files: " + String((int)FILE_COUNT) + "</p>";
+    response += "<hr><p><a href='/'>Back to Dashboard</a></p></body></html>";
+    return {host::stringAllocs, host::stringBytesCopied, response.length()};
+}
+
+static Cost filesWithWriter(char *buffer, size_t size)
+{
+    host::resetStringStats();
+    FixedBufferPrint out(buffer, size);
+    ResponseWriter html(out);
+    html.raw("<!DOCTYPE html><html><head><title>SPIFFS Files</title>");
+    html.raw("<style>body {font-family: Arial, sans-serif; margin: 20px; background: #f5f5f5;}");
+    html.raw("h1 {color: #333;} ul {list-style-type: none; padding: 0;}");
+    html.raw("li {padding: 8px; margin: 5px 0; background: white; border-radius: 4px;}</style></head><body>");
+    html.raw("<h1>SPIFFS Files Debug</h1>");
+    html.raw("<p><strong>SPIFFS Status:</strong> Available</p>");
+    html.raw("<h2>All Files:</h2><ul>");
+    for (size_t i = 0; i < FILE_COUNT; i++)
+    {
+        html.raw("<li><strong>").html(FILES[i]).raw("</strong> (");
+        out.print(1024 + (int)i * 37);
+        html.raw(" bytes) <a href='").html(FILES[i]).raw("' target='_blank'>Open</a></li>");
+    }
+    out.printf("</ul><p>Total files: %d</p>", (int)FILE_COUNT);
+    html.raw("<hr><p><a href='/'>Back to Dashboard</a></p></body></html>");
+    return {host::stringAllocs, host::stringBytesCopied + (uint32_t)out.length(), out.length()};
+}
+
+static void report(const char *name, const Cost &before, const Cost &after)
+{
+    char line[160];
+    snprintf(line, sizeof(line), "%-14s %5zu B   String: %3u allocs %6u B copied   writer: %u allocs %5u B copied",
+             name, after.length, before.allocs, before.bytes, after.allocs, after.bytes);
+    TEST_MESSAGE(line);
+}
+
+void test_benchmark_actuator_status()
+{
+    char buffer[384];
+    Cost before = statusWithString();
+    Cost after = statusWithWriter(buffer, sizeof(buffer));
+    report("status", before, after);
+
+    TEST_ASSERT_EQUAL(before.length, after.length);
+    TEST_ASSERT_EQUAL(0, after.allocs);
+    TEST_ASSERT_EQUAL(after.length, after.bytes); // Every byte written once
+    TEST_ASSERT_GREATER_THAN(after.bytes * 3, before.bytes);
+}
+
+void test_benchmark_debug_files()
+{
+    static char buffer[4096];
+    Cost before = filesWithString();
+    Cost after = filesWithWriter(buffer, sizeof(buffer));
+    report("/debug/files", before, after);
+
+    TEST_ASSERT_EQUAL(before.length, after.length);
+    TEST_ASSERT_EQUAL(0, after.allocs);
+    TEST_ASSERT_EQUAL(after.length, after.bytes);
+    TEST_ASSERT_GREATER_THAN(after.bytes * 5, before.bytes);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_commas_between_members_and_elements);
+    RUN_TEST(test_escapes_json_and_html);
+    RUN_TEST(test_non_finite_numbers_are_null);
+    RUN_TEST(test_template_keeps_unknown_percent_signs);
+    RUN_TEST(test_fixed_buffer_truncates_and_flags);
+    RUN_TEST(test_nesting_past_max_depth_is_flagged);
+    RUN_TEST(test_max_depth_itself_is_fine);
+    RUN_TEST(test_benchmark_actuator_status);
+    RUN_TEST(test_benchmark_debug_files);
+    return UNITY_END();
+}
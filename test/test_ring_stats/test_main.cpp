@@ -0,0 +1,195 @@
+/**
+ * @file test_main.cpp
+ * @brief RingStats against a naive recomputation of the window (native)
+ *
+ * Each property test pushes a long random stream and, after every push,
+ * compares size, sum, newest/oldest, minimum, maximum and variance with
+ * the same figures recomputed from a std::deque of the last N samples.
+ * The streams include a monotonic ramp (the worst case for the min/max
+ * deques) and floats (the case the periodic m2 recompute is there for).
+ * The benchmark compares push() with re-summing the buffer on every
+ * read, which is what the analog sensors did before.
+ */
+
+#include <unity.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "utils/RingStats.h"
+
+void setUp() { srand(1); }
+void tearDown() {}
+
+static uint16_t adcSample() { return rand() % 4096; }
+static uint16_t ramp()
+{
+    static uint16_t value = 0;
+    return value++;
+}
+static float noise() { return (rand() / (float)RAND_MAX - 0.5f) * 100.0f; }
+
+// Pushes count samples from next() and checks every statistic after each
+template <typename T, uint16_t N>
+static void checkAgainstNaive(int count, T (*next)())
+{
+    RingStats<T, N, true, true> stats;
+    std::deque<T> window;
+    double worstVarianceError = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        T x = next();
+        stats.push(x);
+        window.push_back(x);
+        if (window.size() > N)
+            window.pop_front();
+
+        double sum = 0;
+        for (T v : window)
+            sum += v;
+        double mean = sum / window.size();
+        double variance = 0;
+        for (T v : window)
+            variance += (v - mean) * (v - mean);
+        variance /= window.size();
+
+        TEST_ASSERT_EQUAL(window.size(), stats.size());
+        TEST_ASSERT_TRUE(window.back() == stats.newest());
+        TEST_ASSERT_TRUE(window.front() == stats.at(0));
+        TEST_ASSERT_TRUE(*std::min_element(window.begin(), window.end()) == stats.minimum());
+        TEST_ASSERT_TRUE(*std::max_element(window.begin(), window.end()) == stats.maximum());
+        TEST_ASSERT_FLOAT_WITHIN(1e-6 * fabs(sum) + 1e-9, sum, (double)stats.sum());
+        TEST_ASSERT_FLOAT_WITHIN(1e-4 * (fabs(mean) + 1), mean, stats.mean());
+        worstVarianceError = fmax(worstVarianceError, fabs(stats.variance() - variance) / (variance + 1));
+    }
+
+    char line[96];
+    snprintf(line, sizeof(line), "N=%u, %d pushes: worst variance error %.1e (relative)", N, count, worstVarianceError);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_LESS_THAN(1e-3, worstVarianceError);
+}
+
+// ─── Properties ─────────────────────────────────────────────────────────────
+
+void test_adc_samples_match_naive()
+{
+    checkAgainstNaive<uint16_t, 16>(200000, adcSample);
+    checkAgainstNaive<uint16_t, 64>(50000, adcSample);
+    checkAgainstNaive<uint16_t, 2>(1000, adcSample);
+}
+
+void test_monotonic_ramp_matches_naive()
+{
+    // Wraps uint16_t once: a rising ramp, one drop, then rising again
+    checkAgainstNaive<uint16_t, 16>(70000, ramp);
+}
+
+void test_float_samples_do_not_drift()
+{
+    checkAgainstNaive<float, 32>(100000, noise);
+}
+
+void test_partial_window_and_clear()
+{
+    RingStats<uint16_t, 8, true, true> stats;
+    TEST_ASSERT_EQUAL(0, stats.size());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.mean());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.variance());
+
+    stats.push(10);
+    stats.push(20);
+    stats.push(30);
+    TEST_ASSERT_FALSE(stats.full());
+    TEST_ASSERT_EQUAL(60, stats.sum());
+    TEST_ASSERT_EQUAL(10, stats.minimum());
+    TEST_ASSERT_EQUAL(30, stats.maximum());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3, 200.0f / 3, stats.variance());
+
+    stats.clear();
+    TEST_ASSERT_EQUAL(0, stats.size());
+    TEST_ASSERT_EQUAL(0, stats.sum());
+    stats.push(5);
+    TEST_ASSERT_EQUAL(5, stats.minimum());
+    TEST_ASSERT_EQUAL(5, stats.maximum());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.variance());
+}
+
+// ─── Benchmark ──────────────────────────────────────────────────────────────
+
+template <uint16_t N>
+static double naiveNsPerRead(int reads)
+{
+    uint16_t buffer[N] = {0};
+    uint16_t index = 0;
+    volatile float sink;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reads; i++)
+    {
+        buffer[index] = i & 4095;
+        index = (index + 1) % N;
+        uint32_t sum = 0;
+        for (uint16_t k = 0; k < N; k++)
+            sum += buffer[k];
+        sink = (float)sum / N;
+    }
+    (void)sink;
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / reads;
+}
+
+template <uint16_t N>
+static double ringNsPerRead(int reads)
+{
+    RingStats<uint16_t, N> stats;
+    volatile float sink;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reads; i++)
+    {
+        stats.push(i & 4095);
+        sink = stats.mean();
+    }
+    (void)sink;
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / reads;
+}
+
+void test_benchmark_push_and_mean()
+{
+    const int READS = 5000000;
+    double naive16 = naiveNsPerRead<16>(READS), ring16 = ringNsPerRead<16>(READS);
+    double naive64 = naiveNsPerRead<64>(READS), ring64 = ringNsPerRead<64>(READS);
+
+    RingStats<uint16_t, 16, true, true> all;
+    volatile float sink;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < READS; i++)
+    {
+        all.push((i * 7919) & 4095);
+        sink = all.mean() + all.maximum() - all.minimum() + all.variance();
+    }
+    (void)sink;
+    double allNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / READS;
+
+    char line[160];
+    snprintf(line, sizeof(line), "push+mean: N=16 %.1f ns (re-sum %.1f ns), N=64 %.1f ns (re-sum %.1f ns); N=16 with min/max/variance %.1f ns",
+             ring16, naive16, ring64, naive64, allNs);
+    TEST_MESSAGE(line);
+
+    // O(1): the window size does not matter, and re-summing 64 samples does
+    TEST_ASSERT_LESS_THAN(naive64, ring64);
+    TEST_ASSERT_LESS_THAN(3 * ring16 + 5, ring64);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_adc_samples_match_naive);
+    RUN_TEST(test_monotonic_ramp_matches_naive);
+    RUN_TEST(test_float_samples_do_not_drift);
+    RUN_TEST(test_partial_window_and_clear);
+    RUN_TEST(test_benchmark_push_and_mean);
+    return UNITY_END();
+}
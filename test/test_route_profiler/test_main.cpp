@@ -0,0 +1,178 @@
+/**
+ * @file test_main.cpp
+ * @brief RouteProfiler histograms, percentiles and record() cost (native)
+ *
+ * Everything is read back through writeStats(), i.e. the /api/perf JSON,
+ * so the tests check what the endpoint reports.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include "core/RouteProfiler.h"
+#include "utils/ResponseWriter.h"
+
+static RouteProfiler *profiler;
+static char stats[4096];
+
+void setUp() { profiler = new RouteProfiler(); }
+void tearDown() { delete profiler; }
+
+static const char *render()
+{
+    FixedBufferPrint out(stats, sizeof(stats));
+    ResponseWriter json(out);
+    json.beginObject();
+    profiler->writeStats(json);
+    json.endObject();
+    TEST_ASSERT_FALSE(json.overflowed());
+    return stats;
+}
+
+// Numeric member of the first route object that has it
+static long statOf(const char *key)
+{
+    char pattern[32];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *at = strstr(render(), pattern);
+    TEST_ASSERT_NOT_NULL_MESSAGE(at, key);
+    return strtol(at + strlen(pattern), nullptr, 10);
+}
+
+// ─── Histogram ──────────────────────────────────────────────────────────────
+
+void test_percentile_within_bucket_error()
+{
+    int8_t route = profiler->addRoute("/api/status", HTTP_GET);
+
+    // One sample at v plus a far larger max: p50 is v's bucket bound
+    for (uint32_t v = 1; v < 10000000; v = v * 3 / 2 + 1)
+    {
+        profiler->reset();
+        profiler->record(route, v, 0);
+        profiler->record(route, v * 10, 0);
+
+        long p50 = statOf("p50");
+        TEST_ASSERT_GREATER_OR_EQUAL((long)v, p50);
+        TEST_ASSERT_LESS_OR_EQUAL((long)(v + v / 4), p50);
+    }
+}
+
+void test_p50_and_p99_split_fast_and_slow()
+{
+    int8_t route = profiler->addRoute("/api/sensors", HTTP_GET);
+
+    for (int i = 0; i < 989; i++)
+        profiler->record(route, 100, 0);
+    for (int i = 0; i < 11; i++)
+        profiler->record(route, 50000, 0);
+
+    TEST_ASSERT_EQUAL(1000, statOf("count"));
+    TEST_ASSERT_LESS_OR_EQUAL(125, statOf("p50"));
+    TEST_ASSERT_EQUAL(50000, statOf("p99")); // Clamped to max, not the bucket bound
+    TEST_ASSERT_EQUAL(50000, statOf("max"));
+    TEST_ASSERT_EQUAL((989 * 100 + 11 * 50000) / 1000, statOf("mean"));
+    TEST_ASSERT_EQUAL(11, statOf("slow")); // 50 ms >= PERF_SLOW_HANDLER_US
+}
+
+void test_full_bucket_halves_the_route()
+{
+    int8_t route = profiler->addRoute("/api/status", HTTP_GET);
+
+    // Days of 2 s polling: the common bucket fills many times over while
+    // 0.5% of the requests stay slow
+    for (int i = 0; i < 400000; i++)
+        profiler->record(route, i % 200 == 0 ? 50000 : 100, 0);
+
+    TEST_ASSERT_EQUAL(400000, statOf("count"));
+    TEST_ASSERT_LESS_OR_EQUAL(125, statOf("p50"));
+    TEST_ASSERT_LESS_OR_EQUAL(125, statOf("p99")); // Not drifting toward the tail
+    TEST_ASSERT_EQUAL(50000, statOf("max"));
+}
+
+void test_huge_latency_lands_in_last_bucket()
+{
+    int8_t route = profiler->addRoute("/api/files", HTTP_GET);
+    profiler->record(route, UINT32_MAX, 0);
+
+    TEST_ASSERT_EQUAL((long)UINT32_MAX, statOf("p99"));
+    TEST_ASSERT_EQUAL((long)UINT32_MAX, statOf("max"));
+}
+
+void test_heap_delta_min_and_mean()
+{
+    int8_t route = profiler->addRoute("/api/config", HTTP_POST);
+    profiler->record(route, 10, -400);
+    profiler->record(route, 10, 0);
+    profiler->record(route, 10, 100);
+
+    TEST_ASSERT_EQUAL(-400, statOf("heapDeltaMin"));
+    TEST_ASSERT_EQUAL(-100, statOf("heapDeltaMean"));
+}
+
+// ─── Routes ─────────────────────────────────────────────────────────────────
+
+void test_unhit_routes_are_skipped_and_reset_keeps_routes()
+{
+    profiler->addRoute("/api/status", HTTP_GET);
+    int8_t post = profiler->addRoute("/api/command", HTTP_POST);
+    profiler->record(post, 42, 0);
+
+    const char *json = render();
+    TEST_ASSERT_NULL(strstr(json, "/api/status"));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"method\":\"POST\",\"path\":\"/api/command\""));
+
+    profiler->reset();
+    TEST_ASSERT_EQUAL_STRING("{\"routes\":[]}", render());
+    TEST_ASSERT_EQUAL(2, profiler->getRouteCount());
+
+    profiler->record(post, 7, 0);
+    TEST_ASSERT_EQUAL(7, statOf("max"));
+}
+
+void test_route_slots_are_bounded()
+{
+    for (int i = 0; i < PERF_MAX_ROUTES; i++)
+        TEST_ASSERT_EQUAL(i, profiler->addRoute("/r", HTTP_GET));
+    TEST_ASSERT_EQUAL(-1, profiler->addRoute("/one-too-many", HTTP_GET));
+
+    // Records for a route that got no slot are dropped
+    profiler->record(-1, 5, 0);
+    profiler->record(PERF_MAX_ROUTES, 5, 0);
+    TEST_ASSERT_EQUAL_STRING("{\"routes\":[]}", render());
+}
+
+// ─── Benchmark ──────────────────────────────────────────────────────────────
+
+void test_benchmark_record()
+{
+    int8_t route = profiler->addRoute("/api/status", HTTP_GET);
+    const int SAMPLES = 1000000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < SAMPLES; i++)
+        profiler->record(route, 50 + ((uint32_t)i * 7919) % 5000, -(i & 63));
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / SAMPLES;
+
+    char line[96];
+    snprintf(line, sizeof(line), "record(): %.1f ns per handler run", ns);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_EQUAL(SAMPLES, statOf("count"));
+    // Bookkeeping only: no allocation, no search over routes
+    TEST_ASSERT_LESS_THAN(1000.0, ns);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_percentile_within_bucket_error);
+    RUN_TEST(test_p50_and_p99_split_fast_and_slow);
+    RUN_TEST(test_full_bucket_halves_the_route);
+    RUN_TEST(test_huge_latency_lands_in_last_bucket);
+    RUN_TEST(test_heap_delta_min_and_mean);
+    RUN_TEST(test_unhit_routes_are_skipped_and_reset_keeps_routes);
+    RUN_TEST(test_route_slots_are_bounded);
+    RUN_TEST(test_benchmark_record);
+    return UNITY_END();
+}
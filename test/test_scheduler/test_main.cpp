@@ -0,0 +1,348 @@
+/**
+ * @file test_main.cpp
+ * @brief Scheduler on a virtual clock, and a comparison with the old loop
+ *
+ * millis() is the host's virtual clock: nothing here depends on how fast
+ * the PC is. idle() has no loop task to block on, so it delay()s, which
+ * moves the clock by exactly the time it would have slept.
+ *
+ * The comparison replays a minute of main.cpp's periodic work both ways:
+ * the old loop (poll every Timer, then delay(10)) and the scheduler (run
+ * what is due, sleep until the next deadline), counting wake-ups and how
+ * late each job ran. Each job advances the clock by a rough work time.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <string>
+#include "utils/ResponseWriter.h"
+#include "utils/Scheduler.h"
+#include "utils/Timer.h"
+
+static Scheduler *sched;
+static std::string ran;
+
+void setUp()
+{
+    host::resetClock(1000 * 1000); // millis() 1000: Timer treats 0 as "never ran"
+    sched = new Scheduler();
+    sched->begin();
+    ran.clear();
+}
+void tearDown() { delete sched; }
+
+static void taskA() { ran += 'A'; }
+static void taskB() { ran += 'B'; }
+static void taskC() { ran += 'C'; }
+
+// Advance to the next deadline (at most maxSleep) and run what is due
+static void step(uint32_t maxSleep = SCHEDULER_MAX_SLEEP)
+{
+    sched->idle(maxSleep);
+    sched->runDue();
+}
+
+// ─── Deadlines and priorities ───────────────────────────────────────────────
+
+void test_nothing_runs_before_its_deadline()
+{
+    sched->addTask("a", taskA, 10);
+
+    TEST_ASSERT_EQUAL(0, sched->runDue());
+    TEST_ASSERT_EQUAL(10, sched->getSleepTime(100));
+    host::advanceMillis(9);
+    TEST_ASSERT_EQUAL(0, sched->runDue());
+    host::advanceMillis(1);
+    TEST_ASSERT_EQUAL(1, sched->runDue());
+    TEST_ASSERT_EQUAL_STRING("A", ran.c_str());
+}
+
+void test_due_tasks_run_highest_priority_first()
+{
+    sched->addTask("low", taskA, 10, SCHED_PRIORITY_LOW);
+    sched->addTask("normal", taskB, 10, SCHED_PRIORITY_NORMAL);
+    sched->addTask("high", taskC, 10, SCHED_PRIORITY_HIGH);
+
+    host::advanceMillis(10);
+    TEST_ASSERT_EQUAL(3, sched->runDue());
+    TEST_ASSERT_EQUAL_STRING("CBA", ran.c_str());
+}
+
+void test_sleeps_exactly_until_next_deadline()
+{
+    sched->addTask("a", taskA, 30);
+    sched->addTask("b", taskB, 70);
+
+    TEST_ASSERT_EQUAL(30, sched->getSleepTime(100));
+    TEST_ASSERT_EQUAL(20, sched->getSleepTime(20)); // Capped
+
+    step();
+    TEST_ASSERT_EQUAL(1030, millis());
+    TEST_ASSERT_EQUAL_STRING("A", ran.c_str());
+    step();
+    TEST_ASSERT_EQUAL(1060, millis());
+    step();
+    TEST_ASSERT_EQUAL(1070, millis());
+    TEST_ASSERT_EQUAL_STRING("AAB", ran.c_str());
+}
+
+void test_keeps_phase_and_skips_missed_runs()
+{
+    sched->addTask("a", taskA, 10);
+
+    // 3 ms late: next run stays on the 10 ms grid
+    host::advanceMillis(13);
+    sched->runDue();
+    TEST_ASSERT_EQUAL(7, sched->getSleepTime(100));
+
+    // Three periods late: one run, not three back to back
+    host::advanceMillis(37);
+    TEST_ASSERT_EQUAL(1, sched->runDue());
+    TEST_ASSERT_EQUAL(0, sched->runDue());
+    TEST_ASSERT_EQUAL(10, sched->getSleepTime(100));
+}
+
+static int8_t selfTask;
+static void rescheduling()
+{
+    ran += 'S';
+    sched->setInterval(selfTask, 25);
+}
+
+void test_task_can_reschedule_itself()
+{
+    selfTask = sched->addTask("self", rescheduling, 10);
+    sched->addTask("a", taskA, 30);
+
+    step(); // 1010: S, next at 1035
+    TEST_ASSERT_EQUAL(20, sched->getSleepTime(100)); // a at 1030 comes first
+    step(); // 1030: A
+    step(); // 1035: S
+    TEST_ASSERT_EQUAL(1035, millis());
+    TEST_ASSERT_EQUAL_STRING("SAS", ran.c_str());
+}
+
+void test_survives_millis_wraparound()
+{
+    host::resetClock((uint64_t)(UINT32_MAX - 15) * 1000);
+    delete sched;
+    sched = new Scheduler();
+
+    sched->addTask("a", taskA, 10);
+    sched->addTask("b", taskB, 35);
+
+    for (int i = 0; i < 6; i++)
+        step();
+
+    // millis() wraps 16 ms in: a at -6, +4, +14, +24, +34; b at +19
+    TEST_ASSERT_EQUAL_STRING("AAABAA", ran.c_str());
+}
+
+// ─── Events ─────────────────────────────────────────────────────────────────
+
+void test_post_runs_subscribers_now_without_moving_deadline()
+{
+    sched->addTask("commands", taskA, 100, SCHED_PRIORITY_HIGH, SCHED_EVENT_COMMAND);
+    sched->addTask("other", taskB, 100);
+
+    host::advanceMillis(40);
+    sched->post(SCHED_EVENT_COMMAND);
+    TEST_ASSERT_EQUAL(0, sched->getSleepTime(100)); // Pending event: don't sleep
+    TEST_ASSERT_EQUAL(1, sched->runDue());
+    TEST_ASSERT_EQUAL_STRING("A", ran.c_str());
+
+    // Periodic schedule unchanged
+    TEST_ASSERT_EQUAL(60, sched->getSleepTime(100));
+    step();
+    TEST_ASSERT_EQUAL_STRING("AAB", ran.c_str());
+}
+
+void test_unsubscribed_events_wake_nothing()
+{
+    sched->addTask("commands", taskA, 100, SCHED_PRIORITY_NORMAL, SCHED_EVENT_COMMAND);
+    sched->postFromISR(SCHED_EVENT_MOTION);
+    TEST_ASSERT_EQUAL(0, sched->runDue());
+    TEST_ASSERT_EQUAL(100, sched->getSleepTime(1000));
+}
+
+void test_trigger_and_disable()
+{
+    int8_t a = sched->addTask("a", taskA, 50);
+    int8_t b = sched->addTask("b", taskB, 50);
+
+    sched->trigger(b);
+    sched->runDue();
+    TEST_ASSERT_EQUAL_STRING("B", ran.c_str());
+
+    sched->setEnabled(a, false);
+    step();
+    TEST_ASSERT_EQUAL_STRING("BB", ran.c_str());
+
+    sched->trigger(a); // Disabled tasks ignore triggers too
+    TEST_ASSERT_EQUAL(0, sched->runDue());
+}
+
+// ─── Old loop vs scheduler ──────────────────────────────────────────────────
+
+struct Job
+{
+    const char *name;
+    uint32_t interval;
+    uint32_t workMs; // Rough time the job keeps the CPU busy
+};
+
+// main.cpp's periodic tasks at their config.h periods
+static const Job JOBS[] = {
+    {"network", NETWORK_POLL_INTERVAL, 1},
+    {"sensors", SENSOR_READ_INTERVAL, 5},
+    {"status", STATUS_UPDATE_INTERVAL, 2},
+    {"heartbeat", HEARTBEAT_INTERVAL, 0},
+    {"health", HEALTH_CHECK_INTERVAL, 1},
+    {"serial", SERIAL_POLL_INTERVAL, 0},
+};
+static const int JOB_COUNT = sizeof(JOBS) / sizeof(JOBS[0]);
+static const uint32_t SIMULATED_MS = 60000;
+
+template <int I>
+static void work() { host::advanceMillis(JOBS[I].workMs); }
+static const TaskFunction WORK[JOB_COUNT] = {work<0>, work<1>, work<2>, work<3>, work<4>, work<5>};
+
+struct LoopCost
+{
+    uint32_t wakeups;
+    uint32_t runs;
+    uint32_t maxLateMs;
+};
+
+static LoopCost oldLoop()
+{
+    Timer *timers[JOB_COUNT];
+    for (int i = 0; i < JOB_COUNT; i++)
+    {
+        timers[i] = new Timer(JOBS[i].interval);
+        timers[i]->reset();
+    }
+
+    LoopCost cost = {0, 0, 0};
+    uint32_t end = millis() + SIMULATED_MS;
+    while (millis() < end)
+    {
+        for (int i = 0; i < JOB_COUNT; i++)
+        {
+            if (timers[i]->isReady())
+            {
+                WORK[i]();
+                cost.runs++;
+                cost.maxLateMs = max(cost.maxLateMs, timers[i]->getLateness());
+            }
+        }
+        delay(10);
+        cost.wakeups++;
+    }
+
+    for (int i = 0; i < JOB_COUNT; i++)
+        delete timers[i];
+    return cost;
+}
+
+static void noop() {}
+
+static LoopCost scheduledLoop()
+{
+    for (int i = 0; i < JOB_COUNT; i++)
+        sched->addTask(JOBS[i].name, WORK[i], JOBS[i].interval);
+
+    LoopCost cost = {0, 0, 0};
+    uint32_t end = millis() + SIMULATED_MS;
+    while (millis() < end)
+    {
+        cost.runs += sched->runDue();
+        if (sched->getSleepTime(SCHEDULER_MAX_SLEEP) > 0)
+        {
+            sched->idle(SCHEDULER_MAX_SLEEP);
+            cost.wakeups++;
+        }
+    }
+
+    // Lateness as the scheduler records it
+    char buffer[2048];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter json(out);
+    json.beginObject();
+    sched->writeStats(json);
+    json.endObject();
+    for (const char *at = strstr(buffer, "\"lateMax\":"); at; at = strstr(at + 1, "\"lateMax\":"))
+        cost.maxLateMs = max(cost.maxLateMs, (uint32_t)strtoul(at + 10, nullptr, 10));
+    return cost;
+}
+
+void test_compare_with_fixed_delay_loop()
+{
+    LoopCost before = oldLoop();
+    host::resetClock(1000 * 1000);
+    LoopCost after = scheduledLoop();
+
+    char line[160];
+    snprintf(line, sizeof(line), "60 s: delay(10) loop %u wake-ups, %u runs, late <= %u ms   scheduler %u wake-ups, %u runs, late <= %u ms",
+             before.wakeups, before.runs, before.maxLateMs, after.wakeups, after.runs, after.maxLateMs);
+    TEST_MESSAGE(line);
+
+    // The old loop drifts by the work it does each pass and runs less often
+    TEST_ASSERT_GREATER_THAN(after.wakeups, before.wakeups);
+    TEST_ASSERT_GREATER_OR_EQUAL(before.runs, after.runs);
+    // Late only by the work of jobs due at the same moment
+    uint32_t sameMomentWork = 0;
+    for (int i = 0; i < JOB_COUNT; i++)
+        sameMomentWork += JOBS[i].workMs;
+    TEST_ASSERT_LESS_OR_EQUAL(sameMomentWork, after.maxLateMs);
+    TEST_ASSERT_LESS_THAN(before.maxLateMs, after.maxLateMs);
+}
+
+static uint32_t idleWakeupsPerSecond(uint32_t serialInterval)
+{
+    Scheduler idleLoop;
+    idleLoop.addTask("heartbeat", noop, HEARTBEAT_INTERVAL);
+    idleLoop.addTask("serial", noop, serialInterval);
+
+    uint32_t wakeups = 0;
+    uint32_t end = millis() + SIMULATED_MS;
+    while (millis() < end)
+    {
+        idleLoop.idle(SCHEDULER_MAX_SLEEP);
+        idleLoop.runDue();
+        wakeups++;
+    }
+    return wakeups / (SIMULATED_MS / 1000);
+}
+
+void test_serial_poll_wakeups()
+{
+    // Only the slow tasks: what an idle device pays for polling Serial
+    uint32_t fast = idleWakeupsPerSecond(50);
+    uint32_t now = idleWakeupsPerSecond(SERIAL_POLL_INTERVAL);
+
+    char line[96];
+    snprintf(line, sizeof(line), "idle wake-ups/s: serial every 50 ms %u, every %u ms %u",
+             fast, (unsigned)SERIAL_POLL_INTERVAL, now);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_LESS_THAN(fast, now);
+    TEST_ASSERT_LESS_OR_EQUAL(1000 / SCHEDULER_MAX_SLEEP + 1000 / SERIAL_POLL_INTERVAL, now);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_nothing_runs_before_its_deadline);
+    RUN_TEST(test_due_tasks_run_highest_priority_first);
+    RUN_TEST(test_sleeps_exactly_until_next_deadline);
+    RUN_TEST(test_keeps_phase_and_skips_missed_runs);
+    RUN_TEST(test_task_can_reschedule_itself);
+    RUN_TEST(test_survives_millis_wraparound);
+    RUN_TEST(test_post_runs_subscribers_now_without_moving_deadline);
+    RUN_TEST(test_unsubscribed_events_wake_nothing);
+    RUN_TEST(test_trigger_and_disable);
+    RUN_TEST(test_compare_with_fixed_delay_loop);
+    RUN_TEST(test_serial_poll_wakeups);
+    return UNITY_END();
+}
@@ -0,0 +1,296 @@
+/**
+ * @file test_main.cpp
+ * @brief SensorManager registry with fake drivers on a virtual clock (native)
+ *
+ * The fakes stand in for the real drivers: each counts its polls (the
+ * "bus I/O") and reports a value that moves by a fixed step per poll.
+ * The sampling task is simulated the way main.cpp runs it: poll(), then
+ * sleep for getSleepTime().
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <unity.h>
+#include "sensors/SensorManager.h"
+
+struct FakeSensor : public ISensor
+{
+    const char *name;
+    const char *fieldNames[SENSOR_MAX_FIELDS];
+    uint8_t fieldCount;
+    uint32_t period;
+    float step;
+    bool present = true;
+    bool ok = true;
+    bool event = false;
+    uint32_t polls = 0;
+    float value = 20.0f;
+
+    FakeSensor(const char *name, uint32_t period, float step = 1.0f)
+        : name(name), fieldCount(1), period(period), step(step)
+    {
+        fieldNames[0] = name;
+    }
+
+    const char *getName() const { return name; }
+    bool begin() { return present; }
+    SensorPollResult poll()
+    {
+        polls++;
+        value += step;
+        if (!ok)
+            return SENSOR_POLL_FAILED;
+        return event ? SENSOR_POLL_EVENT : SENSOR_POLL_OK;
+    }
+    uint8_t readFields(SensorField *fields)
+    {
+        for (uint8_t f = 0; f < fieldCount; f++)
+            setField(fields[f], fieldNames[f], SENSOR_FIELD_FLOAT, value + f / 3.0f);
+        return fieldCount;
+    }
+    uint32_t getPeriod() const { return period; }
+};
+
+static SensorManager *manager;
+static uint32_t wakes, wakesFromISR;
+static uint32_t events;
+
+static void onWake(bool fromISR)
+{
+    wakes++;
+    if (fromISR)
+        wakesFromISR++;
+}
+
+static void onEvent(const char *, const SensorField *, uint8_t) { events++; }
+
+void setUp()
+{
+    host::resetClock();
+    manager = new SensorManager();
+    manager->setWakeHook(onWake);
+    manager->setEventHook(onEvent);
+    wakes = wakesFromISR = events = 0;
+}
+
+void tearDown() { delete manager; }
+
+static void configure(const char *json)
+{
+    StaticJsonDocument<512> doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, json));
+    TEST_ASSERT_TRUE(manager->configureAdaptive(doc.as<JsonObjectConst>()));
+}
+
+// The "sampling" task for durationMs of virtual time
+static void runSampling(uint32_t durationMs)
+{
+    uint32_t end = millis() + durationMs;
+    while ((int32_t)(millis() - end) < 0)
+    {
+        manager->poll(millis());
+        uint32_t sleep = manager->getSleepTime(millis(), end - millis());
+        host::advanceMillis(max(sleep, (uint32_t)1));
+    }
+}
+
+// ─── Scheduling ─────────────────────────────────────────────────────────────
+
+void test_each_sensor_is_polled_at_its_own_rate()
+{
+    FakeSensor dht("temperature", 2000), mpu("accelX", 10), pir("motion", 0), absent("distance", 100);
+    absent.present = false;
+    manager->addSensor(&dht);
+    manager->addSensor(&mpu);
+    manager->addSensor(&pir);
+    manager->addSensor(&absent);
+    configure("{\"enabled\":false}");
+
+    TEST_ASSERT_EQUAL(3, manager->begin());
+    runSampling(10000);
+
+    TEST_ASSERT_UINT_WITHIN(1, 5, dht.polls);
+    TEST_ASSERT_UINT_WITHIN(2, 1000, mpu.polls);
+    TEST_ASSERT_EQUAL(0, pir.polls); // Event-driven: only when asked
+    TEST_ASSERT_EQUAL(0, absent.polls);
+}
+
+void test_requested_poll_runs_next_and_reports_events()
+{
+    FakeSensor dht("temperature", 2000), pir("motion", 0);
+    manager->addSensor(&dht);
+    int8_t pirId = manager->addSensor(&pir);
+    manager->begin();
+    runSampling(100);
+
+    pir.event = true;
+    manager->requestPollFromISR(pirId);
+    TEST_ASSERT_EQUAL(1, wakesFromISR);
+    TEST_ASSERT_EQUAL(0, manager->getSleepTime(millis(), 1000));
+
+    TEST_ASSERT_EQUAL(1, manager->poll(millis()));
+    TEST_ASSERT_EQUAL(1, pir.polls);
+    TEST_ASSERT_EQUAL(1, events);
+
+    // The requested poll did not move the DHT's grid
+    TEST_ASSERT_EQUAL(1, dht.polls);
+    TEST_ASSERT_UINT_WITHIN(1, 1900, manager->getSleepTime(millis(), 5000));
+}
+
+void test_stable_sensor_slows_down_and_speeds_up_on_change()
+{
+    FakeSensor soil("soilMoisture", 1000, 0.0f); // Deadband 40
+    manager->addSensor(&soil);
+    manager->begin();
+
+    runSampling(60000);
+    uint32_t stablePolls = soil.polls;
+    TEST_ASSERT_LESS_THAN(60 / 4, stablePolls); // Fixed rate would be 60
+
+    // A drop makes the next reading significant: back to the base period
+    soil.step = -50.0f;
+    while (soil.polls == stablePolls)
+        runSampling(100);
+    uint32_t changedAt = soil.polls;
+    runSampling(5000);
+    TEST_ASSERT_UINT_WITHIN(1, 5, soil.polls - changedAt);
+}
+
+void test_rejected_settings_change_nothing()
+{
+    configure("{\"stablePolls\":5,\"deadbands\":{\"soilMoisture\":25}}");
+
+    StaticJsonDocument<2048> before, after, request;
+    manager->getAdaptiveConfig(before.to<JsonObject>());
+
+    // Valid scalars, then more new deadbands than the table has room for
+    JsonObject settings = request.to<JsonObject>();
+    settings["enabled"] = false;
+    settings["stablePolls"] = 9;
+    settings["heartbeat"] = 1000;
+    JsonObject deadbands = settings.createNestedObject("deadbands");
+    deadbands["soilMoisture"] = 99;
+    char names[ADAPTIVE_MAX_DEADBANDS][8];
+    for (int i = 0; i < ADAPTIVE_MAX_DEADBANDS; i++)
+    {
+        snprintf(names[i], sizeof(names[i]), "f%d", i);
+        deadbands[names[i]] = 1;
+    }
+    TEST_ASSERT_FALSE(manager->configureAdaptive(request.as<JsonObjectConst>()));
+
+    manager->getAdaptiveConfig(after.to<JsonObject>());
+    char expected[1024], actual[1024];
+    serializeJson(before, expected, sizeof(expected));
+    serializeJson(after, actual, sizeof(actual));
+    TEST_ASSERT_EQUAL_STRING(expected, actual);
+    TEST_ASSERT_EQUAL(5, after["stablePolls"].as<int>());
+    JsonObjectConst kept = after["deadbands"].as<JsonObjectConst>();
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 25, kept["soilMoisture"].as<float>());
+}
+
+// ─── Snapshot ───────────────────────────────────────────────────────────────
+
+void test_reading_the_snapshot_does_not_poll()
+{
+    FakeSensor dht("temperature", 2000);
+    manager->addSensor(&dht);
+    manager->begin();
+    runSampling(1);
+    uint32_t polls = dht.polls;
+
+    StaticJsonDocument<256> doc;
+    for (int i = 0; i < 100; i++)
+    {
+        manager->getAllSensorData(doc.to<JsonObject>());
+        manager->getTemperature();
+    }
+
+    TEST_ASSERT_EQUAL(polls, dht.polls);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, dht.value, doc["temperature"].as<float>());
+    TEST_ASSERT_FLOAT_WITHIN(0.001, dht.value, manager->getTemperature());
+}
+
+void test_failing_sensor_drops_out_and_comes_back()
+{
+    FakeSensor dht("temperature", 2000), ldr("lightLevel", 1000);
+    manager->addSensor(&dht);
+    manager->addSensor(&ldr);
+    manager->begin();
+    runSampling(1);
+
+    dht.ok = false;
+    runSampling(2000 * SENSOR_MAX_FAILURES);
+
+    StaticJsonDocument<256> doc;
+    manager->getAllSensorData(doc.to<JsonObject>());
+    TEST_ASSERT_FALSE(doc.containsKey("temperature"));
+    TEST_ASSERT_TRUE(doc.containsKey("lightLevel"));
+
+    dht.ok = true;
+    runSampling(SENSOR_RETRY_INTERVAL);
+    manager->getAllSensorData(doc.to<JsonObject>());
+    TEST_ASSERT_TRUE(doc.containsKey("temperature"));
+}
+
+// ─── ESP-NOW payload ────────────────────────────────────────────────────────
+
+void test_peer_data_fits_one_frame_watched_fields_first()
+{
+    // More fields than a 229-byte frame holds; names as the real drivers use
+    FakeSensor mpu("accelX", 10), vibration("vibrationRms", 1000), dht("temperature", 2000), soil("soilMoisture", 1000);
+    const char *mpuFields[] = {"accelX", "accelY", "accelZ", "gyroX", "gyroY", "gyroZ", "pitch", "roll", "heading"};
+    memcpy(mpu.fieldNames, mpuFields, sizeof(mpuFields));
+    mpu.fieldCount = 9;
+    const char *vibrationFields[] = {"vibrationRms", "vibrationPeak", "crestFactor", "peakFrequency"};
+    memcpy(vibration.fieldNames, vibrationFields, sizeof(vibrationFields));
+    vibration.fieldCount = 4;
+    const char *dhtFields[] = {"temperature", "humidity", "heatIndex"};
+    memcpy(dht.fieldNames, dhtFields, sizeof(dhtFields));
+    dht.fieldCount = 3;
+    dht.step = 0.123456f;
+    manager->addSensor(&mpu);
+    manager->addSensor(&vibration);
+    manager->addSensor(&dht);
+    manager->addSensor(&soil);
+    manager->begin();
+    runSampling(1);
+
+    StaticJsonDocument<1024> full;
+    manager->getAllSensorData(full.to<JsonObject>());
+    TEST_ASSERT_GREATER_THAN(229, measureJson(full));
+
+    StaticJsonDocument<768> doc;
+    JsonObject root = doc.to<JsonObject>();
+    root["device"] = "ESP32-Node-1";
+    uint8_t dropped = manager->getPeerSensorData(root, 229);
+
+    char json[256];
+    size_t length = serializeJson(doc, json, sizeof(json));
+    TEST_MESSAGE(json);
+    TEST_ASSERT_LESS_OR_EQUAL(229, length);
+    TEST_ASSERT_GREATER_THAN(0, dropped);
+    TEST_ASSERT_EQUAL(full.as<JsonObjectConst>().size() + 1, root.size() + dropped);
+
+    // Every watched field made it (ADAPTIVE_DEADBANDS)
+    const char *watched[] = {"temperature", "humidity", "soilMoisture", "pitch", "roll", "vibrationRms"};
+    for (const char *field : watched)
+        TEST_ASSERT_TRUE_MESSAGE(root.containsKey(field), field);
+    TEST_ASSERT_EQUAL_STRING("ESP32-Node-1", root["device"].as<const char *>());
+
+    // Rounded to two decimals
+    float temperature = root["temperature"].as<float>();
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, roundf(temperature * 100) / 100, temperature);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_each_sensor_is_polled_at_its_own_rate);
+    RUN_TEST(test_requested_poll_runs_next_and_reports_events);
+    RUN_TEST(test_stable_sensor_slows_down_and_speeds_up_on_change);
+    RUN_TEST(test_rejected_settings_change_nothing);
+    RUN_TEST(test_reading_the_snapshot_does_not_poll);
+    RUN_TEST(test_failing_sensor_drops_out_and_comes_back);
+    RUN_TEST(test_peer_data_fits_one_frame_watched_fields_first);
+    return UNITY_END();
+}
@@ -0,0 +1,193 @@
+/**
+ * @file test_main.cpp
+ * @brief TaskRunner pipeline on host threads: cleanup, throughput, latency
+ *
+ * freertos/task.h runs each task on a std::thread, so the three tasks
+ * and the SPSC queues between them run truly in parallel, as on the two
+ * ESP32 cores. Time is the wall clock here; the figures are host numbers
+ * (the pipeline's overhead, not the ESP32's), but the properties checked
+ * - nothing lost or reordered, a stalled consumer drops instead of
+ * delaying sampling - are the same. The host OS can preempt a thread for
+ * several ms, so "no drops" allows a few.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+#include "core/TaskRunner.h"
+#include "utils/ResponseWriter.h"
+
+static TaskRunner *runner;
+
+static std::atomic<uint32_t> produced;
+static std::vector<uint32_t> stored;
+static std::vector<uint32_t> published;
+static std::atomic<uint32_t> storeDelayMs;
+
+static size_t source(char *buffer, size_t size)
+{
+    return snprintf(buffer, size, "{\"type\":\"sensor\",\"n\":%u}", (unsigned)++produced);
+}
+static void store(const SensorSnapshot &snapshot)
+{
+    stored.push_back(snapshot.sequence);
+    if (storeDelayMs)
+        delay(storeDelayMs); // A slow SPIFFS write
+}
+static void publish(const SensorSnapshot &snapshot) { published.push_back(snapshot.sequence); }
+
+void setUp()
+{
+    host::useRealTime();
+    host::failTaskCreate = -1;
+    produced = 0;
+    storeDelayMs = 0;
+    stored.clear();
+    published.clear();
+    runner = new TaskRunner();
+}
+
+void tearDown()
+{
+    runner->end();
+    delete runner;
+    host::resetClock();
+}
+
+static long statOf(const char *json, const char *key)
+{
+    char pattern[32];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *at = strstr(json, pattern);
+    TEST_ASSERT_NOT_NULL_MESSAGE(at, key);
+    return strtol(at + strlen(pattern), nullptr, 10);
+}
+
+static const char *stats()
+{
+    static char buffer[1024];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter json(out);
+    json.beginObject();
+    runner->writeStats(json);
+    json.endObject();
+    return buffer;
+}
+
+static uint32_t droppedBy(const char *queue)
+{
+    return statOf(strstr(stats(), queue), "dropped");
+}
+
+static void assertInOrder(const std::vector<uint32_t> &sequences)
+{
+    for (size_t i = 1; i < sequences.size(); i++)
+        TEST_ASSERT_GREATER_THAN(sequences[i - 1], sequences[i]);
+}
+
+// ─── Startup ────────────────────────────────────────────────────────────────
+
+void test_failed_start_leaves_no_tasks_running()
+{
+    for (int failAt = 0; failAt < 3; failAt++)
+    {
+        host::failTaskCreate = failAt;
+        TEST_ASSERT_FALSE(runner->begin(source, store, publish));
+        TEST_ASSERT_FALSE(runner->isRunning());
+        TEST_ASSERT_EQUAL_MESSAGE(0, host::tasksAlive.load(), "tasks left behind");
+    }
+
+    // And a later attempt starts cleanly
+    TEST_ASSERT_TRUE(runner->begin(source, store, publish));
+    TEST_ASSERT_EQUAL(3, host::tasksAlive.load());
+    runner->end();
+    TEST_ASSERT_EQUAL(0, host::tasksAlive.load());
+}
+
+// ─── Pipeline ───────────────────────────────────────────────────────────────
+
+void test_every_snapshot_reaches_both_consumers_in_order()
+{
+    runner->setSensorInterval(5);
+    TEST_ASSERT_TRUE(runner->begin(source, store, publish));
+    delay(1000);
+    runner->end();
+
+    uint32_t snapshots = statOf(stats(), "snapshots");
+    uint32_t dropped = droppedBy("storageQueue") + droppedBy("publishQueue");
+    char line[160];
+    snprintf(line, sizeof(line), "5 ms interval, 1 s: %u snapshots, %zu stored, %zu published, latency avg %ld us max %ld us",
+             (unsigned)snapshots, stored.size(), published.size(),
+             statOf(stats(), "latencyAvg"), statOf(stats(), "latencyMax"));
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_GREATER_THAN(150, snapshots); // ~200 expected; leave room for a loaded CI box
+    TEST_ASSERT_LESS_OR_EQUAL(snapshots / 20, dropped);
+    // end() can catch a snapshot between the two queues or mid-drain
+    TEST_ASSERT_UINT_WITHIN(TASK_QUEUE_DEPTH + dropped, snapshots, stored.size());
+    TEST_ASSERT_UINT_WITHIN(TASK_QUEUE_DEPTH + dropped, snapshots, published.size());
+    assertInOrder(stored);
+    assertInOrder(published);
+}
+
+void test_stalled_storage_drops_without_delaying_sampling()
+{
+    storeDelayMs = 100; // Flash stall: 20 sampling periods per write
+    runner->setSensorInterval(5);
+    TEST_ASSERT_TRUE(runner->begin(source, store, publish));
+    delay(1000);
+    runner->end();
+
+    uint32_t snapshots = statOf(stats(), "snapshots");
+    uint32_t storageDropped = droppedBy("storageQueue");
+    uint32_t publishDropped = droppedBy("publishQueue");
+
+    char line[160];
+    snprintf(line, sizeof(line), "storage stalled 100 ms/write: %u snapshots, %zu stored, %u dropped, %zu published",
+             (unsigned)snapshots, stored.size(), (unsigned)storageDropped, published.size());
+    TEST_MESSAGE(line);
+
+    // Sampling kept its grid and publishing kept up
+    TEST_ASSERT_GREATER_THAN(150, snapshots);
+    TEST_ASSERT_LESS_OR_EQUAL(snapshots / 20, publishDropped);
+    TEST_ASSERT_UINT_WITHIN(TASK_QUEUE_DEPTH + publishDropped, snapshots, published.size());
+    // Storage got one write per stall plus what the queue held
+    TEST_ASSERT_LESS_THAN(snapshots / 4, (uint32_t)stored.size());
+    TEST_ASSERT_GREATER_THAN(snapshots / 2, storageDropped);
+    assertInOrder(stored);
+}
+
+// ─── Benchmark ──────────────────────────────────────────────────────────────
+
+void test_benchmark_throughput()
+{
+    // Interval 0: sample as fast as the consumers let the queues drain
+    runner->setSensorInterval(0);
+    TEST_ASSERT_TRUE(runner->begin(source, store, publish));
+    delay(200);
+    runner->end();
+
+    uint32_t snapshots = statOf(stats(), "snapshots");
+    uint32_t dropped = droppedBy("storageQueue") + droppedBy("publishQueue");
+
+    char line[160];
+    snprintf(line, sizeof(line), "flat out, 200 ms: %u snapshots/s, %zu stored, %zu published, %u dropped",
+             (unsigned)(snapshots * 5), stored.size(), published.size(), (unsigned)dropped);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_GREATER_THAN(1000, snapshots);
+    assertInOrder(stored);
+    assertInOrder(published);
+    // Whatever was not dropped was delivered
+    TEST_ASSERT_UINT_WITHIN(2 * TASK_QUEUE_DEPTH, 2 * snapshots, stored.size() + published.size() + dropped);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_failed_start_leaves_no_tasks_running);
+    RUN_TEST(test_every_snapshot_reaches_both_consumers_in_order);
+    RUN_TEST(test_stalled_storage_drops_without_delaying_sampling);
+    RUN_TEST(test_benchmark_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,238 @@
+/**
+ * @file test_main.cpp
+ * @brief TimingWheel cascades, ids, sleep time and pool limits (native)
+ *
+ * The wheel runs on the host virtual clock and is advanced one tick at a
+ * time, as the scheduler task does, so each test sees the exact tick a
+ * timer fires on. Timers are scheduled at unaligned ticks so the level
+ * boundaries (63/64 and 4095/4096 ticks, and beyond the top level) are
+ * crossed by a cascade rather than landing on one.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "utils/TimingWheel.h"
+
+static const uint32_t TICK = TIMING_WHEEL_TICK_MS;
+static const uint32_t TOP_TICKS = 1u << (TIMING_WHEEL_LEVELS * TIMING_WHEEL_SLOT_BITS); // ~46 h
+
+struct Fired
+{
+    uint32_t at;
+    int count;
+};
+
+static TimingWheel *wheel;
+static int wakes;
+
+static void onFire(void *context)
+{
+    Fired *fired = static_cast<Fired *>(context);
+    fired->at = millis();
+    fired->count++;
+}
+
+static void onWake() { wakes++; }
+
+void setUp()
+{
+    host::resetClock();
+    wheel = new TimingWheel();
+    wheel->begin(millis());
+    wakes = 0;
+}
+
+void tearDown() { delete wheel; }
+
+static void stepTicks(uint32_t ticks)
+{
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        host::advanceMillis(TICK);
+        wheel->advance(millis());
+    }
+}
+
+// Schedule from a tick boundary and step until it fires
+static void expectFiresAfter(uint32_t ticks)
+{
+    Fired fired = {0, 0};
+    uint32_t start = millis();
+    TEST_ASSERT_NOT_EQUAL(0, wheel->schedule(ticks * TICK, onFire, &fired));
+
+    // Jump close to the deadline in one advance(), then go tick by tick
+    if (ticks > 2)
+    {
+        host::advanceMillis((ticks - 2) * TICK);
+        wheel->advance(millis());
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(0, fired.count, "fired early");
+    while (fired.count == 0 && millis() - start <= (ticks + 2) * TICK)
+        stepTicks(1);
+
+    char message[48];
+    snprintf(message, sizeof(message), "delay of %lu ticks", (unsigned long)ticks);
+    TEST_ASSERT_EQUAL_MESSAGE(1, fired.count, message);
+    TEST_ASSERT_EQUAL_MESSAGE(start + ticks * TICK, fired.at, message);
+}
+
+// ─── Cascades ───────────────────────────────────────────────────────────────
+
+void test_level_boundaries_at_unaligned_ticks()
+{
+    static const uint32_t DELAYS[] = {1, 2, 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 262145};
+    for (uint32_t offset : {37u, 5u, 1000u})
+    {
+        stepTicks(offset);
+        for (uint32_t ticks : DELAYS)
+            expectFiresAfter(ticks);
+    }
+    TEST_ASSERT_EQUAL(0, wheel->getPending());
+}
+
+void test_delay_beyond_the_top_level_fires_on_time()
+{
+    stepTicks(123);
+    expectFiresAfter(TOP_TICKS - 1);
+    expectFiresAfter(TOP_TICKS + 5000);
+    expectFiresAfter(3 * TOP_TICKS + 7); // Re-parked by several cascades
+}
+
+void test_timers_on_one_tick_all_fire()
+{
+    Fired fired = {0, 0};
+    stepTicks(10);
+    for (int i = 0; i < 5; i++)
+        wheel->schedule(4096 * TICK, onFire, &fired); // Same level-2 slot
+    wheel->schedule(4096 * TICK + 1, onFire, &fired); // Rounded up a tick
+
+    stepTicks(4096);
+    TEST_ASSERT_EQUAL(5, fired.count);
+    stepTicks(1);
+    TEST_ASSERT_EQUAL(6, fired.count);
+}
+
+// ─── Ids ────────────────────────────────────────────────────────────────────
+
+void test_cancel_after_fire_is_a_no_op()
+{
+    Fired first = {0, 0}, second = {0, 0};
+    TimerId old = wheel->schedule(30, onFire, &first);
+    stepTicks(3);
+    TEST_ASSERT_EQUAL(1, first.count);
+    TEST_ASSERT_FALSE(wheel->isPending(old));
+
+    // The freed node is reused with a new generation
+    TimerId reused = wheel->schedule(30, onFire, &second);
+    TEST_ASSERT_EQUAL(old & 0xFFFF, reused & 0xFFFF);
+    TEST_ASSERT_NOT_EQUAL(old, reused);
+
+    TEST_ASSERT_FALSE(wheel->cancel(old));
+    TEST_ASSERT_TRUE(wheel->isPending(reused));
+    stepTicks(3);
+    TEST_ASSERT_EQUAL(1, second.count);
+
+    TEST_ASSERT_FALSE(wheel->cancel(reused));
+    TEST_ASSERT_FALSE(wheel->cancel(0));
+}
+
+void test_cancel_before_fire()
+{
+    Fired fired = {0, 0};
+    TimerId id = wheel->schedule(5000, onFire, &fired);
+    stepTicks(100);
+    TEST_ASSERT_TRUE(wheel->cancel(id));
+    TEST_ASSERT_FALSE(wheel->cancel(id));
+    stepTicks(1000);
+    TEST_ASSERT_EQUAL(0, fired.count);
+    TEST_ASSERT_EQUAL(0, wheel->getPending());
+}
+
+// ─── Sleep time ─────────────────────────────────────────────────────────────
+
+void test_sleep_time()
+{
+    Fired fired = {0, 0};
+    stepTicks(7);
+    TEST_ASSERT_EQUAL(100, wheel->getSleepTime(millis(), 100)); // Nothing pending
+
+    wheel->setWakeHook(onWake);
+    wheel->schedule(50, onFire, &fired);
+    TEST_ASSERT_EQUAL(1, wakes); // Earlier than the planned wake-up
+    TEST_ASSERT_EQUAL(50, wheel->getSleepTime(millis(), 1000));
+    TEST_ASSERT_EQUAL(20, wheel->getSleepTime(millis(), 20));
+
+    // Planned wake-up is now 20 ms away: only an earlier timer wakes
+    wheel->schedule(200, onFire, &fired);
+    TEST_ASSERT_EQUAL(1, wakes);
+    wheel->schedule(10, onFire, &fired);
+    TEST_ASSERT_EQUAL(2, wakes);
+}
+
+void test_sleeping_as_told_never_misses_a_timer()
+{
+    static const uint32_t DELAYS_MS[] = {15, 640, 650, 10000, 41000, 3000000};
+    Fired fired[6] = {};
+    stepTicks(29);
+    host::advanceMillis(3); // Off the tick grid, as the loop is
+    uint32_t start = millis();
+    for (int i = 0; i < 6; i++)
+        wheel->schedule(DELAYS_MS[i], onFire, &fired[i]);
+
+    uint32_t wakeUps = 0;
+    while (wheel->getPending() > 0)
+    {
+        uint32_t sleep = wheel->getSleepTime(millis(), 60000);
+        host::advanceMillis(sleep > 0 ? sleep : 1);
+        wheel->advance(millis());
+        wakeUps++;
+    }
+
+    for (int i = 0; i < 6; i++)
+    {
+        // Fires on the first tick at or after the deadline
+        TEST_ASSERT_GREATER_OR_EQUAL(start + DELAYS_MS[i], fired[i].at);
+        TEST_ASSERT_LESS_THAN(start + DELAYS_MS[i] + TICK, fired[i].at);
+    }
+    TEST_ASSERT_LESS_THAN(3000000 / TICK / 32, wakeUps); // Not once per tick
+}
+
+// ─── Pool ───────────────────────────────────────────────────────────────────
+
+void test_pool_exhaustion()
+{
+    Fired fired = {0, 0};
+    TimerId first = 0;
+    for (int i = 0; i < TIMING_WHEEL_MAX_TIMERS; i++)
+    {
+        TimerId id = wheel->schedule(1000 + i, onFire, &fired);
+        TEST_ASSERT_NOT_EQUAL(0, id);
+        if (i == 0)
+            first = id;
+    }
+    TEST_ASSERT_EQUAL(TIMING_WHEEL_MAX_TIMERS, wheel->getPending());
+
+    TEST_ASSERT_EQUAL(0, wheel->schedule(10, onFire, &fired));
+    TEST_ASSERT_EQUAL(1, wheel->getPoolExhausted());
+
+    TEST_ASSERT_TRUE(wheel->cancel(first));
+    TEST_ASSERT_NOT_EQUAL(0, wheel->schedule(10, onFire, &fired));
+
+    stepTicks(1000 / TICK + TIMING_WHEEL_MAX_TIMERS / TICK + 2);
+    TEST_ASSERT_EQUAL(TIMING_WHEEL_MAX_TIMERS, fired.count);
+    TEST_ASSERT_EQUAL(TIMING_WHEEL_MAX_TIMERS, wheel->getMaxPending());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_level_boundaries_at_unaligned_ticks);
+    RUN_TEST(test_delay_beyond_the_top_level_fires_on_time);
+    RUN_TEST(test_timers_on_one_tick_all_fire);
+    RUN_TEST(test_cancel_after_fire_is_a_no_op);
+    RUN_TEST(test_cancel_before_fire);
+    RUN_TEST(test_sleep_time);
+    RUN_TEST(test_sleeping_as_told_never_misses_a_timer);
+    RUN_TEST(test_pool_exhaustion);
+    return UNITY_END();
+}
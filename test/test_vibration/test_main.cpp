@@ -0,0 +1,243 @@
+/**
+ * @file test_main.cpp
+ * @brief RealFFT against a reference DFT, VibrationAnalyzer features (native)
+ *
+ * The reference is the DFT sum in double precision; RealFFT has to match
+ * it to float rounding at every size. The analyzer is fed synthesized
+ * accelerometer samples (gravity plus known tones) at the FIFO rate and
+ * with the bands and frame interval from config.h, as SensorAdapters
+ * sets it up. The benchmark reports the cost of one frame in ns and, on
+ * x86, in TSC cycles.
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "sensors/VibrationAnalyzer.h"
+#include "utils/RealFFT.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_CYCLE_COUNTER 1
+#endif
+
+static const float EDGES[] = {VIBRATION_BAND_EDGES};
+static const uint8_t EDGE_COUNT = sizeof(EDGES) / sizeof(EDGES[0]);
+
+static VibrationAnalyzer analyzer;
+
+void setUp()
+{
+    srand(1);
+    analyzer.setBands(EDGES, EDGE_COUNT);
+    analyzer.begin(MPU_SAMPLE_RATE, MPU_SAMPLE_RATE * VIBRATION_INTERVAL / 1000);
+}
+void tearDown() {}
+
+// Largest difference between RealFFT and the DFT sum over all bins
+template <uint16_t N>
+static double maxErrorAgainstDFT()
+{
+    static RealFFT<N> fft;
+    static float data[N];
+    static double x[N];
+    for (int n = 0; n < N; n++)
+        data[n] = x[n] = rand() / (double)RAND_MAX - 0.5;
+
+    fft.forward(data);
+
+    double maxError = 0;
+    for (int k = 0; k <= N / 2; k++)
+    {
+        double re = 0, im = 0;
+        for (int n = 0; n < N; n++)
+        {
+            re += x[n] * cos(2 * M_PI * k * n / N);
+            im -= x[n] * sin(2 * M_PI * k * n / N);
+        }
+
+        double gotRe = k == 0 ? data[0] : k == N / 2 ? data[1] : data[2 * k];
+        double gotIm = k == 0 || k == N / 2 ? 0 : data[2 * k + 1];
+        maxError = fmax(maxError, fmax(fabs(gotRe - re), fabs(gotIm - im)));
+
+        double power = fft.power(data, k);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4 * (1 + re * re + im * im), re * re + im * im, power);
+    }
+    return maxError;
+}
+
+// Gravity on Z plus the given tones (amplitude in g) for count samples
+static int feed(int count, float f1, float a1, float f2 = 0, float a2 = 0)
+{
+    int frames = 0;
+    for (int i = 0; i < count; i++)
+    {
+        float t = i / (float)MPU_SAMPLE_RATE;
+        float z = 1.0f + a1 * sinf(2 * M_PI * f1 * t) + a2 * sinf(2 * M_PI * f2 * t);
+        analyzer.addSample(0.01f, 0.0f, z);
+        if (analyzer.isFrameReady() && analyzer.analyze())
+            frames++;
+    }
+    return frames;
+}
+
+static float totalBandEnergy()
+{
+    float total = 0;
+    for (uint8_t b = 0; b < analyzer.getBandCount(); b++)
+        total += analyzer.getFeatures().bandEnergy[b];
+    return total;
+}
+
+// ─── RealFFT ────────────────────────────────────────────────────────────────
+
+void test_fft_matches_reference_dft()
+{
+    char line[96];
+    double e8 = maxErrorAgainstDFT<8>(), e64 = maxErrorAgainstDFT<64>();
+    double e256 = maxErrorAgainstDFT<256>(), e1024 = maxErrorAgainstDFT<1024>();
+    snprintf(line, sizeof(line), "max |FFT - DFT|: N=8 %.1e, 64 %.1e, 256 %.1e, 1024 %.1e", e8, e64, e256, e1024);
+    TEST_MESSAGE(line);
+
+    // Float rounding grows about with log2(N) times the bin magnitude (~sqrt(N)/3)
+    TEST_ASSERT_LESS_THAN(1e-6, e8);
+    TEST_ASSERT_LESS_THAN(5e-6, e64);
+    TEST_ASSERT_LESS_THAN(1e-5, e256);
+    TEST_ASSERT_LESS_THAN(5e-5, e1024);
+}
+
+void test_fft_of_a_bin_centred_cosine()
+{
+    static RealFFT<64> fft;
+    float data[64];
+    for (int n = 0; n < 64; n++)
+        data[n] = 2.0f + cosf(2 * M_PI * 5 * n / 64);
+    fft.forward(data);
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 128.0f, data[0]); // DC: 2 * N
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 0.0f, data[1]);   // Nyquist
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 32.0f, data[10]); // Re X[5] = N/2
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 0.0f, data[11]);
+    for (int k = 1; k < 32; k++)
+    {
+        if (k != 5)
+            TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.0f, fft.power(data, k));
+    }
+}
+
+// ─── VibrationAnalyzer ──────────────────────────────────────────────────────
+
+void test_one_frame_per_interval()
+{
+    // Ten seconds: the first frame once 256 samples are in, then one per hop
+    int frames = feed(10 * MPU_SAMPLE_RATE, 37, 0.5f);
+    int hop = MPU_SAMPLE_RATE * VIBRATION_INTERVAL / 1000;
+    TEST_ASSERT_EQUAL(1 + (10 * MPU_SAMPLE_RATE - VIBRATION_FFT_SIZE) / hop, frames);
+    TEST_ASSERT_EQUAL(frames, analyzer.getFeatures().frames);
+}
+
+void test_tone_features()
+{
+    feed(10 * MPU_SAMPLE_RATE, 37, 0.5f);
+    const VibrationFeatures &features = analyzer.getFeatures();
+
+    // Gravity is removed; a sine has RMS a/√2 and crest factor √2
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 0.5f / sqrtf(2), features.rms);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 0.5f, features.peak);
+    TEST_ASSERT_FLOAT_WITHIN(0.03, sqrtf(2), features.crestFactor);
+    TEST_ASSERT_FLOAT_WITHIN(analyzer.getResolution() / 2, 37.0f, features.peakFrequency);
+
+    // All the energy in the 25-50 Hz band, and it adds up to RMS²
+    TEST_ASSERT_FLOAT_WITHIN(0.005, 0.125f, features.bandEnergy[2]);
+    TEST_ASSERT_FLOAT_WITHIN(0.005, features.rms * features.rms, totalBandEnergy());
+}
+
+void test_two_off_bin_tones_land_in_their_bands()
+{
+    feed(3 * MPU_SAMPLE_RATE, 12.3f, 0.2f, 70, 0.05f);
+    analyzer.analyze();
+    const VibrationFeatures &features = analyzer.getFeatures();
+
+    TEST_ASSERT_FLOAT_WITHIN(analyzer.getResolution(), 12.3f, features.peakFrequency);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 0.02f, features.bandEnergy[1]);    // 10-25 Hz: 0.2²/2
+    TEST_ASSERT_FLOAT_WITHIN(0.0002, 0.00125f, features.bandEnergy[3]); // 50-100 Hz: 0.05²/2
+    TEST_ASSERT_FLOAT_WITHIN(0.0005, 0.0f, features.bandEnergy[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.0005, 0.0f, features.bandEnergy[2]);
+}
+
+void test_not_enough_samples()
+{
+    feed(VIBRATION_FFT_SIZE - 1, 37, 0.5f);
+    TEST_ASSERT_FALSE(analyzer.isFrameReady());
+    TEST_ASSERT_FALSE(analyzer.analyze());
+    TEST_ASSERT_EQUAL(0, analyzer.getFeatures().frames);
+}
+
+// ─── Benchmark ──────────────────────────────────────────────────────────────
+
+void test_benchmark_frame()
+{
+    const int FRAMES = 20000;
+    feed(VIBRATION_FFT_SIZE, 37, 0.5f);
+
+    static RealFFT<VIBRATION_FFT_SIZE> fft;
+    static float signal[VIBRATION_FFT_SIZE], data[VIBRATION_FFT_SIZE];
+    for (int n = 0; n < VIBRATION_FFT_SIZE; n++)
+        signal[n] = sinf(n);
+
+    auto start = std::chrono::steady_clock::now();
+#ifdef HAVE_CYCLE_COUNTER
+    uint64_t startCycles = __rdtsc();
+#endif
+    for (int i = 0; i < FRAMES; i++)
+    {
+        memcpy(data, signal, sizeof(data)); // As analyze() fills its work buffer
+        fft.forward(data);
+    }
+#ifdef HAVE_CYCLE_COUNTER
+    double fftCycles = (double)(__rdtsc() - startCycles) / FRAMES;
+#endif
+    double fftNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+
+    start = std::chrono::steady_clock::now();
+#ifdef HAVE_CYCLE_COUNTER
+    startCycles = __rdtsc();
+#endif
+    for (int i = 0; i < FRAMES; i++)
+        analyzer.analyze();
+#ifdef HAVE_CYCLE_COUNTER
+    double frameCycles = (double)(__rdtsc() - startCycles) / FRAMES;
+#endif
+    double frameNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+
+    char line[128];
+#ifdef HAVE_CYCLE_COUNTER
+    snprintf(line, sizeof(line), "%d-point forward(): %.0f ns, %.0f cycles; analyze(): %.0f ns, %.0f cycles per frame",
+             VIBRATION_FFT_SIZE, fftNs, fftCycles, frameNs, frameCycles);
+#else
+    snprintf(line, sizeof(line), "%d-point forward(): %.0f ns; analyze(): %.0f ns per frame",
+             VIBRATION_FFT_SIZE, fftNs, frameNs);
+#endif
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_FALSE(isnan(data[2]));
+    // One frame per second has to be a small fraction of a core
+    TEST_ASSERT_LESS_THAN(1e6, frameNs);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fft_matches_reference_dft);
+    RUN_TEST(test_fft_of_a_bin_centred_cosine);
+    RUN_TEST(test_one_frame_per_interval);
+    RUN_TEST(test_tone_features);
+    RUN_TEST(test_two_off_bin_tones_land_in_their_bands);
+    RUN_TEST(test_not_enough_samples);
+    RUN_TEST(test_benchmark_frame);
+    return UNITY_END();
+}
@@ -0,0 +1,234 @@
+/**
+ * @file test_main.cpp
+ * @brief Non-blocking WiFi scan state machine against a fake driver (native)
+ *
+ * Every call a handler or the loop makes (requestScan, update,
+ * writeScanResults) must return without waiting for the radio: the
+ * virtual clock may not move inside it and no call may take more than a
+ * few ms of real time. The fake driver takes 2.5 s per scan.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include "core/WiFiManager.h"
+#include "utils/ResponseWriter.h"
+
+static const FakeNetwork NETWORKS[] = {
+    {"office", -71, 6, WIFI_AUTH_WPA2_PSK},
+    {"guest", -48, 1, WIFI_AUTH_OPEN},
+    {"lab", -60, 11, WIFI_AUTH_WPA2_PSK},
+    {"far-away", -90, 3, WIFI_AUTH_WPA_PSK},
+};
+
+static const double BUDGET_MS = 5.0;
+
+static WiFiManager *manager;
+static uint32_t callbackId;
+static int callbackSuccess;
+static double worstCallMs;
+
+static void onScanComplete(uint32_t scanId, bool success)
+{
+    callbackId = scanId;
+    callbackSuccess = success;
+}
+
+// Run one manager call, checking it neither sleeps nor spins
+template <typename Fn>
+static auto timed(Fn fn) -> decltype(fn())
+{
+    uint64_t clockBefore = host::clockUs;
+    uint32_t delaysBefore = host::delayCalls;
+    auto start = std::chrono::steady_clock::now();
+
+    auto result = fn();
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (ms > worstCallMs)
+        worstCallMs = ms;
+    TEST_ASSERT_EQUAL(clockBefore, host::clockUs);
+    TEST_ASSERT_EQUAL(delaysBefore, host::delayCalls);
+    TEST_ASSERT_LESS_THAN(BUDGET_MS, ms);
+    return result;
+}
+
+static uint32_t request(bool force = false)
+{
+    return timed([&] { return manager->requestScan(force); });
+}
+
+static void update()
+{
+    timed([] { manager->update(); return 0; });
+}
+
+void setUp()
+{
+    host::resetClock(1000000);
+    WiFi.reset();
+    WiFi.networks = NETWORKS;
+    WiFi.networkCount = sizeof(NETWORKS) / sizeof(NETWORKS[0]);
+
+    manager = new WiFiManager();
+    manager->begin("test-network", "secret");
+    manager->setOnScanComplete(onScanComplete);
+    host::resetClock(host::clockUs); // begin() may poll with delay()
+
+    callbackId = 0;
+    callbackSuccess = -1;
+}
+
+void tearDown()
+{
+    delete manager;
+}
+
+// Poll the loop every 10 ms until the scan settles
+static void runLoopFor(uint32_t ms)
+{
+    for (uint32_t t = 0; t < ms; t += 10)
+    {
+        host::advanceMillis(10);
+        update();
+    }
+}
+
+void test_request_returns_at_once_and_scan_runs_async()
+{
+    uint32_t id = request();
+    TEST_ASSERT_EQUAL(1, id);
+    TEST_ASSERT_EQUAL(SCAN_STATE_PENDING, manager->getScanState());
+
+    update();
+    TEST_ASSERT_EQUAL(SCAN_STATE_RUNNING, manager->getScanState());
+    TEST_ASSERT_EQUAL(1, WiFi.scansStarted);
+    TEST_ASSERT_EQUAL(0, WiFi.blockingScans);
+    TEST_ASSERT_FALSE(manager->isScanComplete(id));
+
+    runLoopFor(3000);
+    TEST_ASSERT_EQUAL(SCAN_STATE_DONE, manager->getScanState());
+    TEST_ASSERT_TRUE(manager->isScanComplete(id));
+    TEST_ASSERT_EQUAL(id, callbackId);
+    TEST_ASSERT_EQUAL(1, callbackSuccess);
+}
+
+void test_results_are_sorted_strongest_first()
+{
+    request();
+    update();
+    runLoopFor(3000);
+
+    char buffer[512];
+    FixedBufferPrint out(buffer, sizeof(buffer));
+    ResponseWriter json(out);
+    json.beginObject();
+    timed([&] { manager->writeScanResults(json); return 0; });
+    json.endObject();
+
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "\"count\":4"));
+    const char *guest = strstr(buffer, "guest");
+    const char *lab = strstr(buffer, "lab");
+    const char *office = strstr(buffer, "office");
+    const char *far = strstr(buffer, "far-away");
+    TEST_ASSERT_TRUE(guest && lab && office && far);
+    TEST_ASSERT_TRUE(guest < lab && lab < office && office < far);
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "\"encryption\":\"Open\""));
+}
+
+void test_requests_during_a_scan_join_it()
+{
+    uint32_t first = request();
+    update();
+    uint32_t second = request();
+    uint32_t forced = request(true);
+
+    TEST_ASSERT_EQUAL(first, second);
+    TEST_ASSERT_EQUAL(first, forced);
+    runLoopFor(3000);
+    TEST_ASSERT_EQUAL(1, WiFi.scansStarted);
+}
+
+void test_fresh_results_are_reused_until_ttl()
+{
+    uint32_t first = request();
+    update();
+    runLoopFor(3000);
+
+    TEST_ASSERT_EQUAL(first, request());
+    TEST_ASSERT_EQUAL(SCAN_STATE_DONE, manager->getScanState());
+
+    host::advanceMillis(WIFI_SCAN_TTL);
+    uint32_t next = request();
+    TEST_ASSERT_EQUAL(first + 1, next);
+    update();
+    TEST_ASSERT_EQUAL(2, WiFi.scansStarted);
+}
+
+void test_force_starts_a_new_scan()
+{
+    uint32_t first = request();
+    update();
+    runLoopFor(3000);
+
+    uint32_t forced = request(true);
+    TEST_ASSERT_EQUAL(first + 1, forced);
+    update();
+    TEST_ASSERT_EQUAL(2, WiFi.scansStarted);
+}
+
+void test_hung_driver_times_out()
+{
+    WiFi.hang = true;
+    uint32_t id = request();
+    update();
+    runLoopFor(WIFI_SCAN_TIMEOUT + 100);
+
+    TEST_ASSERT_EQUAL(SCAN_STATE_FAILED, manager->getScanState());
+    TEST_ASSERT_TRUE(manager->isScanFailed(id));
+    TEST_ASSERT_EQUAL(id, callbackId);
+    TEST_ASSERT_EQUAL(0, callbackSuccess);
+}
+
+void test_start_failure_is_reported()
+{
+    WiFi.failStart = true;
+    uint32_t id = request();
+    update();
+
+    TEST_ASSERT_EQUAL(SCAN_STATE_FAILED, manager->getScanState());
+    TEST_ASSERT_TRUE(manager->isScanFailed(id));
+    TEST_ASSERT_EQUAL(0, callbackSuccess);
+}
+
+void test_no_call_exceeds_budget()
+{
+    // Everything above went through timed(); report the worst case
+    char line[64];
+    snprintf(line, sizeof(line), "worst call %.3f ms (budget %.0f ms)", worstCallMs, BUDGET_MS);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_LESS_THAN(BUDGET_MS, worstCallMs);
+}
+
+void test_calls_before_begin_are_harmless()
+{
+    WiFiManager idle;
+    TEST_ASSERT_EQUAL(0, idle.requestScan());
+    idle.update();
+    TEST_ASSERT_EQUAL(SCAN_STATE_IDLE, idle.getScanState());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_request_returns_at_once_and_scan_runs_async);
+    RUN_TEST(test_results_are_sorted_strongest_first);
+    RUN_TEST(test_requests_during_a_scan_join_it);
+    RUN_TEST(test_fresh_results_are_reused_until_ttl);
+    RUN_TEST(test_force_starts_a_new_scan);
+    RUN_TEST(test_hung_driver_times_out);
+    RUN_TEST(test_start_failure_is_reported);
+    RUN_TEST(test_calls_before_begin_are_harmless);
+    RUN_TEST(test_no_call_exceeds_budget);
+    return UNITY_END();
+}